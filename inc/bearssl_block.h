@@ -154,14 +154,17 @@
  * Implemented Block Ciphers
  * -------------------------
  * 
- *   Function   Name         Allowed key lengths (bytes)
- *
- *   AES        aes_ct       16, 24 and 32
- *   AES        aes_ct64     16, 24 and 32
- *   AES        aes_big      16, 24 and 32
- *   AES        aes_small    16, 24 and 32
- *   DES        des_ct       8, 16 and 24
- *   DES        des_tab      8, 16 and 24
+ *   Function   Name            Allowed key lengths (bytes)
+ *
+ *   AES        aes_ct          16, 24 and 32
+ *   AES        aes_ct64        16, 24 and 32
+ *   AES        aes_big         16, 24 and 32
+ *   AES        aes_small       16, 24 and 32
+ *   AES        aes_x86ni       16, 24 and 32
+ *   AES        aes_ct64_sse2   16, 24 and 32 (CBC decryption and CTR only)
+ *   AES        aes_ct64_avx2   16, 24 and 32 (CBC decryption and CTR only)
+ *   DES        des_ct          8, 16 and 24
+ *   DES        des_tab         8, 16 and 24
  *
  * 'aes_big' is a "classical" AES implementation, using tables. It
  * is fast but not constant-time, since it makes data-dependent array
@@ -184,6 +187,21 @@
  * similar to 'aes_ct' but uses 64-bit values, for faster processing
  * on 64-bit machines.
  *
+ * 'aes_x86ni' uses the AES-NI opcodes that are available on recent
+ * x86 CPU. It is both fast and constant-time. Its code is compiled only
+ * if the compiler supports the relevant intrinsics, and it may be used
+ * only if the current CPU actually implements these opcodes: the
+ * br_aes_x86ni_cbcenc_get_vtable() (and similar) functions return a
+ * pointer to the relevant vtable when the implementation is usable,
+ * NULL otherwise.
+ *
+ * 'aes_ct64_sse2' and 'aes_ct64_avx2' are the 'aes_ct64' code with
+ * the 64-bit words replaced by SSE2 or AVX2 registers, for 8 or 16
+ * blocks in parallel. They are constant-time, and meant for x86 CPU
+ * that lack AES-NI (or where it is not exposed, e.g. in some virtual
+ * machines). They are available through get_vtable() functions, like
+ * 'aes_x86ni'.
+ *
  * 'des_tab' is a classic, table-based implementation of DES/3DES. It
  * is not constant-time.
  *
@@ -380,6 +398,115 @@ void br_aes_ct64_cbcdec_run(const br_aes_ct64_cbcdec_keys *ctx, void *iv,
 uint32_t br_aes_ct64_ctr_run(const br_aes_ct64_ctr_keys *ctx,
 	const void *iv, uint32_t cc, void *data, size_t len);
 
+/*
+ * AES implementation using AES-NI opcodes (x86 platform). The subkeys
+ * are stored as bytes, in the order and format expected by the AES-NI
+ * opcodes. The init() and run() functions, and the vtables, exist only
+ * if the implementation could be compiled; use the get_vtable()
+ * functions to obtain a vtable pointer, which will be NULL if the
+ * implementation is not available at runtime (unsupported CPU or
+ * compiler).
+ */
+#define br_aes_x86ni_BLOCK_SIZE   16
+typedef struct {
+	const br_block_cbcenc_class *vtable;
+	union {
+		unsigned char skni[16 * 15];
+	} skey;
+	unsigned num_rounds;
+} br_aes_x86ni_cbcenc_keys;
+typedef struct {
+	const br_block_cbcdec_class *vtable;
+	union {
+		unsigned char skni[16 * 15];
+	} skey;
+	unsigned num_rounds;
+} br_aes_x86ni_cbcdec_keys;
+typedef struct {
+	const br_block_ctr_class *vtable;
+	union {
+		unsigned char skni[16 * 15];
+	} skey;
+	unsigned num_rounds;
+} br_aes_x86ni_ctr_keys;
+extern const br_block_cbcenc_class br_aes_x86ni_cbcenc_vtable;
+extern const br_block_cbcdec_class br_aes_x86ni_cbcdec_vtable;
+extern const br_block_ctr_class br_aes_x86ni_ctr_vtable;
+void br_aes_x86ni_cbcenc_init(br_aes_x86ni_cbcenc_keys *ctx,
+	const void *key, size_t len);
+void br_aes_x86ni_cbcdec_init(br_aes_x86ni_cbcdec_keys *ctx,
+	const void *key, size_t len);
+void br_aes_x86ni_ctr_init(br_aes_x86ni_ctr_keys *ctx,
+	const void *key, size_t len);
+void br_aes_x86ni_cbcenc_run(const br_aes_x86ni_cbcenc_keys *ctx, void *iv,
+	void *data, size_t len);
+void br_aes_x86ni_cbcdec_run(const br_aes_x86ni_cbcdec_keys *ctx, void *iv,
+	void *data, size_t len);
+uint32_t br_aes_x86ni_ctr_run(const br_aes_x86ni_ctr_keys *ctx,
+	const void *iv, uint32_t cc, void *data, size_t len);
+const br_block_cbcenc_class *br_aes_x86ni_cbcenc_get_vtable(void);
+const br_block_cbcdec_class *br_aes_x86ni_cbcdec_get_vtable(void);
+const br_block_ctr_class *br_aes_x86ni_ctr_get_vtable(void);
+
+/*
+ * Variants of aes_ct64 that run the bitsliced rounds in SIMD registers,
+ * with one instance of the ct64 representation per 64-bit lane: the
+ * SSE2 variant processes 8 blocks in parallel, the AVX2 variant 16
+ * blocks. The key schedule and subkey format are those of aes_ct64.
+ * Only CBC decryption and CTR are provided (CBC encryption cannot be
+ * parallelised; use aes_ct64 for it). As for aes_x86ni, the init() and
+ * run() functions, and the vtables, exist only if the code could be
+ * compiled; use the get_vtable() functions, which return NULL if the
+ * implementation is not available at runtime.
+ */
+#define br_aes_ct64_sse2_BLOCK_SIZE   16
+typedef struct {
+	const br_block_cbcdec_class *vtable;
+	uint64_t skey[30];
+	unsigned num_rounds;
+} br_aes_ct64_sse2_cbcdec_keys;
+typedef struct {
+	const br_block_ctr_class *vtable;
+	uint64_t skey[30];
+	unsigned num_rounds;
+} br_aes_ct64_sse2_ctr_keys;
+extern const br_block_cbcdec_class br_aes_ct64_sse2_cbcdec_vtable;
+extern const br_block_ctr_class br_aes_ct64_sse2_ctr_vtable;
+void br_aes_ct64_sse2_cbcdec_init(br_aes_ct64_sse2_cbcdec_keys *ctx,
+	const void *key, size_t len);
+void br_aes_ct64_sse2_ctr_init(br_aes_ct64_sse2_ctr_keys *ctx,
+	const void *key, size_t len);
+void br_aes_ct64_sse2_cbcdec_run(const br_aes_ct64_sse2_cbcdec_keys *ctx,
+	void *iv, void *data, size_t len);
+uint32_t br_aes_ct64_sse2_ctr_run(const br_aes_ct64_sse2_ctr_keys *ctx,
+	const void *iv, uint32_t cc, void *data, size_t len);
+const br_block_cbcdec_class *br_aes_ct64_sse2_cbcdec_get_vtable(void);
+const br_block_ctr_class *br_aes_ct64_sse2_ctr_get_vtable(void);
+
+#define br_aes_ct64_avx2_BLOCK_SIZE   16
+typedef struct {
+	const br_block_cbcdec_class *vtable;
+	uint64_t skey[30];
+	unsigned num_rounds;
+} br_aes_ct64_avx2_cbcdec_keys;
+typedef struct {
+	const br_block_ctr_class *vtable;
+	uint64_t skey[30];
+	unsigned num_rounds;
+} br_aes_ct64_avx2_ctr_keys;
+extern const br_block_cbcdec_class br_aes_ct64_avx2_cbcdec_vtable;
+extern const br_block_ctr_class br_aes_ct64_avx2_ctr_vtable;
+void br_aes_ct64_avx2_cbcdec_init(br_aes_ct64_avx2_cbcdec_keys *ctx,
+	const void *key, size_t len);
+void br_aes_ct64_avx2_ctr_init(br_aes_ct64_avx2_ctr_keys *ctx,
+	const void *key, size_t len);
+void br_aes_ct64_avx2_cbcdec_run(const br_aes_ct64_avx2_cbcdec_keys *ctx,
+	void *iv, void *data, size_t len);
+uint32_t br_aes_ct64_avx2_ctr_run(const br_aes_ct64_avx2_ctr_keys *ctx,
+	const void *iv, uint32_t cc, void *data, size_t len);
+const br_block_cbcdec_class *br_aes_ct64_avx2_cbcdec_get_vtable(void);
+const br_block_ctr_class *br_aes_ct64_avx2_ctr_get_vtable(void);
+
 /*
  * These structures are large enough to accommodate subkeys for all
  * AES implementations.
@@ -390,6 +517,7 @@ typedef union {
 	br_aes_small_cbcenc_keys small;
 	br_aes_ct_cbcenc_keys ct;
 	br_aes_ct64_cbcenc_keys ct64;
+	br_aes_x86ni_cbcenc_keys x86ni;
 } br_aes_gen_cbcenc_keys;
 typedef union {
 	const br_block_cbcdec_class *vtable;
@@ -397,6 +525,9 @@ typedef union {
 	br_aes_small_cbcdec_keys small;
 	br_aes_ct_cbcdec_keys ct;
 	br_aes_ct64_cbcdec_keys ct64;
+	br_aes_x86ni_cbcdec_keys x86ni;
+	br_aes_ct64_sse2_cbcdec_keys ct64_sse2;
+	br_aes_ct64_avx2_cbcdec_keys ct64_avx2;
 } br_aes_gen_cbcdec_keys;
 typedef union {
 	const br_block_ctr_class *vtable;
@@ -404,6 +535,9 @@ typedef union {
 	br_aes_small_ctr_keys small;
 	br_aes_ct_ctr_keys ct;
 	br_aes_ct64_ctr_keys ct64;
+	br_aes_x86ni_ctr_keys x86ni;
+	br_aes_ct64_sse2_ctr_keys ct64_sse2;
+	br_aes_ct64_avx2_ctr_keys ct64_avx2;
 } br_aes_gen_ctr_keys;
 
 /*
@@ -473,4 +607,172 @@ typedef union {
 	br_des_ct_cbcdec_keys ct;
 } br_des_gen_cbcdec_keys;
 
+/*
+ * ChaCha20 and Poly1305.
+ * ----------------------
+ *
+ * ChaCha20 is a stream cipher; Poly1305 is a MAC algorithm. They are
+ * described in RFC 7539. Both are used together in the AEAD mode known
+ * as "ChaCha20+Poly1305".
+ *
+ * A ChaCha20 implementation is a function with the following
+ * parameters:
+ *
+ *   key    secret key (32 bytes)
+ *   iv     nonce (12 bytes)
+ *   cc     initial block counter value
+ *   data   data to encrypt or decrypt (processed in place)
+ *   len    data length (in bytes)
+ *
+ * The new block counter value is returned. If len is not a multiple of
+ * 64, then the last (partial) block still counts as a full block for
+ * the counter update.
+ */
+typedef uint32_t (*br_chacha20_run)(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len);
+
+/*
+ * ChaCha20 implementation that relies only on 32-bit additions,
+ * XORs and rotations. It is constant-time.
+ */
+uint32_t br_chacha20_ct_run(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len);
+
+/*
+ * ChaCha20 implementation that uses SSE2 opcodes (on x86 platforms)
+ * to process four blocks in parallel. br_chacha20_sse2_get() returns
+ * a pointer to br_chacha20_sse2_run() if that implementation was
+ * compiled and the CPU supports it; otherwise, it returns 0. This
+ * implementation is constant-time.
+ */
+uint32_t br_chacha20_sse2_run(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len);
+br_chacha20_run br_chacha20_sse2_get(void);
+
+/*
+ * ChaCha20 implementation that uses AVX2 opcodes (on x86 platforms)
+ * to process eight blocks in parallel. br_chacha20_avx2_get() returns
+ * a pointer to br_chacha20_avx2_run() if that implementation was
+ * compiled and both the CPU and the operating system support AVX2;
+ * otherwise, it returns 0. This implementation is constant-time.
+ */
+uint32_t br_chacha20_avx2_run(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len);
+br_chacha20_run br_chacha20_avx2_get(void);
+
+/*
+ * A Poly1305 implementation is a function that performs the complete
+ * ChaCha20+Poly1305 AEAD processing (encryption and MAC computation,
+ * or MAC computation and decryption), with the following parameters:
+ *
+ *   key       secret key (32 bytes)
+ *   iv        nonce (12 bytes)
+ *   data      data to encrypt or decrypt (processed in place)
+ *   len       data length (in bytes)
+ *   aad       additional authenticated data
+ *   aad_len   length of additional authenticated data (in bytes)
+ *   tag       output buffer for the authentication tag (16 bytes)
+ *   ichacha   ChaCha20 implementation to use
+ *   encrypt   non-zero for encryption, zero for decryption
+ *
+ * The MAC key is computed with ChaCha20 (counter 0), and the data is
+ * encrypted or decrypted with counter values starting at 1. The tag is
+ * always computed over the ciphertext; when decrypting, the caller is
+ * responsible for comparing the computed tag with the expected value.
+ */
+typedef void (*br_poly1305_run)(const void *key, const void *iv,
+	void *data, size_t len, const void *aad, size_t aad_len,
+	void *tag, br_chacha20_run ichacha, int encrypt);
+
+/*
+ * Poly1305 implementation that uses 32x32->64 multiplications. It is
+ * constant-time (if multiplications are constant-time).
+ */
+void br_poly1305_ctmul_run(const void *key, const void *iv,
+	void *data, size_t len, const void *aad, size_t aad_len,
+	void *tag, br_chacha20_run ichacha, int encrypt);
+
+/*
+ * CCM mode.
+ * ---------
+ *
+ * CCM (NIST SP 800-38C, RFC 3610) combines CTR encryption and a CBC-MAC
+ * with the same block cipher and key. br_ccm_run() performs the complete
+ * processing of a message, with two block cipher contexts which MUST
+ * have been initialised with the same key:
+ *
+ *   bc_cbc      CBC encryption context (used for the CBC-MAC)
+ *   bc_ctr      CTR context (used for encryption and tag masking)
+ *   nonce       nonce (7 to 13 bytes)
+ *   nonce_len   nonce length (in bytes)
+ *   aad         additional authenticated data
+ *   aad_len     length of additional authenticated data (in bytes)
+ *   data        data to encrypt or decrypt (processed in place)
+ *   len         data length (in bytes)
+ *   tag         output buffer for the authentication tag
+ *   tag_len     tag length (even, 4 to 16 bytes)
+ *   encrypt     non-zero for encryption, zero for decryption
+ *
+ * The block cipher must have 16-byte blocks (i.e. AES). The data length
+ * must fit in the counter field (15 - nonce_len bytes). The tag is
+ * always computed over the plaintext; when decrypting, the caller is
+ * responsible for comparing the computed tag with the expected value.
+ */
+void br_ccm_run(const br_block_cbcenc_class *const *bc_cbc,
+	const br_block_ctr_class *const *bc_ctr,
+	const void *nonce, size_t nonce_len,
+	const void *aad, size_t aad_len,
+	void *data, size_t len,
+	void *tag, size_t tag_len, int encrypt);
+
+/*
+ * GCM kernels.
+ * ------------
+ *
+ * A GCM kernel performs, in a single pass over the data, both the CTR
+ * encryption or decryption, and the GHASH computation over the
+ * ciphertext, as used in the GCM mode. This avoids streaming each
+ * record twice through the cache. A kernel is bound to a specific CTR
+ * implementation: it uses the subkeys from a context that was
+ * initialised with that implementation.
+ *
+ * The OOP structure contains the following:
+ *
+ *   ctr_vtable    the CTR implementation for which the kernel works
+ *   encrypt       CTR-encrypt the data, then inject the ciphertext
+ *                 into the GHASH state
+ *   decrypt       inject the ciphertext into the GHASH state, then
+ *                 CTR-decrypt the data
+ *
+ * For encrypt() and decrypt(), the 'iv', 'cc', 'data' and 'len'
+ * parameters have the same meaning as for the CTR run() function, and
+ * the new counter value is returned. 'h' is the GHASH key (16 bytes),
+ * and 'y' is the GHASH state (16 bytes), which is updated as if by a
+ * call to a br_ghash function on the ciphertext; if 'len' is not a
+ * multiple of 16, then the ciphertext is implicitly padded with zeros.
+ *
+ * GCM kernels are optional: code that uses them must also support
+ * the two-pass processing with a CTR implementation and a separate
+ * GHASH implementation.
+ */
+typedef struct br_gcm_kernel_class_ br_gcm_kernel_class;
+struct br_gcm_kernel_class_ {
+	const br_block_ctr_class *ctr_vtable;
+	uint32_t (*encrypt)(const br_block_ctr_class *const *ctx,
+		const void *iv, uint32_t cc, const void *h, void *y,
+		void *data, size_t len);
+	uint32_t (*decrypt)(const br_block_ctr_class *const *ctx,
+		const void *iv, uint32_t cc, const void *h, void *y,
+		void *data, size_t len);
+};
+
+/*
+ * GCM kernel for AES-NI and pclmulqdq (works with the 'aes_x86ni' CTR
+ * implementation). br_aes_x86ni_gcm_kernel_get() returns a pointer to
+ * the kernel if the compiler and the CPU support the relevant opcodes,
+ * NULL otherwise.
+ */
+extern const br_gcm_kernel_class br_aes_x86ni_gcm_kernel;
+const br_gcm_kernel_class *br_aes_x86ni_gcm_kernel_get(void);
+
 #endif
@@ -92,6 +92,7 @@
 #define BR_EC_brainpoolP256r1    26
 #define BR_EC_brainpoolP384r1    27
 #define BR_EC_brainpoolP512r1    28
+#define BR_EC_curve25519         29
 
 /*
  * Structure for an EC public key.
@@ -125,6 +126,13 @@ typedef struct {
  *     Get a pointer to the curve order (minimal unsigned big-endian
  *     encoding).
  *
+ *  xoff
+ *     Get the offset and length of the X coordinate in an encoded
+ *     point (as produced by mul()); for ECDH, this is the shared
+ *     secret. For the NIST curves (uncompressed format), the offset
+ *     is 1 and the length is that of the field modulus; for
+ *     Curve25519, the point is the X (u) coordinate only.
+ *
  *  mul
  *     Compute x*G. Provided point G (encoded size Glen) must be valid and
  *     distinct from the point at infinity. 'x' must be non-zero and less
@@ -133,16 +141,29 @@ typedef struct {
  *     However, if x is a non-zero multiple of the curve order, then it is
  *     not guaranteed that an error is reported.
  *
+ *  mulgen
+ *     Compute x*G, where G is the conventional generator for the curve
+ *     (as returned by generator()). The result is written in R, in
+ *     uncompressed format, and its length (which is equal to the
+ *     generator length) is returned. 'x' must be non-zero and less
+ *     than the curve order. This is typically faster than mul() with
+ *     the generator, since it may use precomputed tables.
+ *
  *  muladd
  *     compute x*A+y*B, result being written over A. Points and multipliers
- *     must fulfill the same conditions as for mul().
+ *     must fulfill the same conditions as for mul(). This function is
+ *     meant for operations on public data (signature verification), and
+ *     it need not be constant-time.
  */
 typedef struct {
 	uint32_t supported_curves;
 	const unsigned char *(*generator)(int curve, size_t *len);
 	const unsigned char *(*order)(int curve, size_t *len);
+	size_t (*xoff)(int curve, size_t *len);
 	uint32_t (*mul)(unsigned char *G, size_t Glen,
 		const unsigned char *x, size_t xlen, int curve);
+	size_t (*mulgen)(unsigned char *R,
+		const unsigned char *x, size_t xlen, int curve);
 	uint32_t (*muladd)(unsigned char *A, const unsigned char *B, size_t len,
 		const unsigned char *x, size_t xlen,
 		const unsigned char *y, size_t ylen, int curve);
@@ -154,6 +175,36 @@ typedef struct {
  */
 extern const br_ec_impl br_ec_prime_i31;
 
+/*
+ * An implementation dedicated to secp256r1 (NIST P-256), with
+ * specialised field arithmetic (32-bit words, and a modular reduction
+ * that uses the special format of the field modulus). Other curves
+ * (secp384r1 and secp521r1) are delegated to br_ec_prime_i31, so
+ * this implementation supports the same curves, and can be used
+ * wherever br_ec_prime_i31 is used.
+ */
+extern const br_ec_impl br_ec_p256_m32;
+
+/*
+ * An implementation of Curve25519 (X25519 key exchange, RFC 7748),
+ * with a constant-time Montgomery ladder. Points are encoded as their
+ * u coordinate (32 bytes, little-endian). Multipliers are big-endian
+ * (as for all other curves, but contrary to RFC 7748), and are clamped
+ * as specified in RFC 7748. The generator() and order() functions
+ * return, respectively, the conventional base point (u = 9) and a
+ * value such that any lower 32-byte multiplier is acceptable.
+ * muladd() is not supported (it always returns 0). Only curve
+ * Curve25519 is supported.
+ */
+extern const br_ec_impl br_ec_c25519_m32;
+
+/*
+ * An aggregate implementation that supports secp256r1 (with
+ * br_ec_p256_m32), Curve25519 (with br_ec_c25519_m32), and secp384r1
+ * and secp521r1 (with br_ec_prime_i31).
+ */
+extern const br_ec_impl br_ec_all_m32;
+
 /*
  * Convert a signature from "raw" to "asn1". Conversion is done "in
  * place" and the new length is returned. Conversion may enlarge the
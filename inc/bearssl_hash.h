@@ -276,6 +276,111 @@ void br_sha512_out(const br_sha512_context *ctx, void *out);
 #define br_sha512_state       br_sha384_state
 #define br_sha512_set_state   br_sha384_set_state
 
+/*
+ * Alternate implementations of SHA-1, SHA-224 and SHA-256 that use the
+ * x86 SHA extensions (sha1rnds4, sha256rnds2...). They use the same
+ * context structures and state encoding as the portable implementations,
+ * thus br_sha1_state() and br_sha1_set_state() (and their SHA-224/256
+ * counterparts) work with both, and saved states can be transferred
+ * from one implementation to the other. Full input blocks are processed
+ * directly from the caller's buffer.
+ *
+ * These implementations are available only on x86 platforms where the
+ * compiler supports the relevant intrinsics; moreover, the CPU must
+ * support the opcodes. The br_xxx_x86ni_get_vtable() functions return
+ * a pointer to the relevant vtable if it is available and the CPU
+ * supports it; otherwise, they return NULL. The br_xxx_x86ni_init()
+ * (and other) functions MUST NOT be called if the corresponding
+ * br_xxx_x86ni_get_vtable() returned NULL.
+ */
+extern const br_hash_class br_sha1_x86ni_vtable;
+void br_sha1_x86ni_init(br_sha1_context *ctx);
+void br_sha1_x86ni_update(br_sha1_context *ctx, const void *data, size_t len);
+void br_sha1_x86ni_out(const br_sha1_context *ctx, void *out);
+const br_hash_class *br_sha1_x86ni_get_vtable(void);
+
+extern const br_hash_class br_sha224_x86ni_vtable;
+void br_sha224_x86ni_init(br_sha224_context *ctx);
+void br_sha224_x86ni_update(br_sha224_context *ctx,
+	const void *data, size_t len);
+void br_sha224_x86ni_out(const br_sha224_context *ctx, void *out);
+const br_hash_class *br_sha224_x86ni_get_vtable(void);
+
+extern const br_hash_class br_sha256_x86ni_vtable;
+void br_sha256_x86ni_init(br_sha256_context *ctx);
+#define br_sha256_x86ni_update   br_sha224_x86ni_update
+void br_sha256_x86ni_out(const br_sha256_context *ctx, void *out);
+const br_hash_class *br_sha256_x86ni_get_vtable(void);
+
+/*
+ * Multi-buffer SHA-256: several independent SHA-256 (or SHA-224)
+ * computations are advanced together, with one computation per SIMD
+ * lane. This is meant for callers which have many short, unrelated
+ * messages to hash (e.g. HMAC over many small records, or a batch of
+ * certificates to verify).
+ *
+ * An implementation is described by a br_sha256_mb_impl structure:
+ *
+ *   lanes   maximum number of blocks processed in one call to run()
+ *           (at most 8)
+ *   run     process one 64-byte block for each of 'num' independent
+ *           states (1 <= num <= lanes); val[i] points to the eight
+ *           32-bit words of the state for lane i (the 'val' field of
+ *           a br_sha256_context), and buf[i] to the block for lane i.
+ *
+ * br_sha256_mb_update() injects 'len' bytes into each of the 'num'
+ * provided contexts: data[i] goes to ctx[i]. The contexts must be
+ * initialized (with br_sha256_init() or br_sha224_init(), or any
+ * other implementation that uses br_sha256_context) and distinct; they
+ * need not have the same amount of buffered data. 'num' may exceed the
+ * number of lanes of the implementation. Afterwards, the contexts can
+ * be used with the normal functions (e.g. br_sha256_out()).
+ *
+ * Implementations:
+ *
+ *   portable   plain C, one lane (uses the same code as br_sha256_vtable)
+ *   sse2       four lanes with SSE2 opcodes (x86 only)
+ *   avx2       eight lanes with AVX2 opcodes (x86 only)
+ *   x86ni      two interleaved lanes with the SHA opcodes (x86 only)
+ *
+ * br_sha256_mb_sse2_get(), br_sha256_mb_avx2_get() and
+ * br_sha256_mb_x86ni_get() return a pointer to the relevant
+ * implementation if it was compiled and the CPU supports it;
+ * otherwise, they return NULL. br_sha256_mb_get_default()
+ * returns the fastest available implementation, in the order x86ni,
+ * avx2, sse2, portable (it never returns NULL).
+ */
+typedef struct {
+	unsigned lanes;
+	void (*run)(uint32_t *const *val,
+		const unsigned char *const *buf, size_t num);
+} br_sha256_mb_impl;
+
+extern const br_sha256_mb_impl br_sha256_mb_portable;
+void br_sha256_mb_portable_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num);
+
+extern const br_sha256_mb_impl br_sha256_mb_sse2;
+void br_sha256_mb_sse2_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num);
+const br_sha256_mb_impl *br_sha256_mb_sse2_get(void);
+
+extern const br_sha256_mb_impl br_sha256_mb_avx2;
+void br_sha256_mb_avx2_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num);
+const br_sha256_mb_impl *br_sha256_mb_avx2_get(void);
+
+extern const br_sha256_mb_impl br_sha256_mb_x86ni;
+void br_sha256_mb_x86ni_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num);
+const br_sha256_mb_impl *br_sha256_mb_x86ni_get(void);
+
+const br_sha256_mb_impl *br_sha256_mb_get_default(void);
+
+void br_sha256_mb_update(const br_sha256_mb_impl *impl,
+	br_sha256_context *const *ctx, const void *const *data,
+	size_t len, size_t num);
+
 /*
  * "md5sha1" is a special hash function that computes both MD5 and SHA-1
  * on the same input, and produces a 36-byte output (MD5 and SHA-1
@@ -326,6 +431,7 @@ typedef struct {
 	uint32_t val_32[25];
 	uint64_t val_64[16];
 	const br_hash_class *impl[6];
+	uint32_t dropped;
 } br_multihash_context;
 
 /*
@@ -365,6 +471,24 @@ br_multihash_getimpl(const br_multihash_context *ctx, int id)
  */
 void br_multihash_init(br_multihash_context *ctx);
 
+/*
+ * Stop computing the hash functions which are not needed anymore. The
+ * 'keep' parameter is a bit mask: bit i is set if the hash function
+ * of ID i shall still be computed (e.g. (1 << br_sha256_ID) to keep
+ * only SHA-256). The other hash functions are no longer updated with
+ * subsequent data, and br_multihash_out() returns 0 for them. The
+ * implementation pointers are not modified (br_multihash_getimpl()
+ * still returns them), and the next br_multihash_init() computes all
+ * configured hash functions again. Calling this function several
+ * times drops the union of the non-kept functions.
+ *
+ * This is meant for protocol engines that know, at some point, which
+ * hash outputs they will actually need (e.g. once the TLS version and
+ * cipher suite have been chosen): each hash function costs its full
+ * processing time over every subsequent input byte.
+ */
+void br_multihash_restrict(br_multihash_context *ctx, unsigned keep);
+
 /*
  * Input some bytes into the context.
  */
@@ -376,7 +500,8 @@ void br_multihash_update(br_multihash_context *ctx,
  * function. The hash function is given by ID (e.g. br_md5_ID for MD5).
  * The hash output is written on 'dst'. The hash length is returned (in
  * bytes); if the specified hash function is not implemented by this
- * context, then this function returns 0.
+ * context, or was dropped with br_multihash_restrict(), then this
+ * function returns 0.
  *
  * Obtaining the hash output does not invalidate the current hashing
  * operation, thus "partial hashes" can be obtained.
@@ -421,4 +546,16 @@ void br_ghash_ctmul32(void *y, const void *h, const void *data, size_t len);
  */
 void br_ghash_ctmul64(void *y, const void *h, const void *data, size_t len);
 
+/*
+ * Implementation of GHASH using the x86 pclmulqdq opcode (carry-less
+ * multiplication). Four blocks are processed per modular reduction,
+ * with precomputed powers of h. This implementation is available only
+ * on x86 platforms where the compiler supports the relevant intrinsics;
+ * moreover, the CPU must support the opcode. br_ghash_pclmul_get()
+ * returns a pointer to br_ghash_pclmul() if it is available and the
+ * CPU supports it; otherwise, it returns 0.
+ */
+void br_ghash_pclmul(void *y, const void *h, const void *data, size_t len);
+br_ghash br_ghash_pclmul_get(void);
+
 #endif
@@ -50,7 +50,12 @@
  */
 
 /*
- * Key context.
+ * Key context. It contains the internal hash states obtained after
+ * processing the inner and outer padded key blocks (ksi and kso), so
+ * that initializing a HMAC context from it does not involve any call
+ * to the compression function. Callers that compute many HMAC values
+ * with the same key should thus keep the key context around rather
+ * than calling br_hmac_key_init() for each value.
  */
 typedef struct {
 	const br_hash_class *dig_vtable;
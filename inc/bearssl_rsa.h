@@ -212,6 +212,87 @@ uint32_t br_rsa_i31_pkcs1_sign(const unsigned char *hash_oid,
 	const unsigned char *hash, size_t hash_len,
 	const br_rsa_private_key *sk, unsigned char *x);
 
+/*
+ * Expanded RSA private key for the "i31" engine. The br_rsa_i31_private()
+ * function decodes the key factors and computes the Montgomery
+ * parameters anew for each operation; when the same key is used many
+ * times, this work can be done once with br_rsa_i31_expand_key(), and
+ * the private key operations then use br_rsa_i31_private_expanded() and
+ * br_rsa_i31_pkcs1_sign_expanded(), which skip all that setup.
+ *
+ * The expanded key contains the factors p and q (in internal i31
+ * format), the Montgomery parameters for both factors (including
+ * R^2 mod p and R^2 mod q), the CRT coefficient iq (reduced modulo p,
+ * in Montgomery representation), and copies of the exponents dp and
+ * dq. The structure does not reference the source br_rsa_private_key,
+ * and contains secret values; it should be treated as opaque, and
+ * cleared when no longer needed.
+ *
+ * The buffer sizes are for the maximum supported RSA modulus size
+ * (4096 bits), for a total of about 2 kB.
+ */
+#define BR_RSA_I31_XKEY_WORDS   (2 + ((((4096 + 64) >> 1) + 30) / 31))
+#define BR_RSA_I31_XKEY_BYTES   ((4096 + 64) >> 4)
+
+typedef struct {
+	uint32_t n_bitlen;
+	uint32_t p0i, q0i;
+	uint32_t mp[BR_RSA_I31_XKEY_WORDS];
+	uint32_t mq[BR_RSA_I31_XKEY_WORDS];
+	uint32_t r2p[BR_RSA_I31_XKEY_WORDS];
+	uint32_t r2q[BR_RSA_I31_XKEY_WORDS];
+	uint32_t iq[BR_RSA_I31_XKEY_WORDS];
+	unsigned char dp[BR_RSA_I31_XKEY_BYTES];
+	size_t dplen;
+	unsigned char dq[BR_RSA_I31_XKEY_BYTES];
+	size_t dqlen;
+} br_rsa_i31_expanded_key;
+
+/*
+ * Expand a RSA private key. Returned value is 1 on success, 0 on error
+ * (the key is too large, or has an even factor). On error, the
+ * expanded key contents are indeterminate and must not be used.
+ */
+uint32_t br_rsa_i31_expand_key(br_rsa_i31_expanded_key *xsk,
+	const br_rsa_private_key *sk);
+
+/*
+ * Private-key operation and PKCS#1 v1.5 signature generation with an
+ * expanded key. These functions have the same semantics as
+ * br_rsa_i31_private() and br_rsa_i31_pkcs1_sign(), and produce the
+ * same results.
+ */
+uint32_t br_rsa_i31_private_expanded(unsigned char *x,
+	const br_rsa_i31_expanded_key *xsk);
+uint32_t br_rsa_i31_pkcs1_sign_expanded(const unsigned char *hash_oid,
+	const unsigned char *hash, size_t hash_len,
+	const br_rsa_i31_expanded_key *xsk, unsigned char *x);
+
+/*
+ * RSA "i62" engine. Similar to i31, but the modular exponentiations use
+ * 62-bit words and the 64x64->128 multiplication, which is much faster
+ * on 64-bit architectures. This engine is available only if the
+ * compiler supports a 128-bit integer type (on 64-bit platforms); the
+ * br_rsa_i62_*_get() functions return a pointer to the relevant
+ * function if it is available, 0 otherwise. The br_rsa_i62_*()
+ * functions themselves are not defined if the engine is not available.
+ */
+
+uint32_t br_rsa_i62_public(unsigned char *x, size_t xlen,
+	const br_rsa_public_key *pk);
+uint32_t br_rsa_i62_pkcs1_vrfy(const unsigned char *x, size_t xlen,
+	const unsigned char *hash_oid, size_t hash_len,
+	const br_rsa_public_key *pk, unsigned char *hash_out);
+uint32_t br_rsa_i62_private(unsigned char *x,
+	const br_rsa_private_key *sk);
+uint32_t br_rsa_i62_pkcs1_sign(const unsigned char *hash_oid,
+	const unsigned char *hash, size_t hash_len,
+	const br_rsa_private_key *sk, unsigned char *x);
+br_rsa_public br_rsa_i62_public_get(void);
+br_rsa_pkcs1_vrfy br_rsa_i62_pkcs1_vrfy_get(void);
+br_rsa_private br_rsa_i62_private_get(void);
+br_rsa_pkcs1_sign br_rsa_i62_pkcs1_sign_get(void);
+
 /*
  * Perform RSA decryption for SSL/TLS. This function uses the provided core
  * and private key to decrypt the message in data[] of size 'len'. The
@@ -279,6 +279,57 @@ struct br_sslrec_in_cbc_class_ {
 		const void *iv);
 };
 
+/*
+ * A CBC+HMAC kernel performs, in a single pass, the CBC encryption of
+ * some data and the hashing (for HMAC) of either the plaintext or the
+ * ciphertext. CBC encryption is inherently sequential, and so is the
+ * hash compression function; with both computations interleaved
+ * ("stitched"), the CPU can run them in parallel. A kernel is bound to
+ * a specific CBC encryption implementation, and supports only some
+ * hash functions.
+ *
+ * The OOP structure contains the following:
+ *
+ *   cbcenc_vtable   the CBC encryption implementation for which the
+ *                   kernel works
+ *   hashes          supported hash functions: bit (1 << id) is set for
+ *                   each supported hash function identifier
+ *   mac_encrypt     inject the data into the hash context, then
+ *                   CBC-encrypt it (MAC-then-encrypt)
+ *   encrypt_mac     CBC-encrypt the data, then inject the ciphertext
+ *                   into the hash context (Encrypt-then-MAC)
+ *
+ * For mac_encrypt() and encrypt_mac(), the 'ctx', 'iv', 'data' and 'len'
+ * parameters have the same meaning as for the CBC run() function (in
+ * particular, 'len' must be a multiple of the block size). 'hc' is a
+ * hash context, which must have been initialized with an implementation
+ * of a supported hash function that uses the standard context structure
+ * for that function (e.g. br_sha1_context for SHA-1). The result is the
+ * same as with the hash update() function and the CBC run() function
+ * called in the relevant order.
+ *
+ * CBC+HMAC kernels are optional: code that uses them must also support
+ * the two-pass processing.
+ */
+typedef struct br_cbc_hmac_kernel_class_ br_cbc_hmac_kernel_class;
+struct br_cbc_hmac_kernel_class_ {
+	const br_block_cbcenc_class *cbcenc_vtable;
+	uint32_t hashes;
+	void (*mac_encrypt)(const br_block_cbcenc_class *const *ctx,
+		void *iv, const br_hash_class **hc, void *data, size_t len);
+	void (*encrypt_mac)(const br_block_cbcenc_class *const *ctx,
+		void *iv, const br_hash_class **hc, void *data, size_t len);
+};
+
+/*
+ * CBC+HMAC kernel for AES-NI and the x86 SHA opcodes, with SHA-1 and
+ * SHA-256 (works with the 'aes_x86ni' CBC encryption implementation).
+ * br_aes_x86ni_cbc_hmac_kernel_get() returns a pointer to the kernel if
+ * the compiler and the CPU support the relevant opcodes, NULL otherwise.
+ */
+extern const br_cbc_hmac_kernel_class br_aes_x86ni_cbc_hmac_kernel;
+const br_cbc_hmac_kernel_class *br_aes_x86ni_cbc_hmac_kernel_get(void);
+
 /*
  * An engine for processing outgoing records with a block cipher in
  * CBC mode has an extra initialization function, that takes as inputs:
@@ -333,11 +384,46 @@ typedef struct {
 	} bc;
 	br_hmac_key_context mac;
 	size_t mac_len;
+	const br_cbc_hmac_kernel_class *kern;
 	unsigned char iv[16];
 	int explicit_IV;
 } br_sslrec_out_cbc_context;
 extern const br_sslrec_out_cbc_class br_sslrec_out_cbc_vtable;
 
+/*
+ * Set the CBC+HMAC kernel for an outgoing CBC record context (with
+ * br_sslrec_out_cbc_vtable or br_sslrec_out_cbc_etm_vtable); this must
+ * be called after init(), which clears any previously set kernel. The
+ * kernel is used only if it works with the block cipher implementation
+ * provided to init() (its 'cbcenc_vtable' field is equal to that
+ * implementation) and supports the hash function; otherwise (or if
+ * 'kern_impl' is NULL), the HMAC and the CBC encryption are computed
+ * in two separate passes over the data.
+ */
+static inline void
+br_sslrec_out_cbc_set_kernel(br_sslrec_out_cbc_context *cc,
+	const br_cbc_hmac_kernel_class *kern_impl)
+{
+	if (kern_impl != NULL && kern_impl->cbcenc_vtable == cc->bc.vtable
+		&& ((kern_impl->hashes >> ((cc->mac.dig_vtable->desc
+		>> BR_HASHDESC_ID_OFF) & BR_HASHDESC_ID_MASK)) & 1) != 0)
+	{
+		cc->kern = kern_impl;
+	} else {
+		cc->kern = NULL;
+	}
+}
+
+/*
+ * Alternate CBC + HMAC record engines, for the Encrypt-then-MAC mode
+ * (RFC 7366). They use the same context structures and initialization
+ * parameters as the engines above. The MAC is computed over the
+ * encrypted data, so that incoming records are authenticated before
+ * decryption, which avoids the costly constant-time MAC processing.
+ */
+extern const br_sslrec_in_cbc_class br_sslrec_in_cbc_etm_vtable;
+extern const br_sslrec_out_cbc_class br_sslrec_out_cbc_etm_vtable;
+
 /* ===================================================================== */
 
 /*
@@ -396,6 +482,7 @@ typedef struct {
 		br_aes_gen_ctr_keys aes;
 	} bc;
 	br_ghash gh;
+	const br_gcm_kernel_class *kern;
 	unsigned char iv[4];
 	unsigned char h[16];
 } br_sslrec_gcm_context;
@@ -403,6 +490,162 @@ typedef struct {
 extern const br_sslrec_in_gcm_class br_sslrec_in_gcm_vtable;
 extern const br_sslrec_out_gcm_class br_sslrec_out_gcm_vtable;
 
+/*
+ * Set the GCM kernel for a GCM record context (incoming or outgoing);
+ * this must be called after init(), which clears any previously set
+ * kernel. The kernel is used only if it works with the block cipher
+ * implementation provided to init() (its 'ctr_vtable' field is equal
+ * to that implementation); otherwise (or if 'kern_impl' is NULL), the
+ * CTR encryption and the GHASH computation are performed in two
+ * separate passes over the data.
+ */
+static inline void
+br_sslrec_gcm_set_kernel(br_sslrec_gcm_context *cc,
+	const br_gcm_kernel_class *kern_impl)
+{
+	if (kern_impl != NULL && kern_impl->ctr_vtable == cc->bc.vtable) {
+		cc->kern = kern_impl;
+	} else {
+		cc->kern = NULL;
+	}
+}
+
+/* ===================================================================== */
+
+/*
+ * An engine for processing incoming records with a block cipher in
+ * CCM mode (RFC 6655) has an extra initialization function, that takes
+ * as inputs:
+ * -- a block cipher (CBC encryption) implementation, for the CBC-MAC;
+ * -- a block cipher (CTR) implementation, for encryption;
+ * -- the key (used with both implementations);
+ * -- an initial IV (4 bytes);
+ * -- the authentication tag length (16 for CCM, 8 for CCM_8).
+ *
+ * The initialization function is responsible for setting the 'vtable'
+ * field of the context.
+ */
+typedef struct br_sslrec_in_ccm_class_ br_sslrec_in_ccm_class;
+struct br_sslrec_in_ccm_class_ {
+	br_sslrec_in_class inner;
+	void (*init)(const br_sslrec_in_ccm_class **ctx,
+		const br_block_cbcenc_class *bc_impl,
+		const br_block_ctr_class *bcctr_impl,
+		const void *key, size_t key_len,
+		const void *iv, size_t tag_len);
+};
+
+/*
+ * An engine for processing outgoing records with a block cipher in
+ * CCM mode (RFC 6655) has an extra initialization function, that takes
+ * as inputs:
+ * -- a block cipher (CBC encryption) implementation, for the CBC-MAC;
+ * -- a block cipher (CTR) implementation, for encryption;
+ * -- the key (used with both implementations);
+ * -- an initial IV (4 bytes);
+ * -- the authentication tag length (16 for CCM, 8 for CCM_8).
+ *
+ * The initialization function is responsible for setting the 'vtable'
+ * field of the context.
+ */
+typedef struct br_sslrec_out_ccm_class_ br_sslrec_out_ccm_class;
+struct br_sslrec_out_ccm_class_ {
+	br_sslrec_out_class inner;
+	void (*init)(const br_sslrec_out_ccm_class **ctx,
+		const br_block_cbcenc_class *bc_impl,
+		const br_block_ctr_class *bcctr_impl,
+		const void *key, size_t key_len,
+		const void *iv, size_t tag_len);
+};
+
+/*
+ * We use the same context structure for incoming and outgoing records
+ * with CCM, because it allows internal code sharing.
+ */
+typedef struct {
+	union {
+		const void *gen;
+		const br_sslrec_in_ccm_class *in;
+		const br_sslrec_out_ccm_class *out;
+	} vtable;
+	uint64_t seq;
+	union {
+		const br_block_cbcenc_class *vtable;
+		br_aes_gen_cbcenc_keys aes;
+	} bc;
+	union {
+		const br_block_ctr_class *vtable;
+		br_aes_gen_ctr_keys aes;
+	} bcctr;
+	unsigned char iv[4];
+	size_t tag_len;
+} br_sslrec_ccm_context;
+
+extern const br_sslrec_in_ccm_class br_sslrec_in_ccm_vtable;
+extern const br_sslrec_out_ccm_class br_sslrec_out_ccm_vtable;
+
+/* ===================================================================== */
+
+/*
+ * An engine for processing incoming records with ChaCha20+Poly1305
+ * (RFC 7905) has an extra initialization function, that takes as inputs:
+ * -- a ChaCha20 implementation;
+ * -- a Poly1305 implementation;
+ * -- the encryption key (32 bytes);
+ * -- the initial IV (12 bytes).
+ *
+ * The initialization function is responsible for setting the 'vtable'
+ * field of the context.
+ */
+typedef struct br_sslrec_in_chapol_class_ br_sslrec_in_chapol_class;
+struct br_sslrec_in_chapol_class_ {
+	br_sslrec_in_class inner;
+	void (*init)(const br_sslrec_in_chapol_class **ctx,
+		br_chacha20_run ichacha,
+		br_poly1305_run ipoly,
+		const void *key, const void *iv);
+};
+
+/*
+ * An engine for processing outgoing records with ChaCha20+Poly1305
+ * (RFC 7905) has an extra initialization function, that takes as inputs:
+ * -- a ChaCha20 implementation;
+ * -- a Poly1305 implementation;
+ * -- the encryption key (32 bytes);
+ * -- the initial IV (12 bytes).
+ *
+ * The initialization function is responsible for setting the 'vtable'
+ * field of the context.
+ */
+typedef struct br_sslrec_out_chapol_class_ br_sslrec_out_chapol_class;
+struct br_sslrec_out_chapol_class_ {
+	br_sslrec_out_class inner;
+	void (*init)(const br_sslrec_out_chapol_class **ctx,
+		br_chacha20_run ichacha,
+		br_poly1305_run ipoly,
+		const void *key, const void *iv);
+};
+
+/*
+ * We use the same context structure for incoming and outgoing records
+ * with ChaCha20+Poly1305, because it allows internal code sharing.
+ */
+typedef struct {
+	union {
+		const void *gen;
+		const br_sslrec_in_chapol_class *in;
+		const br_sslrec_out_chapol_class *out;
+	} vtable;
+	uint64_t seq;
+	unsigned char key[32];
+	unsigned char iv[12];
+	br_chacha20_run ichacha;
+	br_poly1305_run ipoly;
+} br_sslrec_chapol_context;
+
+extern const br_sslrec_in_chapol_class br_sslrec_in_chapol_vtable;
+extern const br_sslrec_out_chapol_class br_sslrec_out_chapol_vtable;
+
 /* ===================================================================== */
 
 /*
@@ -419,7 +662,7 @@ typedef struct {
 /*
  * Maximum numnber of cipher suites supported by a client or server.
  */
-#define BR_MAX_CIPHER_SUITES   40
+#define BR_MAX_CIPHER_SUITES   48
 
 /*
  * Context structure for SSL engine. This is common to the client and
@@ -503,12 +746,16 @@ typedef struct {
 		const br_sslrec_in_class *vtable;
 		br_sslrec_in_cbc_context cbc;
 		br_sslrec_gcm_context gcm;
+		br_sslrec_ccm_context ccm;
+		br_sslrec_chapol_context chapol;
 	} in;
 	union {
 		const br_sslrec_out_class *vtable;
 		br_sslrec_out_clear_context clear;
 		br_sslrec_out_cbc_context cbc;
 		br_sslrec_gcm_context gcm;
+		br_sslrec_ccm_context ccm;
+		br_sslrec_chapol_context chapol;
 	} out;
 
 	/*
@@ -574,6 +821,14 @@ typedef struct {
 	unsigned char reneg;
 	unsigned char saved_finished[24];
 
+	/*
+	 * Encrypt-then-MAC (RFC 7366): this flag is set to 1 when the
+	 * extension was negotiated in the current handshake; it then
+	 * applies to the CBC record engines set up at the next
+	 * ChangeCipherSpec, in both directions.
+	 */
+	unsigned char etm;
+
 	/*
 	 * Context variables for the handshake processor.
 	 * The 'pad' must be large enough to accommodate an
@@ -645,10 +900,20 @@ typedef struct {
 	const br_block_cbcenc_class *ides_cbcenc;
 	const br_block_cbcdec_class *ides_cbcdec;
 	br_ghash ighash;
+	br_chacha20_run ichacha;
+	br_poly1305_run ipoly;
 	const br_sslrec_in_cbc_class *icbc_in;
 	const br_sslrec_out_cbc_class *icbc_out;
+	const br_sslrec_in_cbc_class *icbc_etm_in;
+	const br_sslrec_out_cbc_class *icbc_etm_out;
+	const br_cbc_hmac_kernel_class *icbc_kernel;
 	const br_sslrec_in_gcm_class *igcm_in;
 	const br_sslrec_out_gcm_class *igcm_out;
+	const br_gcm_kernel_class *igcm_kernel;
+	const br_sslrec_in_ccm_class *iccm_in;
+	const br_sslrec_out_ccm_class *iccm_out;
+	const br_sslrec_in_chapol_class *ichapol_in;
+	const br_sslrec_out_chapol_class *ichapol_out;
 	const br_ec_impl *iec;
 
 } br_ssl_engine_context;
@@ -701,6 +966,14 @@ br_ssl_engine_get_hash(br_ssl_engine_context *ctx, int id)
 	return br_multihash_getimpl(&ctx->mhash, id);
 }
 
+/*
+ * Set all supported hash functions (MD5, SHA-1, SHA-224, SHA-256,
+ * SHA-384 and SHA-512) to the default implementations. For SHA-1,
+ * SHA-224 and SHA-256, this is 'x86ni' if the CPU supports it; the
+ * portable implementation is used otherwise.
+ */
+void br_ssl_engine_set_default_hashes(br_ssl_engine_context *cc);
+
 /*
  * Set the PRF implementation (for TLS 1.0 and 1.1).
  */
@@ -750,6 +1023,44 @@ br_ssl_engine_set_aes_ctr(br_ssl_engine_context *cc,
 	cc->iaes_ctr = impl;
 }
 
+/*
+ * Set the AES/CBC implementations to the default choice: this is the
+ * AES-NI implementation if the current CPU supports it; otherwise,
+ * this is the constant-time 'aes_ct64' implementation on 64-bit
+ * architectures, and 'aes_ct' on other systems. Without AES-NI, CBC
+ * decryption and CTR use 'aes_ct64_avx2' or 'aes_ct64_sse2' (with
+ * 'aes_ct64' for CBC encryption) when the CPU supports them. If AES-NI
+ * and the x86 SHA opcodes are supported, the CBC+HMAC kernel is also
+ * set.
+ */
+void br_ssl_engine_set_default_aes_cbc(br_ssl_engine_context *cc);
+
+/*
+ * Set the AES/CTR and GHASH implementations (for AES/GCM) to the default
+ * choice. For AES, this follows the same rules as
+ * br_ssl_engine_set_default_aes_cbc(); for GHASH, this is 'ghash_pclmul'
+ * if the CPU supports it, otherwise 'ghash_ctmul64' on 64-bit
+ * architectures, and 'ghash_ctmul' on other systems.
+ */
+void br_ssl_engine_set_default_aes_gcm(br_ssl_engine_context *cc);
+
+/*
+ * Set the AES/CBC (encryption) and AES/CTR implementations, and the
+ * record processor implementations for AES/CCM, to the default choice.
+ * For AES, this follows the same rules as
+ * br_ssl_engine_set_default_aes_cbc().
+ */
+void br_ssl_engine_set_default_aes_ccm(br_ssl_engine_context *cc);
+
+/*
+ * Set the ChaCha20 and Poly1305 implementations, and the record
+ * processor implementations for ChaCha20+Poly1305, to the default
+ * choice. For ChaCha20, this is 'chacha20_avx2' or 'chacha20_sse2' if
+ * the CPU supports them (in that order of preference), 'chacha20_ct'
+ * otherwise; for Poly1305, this is 'poly1305_ctmul'.
+ */
+void br_ssl_engine_set_default_chapol(br_ssl_engine_context *cc);
+
 /*
  * Set the 3DES/CBC implementations.
  */
@@ -771,6 +1082,21 @@ br_ssl_engine_set_ghash(br_ssl_engine_context *cc, br_ghash impl)
 	cc->ighash = impl;
 }
 
+/*
+ * Set the GCM kernel (fused CTR and GHASH processing). This is optional,
+ * and no kernel is set by br_ssl_engine_set_default_aes_gcm(); the
+ * kernel is used only for records where the configured AES/CTR
+ * implementation is the one that the kernel works with, and only with
+ * the standard GCM record engines (br_sslrec_in_gcm_vtable and
+ * br_sslrec_out_gcm_vtable). Setting NULL disables the use of a kernel.
+ */
+static inline void
+br_ssl_engine_set_gcm_kernel(br_ssl_engine_context *cc,
+	const br_gcm_kernel_class *impl)
+{
+	cc->igcm_kernel = impl;
+}
+
 /*
  * Set the CBC+HMAC record processor implementations.
  */
@@ -783,6 +1109,38 @@ br_ssl_engine_set_cbc(br_ssl_engine_context *cc,
 	cc->icbc_out = impl_out;
 }
 
+/*
+ * Set the CBC+HMAC kernel (stitched CBC encryption and HMAC, for
+ * outgoing records). This is optional; the kernel is used only for
+ * records where the configured CBC encryption implementation and
+ * the HMAC hash function are supported by the kernel, and only with
+ * the standard CBC record engines (br_sslrec_out_cbc_vtable and
+ * br_sslrec_out_cbc_etm_vtable). Setting NULL disables the use of a
+ * kernel.
+ */
+static inline void
+br_ssl_engine_set_cbc_kernel(br_ssl_engine_context *cc,
+	const br_cbc_hmac_kernel_class *impl)
+{
+	cc->icbc_kernel = impl;
+}
+
+/*
+ * Set the CBC+HMAC record processor implementations for the
+ * Encrypt-then-MAC mode (RFC 7366). The extension is offered (as a
+ * client) or accepted (as a server) only if both implementations
+ * are set, in addition to the ones set with br_ssl_engine_set_cbc().
+ * Setting NULL disables Encrypt-then-MAC.
+ */
+static inline void
+br_ssl_engine_set_cbc_etm(br_ssl_engine_context *cc,
+	const br_sslrec_in_cbc_class *impl_in,
+	const br_sslrec_out_cbc_class *impl_out)
+{
+	cc->icbc_etm_in = impl_in;
+	cc->icbc_etm_out = impl_out;
+}
+
 /*
  * Set the GCM record processor implementations.
  */
@@ -795,6 +1153,52 @@ br_ssl_engine_set_gcm(br_ssl_engine_context *cc,
 	cc->igcm_out = impl_out;
 }
 
+/*
+ * Set the CCM record processor implementations. CCM uses the AES/CBC
+ * encryption implementation (for the CBC-MAC) and the AES/CTR
+ * implementation.
+ */
+static inline void
+br_ssl_engine_set_ccm(br_ssl_engine_context *cc,
+	const br_sslrec_in_ccm_class *impl_in,
+	const br_sslrec_out_ccm_class *impl_out)
+{
+	cc->iccm_in = impl_in;
+	cc->iccm_out = impl_out;
+}
+
+/*
+ * Set the ChaCha20 implementation (for ChaCha20+Poly1305).
+ */
+static inline void
+br_ssl_engine_set_chacha20(br_ssl_engine_context *cc,
+	br_chacha20_run ichacha)
+{
+	cc->ichacha = ichacha;
+}
+
+/*
+ * Set the Poly1305 implementation (for ChaCha20+Poly1305).
+ */
+static inline void
+br_ssl_engine_set_poly1305(br_ssl_engine_context *cc,
+	br_poly1305_run ipoly)
+{
+	cc->ipoly = ipoly;
+}
+
+/*
+ * Set the ChaCha20+Poly1305 record processor implementations.
+ */
+static inline void
+br_ssl_engine_set_chapol(br_ssl_engine_context *cc,
+	const br_sslrec_in_chapol_class *impl_in,
+	const br_sslrec_out_chapol_class *impl_out)
+{
+	cc->ichapol_in = impl_in;
+	cc->ichapol_out = impl_out;
+}
+
 /*
  * Set the ECC core operations implementation. The 'iec' parameter
  * points to the core EC code used for both ECDHE and ECDSA.
@@ -1132,6 +1536,10 @@ br_ssl_client_forget_session(br_ssl_client_context *cc)
  *      3   AES-128/GCM
  *      4   AES-256/GCM
  *      5   ChaCha20/Poly1305
+ *      6   AES-128/CCM
+ *      7   AES-256/CCM
+ *      8   AES-128/CCM_8
+ *      9   AES-256/CCM_8
  *
  *   Bits 4 to 7: MAC algorithm
  *      0   AEAD           No dedicated MAC because encryption is AEAD
@@ -1157,6 +1565,10 @@ typedef uint16_t br_suite_translated[2];
 #define BR_SSLENC_AES128_GCM     3
 #define BR_SSLENC_AES256_GCM     4
 #define BR_SSLENC_CHACHA20       5
+#define BR_SSLENC_AES128_CCM     6
+#define BR_SSLENC_AES256_CCM     7
+#define BR_SSLENC_AES128_CCM8    8
+#define BR_SSLENC_AES256_CCM8    9
 
 #define BR_SSLMAC_AEAD           0
 #define BR_SSLMAC_SHA1           br_sha1_ID
@@ -1263,13 +1675,16 @@ struct br_ssl_server_policy_class_ {
 /*
  * A single-chain RSA policy handler, that always uses a single chain and
  * a RSA key. It may be restricted to do only signatures or only key
- * exchange.
+ * exchange. If 'xsk' is not NULL, then the private key operations use
+ * that expanded "i31" key, and the sk, irsacore and irsasign fields
+ * are ignored.
  */
 typedef struct {
 	const br_ssl_server_policy_class *vtable;
 	const br_x509_certificate *chain;
 	size_t chain_len;
 	const br_rsa_private_key *sk;
+	const br_rsa_i31_expanded_key *xsk;
 	unsigned allowed_usages;
 	br_rsa_private irsacore;
 	br_rsa_pkcs1_sign irsasign;
@@ -1332,8 +1747,7 @@ typedef struct {
 	const br_ssl_session_cache_class *vtable;
 	unsigned char *store;
 	size_t store_len, store_ptr;
-	unsigned char index_key[32];
-	const br_hash_class *hash;
+	br_hmac_key_context index_key;
 	int init_done;
 	uint32_t head, tail, root;
 } br_ssl_session_cache_lru;
@@ -1575,6 +1989,17 @@ void br_ssl_server_set_single_rsa(br_ssl_server_context *cc,
 	const br_rsa_private_key *sk, unsigned allowed_usages,
 	br_rsa_private irsacore, br_rsa_pkcs1_sign irsasign);
 
+/*
+ * Set the server certificate chain and key (single RSA case), with a
+ * key expanded with br_rsa_i31_expand_key(). The key decoding and
+ * Montgomery setup are then not redone for each handshake. The
+ * expanded key is not copied; it must remain valid as long as the
+ * server context uses it.
+ */
+void br_ssl_server_set_single_rsa_expanded(br_ssl_server_context *cc,
+	const br_x509_certificate *chain, size_t chain_length,
+	const br_rsa_i31_expanded_key *xsk, unsigned allowed_usages);
+
 /*
  * Set the server certificate chain and key (single EC case).
  * The 'allowed_usages' is a combination of usages, namely
@@ -1818,6 +2243,28 @@ int br_sslio_close(br_sslio_context *cc);
 #define BR_TLS_ECDH_RSA_WITH_AES_128_GCM_SHA256      0xC031
 #define BR_TLS_ECDH_RSA_WITH_AES_256_GCM_SHA384      0xC032
 
+/* From RFC 6655 and 7251 */
+#define BR_TLS_RSA_WITH_AES_128_CCM                  0xC09C
+#define BR_TLS_RSA_WITH_AES_256_CCM                  0xC09D
+#define BR_TLS_DHE_RSA_WITH_AES_128_CCM              0xC09E
+#define BR_TLS_DHE_RSA_WITH_AES_256_CCM              0xC09F
+#define BR_TLS_RSA_WITH_AES_128_CCM_8                0xC0A0
+#define BR_TLS_RSA_WITH_AES_256_CCM_8                0xC0A1
+#define BR_TLS_DHE_RSA_WITH_AES_128_CCM_8            0xC0A2
+#define BR_TLS_DHE_RSA_WITH_AES_256_CCM_8            0xC0A3
+#define BR_TLS_PSK_WITH_AES_128_CCM                  0xC0A4
+#define BR_TLS_PSK_WITH_AES_256_CCM                  0xC0A5
+#define BR_TLS_DHE_PSK_WITH_AES_128_CCM              0xC0A6
+#define BR_TLS_DHE_PSK_WITH_AES_256_CCM              0xC0A7
+#define BR_TLS_PSK_WITH_AES_128_CCM_8                0xC0A8
+#define BR_TLS_PSK_WITH_AES_256_CCM_8                0xC0A9
+#define BR_TLS_PSK_DHE_WITH_AES_128_CCM_8            0xC0AA
+#define BR_TLS_PSK_DHE_WITH_AES_256_CCM_8            0xC0AB
+#define BR_TLS_ECDHE_ECDSA_WITH_AES_128_CCM          0xC0AC
+#define BR_TLS_ECDHE_ECDSA_WITH_AES_256_CCM          0xC0AD
+#define BR_TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8        0xC0AE
+#define BR_TLS_ECDHE_ECDSA_WITH_AES_256_CCM_8        0xC0AF
+
 /* From RFC 7905 */
 #define BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256     0xCCA8
 #define BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256   0xCCA9
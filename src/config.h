@@ -41,6 +41,17 @@
 #define BR_64   1
  */
 
+/*
+ * When BR_INT128 is enabled, the 'unsigned __int128' type is assumed to
+ * be supported by the compiler, and 64x64->128 multiplications to be
+ * efficient. This enables the "i62" big integer code (and the RSA
+ * implementation that uses it). Default behaviour is to enable it on
+ * 64-bit architectures (see BR_64) when the compiler advertises the
+ * type (GCC and Clang define __SIZEOF_INT128__ in that case).
+ *
+#define BR_INT128   1
+ */
+
 /*
  * When BR_SLOW_MUL is enabled, multiplications are assumed to be
  * substantially slow with regards to other integer operations, thus
@@ -60,6 +71,71 @@
 #define BR_CT_MUL31   1
  */
 
+/*
+ * BR_I31_KARATSUBA is the modulus size, in 31-bit words, from which the
+ * "i31" modular exponentiation (used for RSA private key operations)
+ * switches to Karatsuba multiplication with a separate Montgomery
+ * reduction. It is 0 (Karatsuba code not used) by default: on x86
+ * (64-bit), the fused Montgomery multiplication is still faster for
+ * RSA-4096 factors. It may pay off on platforms with slow multiplications
+ * (see BR_CT_MUL31); the "karatsuba" entry in testspeed shows the
+ * crossover point.
+ *
+#define BR_I31_KARATSUBA   40
+ */
+
+/*
+ * When BR_EC_COMPILED is enabled, the generic prime curve implementation
+ * (ec_prime_i31) uses point doubling, addition, validation and
+ * conversion routines written as straight-line C code, instead of the
+ * compact microcode interpreter. The code is about 1.1 kB larger, and
+ * the speed gain depends on the curve: on x86 (64-bit, gcc -Os), point
+ * multiplication went from 1180 to 1335 per second for P-256 and from
+ * 259 to 286 for P-521, but P-384 was slightly slower (547 to 541).
+ * Default is to use the interpreter. testspeed links only the library,
+ * so comparing both with the "ec_prime_i31" entry requires a rebuild
+ * with and without this option; testcrypto always checks both variants
+ * (EC_prime_i31 and EC_prime_i31_compiled).
+ *
+#define BR_EC_COMPILED   1
+ */
+
+/*
+ * When BR_AES_X86NI is enabled, the AES implementation using the x86 AES-NI
+ * opcodes (when running on x86 platforms) will be compiled, along with
+ * the GHASH implementation that uses the pclmulqdq opcode. If this is
+ * set to 0 explicitly, then that implementation will not be compiled
+ * at all. Default behaviour is to compile it when the compiler is known
+ * to support the relevant intrinsics (GCC 4.8+, Clang 3.7+); actual use
+ * also requires the CPU to support the opcodes, which is tested at
+ * runtime.
+ *
+#define BR_AES_X86NI   1
+ */
+
+/*
+ * When BR_SHA_X86NI is enabled, the SHA-1 and SHA-224/256 implementations
+ * that use the x86 SHA extensions (sha1rnds4, sha256rnds2...) will be
+ * compiled. As for BR_AES_X86NI, default behaviour is to compile them
+ * when the compiler is known to support the intrinsics; actual use
+ * requires a runtime test of the CPU support.
+ *
+#define BR_SHA_X86NI   1
+ */
+
+/*
+ * When BR_SSE2 (respectively BR_AVX2) is enabled, implementations that
+ * use SSE2 (respectively AVX2) opcodes on x86 platforms, such as the
+ * vectorized ChaCha20 and bitsliced AES implementations, will be
+ * compiled. As for BR_AES_X86NI, default behaviour is to compile them
+ * when the compiler is known to support the intrinsics; actual use is
+ * subject to a runtime test of the CPU (and, for AVX2, operating
+ * system) support.
+ *
+#define BR_SSE2   1
+#define BR_AVX2   1
+ */
+
 /*
  * When BR_USE_URANDOM is enabled, the SSL engine will use /dev/urandom
  * to automatically obtain quality randomness for seedings its internal
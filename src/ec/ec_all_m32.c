@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * Aggregate implementation: Curve25519 is handled by br_ec_c25519_m32,
+ * all other curves by br_ec_p256_m32 (which itself delegates secp384r1
+ * and secp521r1 to br_ec_prime_i31).
+ */
+
+static inline const br_ec_impl *
+select_impl(int curve)
+{
+	return curve == BR_EC_curve25519 ? &br_ec_c25519_m32 : &br_ec_p256_m32;
+}
+
+static const unsigned char *
+api_generator(int curve, size_t *len)
+{
+	return select_impl(curve)->generator(curve, len);
+}
+
+static const unsigned char *
+api_order(int curve, size_t *len)
+{
+	return select_impl(curve)->order(curve, len);
+}
+
+static size_t
+api_xoff(int curve, size_t *len)
+{
+	return select_impl(curve)->xoff(curve, len);
+}
+
+static uint32_t
+api_mul(unsigned char *G, size_t Glen,
+	const unsigned char *x, size_t xlen, int curve)
+{
+	return select_impl(curve)->mul(G, Glen, x, xlen, curve);
+}
+
+static size_t
+api_mulgen(unsigned char *R,
+	const unsigned char *x, size_t xlen, int curve)
+{
+	return select_impl(curve)->mulgen(R, x, xlen, curve);
+}
+
+static uint32_t
+api_muladd(unsigned char *A, const unsigned char *B, size_t len,
+	const unsigned char *x, size_t xlen,
+	const unsigned char *y, size_t ylen, int curve)
+{
+	return select_impl(curve)->muladd(A, B, len,
+		x, xlen, y, ylen, curve);
+}
+
+/* see bearssl_ec.h */
+const br_ec_impl br_ec_all_m32 = {
+	(uint32_t)0x23800000,
+	&api_generator,
+	&api_order,
+	&api_xoff,
+	&api_mul,
+	&api_mulgen,
+	&api_muladd
+};
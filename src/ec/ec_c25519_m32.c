@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * This is an implementation of Curve25519 (X25519 key exchange, as
+ * described in RFC 7748), with a Montgomery ladder on the u coordinate.
+ * Field elements are kept as eight 32-bit words (little-endian order),
+ * fully reduced modulo p = 2^255 - 19 at all times; products are
+ * reduced with 2^256 = 38 mod p. All operations are constant-time.
+ *
+ * Points are encoded as the u coordinate only (32 bytes, unsigned
+ * little-endian, as per RFC 7748). Contrary to RFC 7748, multipliers
+ * use the same big-endian convention as for the other curves; since
+ * private keys are random bytes, this does not matter for key
+ * exchange. The multiplier is "clamped" as specified in RFC 7748.
+ */
+
+/*
+ * Field modulus.
+ */
+static const uint32_t F255_P[] = {
+	0xFFFFFFED, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+	0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF
+};
+
+/*
+ * Normalise a[] (any value lower than 2^256) into the 0..p-1 range.
+ */
+static void
+f255_norm(uint32_t *a)
+{
+	uint32_t t[8], m;
+	uint64_t w;
+	int i;
+
+	/*
+	 * Fold the top bit (2^255 = 19 mod p). The value is then lower
+	 * than 2^255 + 19.
+	 */
+	w = (uint64_t)19 * (a[7] >> 31);
+	a[7] &= 0x7FFFFFFF;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)a[i];
+		a[i] = (uint32_t)w;
+		w >>= 32;
+	}
+
+	/*
+	 * a >= p if and only if a + 19 >= 2^255; in that case, the
+	 * result is a + 19 - 2^255.
+	 */
+	w = 19;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)a[i];
+		t[i] = (uint32_t)w;
+		w >>= 32;
+	}
+	m = -(t[7] >> 31);
+	t[7] &= 0x7FFFFFFF;
+	for (i = 0; i < 8; i ++) {
+		a[i] ^= (a[i] ^ t[i]) & m;
+	}
+}
+
+/*
+ * Fold the value a + hi*2^256 (with hi < 2^24) into a[] and normalise
+ * it. The 'hi' extra bits and the top bit of a[] are multiplied by 19
+ * and added back.
+ */
+static void
+f255_fold(uint32_t *a, uint32_t hi)
+{
+	uint64_t w;
+	int i;
+
+	w = (uint64_t)19 * ((hi << 1) | (a[7] >> 31));
+	a[7] &= 0x7FFFFFFF;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)a[i];
+		a[i] = (uint32_t)w;
+		w >>= 32;
+	}
+	f255_norm(a);
+}
+
+/*
+ * Modular addition: d = a + b mod p.
+ */
+static void
+f255_add(uint32_t *d, const uint32_t *a, const uint32_t *b)
+{
+	uint64_t w;
+	int i;
+
+	w = 0;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)a[i] + (uint64_t)b[i];
+		d[i] = (uint32_t)w;
+		w >>= 32;
+	}
+	f255_norm(d);
+}
+
+/*
+ * Modular subtraction: d = a - b mod p.
+ */
+static void
+f255_sub(uint32_t *d, const uint32_t *a, const uint32_t *b)
+{
+	uint64_t w;
+	uint32_t m;
+	int i;
+
+	w = 0;
+	for (i = 0; i < 8; i ++) {
+		w = (uint64_t)a[i] - (uint64_t)b[i] - (uint32_t)(w >> 63);
+		d[i] = (uint32_t)w;
+	}
+	m = -(uint32_t)(w >> 63);
+	w = 0;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)d[i] + (F255_P[i] & m);
+		d[i] = (uint32_t)w;
+		w >>= 32;
+	}
+}
+
+/*
+ * Reduce a 512-bit value t[] (sixteen 32-bit words) modulo p, using
+ * 2^256 = 38 mod p. The result is written in d[].
+ */
+static void
+f255_reduce(uint32_t *d, const uint32_t *t)
+{
+	uint64_t cc;
+	int i;
+
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		cc += (uint64_t)t[i] + MUL(t[i + 8], 38);
+		d[i] = (uint32_t)cc;
+		cc >>= 32;
+	}
+	f255_fold(d, (uint32_t)cc);
+}
+
+/*
+ * Modular multiplication: d = a*b mod p. d[] may be the same array as
+ * a[] and/or b[]. The schoolbook product is fully unrolled, as in
+ * ec_p256_m32.c.
+ */
+#define MROW(i)   do { \
+		uint64_t cc; \
+		uint32_t f; \
+ \
+		f = a[i]; \
+		cc = 0; \
+		MSTEP(i, 0); MSTEP(i, 1); MSTEP(i, 2); MSTEP(i, 3); \
+		MSTEP(i, 4); MSTEP(i, 5); MSTEP(i, 6); MSTEP(i, 7); \
+		t[(i) + 8] = (uint32_t)cc; \
+	} while (0)
+
+#define MSTEP(i, j)   do { \
+		cc += MUL(f, b[j]) + t[(i) + (j)]; \
+		t[(i) + (j)] = (uint32_t)cc; \
+		cc >>= 32; \
+	} while (0)
+
+static void
+f255_mul(uint32_t *d, const uint32_t *a, const uint32_t *b)
+{
+	uint32_t t[16];
+
+	memset(t, 0, sizeof t);
+	MROW(0); MROW(1); MROW(2); MROW(3);
+	MROW(4); MROW(5); MROW(6); MROW(7);
+	f255_reduce(d, t);
+}
+
+#undef MROW
+#undef MSTEP
+
+/*
+ * Modular squaring: d = a^2 mod p. d[] may be the same array as a[].
+ */
+#define SSTEP(i, j)   do { \
+		cc += MUL(f, a[j]) + t[(i) + (j)]; \
+		t[(i) + (j)] = (uint32_t)cc; \
+		cc >>= 32; \
+	} while (0)
+
+static void
+f255_sqr(uint32_t *d, const uint32_t *a)
+{
+	uint32_t t[16], f;
+	uint64_t cc;
+	int i;
+
+	memset(t, 0, sizeof t);
+
+	f = a[0];
+	cc = 0;
+	SSTEP(0, 1); SSTEP(0, 2); SSTEP(0, 3); SSTEP(0, 4); SSTEP(0, 5);
+	SSTEP(0, 6); SSTEP(0, 7);
+	t[8] = (uint32_t)cc;
+
+	f = a[1];
+	cc = 0;
+	SSTEP(1, 2); SSTEP(1, 3); SSTEP(1, 4); SSTEP(1, 5); SSTEP(1, 6);
+	SSTEP(1, 7);
+	t[9] = (uint32_t)cc;
+
+	f = a[2];
+	cc = 0;
+	SSTEP(2, 3); SSTEP(2, 4); SSTEP(2, 5); SSTEP(2, 6); SSTEP(2, 7);
+	t[10] = (uint32_t)cc;
+
+	f = a[3];
+	cc = 0;
+	SSTEP(3, 4); SSTEP(3, 5); SSTEP(3, 6); SSTEP(3, 7);
+	t[11] = (uint32_t)cc;
+
+	f = a[4];
+	cc = 0;
+	SSTEP(4, 5); SSTEP(4, 6); SSTEP(4, 7);
+	t[12] = (uint32_t)cc;
+
+	f = a[5];
+	cc = 0;
+	SSTEP(5, 6); SSTEP(5, 7);
+	t[13] = (uint32_t)cc;
+
+	f = a[6];
+	cc = 0;
+	SSTEP(6, 7);
+	t[14] = (uint32_t)cc;
+
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		uint64_t z;
+
+		z = MUL(a[i], a[i]);
+		cc += (uint64_t)(uint32_t)z + ((uint64_t)t[2 * i] << 1);
+		t[2 * i] = (uint32_t)cc;
+		cc >>= 32;
+		cc += (z >> 32) + ((uint64_t)t[2 * i + 1] << 1);
+		t[2 * i + 1] = (uint32_t)cc;
+		cc >>= 32;
+	}
+	f255_reduce(d, t);
+}
+
+#undef SSTEP
+
+/*
+ * Multiplication by a small constant: d = a*c mod p (c < 2^24).
+ */
+static void
+f255_mulc(uint32_t *d, const uint32_t *a, uint32_t c)
+{
+	uint64_t cc;
+	int i;
+
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		cc += MUL(a[i], c);
+		d[i] = (uint32_t)cc;
+		cc >>= 32;
+	}
+	f255_fold(d, (uint32_t)cc);
+}
+
+/*
+ * Compute d = a^(2^n) mod p (n successive squarings).
+ */
+static void
+f255_sqrn(uint32_t *d, const uint32_t *a, int n)
+{
+	memcpy(d, a, 8 * sizeof(uint32_t));
+	while (n -- > 0) {
+		f255_sqr(d, d);
+	}
+}
+
+/*
+ * Modular inversion: d = 1/a mod p (d = 0 if a = 0). This computes
+ * a^(p-2) = a^(2^255-21) with the usual addition chain.
+ */
+static void
+f255_invert(uint32_t *d, const uint32_t *a)
+{
+	uint32_t x11[8], x5[8], x10[8], x20[8], x50[8], x100[8], r[8];
+
+	/*
+	 * x11 = a^11; xN = a^(2^N-1).
+	 */
+	f255_sqr(r, a);
+	f255_sqrn(x5, r, 2);
+	f255_mul(x5, x5, a);
+	f255_mul(x11, x5, r);
+	f255_sqr(r, x11);
+	f255_mul(x5, x5, r);
+	f255_sqrn(x10, x5, 5);
+	f255_mul(x10, x10, x5);
+	f255_sqrn(x20, x10, 10);
+	f255_mul(x20, x20, x10);
+	f255_sqrn(r, x20, 20);
+	f255_mul(r, r, x20);
+	f255_sqrn(r, r, 10);
+	f255_mul(x50, r, x10);
+	f255_sqrn(x100, x50, 50);
+	f255_mul(x100, x100, x50);
+	f255_sqrn(r, x100, 100);
+	f255_mul(r, r, x100);
+	f255_sqrn(r, r, 50);
+	f255_mul(r, r, x50);
+	f255_sqrn(r, r, 5);
+	f255_mul(d, r, x11);
+}
+
+/*
+ * Swap a[] and b[] if ctl is 1; ctl MUST be 0 or 1.
+ */
+static inline void
+f255_cswap(uint32_t *a, uint32_t *b, uint32_t ctl)
+{
+	uint32_t m;
+	int i;
+
+	m = -ctl;
+	for (i = 0; i < 8; i ++) {
+		uint32_t t;
+
+		t = (a[i] ^ b[i]) & m;
+		a[i] ^= t;
+		b[i] ^= t;
+	}
+}
+
+static const unsigned char GEN[] = {
+	0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/*
+ * This is not the curve order. Since multipliers are clamped, any
+ * 32-byte value is a valid private key; this "order" makes the
+ * generic key generation code (which produces a random value lower
+ * than the order) output 32-byte values.
+ */
+static const unsigned char ORDER[] = {
+	0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static const unsigned char *
+api_generator(int curve, size_t *len)
+{
+	(void)curve;
+	*len = sizeof GEN;
+	return GEN;
+}
+
+static const unsigned char *
+api_order(int curve, size_t *len)
+{
+	(void)curve;
+	*len = sizeof ORDER;
+	return ORDER;
+}
+
+static size_t
+api_xoff(int curve, size_t *len)
+{
+	(void)curve;
+	*len = 32;
+	return 0;
+}
+
+static uint32_t
+api_mul(unsigned char *G, size_t Glen,
+	const unsigned char *kb, size_t kblen, int curve)
+{
+	uint32_t x1[8], x2[8], z2[8], x3[8], z3[8];
+	uint32_t a[8], aa[8], b[8], bb[8], c[8], d[8], e[8];
+	unsigned char k[32];
+	uint32_t swap;
+	int i;
+
+	(void)curve;
+	if (Glen != 32 || kblen > 32) {
+		return 0;
+	}
+
+	/*
+	 * Decode the u coordinate; the top bit is ignored (RFC 7748,
+	 * section 5), and values beyond p are reduced.
+	 */
+	for (i = 0; i < 8; i ++) {
+		x1[i] = br_dec32le(G + (i << 2));
+	}
+	x1[7] &= 0x7FFFFFFF;
+	f255_norm(x1);
+
+	/*
+	 * Clamp the multiplier (big-endian here).
+	 */
+	memset(k, 0, sizeof k);
+	memcpy(k + 32 - kblen, kb, kblen);
+	k[31] &= 0xF8;
+	k[0] &= 0x7F;
+	k[0] |= 0x40;
+
+	/*
+	 * Montgomery ladder (RFC 7748, section 5).
+	 */
+	memset(x2, 0, sizeof x2);
+	x2[0] = 1;
+	memset(z2, 0, sizeof z2);
+	memcpy(x3, x1, sizeof x1);
+	memcpy(z3, x2, sizeof x2);
+	swap = 0;
+	for (i = 254; i >= 0; i --) {
+		uint32_t kt;
+
+		kt = (k[31 - (i >> 3)] >> (i & 7)) & 1;
+		swap ^= kt;
+		f255_cswap(x2, x3, swap);
+		f255_cswap(z2, z3, swap);
+		swap = kt;
+
+		f255_add(a, x2, z2);
+		f255_sqr(aa, a);
+		f255_sub(b, x2, z2);
+		f255_sqr(bb, b);
+		f255_sub(e, aa, bb);
+		f255_add(c, x3, z3);
+		f255_sub(d, x3, z3);
+		f255_mul(d, d, a);
+		f255_mul(c, c, b);
+		f255_add(x3, d, c);
+		f255_sqr(x3, x3);
+		f255_sub(z3, d, c);
+		f255_sqr(z3, z3);
+		f255_mul(z3, z3, x1);
+		f255_mul(x2, aa, bb);
+		f255_mulc(z2, e, 121665);
+		f255_add(z2, z2, aa);
+		f255_mul(z2, z2, e);
+	}
+	f255_cswap(x2, x3, swap);
+	f255_cswap(z2, z3, swap);
+
+	/*
+	 * Result is x2/z2 (0 if z2 = 0). A zero output (which happens
+	 * only for points of small order) is reported as an error.
+	 */
+	f255_invert(z2, z2);
+	f255_mul(x2, x2, z2);
+	for (i = 0; i < 8; i ++) {
+		br_enc32le(G + (i << 2), x2[i]);
+	}
+	swap = 0;
+	for (i = 0; i < 8; i ++) {
+		swap |= x2[i];
+	}
+	return NEQ(swap, 0);
+}
+
+static size_t
+api_mulgen(unsigned char *R,
+	const unsigned char *x, size_t xlen, int curve)
+{
+	memcpy(R, GEN, sizeof GEN);
+	api_mul(R, sizeof GEN, x, xlen, curve);
+	return sizeof GEN;
+}
+
+static uint32_t
+api_muladd(unsigned char *A, const unsigned char *B, size_t len,
+	const unsigned char *x, size_t xlen,
+	const unsigned char *y, size_t ylen, int curve)
+{
+	/*
+	 * Point additions are not supported with the u coordinate
+	 * only (and Curve25519 is used for key exchange only).
+	 */
+	(void)A;
+	(void)B;
+	(void)len;
+	(void)x;
+	(void)xlen;
+	(void)y;
+	(void)ylen;
+	(void)curve;
+	return 0;
+}
+
+/* see bearssl_ec.h */
+const br_ec_impl br_ec_c25519_m32 = {
+	(uint32_t)0x20000000,
+	&api_generator,
+	&api_order,
+	&api_xoff,
+	&api_mul,
+	&api_mulgen,
+	&api_muladd
+};
@@ -0,0 +1,1136 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * This is an implementation of the elliptic curve secp256r1 (aka NIST
+ * P-256) with dedicated field arithmetic: field elements are kept as
+ * eight 32-bit words (little-endian order), and products are reduced
+ * with the special form of the modulus:
+ *
+ *   p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+ *
+ * (this is the "fast reduction" described in FIPS 186-4, appendix D).
+ * All field elements are fully reduced (in the 0..p-1 range) at all
+ * times. All operations are constant-time. Other curves are delegated
+ * to br_ec_prime_i31.
+ */
+
+/*
+ * Field modulus.
+ */
+static const uint32_t F256_P[] = {
+	0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000,
+	0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF
+};
+
+/*
+ * Curve equation parameter b.
+ */
+static const uint32_t F256_B[] = {
+	0x27D2604B, 0x3BCE3C3E, 0xCC53B0F6, 0x651D06B0,
+	0x769886BC, 0xB3EBBD55, 0xAA3A93E7, 0x5AC635D8
+};
+
+/*
+ * Arithmetic right shift of a 64-bit value by 32 bits (the value is
+ * interpreted as a signed integer in two's complement representation).
+ */
+static inline uint64_t
+sar32(uint64_t x)
+{
+	return (x >> 32) | ((-(x >> 63)) << 32);
+}
+
+/*
+ * Subtract p from a[] if a[] >= p. The extra bit 'hi' is the carry
+ * from a previous addition (it is an extra 2^256 term); if it is 1,
+ * then the subtraction is always performed.
+ */
+static void
+f256_final(uint32_t *a, uint32_t hi)
+{
+	uint32_t t[8], cc, m;
+	int i;
+
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		uint64_t w;
+
+		w = (uint64_t)a[i] - (uint64_t)F256_P[i] - cc;
+		t[i] = (uint32_t)w;
+		cc = (uint32_t)(w >> 63);
+	}
+	m = -(hi | NOT(cc));
+	for (i = 0; i < 8; i ++) {
+		a[i] ^= (a[i] ^ t[i]) & m;
+	}
+}
+
+/*
+ * Modular addition: d = a + b mod p.
+ */
+static void
+f256_add(uint32_t *d, const uint32_t *a, const uint32_t *b)
+{
+	uint64_t w;
+	int i;
+
+	w = 0;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)a[i] + (uint64_t)b[i];
+		d[i] = (uint32_t)w;
+		w >>= 32;
+	}
+	f256_final(d, (uint32_t)w);
+}
+
+/*
+ * Modular subtraction: d = a - b mod p.
+ */
+static void
+f256_sub(uint32_t *d, const uint32_t *a, const uint32_t *b)
+{
+	uint64_t w;
+	uint32_t m;
+	int i;
+
+	w = 0;
+	for (i = 0; i < 8; i ++) {
+		w = (uint64_t)a[i] - (uint64_t)b[i] - (uint32_t)(w >> 63);
+		d[i] = (uint32_t)w;
+	}
+	m = -(uint32_t)(w >> 63);
+	w = 0;
+	for (i = 0; i < 8; i ++) {
+		w += (uint64_t)d[i] + (F256_P[i] & m);
+		d[i] = (uint32_t)w;
+		w >>= 32;
+	}
+}
+
+/*
+ * Reduce a 512-bit value t[] (sixteen 32-bit words) modulo p. The
+ * result is written in d[].
+ */
+static void
+f256_reduce(uint32_t *d, const uint32_t *t)
+{
+	uint64_t w[8], cc;
+	int i, j;
+
+	/*
+	 * Fast reduction: with c0..c15 the 32-bit words of the input,
+	 * the value is congruent to:
+	 *   s1 + 2*s2 + 2*s3 + s4 + s5 - s6 - s7 - s8 - s9
+	 * where:
+	 *   s1 = (c7, c6, c5, c4, c3, c2, c1, c0)
+	 *   s2 = (c15, c14, c13, c12, c11, 0, 0, 0)
+	 *   s3 = (0, c15, c14, c13, c12, 0, 0, 0)
+	 *   s4 = (c15, c14, 0, 0, 0, c10, c9, c8)
+	 *   s5 = (c8, c13, c15, c14, c13, c11, c10, c9)
+	 *   s6 = (c10, c8, 0, 0, 0, c13, c12, c11)
+	 *   s7 = (c11, c9, 0, 0, c15, c14, c13, c12)
+	 *   s8 = (c12, 0, c10, c9, c8, c15, c14, c13)
+	 *   s9 = (c13, 0, c11, c10, c9, 0, c15, c14)
+	 * We gather the terms word by word. Each word sum is a signed
+	 * value that fits on 64 bits (two's complement); then we
+	 * propagate carries.
+	 */
+	w[0] = (uint64_t)t[0] + t[8] + t[9]
+		- t[11] - t[12] - t[13] - t[14];
+	w[1] = (uint64_t)t[1] + t[9] + t[10]
+		- t[12] - t[13] - t[14] - t[15];
+	w[2] = (uint64_t)t[2] + t[10] + t[11]
+		- t[13] - t[14] - t[15];
+	w[3] = (uint64_t)t[3] + ((uint64_t)t[11] << 1)
+		+ ((uint64_t)t[12] << 1) + t[13]
+		- t[15] - t[8] - t[9];
+	w[4] = (uint64_t)t[4] + ((uint64_t)t[12] << 1)
+		+ ((uint64_t)t[13] << 1) + t[14]
+		- t[9] - t[10];
+	w[5] = (uint64_t)t[5] + ((uint64_t)t[13] << 1)
+		+ ((uint64_t)t[14] << 1) + t[15]
+		- t[10] - t[11];
+	w[6] = (uint64_t)t[6] + 3 * (uint64_t)t[14]
+		+ ((uint64_t)t[15] << 1) + t[13]
+		- t[8] - t[9];
+	w[7] = (uint64_t)t[7] + 3 * (uint64_t)t[15] + t[8]
+		- t[10] - t[11] - t[12] - t[13];
+
+	/*
+	 * Carry propagation yields a value W + cc*2^256, with W in the
+	 * 0..2^256-1 range and cc a small signed integer (-4 to 6).
+	 * Since 2^256 = 2^224 - 2^192 - 2^96 + 1 mod p, we fold cc back
+	 * into the low words. The first folding may again yield a
+	 * carry of -1 or +1; a second folding cannot, since the value
+	 * is then either small (positive carry) or close to 2^256
+	 * (negative carry).
+	 */
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		w[i] += cc;
+		cc = sar32(w[i]);
+		w[i] &= 0xFFFFFFFF;
+	}
+	for (j = 0; j < 2; j ++) {
+		w[0] += cc;
+		w[3] -= cc;
+		w[6] -= cc;
+		w[7] += cc;
+		cc = 0;
+		for (i = 0; i < 8; i ++) {
+			w[i] += cc;
+			cc = sar32(w[i]);
+			w[i] &= 0xFFFFFFFF;
+		}
+	}
+	for (i = 0; i < 8; i ++) {
+		d[i] = (uint32_t)w[i];
+	}
+	f256_final(d, 0);
+}
+
+/*
+ * Modular multiplication: d = a*b mod p. d[] may be the same array as
+ * a[] and/or b[]. The schoolbook product is fully unrolled: each row
+ * multiplies one word of a[] with all words of b[].
+ */
+#define MROW(i)   do { \
+		uint64_t cc; \
+		uint32_t f; \
+ \
+		f = a[i]; \
+		cc = 0; \
+		MSTEP(i, 0); MSTEP(i, 1); MSTEP(i, 2); MSTEP(i, 3); \
+		MSTEP(i, 4); MSTEP(i, 5); MSTEP(i, 6); MSTEP(i, 7); \
+		t[(i) + 8] = (uint32_t)cc; \
+	} while (0)
+
+#define MSTEP(i, j)   do { \
+		cc += MUL(f, b[j]) + t[(i) + (j)]; \
+		t[(i) + (j)] = (uint32_t)cc; \
+		cc >>= 32; \
+	} while (0)
+
+static void
+f256_mul(uint32_t *d, const uint32_t *a, const uint32_t *b)
+{
+	uint32_t t[16];
+
+	memset(t, 0, sizeof t);
+	MROW(0); MROW(1); MROW(2); MROW(3);
+	MROW(4); MROW(5); MROW(6); MROW(7);
+	f256_reduce(d, t);
+}
+
+#undef MROW
+#undef MSTEP
+
+/*
+ * Modular squaring: d = a^2 mod p. d[] may be the same array as a[].
+ * The cross products a[i]*a[j] (for i < j) are computed first (in
+ * unrolled rows, as in f256_mul()), then doubled and added to the
+ * squares a[i]^2.
+ */
+#define SSTEP(i, j)   do { \
+		cc += MUL(f, a[j]) + t[(i) + (j)]; \
+		t[(i) + (j)] = (uint32_t)cc; \
+		cc >>= 32; \
+	} while (0)
+
+static void
+f256_sqr(uint32_t *d, const uint32_t *a)
+{
+	uint32_t t[16], f;
+	uint64_t cc;
+	int i;
+
+	memset(t, 0, sizeof t);
+
+	f = a[0];
+	cc = 0;
+	SSTEP(0, 1); SSTEP(0, 2); SSTEP(0, 3); SSTEP(0, 4); SSTEP(0, 5);
+	SSTEP(0, 6); SSTEP(0, 7);
+	t[8] = (uint32_t)cc;
+
+	f = a[1];
+	cc = 0;
+	SSTEP(1, 2); SSTEP(1, 3); SSTEP(1, 4); SSTEP(1, 5); SSTEP(1, 6);
+	SSTEP(1, 7);
+	t[9] = (uint32_t)cc;
+
+	f = a[2];
+	cc = 0;
+	SSTEP(2, 3); SSTEP(2, 4); SSTEP(2, 5); SSTEP(2, 6); SSTEP(2, 7);
+	t[10] = (uint32_t)cc;
+
+	f = a[3];
+	cc = 0;
+	SSTEP(3, 4); SSTEP(3, 5); SSTEP(3, 6); SSTEP(3, 7);
+	t[11] = (uint32_t)cc;
+
+	f = a[4];
+	cc = 0;
+	SSTEP(4, 5); SSTEP(4, 6); SSTEP(4, 7);
+	t[12] = (uint32_t)cc;
+
+	f = a[5];
+	cc = 0;
+	SSTEP(5, 6); SSTEP(5, 7);
+	t[13] = (uint32_t)cc;
+
+	f = a[6];
+	cc = 0;
+	SSTEP(6, 7);
+	t[14] = (uint32_t)cc;
+
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		uint64_t z;
+
+		z = MUL(a[i], a[i]);
+		cc += (uint64_t)(uint32_t)z + ((uint64_t)t[2 * i] << 1);
+		t[2 * i] = (uint32_t)cc;
+		cc >>= 32;
+		cc += (z >> 32) + ((uint64_t)t[2 * i + 1] << 1);
+		t[2 * i + 1] = (uint32_t)cc;
+		cc >>= 32;
+	}
+	f256_reduce(d, t);
+}
+
+#undef SSTEP
+
+/*
+ * Compute d = a^(2^n) mod p (n successive squarings).
+ */
+static void
+f256_sqrn(uint32_t *d, const uint32_t *a, int n)
+{
+	memcpy(d, a, 8 * sizeof(uint32_t));
+	while (n -- > 0) {
+		f256_sqr(d, d);
+	}
+}
+
+/*
+ * Modular inversion: d = 1/a mod p (d = 0 if a = 0). This computes
+ * a^(p-2) with an addition chain; p-2 is, in hexadecimal:
+ *   FFFFFFFF 00000001 00000000 00000000
+ *   00000000 FFFFFFFF FFFFFFFF FFFFFFFD
+ */
+static void
+f256_invert(uint32_t *d, const uint32_t *a)
+{
+	uint32_t x2[8], x4[8], x8[8], x16[8], x30[8], x32[8], r[8];
+
+	/*
+	 * xN = a^(2^N-1).
+	 */
+	f256_sqr(x2, a);
+	f256_mul(x2, x2, a);
+	f256_sqrn(x4, x2, 2);
+	f256_mul(x4, x4, x2);
+	f256_sqrn(x8, x4, 4);
+	f256_mul(x8, x8, x4);
+	f256_sqrn(x16, x8, 8);
+	f256_mul(x16, x16, x8);
+	f256_sqrn(x30, x16, 8);
+	f256_mul(x30, x30, x8);
+	f256_sqrn(x30, x30, 4);
+	f256_mul(x30, x30, x4);
+	f256_sqrn(x30, x30, 2);
+	f256_mul(x30, x30, x2);
+	f256_sqrn(x32, x30, 2);
+	f256_mul(x32, x32, x2);
+
+	f256_sqrn(r, x32, 32);
+	f256_mul(r, r, a);
+	f256_sqrn(r, r, 128);
+	f256_mul(r, r, x32);
+	f256_sqrn(r, r, 32);
+	f256_mul(r, r, x32);
+	f256_sqrn(r, r, 30);
+	f256_mul(r, r, x30);
+	f256_sqrn(r, r, 2);
+	f256_mul(d, r, a);
+}
+
+/*
+ * Return 1 if a = 0, 0 otherwise.
+ */
+static inline uint32_t
+f256_iszero(const uint32_t *a)
+{
+	uint32_t z;
+	int i;
+
+	z = 0;
+	for (i = 0; i < 8; i ++) {
+		z |= a[i];
+	}
+	return EQ(z, 0);
+}
+
+/*
+ * Decode a field element (32 bytes, big-endian). Returned value is 1
+ * if the value is lower than p, 0 otherwise (the decoded value is
+ * still set, reduced modulo p).
+ */
+static uint32_t
+f256_decode(uint32_t *a, const unsigned char *buf)
+{
+	uint32_t t[8], cc;
+	int i;
+
+	for (i = 0; i < 8; i ++) {
+		a[i] = br_dec32be(buf + ((7 - i) << 2));
+	}
+	cc = 0;
+	for (i = 0; i < 8; i ++) {
+		uint64_t w;
+
+		w = (uint64_t)a[i] - (uint64_t)F256_P[i] - cc;
+		t[i] = (uint32_t)w;
+		cc = (uint32_t)(w >> 63);
+	}
+	CCOPY(NOT(cc), a, t, sizeof t);
+	return cc;
+}
+
+/*
+ * Encode a field element (32 bytes, big-endian).
+ */
+static void
+f256_encode(unsigned char *buf, const uint32_t *a)
+{
+	int i;
+
+	for (i = 0; i < 8; i ++) {
+		br_enc32be(buf + ((7 - i) << 2), a[i]);
+	}
+}
+
+/*
+ * Type for a point in Jacobian coordinates:
+ * -- three values, x, y and z, fully reduced modulo p
+ * -- affine coordinates are X = x / z^2 and Y = y / z^3
+ * -- for the point at infinity, z = 0
+ */
+typedef struct {
+	uint32_t x[8];
+	uint32_t y[8];
+	uint32_t z[8];
+} p256_jacobian;
+
+/*
+ * Copy P2 into P1 if ctl is 1; ctl MUST be 0 or 1.
+ */
+static inline void
+p256_select(p256_jacobian *P1, const p256_jacobian *P2, uint32_t ctl)
+{
+	uint32_t m;
+	int i;
+
+	m = -ctl;
+	for (i = 0; i < 8; i ++) {
+		P1->x[i] ^= (P1->x[i] ^ P2->x[i]) & m;
+		P1->y[i] ^= (P1->y[i] ^ P2->y[i]) & m;
+		P1->z[i] ^= (P1->z[i] ^ P2->z[i]) & m;
+	}
+}
+
+/*
+ * Point doubling. The formulas are the same as in ec_prime_i31.c:
+ *
+ *   s = 4*x*y^2
+ *   m = 3*(x + z^2)*(x - z^2)
+ *   x' = m^2 - 2*s
+ *   y' = m*(s - x') - 8*y^4
+ *   z' = 2*y*z
+ *
+ * This works for all points, including the point at infinity.
+ */
+static void
+p256_double(p256_jacobian *P)
+{
+	uint32_t t1[8], t2[8], t3[8], t4[8];
+
+	/*
+	 * Compute m = 3*(x+z^2)*(x-z^2) (in t1).
+	 */
+	f256_sqr(t1, P->z);
+	f256_sub(t2, P->x, t1);
+	f256_add(t1, P->x, t1);
+	f256_mul(t3, t1, t2);
+	f256_add(t1, t3, t3);
+	f256_add(t1, t1, t3);
+
+	/*
+	 * Compute s = 4*x*y^2 (in t2) and 2*y^2 (in t3).
+	 */
+	f256_sqr(t3, P->y);
+	f256_add(t3, t3, t3);
+	f256_mul(t2, P->x, t3);
+	f256_add(t2, t2, t2);
+
+	/*
+	 * Compute x' = m^2 - 2*s.
+	 */
+	f256_sqr(P->x, t1);
+	f256_sub(P->x, P->x, t2);
+	f256_sub(P->x, P->x, t2);
+
+	/*
+	 * Compute z' = 2*y*z.
+	 */
+	f256_mul(t4, P->y, P->z);
+	f256_add(P->z, t4, t4);
+
+	/*
+	 * Compute y' = m*(s - x') - 8*y^4.
+	 */
+	f256_sub(t2, t2, P->x);
+	f256_mul(P->y, t1, t2);
+	f256_sqr(t4, t3);
+	f256_sub(P->y, P->y, t4);
+	f256_sub(P->y, P->y, t4);
+}
+
+/*
+ * Point addition: P1 = P1 + P2. The formulas are the same as in
+ * ec_prime_i31.c, with the same limitations: the result is wrong if
+ * exactly one of the operands is the point at infinity, or if P1 = P2.
+ * Returned value is 0 if the two points have the same Y coordinate
+ * (this allows detecting the P1 = P2 case), 1 otherwise.
+ */
+static uint32_t
+p256_add(p256_jacobian *P1, const p256_jacobian *P2)
+{
+	uint32_t t1[8], t2[8], t3[8], t4[8], t5[8], t6[8], t7[8];
+	uint32_t ret;
+
+	/*
+	 * Compute u1 = x1*z2^2 (in t1) and s1 = y1*z2^3 (in t3).
+	 */
+	f256_sqr(t3, P2->z);
+	f256_mul(t1, P1->x, t3);
+	f256_mul(t4, P2->z, t3);
+	f256_mul(t3, P1->y, t4);
+
+	/*
+	 * Compute u2 = x2*z1^2 (in t2) and s2 = y2*z1^3 (in t4).
+	 */
+	f256_sqr(t4, P1->z);
+	f256_mul(t2, P2->x, t4);
+	f256_mul(t5, P1->z, t4);
+	f256_mul(t4, P2->y, t5);
+
+	/*
+	 * Compute h = u2 - u1 (in t2) and r = s2 - s1 (in t4).
+	 */
+	f256_sub(t2, t2, t1);
+	f256_sub(t4, t4, t3);
+	ret = NOT(f256_iszero(t4));
+
+	/*
+	 * Compute u1*h^2 (in t6) and h^3 (in t5).
+	 */
+	f256_sqr(t7, t2);
+	f256_mul(t6, t1, t7);
+	f256_mul(t5, t7, t2);
+
+	/*
+	 * Compute x3 = r^2 - h^3 - 2*u1*h^2.
+	 */
+	f256_sqr(P1->x, t4);
+	f256_sub(P1->x, P1->x, t5);
+	f256_sub(P1->x, P1->x, t6);
+	f256_sub(P1->x, P1->x, t6);
+
+	/*
+	 * Compute y3 = r*(u1*h^2 - x3) - s1*h^3.
+	 */
+	f256_sub(t6, t6, P1->x);
+	f256_mul(P1->y, t4, t6);
+	f256_mul(t1, t5, t3);
+	f256_sub(P1->y, P1->y, t1);
+
+	/*
+	 * Compute z3 = h*z1*z2.
+	 */
+	f256_mul(t1, P1->z, P2->z);
+	f256_mul(P1->z, t1, t2);
+
+	return ret;
+}
+
+/*
+ * Point addition with a normalised point: P1 = P1 + P2, where P2 has
+ * z = 1 (its z coordinate is not read). This saves a few
+ * multiplications over p256_add(), and has the same limitations and
+ * returned value.
+ */
+static uint32_t
+p256_add_mixed(p256_jacobian *P1, const p256_jacobian *P2)
+{
+	uint32_t t1[8], t2[8], t3[8], t4[8], t5[8];
+	uint32_t ret;
+
+	/*
+	 * Compute u2 = x2*z1^2 (in t2) and s2 = y2*z1^3 (in t4).
+	 */
+	f256_sqr(t1, P1->z);
+	f256_mul(t2, P2->x, t1);
+	f256_mul(t3, P1->z, t1);
+	f256_mul(t4, P2->y, t3);
+
+	/*
+	 * Compute h = u2 - x1 (in t2) and r = s2 - y1 (in t4).
+	 */
+	f256_sub(t2, t2, P1->x);
+	f256_sub(t4, t4, P1->y);
+	ret = NOT(f256_iszero(t4));
+
+	/*
+	 * Compute x1*h^2 (in t3) and h^3 (in t5).
+	 */
+	f256_sqr(t1, t2);
+	f256_mul(t3, P1->x, t1);
+	f256_mul(t5, t1, t2);
+
+	/*
+	 * Compute x3 = r^2 - h^3 - 2*x1*h^2.
+	 */
+	f256_sqr(P1->x, t4);
+	f256_sub(P1->x, P1->x, t5);
+	f256_sub(P1->x, P1->x, t3);
+	f256_sub(P1->x, P1->x, t3);
+
+	/*
+	 * Compute y3 = r*(x1*h^2 - x3) - y1*h^3.
+	 */
+	f256_sub(t3, t3, P1->x);
+	f256_mul(t1, t5, P1->y);
+	f256_mul(P1->y, t4, t3);
+	f256_sub(P1->y, P1->y, t1);
+
+	/*
+	 * Compute z3 = h*z1.
+	 */
+	f256_mul(P1->z, P1->z, t2);
+
+	return ret;
+}
+
+/*
+ * Decode a point (uncompressed format only). Returned value is 1 if
+ * the point is valid, 0 otherwise. The point at infinity is not
+ * supported.
+ */
+static uint32_t
+p256_decode(p256_jacobian *P, const void *src, size_t len)
+{
+	const unsigned char *buf;
+	uint32_t r, t1[8], t2[8];
+
+	memset(P, 0, sizeof *P);
+	if (len != 65) {
+		return 0;
+	}
+	buf = src;
+	r = EQ(buf[0], 0x04);
+	r &= f256_decode(P->x, buf + 1);
+	r &= f256_decode(P->y, buf + 33);
+
+	/*
+	 * Check the curve equation: y^2 = x^3 - 3*x + b.
+	 */
+	f256_sqr(t1, P->x);
+	f256_mul(t1, t1, P->x);
+	f256_sub(t1, t1, P->x);
+	f256_sub(t1, t1, P->x);
+	f256_sub(t1, t1, P->x);
+	f256_add(t1, t1, F256_B);
+	f256_sqr(t2, P->y);
+	f256_sub(t1, t1, t2);
+	r &= f256_iszero(t1);
+
+	P->z[0] = 1;
+	return r;
+}
+
+/*
+ * Encode a point into uncompressed format (65 bytes). The point must
+ * not be the point at infinity.
+ */
+static void
+p256_encode(void *dst, const p256_jacobian *P)
+{
+	unsigned char *buf;
+	uint32_t t1[8], t2[8], t3[8];
+
+	buf = dst;
+	f256_invert(t1, P->z);
+	f256_sqr(t2, t1);
+	f256_mul(t3, P->x, t2);
+	buf[0] = 0x04;
+	f256_encode(buf + 1, t3);
+	f256_mul(t2, t2, t1);
+	f256_mul(t3, P->y, t2);
+	f256_encode(buf + 33, t3);
+}
+
+/*
+ * Multiply P by the scalar x (big-endian, xlen bytes), in constant
+ * time. This uses a 4-bit fixed window: the points 1*P to 15*P are
+ * precomputed, and each window costs four doublings and one addition
+ * with a point read from the table with a constant-time lookup.
+ *
+ * As in ec_prime_i31.c, the addition code cannot handle cases where
+ * one of the operands is infinity, which is the case at the start of
+ * the ladder; we maintain a flag for that situation. Since P has
+ * prime order n and x < n, the accumulator can never be equal to
+ * the point it is added with (nor to its opposite).
+ */
+static void
+p256_mul(p256_jacobian *P, const unsigned char *x, size_t xlen)
+{
+	p256_jacobian W[15], Q, T, U;
+	uint32_t qz;
+	int i;
+
+	W[0] = *P;
+	for (i = 1; i < 15; i ++) {
+		if ((i & 1) != 0) {
+			W[i] = W[i >> 1];
+			p256_double(&W[i]);
+		} else {
+			W[i] = W[i - 1];
+			p256_add(&W[i], &W[0]);
+		}
+	}
+
+	memset(&Q, 0, sizeof Q);
+	qz = 1;
+	while (xlen -- > 0) {
+		int k;
+
+		for (k = 4; k >= 0; k -= 4) {
+			uint32_t bits, bnz;
+
+			p256_double(&Q);
+			p256_double(&Q);
+			p256_double(&Q);
+			p256_double(&Q);
+			bits = (*x >> k) & 0x0F;
+			bnz = NEQ(bits, 0);
+			T = W[0];
+			for (i = 1; i < 15; i ++) {
+				p256_select(&T, &W[i], EQ(bits, i + 1));
+			}
+			U = Q;
+			p256_add(&U, &T);
+			p256_select(&Q, &T, bnz & qz);
+			p256_select(&Q, &U, bnz & ~qz);
+			qz &= ~bnz;
+		}
+		x ++;
+	}
+	*P = Q;
+}
+
+/*
+ * Point addition P1 = P1 + P2 that handles all special cases with
+ * explicit tests. This is NOT constant-time; it must be used only on
+ * public data.
+ */
+static void
+p256_add_vartime(p256_jacobian *P1, const p256_jacobian *P2)
+{
+	if (f256_iszero(P2->z)) {
+		return;
+	}
+	if (f256_iszero(P1->z)) {
+		*P1 = *P2;
+		return;
+	}
+	if (!p256_add(P1, P2) && f256_iszero(P1->z)) {
+		*P1 = *P2;
+		p256_double(P1);
+	}
+}
+
+/*
+ * Compute P = x*P + y*Q with an interleaved ladder over 2-bit windows
+ * of both multipliers, and a table of the 15 combinations i*P + j*Q
+ * (same method as in ec_prime_i31.c). This is NOT constant-time.
+ */
+static void
+p256_muladd_vartime(p256_jacobian *P, const p256_jacobian *Q,
+	const unsigned char *x, size_t xlen,
+	const unsigned char *y, size_t ylen)
+{
+	p256_jacobian W[16], R;
+	size_t len, u;
+	int i, j;
+
+	W[1] = *P;
+	W[2] = *P;
+	p256_double(&W[2]);
+	W[3] = W[2];
+	p256_add_vartime(&W[3], P);
+	W[4] = *Q;
+	W[8] = *Q;
+	p256_double(&W[8]);
+	W[12] = W[8];
+	p256_add_vartime(&W[12], Q);
+	for (j = 4; j < 16; j += 4) {
+		for (i = 1; i < 4; i ++) {
+			W[i + j] = W[j];
+			p256_add_vartime(&W[i + j], &W[i]);
+		}
+	}
+
+	len = xlen > ylen ? xlen : ylen;
+	memset(&R, 0, sizeof R);
+	for (u = 0; u < len; u ++) {
+		unsigned bx, by;
+		int k;
+
+		bx = u < len - xlen ? 0 : x[u - (len - xlen)];
+		by = u < len - ylen ? 0 : y[u - (len - ylen)];
+		for (k = 6; k >= 0; k -= 2) {
+			unsigned idx;
+
+			p256_double(&R);
+			p256_double(&R);
+			idx = ((bx >> k) & 3) | (((by >> k) & 3) << 2);
+			if (idx != 0) {
+				p256_add_vartime(&R, &W[idx]);
+			}
+		}
+	}
+	*P = R;
+}
+
+/*
+ * Precomputed multiples of the generator G for p256_mulgen(): entry i
+ * (for i = 1 to 31) contains the affine coordinates x and y of the sum
+ * of 2^(52*k)*G for all bits k set in i.
+ */
+static const uint32_t P256_GTAB[] = {
+	0xD898C296, 0xF4A13945, 0x2DEB33A0, 0x77037D81,
+	0x63A440F2, 0xF8BCE6E5, 0xE12C4247, 0x6B17D1F2,
+	0x37BF51F5, 0xCBB64068, 0x6B315ECE, 0x2BCE3357,
+	0x7C0F9E16, 0x8EE7EB4A, 0xFE1A7F9B, 0x4FE342E2,
+	0x071E5C83, 0xEEA6BC92, 0x8542A0BE, 0x8BD27F19,
+	0x2A58E5B1, 0x20A845B7, 0x5026D73F, 0x54CCC941,
+	0x140916A1, 0xCFD08EF7, 0x5D8EE496, 0x929E0BCC,
+	0xDAD2BF22, 0x3A8F8715, 0xB4514532, 0x1C433F45,
+	0x04BAC870, 0xF7D24BB7, 0x3A23C6AB, 0x593A09A0,
+	0xF94C9D1D, 0xDFCC2358, 0x297BED02, 0x3CFA0F87,
+	0x40F26940, 0xCE98A30B, 0x0248A8AF, 0x62121C0D,
+	0x8309AF9B, 0xA758AA80, 0x70BE12C6, 0xE4E37694,
+	0x3ECCA7E0, 0xC739A5EA, 0x6743333E, 0xA7D2C98F,
+	0x224D9428, 0x0FEF6335, 0x5C792A0C, 0x7EF2EE3C,
+	0x552AC094, 0x302B22DD, 0xDFBD3D20, 0x81B21450,
+	0xD5E609DB, 0xA4F67F51, 0x30ACC011, 0xAFB68627,
+	0x86EF7D7D, 0xDD37E3FF, 0x088B86DB, 0xF6D77C27,
+	0x254C5491, 0x28FE9A4F, 0x6DF0FD5E, 0xD6690337,
+	0xADDAD596, 0x9FF04992, 0x9E4373F9, 0xF3D1A7AF,
+	0xDF074167, 0xA13E9578, 0xE6D13D22, 0x20E2A53C,
+	0xB0879605, 0xD7B86AEE, 0xBE3C7265, 0xA424EC2D,
+	0x12F01E9E, 0x276203C2, 0xB77E46E9, 0xB666FAC5,
+	0x3BF0C52D, 0xF431BB1A, 0x726CD8B6, 0xEF46A44A,
+	0xEE3DE5A9, 0xEB5ABC19, 0x90246904, 0x38AAA380,
+	0x525D6ABF, 0xAEBFD735, 0x96BEA25A, 0xC302F8F4,
+	0x544920A4, 0xDB82B3EA, 0x02EADB2E, 0x621C75D1,
+	0x9EF485F0, 0x8939DC4C, 0x57C46D63, 0x225D03D8,
+	0x522D7F70, 0x4FDAC96F, 0xB4FA649D, 0xD7C4A4FE,
+	0x943E832A, 0x9C762EF1, 0x1786DF70, 0x07E50AB0,
+	0x2589F18E, 0x90F573A8, 0xA7C2A51A, 0x0D2BF28B,
+	0x5B20D37C, 0x48263AF1, 0x60551446, 0x27EC9DB9,
+	0x94B4E7ED, 0x7087A10A, 0x13BD00AC, 0x0CAC3F43,
+	0xC0B9372A, 0x8BC659AA, 0xEDD9583F, 0xF7659958,
+	0x8C267D88, 0x9F05F94A, 0xC99A739D, 0x00DC46E7,
+	0xDF55D0F2, 0x4AF50A00, 0x8156BF6A, 0xB5EB202D,
+	0x5228C111, 0x40D1E3AB, 0x45793424, 0x0312A557,
+	0x9E6486E0, 0x9D90CDA8, 0x1C7522C0, 0xC8A820BD,
+	0x08DCD7AB, 0x867C5580, 0x882A7892, 0x3C510CE2,
+	0x646D54C6, 0x0E283334, 0xEDA4E046, 0x33392776,
+	0x5BA997B0, 0xC3A7FC08, 0x5ACF053F, 0xD35E620F,
+	0x7EB8CFEE, 0x8D9692F7, 0x0D8C013D, 0x05E3F223,
+	0x84E32E59, 0x76347A52, 0x15B0A1E5, 0x3C53E290,
+	0xFAE798D4, 0x538B7DA5, 0x00D23591, 0x1B9F1BD1,
+	0x9A08693F, 0x11A9F072, 0x140EFEB3, 0xD30E7CDA,
+	0x4DD6C004, 0x81DEC926, 0xDAD210D5, 0xBFED14FE,
+	0xB96B9911, 0x39F9FF69, 0x29C2024D, 0x02FD7B73,
+	0x715D29FC, 0x50CFCEB8, 0x0C236311, 0xB682B999,
+	0xC7797831, 0x00F34ADD, 0x59927DF3, 0x42EBD3CB,
+	0xF8E8F683, 0x6DFCF787, 0x3F7FBE90, 0x13D72B7A,
+	0x2DF232CF, 0xFD426D94, 0x5FE39AAD, 0xED84BB42,
+	0x732995FC, 0x023E67A1, 0x355430E3, 0x67DD0A8E,
+	0x97A1D703, 0x0CF83B61, 0x583C33F2, 0xA3233455,
+	0x68142904, 0x27014AB4, 0x00CFA617, 0xFB500882,
+	0x7009B958, 0x6745FF87, 0xD449242D, 0x9E9889BC,
+	0x575616C8, 0x035B613B, 0x138E99E2, 0x00855156,
+	0x292E6AA0, 0x94C0D24B, 0x7E79B3A2, 0xD9BA5B68,
+	0x5F165D99, 0xCEBBBC7B, 0x8A4EEE61, 0x50CC51C1,
+	0x1B4D0D1F, 0xB31D2353, 0x66382ADA, 0x95E18452,
+	0x0A839B5B, 0xACAD4F81, 0x4142FF0F, 0xA0A2A96E,
+	0x1F4FA12F, 0x3EAA8289, 0x6B0FB8F3, 0x68D68C8F,
+	0x839BB85F, 0x320F09C3, 0xA050E62C, 0x0101FB06,
+	0x9AD53458, 0x557582C9, 0x1666432B, 0x55D5398D,
+	0x4FED936F, 0xF7F63118, 0x1833D9E1, 0xD90D6A7F,
+	0x8EBAA72A, 0x059C6A9E, 0x49FF8E2D, 0x576E2290,
+	0x51BBB3F1, 0x9311A269, 0x8D0F4F65, 0xE80F26BD,
+	0x6BECCBB9, 0x9D3DC334, 0x101E5DE4, 0x54E244D5,
+	0xF1B19E28, 0xB3AD4C6E, 0x58C2E3B7, 0x4334FBC0,
+	0x35DF9C25, 0x19BD4107, 0xEC106EB6, 0xD6BBEC0E,
+	0xE5046DC5, 0x788251C7, 0xF179327B, 0x12839B95,
+	0x4A8CB46E, 0xF1C05D98, 0x3C00736B, 0x443737CD,
+	0x12CD8FE5, 0xA760A456, 0x0817BDD9, 0x797489DE,
+	0xF42C23E8, 0xC56EB80A, 0xE6FE7AF5, 0x83719DD7,
+	0x3FEFCFC8, 0xE8881A83, 0xB9B5290B, 0xAEA3C9E0,
+	0x771E4688, 0x10B37ECD, 0xD4D021B6, 0xEE0816A3,
+	0xB3A8CAA1, 0x8E9929BF, 0xC105F2D1, 0x48915DCF,
+	0xDB49019F, 0x3A5FDF82, 0xAD9006E1, 0xC4A438E3,
+	0x87DE4B29, 0x5DB9620F, 0xD91ECB2E, 0xD7420C18,
+	0x32ACF105, 0x301BA1B2, 0x7853A937, 0xDB96BB0C,
+	0xC359AC34, 0xD84BFEF6, 0x64852A1D, 0xAB80CEF0,
+	0xB9DA1717, 0x3FBEE4D3, 0x7A13222C, 0xB325074E,
+	0xE83AD2C9, 0x5D6DC503, 0xAED035BE, 0xCA9F7A1D,
+	0xCBD21E33, 0x552788AC, 0xE09CB9F0, 0x8699DD31,
+	0x329BF961, 0x38584196, 0xB82A5AF9, 0x4CB20E96,
+	0xC72C78C1, 0x24199908, 0xE92859B7, 0x16E65484,
+	0x052FDE29, 0x6A201C4B, 0x0031DBB4, 0x6C897123,
+	0x16C1DA96, 0x4A759982, 0x2CC67214, 0xEEC0B975,
+	0x812C864E, 0xB908B9F1, 0x8439F6BA, 0x367FB66A,
+	0xF966F329, 0x789D664B, 0xF7F1D283, 0xE02AF770,
+	0xDB3038DD, 0xA20A2C70, 0xE99D5C7C, 0x5F0B46D5,
+	0x4B600B83, 0xC9B97D37, 0x3DF3245E, 0x186C7F79,
+	0x4F1CE57F, 0x2AF72460, 0x91E2D8ED, 0x9249897F,
+	0x8D2EA797, 0x8139B36A, 0x9AB58913, 0x9C428DB8,
+	0x6471AAA0, 0xB4A196FB, 0x1B6B9730, 0xDCBAB650,
+	0x295B57D2, 0x7AFCCC8A, 0x4E33A65D, 0xEE2280F4,
+	0x890FCD12, 0xC47A0803, 0x82604F6B, 0x4E98A98D,
+	0xED5FBBD2, 0x0D598F06, 0xA6A1EB84, 0xCE46EC91,
+	0x4BE6458D, 0x1F1E4F3F, 0x595E6547, 0x5F72CC22,
+	0x271A93F1, 0x5BC5341E, 0x58A5F263, 0xC62E155C,
+	0x58BA7FF4, 0x5F6F845A, 0x7E36A6AD, 0x67E1F7DC,
+	0xEEAA4D04, 0xD33A7657, 0x18267E4E, 0xFF9F2322,
+	0x4A53789F, 0xD369F11F, 0x3696B437, 0xC7876FB6,
+	0x0BABA29A, 0xA0E8F0A7, 0x32F6E514, 0xA0318A5F,
+	0x11775A08, 0x5C4A43D1, 0x362EEBB1, 0x418C507C,
+	0x09A325AA, 0xFD08903F, 0xF0EEBB3A, 0xF320B8FC,
+	0xC7644C1D, 0xE33F0255, 0xBB9002D8, 0x4030ECC3,
+	0xF4646F9F, 0xA4486916, 0x959C44FA, 0x5E677D0C,
+	0xD88B9144, 0xE2E7D7D0, 0x6248F91F, 0x5D93A86F,
+	0x02993AEA, 0xE33D0BD5, 0x3100D31E, 0x449F0CE6,
+	0x73CF2678, 0x3FCD925A, 0xA6D0AFC7, 0x34CA923B,
+	0x3067791F, 0x9011091D, 0x5A7941E4, 0x8C568874,
+	0xFC339800, 0x34D37180, 0x595C51F4, 0x7744316B,
+	0xE88C6420, 0xF2DDB693, 0x5BAD14D2, 0xFB3A48B1,
+	0xFDAAB256, 0x52DF1588, 0x3127354C, 0x68C0CD44,
+	0xA591F853, 0x2A849471, 0x93D0CB92, 0xE4DA88E9,
+	0x1639C624, 0x6D1EA35D, 0x263707BA, 0x60FE2A36,
+	0xD0F3BC51, 0x97FC50DE, 0x10062E80, 0xF7FA4D15,
+	0x024C168D, 0xC429A113, 0x3FEAA272, 0xB6C935FB,
+	0xE639EC09, 0xB58A6071, 0xF9C13DE7, 0x4B59253A,
+	0xFBFB8955, 0x6D2D68F2, 0x50723FE2, 0xF0064C12,
+	0x01F185F5, 0xE85D7820, 0x7FA79C93, 0xAA0307BF,
+	0x5B696527, 0x2E75A266, 0x5A00169C, 0x1A2530B0,
+	0x4286FB42, 0x76C4C180, 0x8E831D5B, 0x825F0194,
+	0xEF703739, 0xDBF0A11F, 0xCE5B106A, 0x106F9BC4,
+	0x24111150, 0x61794C4F, 0xBC723A17, 0x435872FE
+};
+
+/*
+ * Multiply the generator by the scalar x (big-endian, xlen bytes), in
+ * constant time. This uses a fixed-base comb with five teeth spaced
+ * by 52 bits: at each of the 52 steps, one bit is taken from each of
+ * the five 52-bit chunks of x, and the resulting 5-bit index selects
+ * a point in P256_GTAB (constant-time lookup). This needs 52 doublings
+ * and 52 mixed additions, instead of 256 doublings and 64 additions
+ * for p256_mul(). As in p256_mul(), partial sums are always lower than
+ * the curve order, so the addition never sees equal or opposite
+ * points.
+ */
+static void
+p256_mulgen(p256_jacobian *P, const unsigned char *x, size_t xlen)
+{
+	p256_jacobian Q, T, U;
+	uint32_t qz;
+	int j;
+
+	memset(&T, 0, sizeof T);
+	T.z[0] = 1;
+	memset(&Q, 0, sizeof Q);
+	qz = 1;
+	for (j = 51; j >= 0; j --) {
+		const uint32_t *tab;
+		uint32_t idx, bnz;
+		int i, k;
+
+		p256_double(&Q);
+
+		idx = 0;
+		for (k = 0; k < 5; k ++) {
+			int bp;
+			size_t v;
+
+			bp = 52 * k + j;
+			v = (size_t)(bp >> 3);
+			if (v < xlen) {
+				idx |= (uint32_t)((x[xlen - 1 - v] >> (bp & 7)) & 1)
+					<< k;
+			}
+		}
+
+		memset(T.x, 0, sizeof T.x);
+		memset(T.y, 0, sizeof T.y);
+		tab = P256_GTAB;
+		for (k = 1; k < 32; k ++) {
+			uint32_t m;
+
+			m = -EQ(idx, k);
+			for (i = 0; i < 8; i ++) {
+				T.x[i] |= m & tab[i];
+				T.y[i] |= m & tab[8 + i];
+			}
+			tab += 16;
+		}
+
+		U = Q;
+		p256_add_mixed(&U, &T);
+		bnz = NEQ(idx, 0);
+		p256_select(&Q, &T, bnz & qz);
+		p256_select(&Q, &U, bnz & ~qz);
+		qz &= ~bnz;
+	}
+	*P = Q;
+}
+
+static const unsigned char *
+api_generator(int curve, size_t *len)
+{
+	if (curve != BR_EC_secp256r1) {
+		return br_ec_prime_i31.generator(curve, len);
+	}
+	*len = br_secp256r1.generator_len;
+	return br_secp256r1.generator;
+}
+
+static const unsigned char *
+api_order(int curve, size_t *len)
+{
+	if (curve != BR_EC_secp256r1) {
+		return br_ec_prime_i31.order(curve, len);
+	}
+	*len = br_secp256r1.order_len;
+	return br_secp256r1.order;
+}
+
+static size_t
+api_xoff(int curve, size_t *len)
+{
+	if (curve != BR_EC_secp256r1) {
+		return br_ec_prime_i31.xoff(curve, len);
+	}
+	*len = 32;
+	return 1;
+}
+
+static uint32_t
+api_mul(unsigned char *G, size_t Glen,
+	const unsigned char *x, size_t xlen, int curve)
+{
+	uint32_t r;
+	p256_jacobian P;
+
+	if (curve != BR_EC_secp256r1) {
+		return br_ec_prime_i31.mul(G, Glen, x, xlen, curve);
+	}
+	r = p256_decode(&P, G, Glen);
+	p256_mul(&P, x, xlen);
+	r &= NOT(f256_iszero(P.z));
+	if (Glen == 65) {
+		p256_encode(G, &P);
+	}
+	return r;
+}
+
+static size_t
+api_mulgen(unsigned char *R,
+	const unsigned char *x, size_t xlen, int curve)
+{
+	p256_jacobian P;
+
+	if (curve != BR_EC_secp256r1) {
+		return br_ec_prime_i31.mulgen(R, x, xlen, curve);
+	}
+	p256_mulgen(&P, x, xlen);
+	p256_encode(R, &P);
+	return 65;
+}
+
+static uint32_t
+api_muladd(unsigned char *A, const unsigned char *B, size_t len,
+	const unsigned char *x, size_t xlen,
+	const unsigned char *y, size_t ylen, int curve)
+{
+	uint32_t r;
+	p256_jacobian P, Q;
+
+	if (curve != BR_EC_secp256r1) {
+		return br_ec_prime_i31.muladd(A, B, len,
+			x, xlen, y, ylen, curve);
+	}
+	r = p256_decode(&P, A, len);
+	r &= p256_decode(&Q, B, len);
+	p256_muladd_vartime(&P, &Q, x, xlen, y, ylen);
+
+	/*
+	 * The result may be infinity only if x*A+y*B = 0, which we
+	 * report as an error.
+	 */
+	r &= NOT(f256_iszero(P.z));
+	if (len == 65) {
+		p256_encode(A, &P);
+	}
+	return r;
+}
+
+/* see bearssl_ec.h */
+const br_ec_impl br_ec_p256_m32 = {
+	(uint32_t)0x03800000,
+	&api_generator,
+	&api_order,
+	&api_xoff,
+	&api_mul,
+	&api_mulgen,
+	&api_muladd
+};
@@ -102,20 +102,783 @@ static const uint32_t P521_B[] = {
 	0x00654FAE
 };
 
+/*
+ * Precomputed multiples of the conventional generator G, used by
+ * point_mulgen() (see that function for the comb layout). Entry i
+ * (for i = 1 to 31) contains the affine coordinates x and y, in
+ * Montgomery representation and without the header word, of the
+ * sum of 2^(k*d)*G for all bits k set in i; d is the comb spacing
+ * (52, 77 or 105, for P-256, P-384 and P-521, respectively).
+ */
+
+static const uint32_t P256_GTAB[] = {
+	0x1E0C482F, 0x5418A914, 0x02F3CE61, 0x711D7560,
+	0x03ADD4AF, 0x37762251, 0x4C2D62A5, 0x2F71ECF1,
+	0x000000BB,
+	0x0542B8FF, 0x57CE9556, 0x39BBE4A6, 0x10D29F99,
+	0x2C5A55C7, 0x0DD21F32, 0x29AED111, 0x2ABE96E1,
+	0x0000008C,
+	0x2A54B736, 0x67CECA97, 0x4107E922, 0x56882B36,
+	0x7A136967, 0x5723FD0B, 0x2F7CEEEA, 0x5B97EC38,
+	0x00000083,
+	0x30B1A1CE, 0x5D87880E, 0x2A8ED151, 0x56071523,
+	0x28AAA1C0, 0x2B1B65E1, 0x74D2896E, 0x43DCF2E7,
+	0x000000EB,
+	0x07279933, 0x62A0BE5D, 0x51E4CEAA, 0x13F7A529,
+	0x625A9269, 0x2A9B75B8, 0x0D9F3F3E, 0x0A3656D2,
+	0x00000022,
+	0x2F306FD7, 0x44125883, 0x40A1BAD0, 0x381A038B,
+	0x13E90DF7, 0x5F4A17B4, 0x09FACFCC, 0x452B9C6C,
+	0x00000014,
+	0x693D293F, 0x02CF7D62, 0x2041A793, 0x72A5A00D,
+	0x70F9B714, 0x092763F9, 0x59CB71BE, 0x65E33B81,
+	0x00000035,
+	0x71C4013C, 0x17581A85, 0x4B695121, 0x3D504C4F,
+	0x70F8D290, 0x5167D726, 0x4E31676F, 0x26459818,
+	0x00000037,
+	0x0C5E3E4A, 0x64B113F9, 0x3AA63CF6, 0x27563750,
+	0x2135AEB8, 0x724C3704, 0x490D1371, 0x5DFE32D6,
+	0x000000A1,
+	0x3AFF13E9, 0x4BF2E263, 0x216C7408, 0x07ABEB47,
+	0x3EC2151A, 0x2A9292D5, 0x3418AB99, 0x51F5128C,
+	0x00000061,
+	0x3F1B8482, 0x44F24AAB, 0x43DB7AF2, 0x7A584454,
+	0x2AB728EC, 0x0962DAE5, 0x7B57A5B1, 0x5A5CF444,
+	0x000000B2,
+	0x1A555248, 0x07D71ED1, 0x43886DCB, 0x680B9491,
+	0x59ECB561, 0x4DCB718B, 0x446A1C17, 0x21E7D378,
+	0x00000075,
+	0x217792AE, 0x010B6399, 0x496156A8, 0x58A848E9,
+	0x6537097A, 0x41D040AB, 0x7AC21396, 0x65A112C8,
+	0x0000002A,
+	0x75050C5D, 0x34AECEB0, 0x5F646DEE, 0x064DBB90,
+	0x59C7E646, 0x4180CACA, 0x4BA69ABB, 0x400F6641,
+	0x0000006A,
+	0x0D72EB85, 0x05CA8D9D, 0x24911E23, 0x73CEC353,
+	0x256F963B, 0x060C4612, 0x6F2B25FE, 0x15EDE7FC,
+	0x000000BB,
+	0x07F9D3AB, 0x506260E7, 0x0B05AB0C, 0x1C0EA5EC,
+	0x21CEBAF5, 0x175BAC36, 0x13298F56, 0x055DDA4A,
+	0x00000027,
+	0x05597151, 0x1160530D, 0x1107F901, 0x47237E6F,
+	0x52C6127A, 0x7A653AF5, 0x473F71A3, 0x58FC3CC7,
+	0x000000BA,
+	0x720F289E, 0x329BEBE1, 0x61E18A96, 0x7E3E4B99,
+	0x191CE12E, 0x69F22B43, 0x7742B72B, 0x42DA4AF4,
+	0x00000051,
+	0x06EF709E, 0x485BC98E, 0x10CC627B, 0x16ED10B2,
+	0x0589FF27, 0x1ECD6E28, 0x72B40531, 0x4EA2701C,
+	0x0000006F,
+	0x46CF2C6F, 0x72C53BC7, 0x495C9C30, 0x2642BF19,
+	0x2CDBCC82, 0x29DA5193, 0x4A22AFDC, 0x29A5497A,
+	0x000000C1,
+	0x1912966D, 0x13F5A326, 0x309C0CCE, 0x5098286A,
+	0x3A18FBAE, 0x770BD5F0, 0x237029B3, 0x5232E70F,
+	0x000000C9,
+	0x2355F7B2, 0x787312A2, 0x43831BBB, 0x6DDEEA05,
+	0x72DBBB39, 0x31715FED, 0x0AC3F4B8, 0x145C0CF1,
+	0x00000029,
+	0x3164553A, 0x3FF2A0D9, 0x54791787, 0x35AD6CD2,
+	0x42CFC2B7, 0x4B3DC594, 0x2CE17CA1, 0x6D8BFA03,
+	0x00000006,
+	0x0CD786E2, 0x7BE9AAFE, 0x1BF01039, 0x49D89AF0,
+	0x3FBE970F, 0x28D78D24, 0x10C87098, 0x6018CDE6,
+	0x000000D2,
+	0x412175CE, 0x44C7F687, 0x0A69BF7F, 0x5717022A,
+	0x59635406, 0x408D0255, 0x4231C8B7, 0x34FF1885,
+	0x000000F0,
+	0x5D0D63F2, 0x5810B4AC, 0x0F2F323B, 0x3DE846CF,
+	0x379B5664, 0x369DDC03, 0x76B25E71, 0x4054C990,
+	0x00000094,
+	0x1538372F, 0x00E82C8E, 0x4DBB3F14, 0x16C6268C,
+	0x10825C2E, 0x55B17A52, 0x75251891, 0x00AADA73,
+	0x00000062,
+	0x11094100, 0x271DC336, 0x42018D5E, 0x20527427,
+	0x559DE3B6, 0x3E36E325, 0x5B332F81, 0x1EDCCAFF,
+	0x00000071,
+	0x03BB9ABC, 0x3DA8636D, 0x451D0D96, 0x2ED2BBD6,
+	0x0E3CE215, 0x2AA01E0E, 0x4EC76D11, 0x56BB029C,
+	0x000000FE,
+	0x618293BA, 0x554D8464, 0x63781FCA, 0x5F28B5B1,
+	0x1CF43D02, 0x23913B1D, 0x1AA7BCE1, 0x27DF53E9,
+	0x0000006A,
+	0x67F9BEE6, 0x15ADF7CC, 0x60EBB378, 0x57B09056,
+	0x740D1F2E, 0x4249BC17, 0x53178308, 0x60897250,
+	0x00000059,
+	0x09684FD2, 0x73907FBA, 0x09B4CA90, 0x65E65E14,
+	0x29AED536, 0x66283A6C, 0x4698A578, 0x46CCCE6F,
+	0x0000007B,
+	0x65690CBE, 0x26E37542, 0x6963EB80, 0x4A831A50,
+	0x105C3067, 0x4025289F, 0x2D0C529C, 0x192A630C,
+	0x000000B0,
+	0x7B452852, 0x35267CA2, 0x55F40DF0, 0x24D4767E,
+	0x3C7E5CD1, 0x17ED9F8E, 0x5781D902, 0x1C1607AB,
+	0x000000DA,
+	0x42B8B01A, 0x03D2B59E, 0x7F5AED8E, 0x14829244,
+	0x28511832, 0x44A9F133, 0x254B7AF8, 0x108266FA,
+	0x0000008B,
+	0x3AB0FDA2, 0x6EA02053, 0x3D16DADA, 0x0BBEC8CB,
+	0x6318820C, 0x1AABBD0A, 0x7F188F04, 0x0A469D17,
+	0x000000E2,
+	0x308CEEAD, 0x5F1D3239, 0x08AF268B, 0x35EBBF87,
+	0x122DBCF5, 0x6423668D, 0x46DB2157, 0x5726603A,
+	0x000000BA,
+	0x47F12AA1, 0x2A3677AE, 0x318F83F7, 0x65EAB7BD,
+	0x1BD97388, 0x28942AC9, 0x7512EE61, 0x1B1AECE2,
+	0x000000C6,
+	0x1983BC89, 0x42333965, 0x21004A6C, 0x1C9386FD,
+	0x4416599D, 0x0070CA16, 0x4E936CF3, 0x5C895E0D,
+	0x00000029,
+	0x126994E6, 0x2E7C78BE, 0x7E2C0007, 0x1F3F947A,
+	0x6DDD4FF3, 0x03073F0E, 0x28732A08, 0x52F19EB2,
+	0x00000094,
+	0x6FF0CF89, 0x3F7972BC, 0x19081B79, 0x3B6DC9F8,
+	0x75AE4222, 0x016520CE, 0x72E27412, 0x2809FAC4,
+	0x000000D2,
+	0x6FC3963D, 0x0949D3C0, 0x160A5BB9, 0x71661EA1,
+	0x5E4FE0C1, 0x4CF31E0B, 0x14AC2ACE, 0x0A65E390,
+	0x000000CB,
+	0x1381BFA4, 0x5D74C8A3, 0x15DB26B0, 0x200CFCFF,
+	0x2797DBE8, 0x284E3624, 0x6D9FC779, 0x509E6C0C,
+	0x000000CE,
+	0x6F7A77B3, 0x4299BF5D, 0x47E6431A, 0x7DD4405B,
+	0x05F0540D, 0x29EB7D4C, 0x62340ABD, 0x36E0BC9D,
+	0x00000005,
+	0x2F6359C5, 0x5ACB2271, 0x06405CB8, 0x09876FE1,
+	0x344749E9, 0x2DC7EACE, 0x030D32AA, 0x7F79437E,
+	0x0000009D,
+	0x25F8A7E8, 0x7F3EAC9C, 0x6AEEF316, 0x79EAAB20,
+	0x4D4E9BEF, 0x7FAAC41C, 0x37D49A88, 0x4046CC0D,
+	0x0000009E,
+	0x49C92D5D, 0x7D49CCC0, 0x47DEBDC4, 0x72B9E27E,
+	0x53FF9931, 0x2C6D6C0E, 0x3EC04BE8, 0x6EC90E7B,
+	0x000000D1,
+	0x16941927, 0x005D95F5, 0x37AE7069, 0x709A110F,
+	0x334BCCC0, 0x6553A29C, 0x67A25355, 0x1E1D68E7,
+	0x0000007C,
+	0x1CB15FC6, 0x37300C0E, 0x15AD91C9, 0x676DE1A6,
+	0x59BD6A50, 0x5E5E8CDF, 0x626E749E, 0x3A738B4C,
+	0x00000016,
+	0x64D7CD43, 0x3A763CCA, 0x0007F78C, 0x152DF803,
+	0x76444EC5, 0x5BE49D9F, 0x0815BCFC, 0x44972E4E,
+	0x000000BC,
+	0x59C01AB0, 0x2176AA81, 0x25148745, 0x24275D8F,
+	0x044B0109, 0x0821F664, 0x7933B63D, 0x772A2AB8,
+	0x00000047,
+	0x1DB63949, 0x61349ADC, 0x6B4F7C0A, 0x48A8C296,
+	0x5194292D, 0x36BCCF78, 0x5D5C3038, 0x2D31CA03,
+	0x00000076,
+	0x7FA7167D, 0x713C2943, 0x7C243CD4, 0x70551F29,
+	0x402342B2, 0x32826F13, 0x11085DF2, 0x715D776B,
+	0x00000078,
+	0x64005AE7, 0x2C4708A6, 0x69D37554, 0x3199279E,
+	0x651C22E4, 0x6B77C8FA, 0x15910B67, 0x513000FA,
+	0x000000D4,
+	0x3BBE5F7D, 0x0C63E062, 0x187EABEB, 0x279FEDD2,
+	0x58D40EF4, 0x4F4CC043, 0x01221C4E, 0x20530838,
+	0x000000CC,
+	0x48A0EBEA, 0x3C82ABA8, 0x0CB7BC96, 0x55140E6D,
+	0x2C31EC7B, 0x7845186C, 0x10BAF103, 0x434A943B,
+	0x00000002,
+	0x23211DDE, 0x1483E1A2, 0x447688D3, 0x52D1F176,
+	0x308E2E76, 0x0AFF79A4, 0x50AC314C, 0x68577F46,
+	0x000000E0,
+	0x4E8701B7, 0x51A96403, 0x7644CA44, 0x4F64D3DD,
+	0x44046B3A, 0x34E909DC, 0x7658D57C, 0x50AB9EC1,
+	0x00000023,
+	0x2128EFB0, 0x677A26F7, 0x32466B27, 0x7EA8BED3,
+	0x46EE0E3C, 0x02D35935, 0x4C2BA530, 0x713A833F,
+	0x000000AA,
+	0x46E79E8B, 0x6C0F2C0B, 0x01534C0C, 0x197CCD66,
+	0x4DC90911, 0x296A5EFE, 0x2D4AF1E6, 0x085BA044,
+	0x00000046,
+	0x605A8AB2, 0x5027EAFC, 0x377C8FBA, 0x04DDA40B,
+	0x691EF882, 0x778A4DDD, 0x2C76827F, 0x14909E4B,
+	0x000000EC,
+	0x6F2A9243, 0x5578F4A4, 0x1449ED4D, 0x00A188B3,
+	0x55DE0AD9, 0x41D3B43C, 0x296809B3, 0x69D1238E,
+	0x00000033
+};
+
+static const uint32_t P384_GTAB[] = {
+	0x294269D5, 0x565FC861, 0x4707BA0E, 0x38BB845B,
+	0x37370F0C, 0x7C541B4D, 0x7F0F3875, 0x11668C3B,
+	0x5B22A434, 0x3614EDE2, 0x7025FEE4, 0x0A678544,
+	0x000006E1,
+	0x27F15BC5, 0x5AD1F8B0, 0x35846087, 0x2FE9CB52,
+	0x28669C24, 0x562E83B0, 0x33175BCE, 0x65A3D3FF,
+	0x06361A90, 0x63969A84, 0x3BB00044, 0x1685717A,
+	0x000005E1,
+	0x57D6280C, 0x54C87B71, 0x6A2D7A58, 0x7EBED4FD,
+	0x24564705, 0x54E3EEE7, 0x0E4FEA4C, 0x0E566364,
+	0x12B7902C, 0x027CB371, 0x6BF2385A, 0x68F8CF16,
+	0x000000CF,
+	0x39C634E1, 0x0A98842B, 0x0CA49092, 0x513B852C,
+	0x46528B74, 0x3D74F7D3, 0x28402716, 0x00BED808,
+	0x7573C8FB, 0x0BD033D4, 0x6D69F660, 0x6F7F47C5,
+	0x000002EC,
+	0x6C14C00B, 0x66420541, 0x0E1DD59E, 0x6A791E4B,
+	0x059EBAC4, 0x37696B99, 0x46B34C07, 0x592FAB26,
+	0x45A19C8F, 0x2C8D5775, 0x1AB8742C, 0x3CBDF0ED,
+	0x00000E0E,
+	0x165AE930, 0x1A1E95D3, 0x51BFE59B, 0x163BF20D,
+	0x720600EC, 0x06D52EC2, 0x7607E92D, 0x20FB9A4C,
+	0x1426C6F3, 0x7B7B6ACA, 0x558FDA26, 0x5ED235B4,
+	0x00000113,
+	0x520C0FF8, 0x50782936, 0x3B5A4BEC, 0x1D74CFD1,
+	0x45FA1ADA, 0x1108B9B0, 0x22166C06, 0x7CFFA4BA,
+	0x60B23BD7, 0x103189DD, 0x6DCBED96, 0x31A628E3,
+	0x00000047,
+	0x591A4A8C, 0x2187FE95, 0x75C05412, 0x34E36BC3,
+	0x365DA736, 0x2C8FD6B7, 0x68AB42BD, 0x5847BE5A,
+	0x28F1BF61, 0x430E433B, 0x7A36767F, 0x54745D30,
+	0x00000399,
+	0x5DA23701, 0x0190B5A6, 0x1CA49C0F, 0x0C77C4FE,
+	0x5C6103C9, 0x5CB04699, 0x48788E3B, 0x46F61422,
+	0x799D93FB, 0x284E5DC2, 0x482E6399, 0x40E5F8E5,
+	0x0000054D,
+	0x3FE095BC, 0x031B9E7A, 0x2565CE14, 0x766E9EE5,
+	0x33B37319, 0x30478673, 0x0572CD92, 0x4F00599C,
+	0x021C3F11, 0x352195B2, 0x7A7D1684, 0x2096197D,
+	0x00000F7F,
+	0x72315654, 0x6F9F4572, 0x04DE88C4, 0x10A71792,
+	0x4BBDA248, 0x53332E44, 0x1D92A9B7, 0x24047F99,
+	0x487E3F20, 0x53520183, 0x37E13A70, 0x38FC5359,
+	0x000003FC,
+	0x1E157305, 0x4AA4C241, 0x708CC904, 0x71E8CCE9,
+	0x3B8A31FB, 0x35760EB6, 0x5A8D6B95, 0x0C4629C2,
+	0x252AEC4C, 0x6AA1D5A7, 0x5D8B71B3, 0x7427FCC0,
+	0x00000019,
+	0x14E86D1B, 0x3EBF6153, 0x7AE2EEC7, 0x50DF3A25,
+	0x23974E9F, 0x783F50EF, 0x59688544, 0x68DEEB8F,
+	0x679A2876, 0x00FB1329, 0x76582BE4, 0x51798D6E,
+	0x00000272,
+	0x398ED48D, 0x6EA6CCBD, 0x00D3A8DE, 0x49F20F0D,
+	0x7B3EC822, 0x1426571E, 0x4E90DCAB, 0x2746D6E4,
+	0x036A00E7, 0x513DA419, 0x3E56CBD9, 0x65D3790D,
+	0x00000679,
+	0x3947B75A, 0x6201FAAC, 0x18880D4F, 0x7E5320C6,
+	0x77E39231, 0x7F020748, 0x37A8805D, 0x2BCE6D63,
+	0x23C13A21, 0x68D8CFB0, 0x6EFC7E4E, 0x3916A5E3,
+	0x000004E4,
+	0x7B563BCE, 0x29881AAB, 0x7CB3B610, 0x51F37817,
+	0x7B4AF5B3, 0x47B82775, 0x2DC8699C, 0x3D8E4400,
+	0x7F424CAF, 0x71E47792, 0x346BD172, 0x5F1AABAE,
+	0x0000059E,
+	0x506729D5, 0x1783807A, 0x76E2F79F, 0x7B9D4A9D,
+	0x2F1847A9, 0x67199331, 0x7B3EEE83, 0x3E97F113,
+	0x4C1144E4, 0x1711C4B6, 0x11BB17AF, 0x5C8B0BE6,
+	0x00000538,
+	0x52CE47A5, 0x7A835ADC, 0x33507F94, 0x4B5CD9ED,
+	0x04BBF894, 0x551633CE, 0x79AB47F6, 0x5BD46C4D,
+	0x27CED93C, 0x6C3A1547, 0x55B58C8D, 0x521C852C,
+	0x00000E67,
+	0x0208786B, 0x0A84DE2A, 0x6C7F2DBC, 0x3CF385FE,
+	0x4CFB6FC6, 0x505DB533, 0x3E00953F, 0x3DEE0E5D,
+	0x7EB3A460, 0x03AC4997, 0x6FDA35BF, 0x21170A71,
+	0x0000072F,
+	0x7D183A54, 0x3834300A, 0x08C4B6A9, 0x4C1B570C,
+	0x44E4AC27, 0x3E1B5EEF, 0x46954EB4, 0x09A3A715,
+	0x39A54E66, 0x775F4E0A, 0x3DEA2BE9, 0x6AFF1252,
+	0x00000B18,
+	0x5607C29E, 0x34D888E5, 0x59AD4B82, 0x44055769,
+	0x4DA9D58F, 0x439FAD10, 0x52FCE0D9, 0x50629537,
+	0x3F96A5A6, 0x776D5241, 0x35F128E5, 0x2A809FB0,
+	0x000008A6,
+	0x1F1C0877, 0x7EB998DE, 0x19DA0471, 0x20641425,
+	0x51A53E57, 0x5406582D, 0x29B19E0E, 0x1F24A789,
+	0x7EA8A218, 0x46AD1A72, 0x008E6EC3, 0x12B736FE,
+	0x00000E01,
+	0x20207042, 0x6AF52D1B, 0x3EA50E3C, 0x4AAD0E2D,
+	0x5D5A25D3, 0x66979A48, 0x48439E48, 0x2DB1D3B1,
+	0x37AAD48A, 0x35B549C8, 0x5C7F82E2, 0x12A0AD92,
+	0x0000094B,
+	0x19706C2D, 0x5A0D2A3A, 0x2DE6725A, 0x4CFAAAE3,
+	0x37403B91, 0x088F41A5, 0x3944C001, 0x03264D5E,
+	0x51FA9769, 0x15A1059A, 0x42D1CBB4, 0x5FBD4AC6,
+	0x00000321,
+	0x50510A23, 0x787CFB95, 0x426C9738, 0x1CFD06E3,
+	0x77A4667E, 0x0D94C67A, 0x44851A40, 0x28355F6B,
+	0x13892566, 0x77C13E8E, 0x74B61CDD, 0x708181C5,
+	0x0000019B,
+	0x1C7FB5D7, 0x174B7A02, 0x29790764, 0x11A24B15,
+	0x06416F9B, 0x0B150ECF, 0x4E4F7796, 0x1C06657E,
+	0x240CF18E, 0x0E2CE0E6, 0x16ABA111, 0x40CB606F,
+	0x00000FEA,
+	0x5B713BE2, 0x152E1247, 0x6FA25BDC, 0x7E9A621F,
+	0x15533AD4, 0x3A9680A9, 0x55BB5611, 0x37F382F7,
+	0x27205E0F, 0x56FAC213, 0x0538E5D2, 0x6EDB0106,
+	0x00000A4A,
+	0x72214245, 0x63F466AE, 0x2F55E511, 0x368AADC5,
+	0x397DF329, 0x06047C21, 0x58D3A9FA, 0x2D79980C,
+	0x639BC0DF, 0x3651B635, 0x5F9FC8C8, 0x6821BF2D,
+	0x00000E30,
+	0x77BBB41F, 0x66BE745C, 0x0D760959, 0x43ED5A6B,
+	0x1B7BA0FE, 0x4C173FEB, 0x6B573DBB, 0x167A3155,
+	0x081F4A1E, 0x02199A88, 0x45EC6C00, 0x247E11DF,
+	0x00000A59,
+	0x2B84C6F5, 0x230F19BB, 0x6F18C95E, 0x13C989BC,
+	0x1D3C1277, 0x6CA8CA56, 0x0E7296DD, 0x36B5A558,
+	0x62263D59, 0x76A00750, 0x673E3C10, 0x5DAE3FE3,
+	0x00000ED4,
+	0x3510390F, 0x6747D244, 0x54CD0B16, 0x03C4F761,
+	0x26B4175A, 0x4E29D919, 0x22649CCE, 0x5B72CC29,
+	0x496E37EF, 0x7528AA54, 0x47E7D96E, 0x48FFEAA4,
+	0x00000C7C,
+	0x29C4C0D8, 0x3D58F8C7, 0x139B1DF9, 0x301B8C4B,
+	0x384680A1, 0x374CF4A1, 0x7A09E561, 0x7EEFCCD7,
+	0x35E05DA4, 0x55A928C3, 0x38D6DCB7, 0x3624F751,
+	0x000000FA,
+	0x45BF4631, 0x1A4E3AC6, 0x39ADF8CA, 0x0814834B,
+	0x6E057BCC, 0x2A92A93F, 0x285542B6, 0x1A3375E8,
+	0x2B757D81, 0x585E2803, 0x055E540E, 0x4A7CBEEF,
+	0x0000081E,
+	0x472C4BA2, 0x58010D92, 0x292C7457, 0x79C2CED1,
+	0x544C8082, 0x30B6630B, 0x07C966EE, 0x1F141B4F,
+	0x30B8BFBC, 0x5C90C447, 0x5E79F64E, 0x2AB3CACD,
+	0x000008EA,
+	0x52D4112A, 0x38E92CF3, 0x2D64C0D2, 0x2A93D3BA,
+	0x7FC3DBD8, 0x569D42A8, 0x1BAAF8D3, 0x649EC523,
+	0x77C5E9AE, 0x5320AE33, 0x17C64F59, 0x109028CA,
+	0x00000CC9,
+	0x5DE0A1C2, 0x5DB665A5, 0x54958195, 0x0F7F0775,
+	0x3FC8A004, 0x57487BA6, 0x26A984FB, 0x613AEAA5,
+	0x5B2F102E, 0x39218B3D, 0x4A0518CE, 0x6585AD33,
+	0x00000AC7,
+	0x62F245A5, 0x4462942A, 0x1F29C1F6, 0x24796318,
+	0x375124AB, 0x635924F2, 0x66E48233, 0x2D7D96C0,
+	0x1AF23C56, 0x187B8AD7, 0x124F2E24, 0x666A501B,
+	0x00000D04,
+	0x298DA294, 0x38EF9F16, 0x2253C01C, 0x6BC4C2B0,
+	0x048BD310, 0x3E2F7F1B, 0x702B97B6, 0x3C1611D3,
+	0x279E1A35, 0x3172639B, 0x2ADAE6E5, 0x5A332F74,
+	0x00000C0C,
+	0x50E44B32, 0x680443E6, 0x73875400, 0x75D62FD2,
+	0x1FD668AD, 0x5924E854, 0x79E12FE1, 0x692A0BEA,
+	0x0E938766, 0x6981EEBE, 0x768E9DAC, 0x721C247A,
+	0x00000A60,
+	0x6598102E, 0x22532770, 0x2A20CB31, 0x12C70FDF,
+	0x01C6361B, 0x244521B1, 0x42BA73AE, 0x130906B9,
+	0x63720664, 0x3C17B7E0, 0x4D097AF7, 0x5570BD0E,
+	0x00000A9E,
+	0x2A78F2D3, 0x35C64501, 0x712773F5, 0x2F352661,
+	0x0F861E86, 0x1AF2E1BF, 0x55CE14E9, 0x24DAF2F4,
+	0x2DE6DC54, 0x460F0CDD, 0x72FF2F10, 0x5515D073,
+	0x00000B49,
+	0x7519DC66, 0x14A20ABB, 0x78AEEE97, 0x42930F77,
+	0x2A7DAB26, 0x7A1CC36C, 0x232BAE55, 0x5CD49AE9,
+	0x163C980F, 0x3E8280D6, 0x4006CB38, 0x1FA51043,
+	0x00000269,
+	0x25DF1882, 0x5E6A6A3C, 0x4DECE639, 0x4FC808FF,
+	0x4DD688C2, 0x255C4528, 0x5E67E9F9, 0x7AF0FB77,
+	0x49920353, 0x4DF48C65, 0x538C5B5A, 0x7DDFDB91,
+	0x00000BEC,
+	0x3E246026, 0x4A35C3DE, 0x177AC8EA, 0x640E2A11,
+	0x31E61A61, 0x1E4C779C, 0x33780CB2, 0x521CCCF3,
+	0x17A4BE6B, 0x2D99BCB3, 0x2429C476, 0x705F9EE4,
+	0x0000086F,
+	0x66C7632F, 0x4289283A, 0x4A8EC97F, 0x64C5E8F7,
+	0x39B81E6F, 0x7FB6A14D, 0x30E7F19B, 0x294B92E5,
+	0x0F936D80, 0x61A85503, 0x5B1C1272, 0x6481C27D,
+	0x000003AC,
+	0x1702A467, 0x72BE7D7D, 0x1E9B06EF, 0x791E3FC8,
+	0x33F1270D, 0x1A8CBBBD, 0x56A8022E, 0x54EAD9C3,
+	0x7B087797, 0x73BFC675, 0x1316A89F, 0x34967FE9,
+	0x00000E61,
+	0x73F1FCDD, 0x1A34BE46, 0x7604F1BA, 0x19B358C1,
+	0x356DADBE, 0x4297EA97, 0x25B5F2A4, 0x36DB991A,
+	0x7720353C, 0x683315A4, 0x696A57A7, 0x6DE3C804,
+	0x0000051A,
+	0x4CCFB1DB, 0x44C0DBE5, 0x664FE5CB, 0x5BCF2925,
+	0x20957F98, 0x57244E31, 0x1BA75974, 0x152EDD7A,
+	0x7AD03E0D, 0x2832D8B8, 0x054FC946, 0x7CE8BC9F,
+	0x00000A5F,
+	0x08E0B1BB, 0x7B3E7F12, 0x25F4169A, 0x32C1546D,
+	0x24B99EA6, 0x377F3604, 0x28CDF686, 0x79662A9B,
+	0x559084A9, 0x3B6C1759, 0x497C3BF3, 0x39713B06,
+	0x0000033B,
+	0x5514FE60, 0x72AE0AFF, 0x2D4F5695, 0x3E026D95,
+	0x7F23481F, 0x6FAC9F05, 0x49251D76, 0x282C0546,
+	0x546B7A1B, 0x5F4E3448, 0x3715DDB2, 0x27DE54E9,
+	0x000006AA,
+	0x3A9131DB, 0x68782CC6, 0x583A2CE1, 0x07127621,
+	0x4C0EDDDA, 0x52CA8C9D, 0x0817C85A, 0x20BA0184,
+	0x797997B4, 0x12BE876D, 0x2724ED6F, 0x2321A933,
+	0x00000B45,
+	0x436EB338, 0x16F30776, 0x5F167DE6, 0x269F4754,
+	0x1F9A9B77, 0x3BE4EE47, 0x52A0DAF5, 0x073B2A8C,
+	0x110BA60C, 0x37EB51ED, 0x6C0A4144, 0x2CE75BAF,
+	0x00000972,
+	0x1F58E07F, 0x10F4ED50, 0x589F1152, 0x7FEFC8C8,
+	0x435A4F8D, 0x6D79EEB8, 0x72F75DB2, 0x45676C4A,
+	0x579DB328, 0x790638FF, 0x64062940, 0x7223BCDF,
+	0x00000F0B,
+	0x40556B8A, 0x1855E02D, 0x249B0A5F, 0x27134B22,
+	0x470D6CEC, 0x45C078FA, 0x44D8FBB1, 0x739D079A,
+	0x1BDEF6A1, 0x298B878A, 0x0F185763, 0x55FABDD6,
+	0x0000057C,
+	0x6D999D38, 0x67FF3872, 0x7DD0111A, 0x0CD729FF,
+	0x5FE1CC4D, 0x7C3D3816, 0x677E657F, 0x1C4CF150,
+	0x76D733F1, 0x19D09873, 0x735C1964, 0x03C8F3E6,
+	0x00000B55,
+	0x0259092E, 0x09589294, 0x6EFF6608, 0x5661F341,
+	0x5D49A4B2, 0x5397AE25, 0x010FA84A, 0x4E4FD221,
+	0x3BAA464E, 0x42EA6C11, 0x23E1369E, 0x0979695E,
+	0x00000071,
+	0x74B465A3, 0x0549D6D3, 0x2C4E7F02, 0x36670D14,
+	0x37F8BEB4, 0x59D6AD4C, 0x3760C99E, 0x6D881993,
+	0x619B4ED7, 0x72746205, 0x2E4D6B68, 0x20C62C22,
+	0x000004FF,
+	0x23B6D3AF, 0x045F6A65, 0x3B319A68, 0x4C75DC8B,
+	0x7CD2D179, 0x4F30B696, 0x2D3608FA, 0x0B53061A,
+	0x4CAE1346, 0x07945A33, 0x49B5574E, 0x724E8512,
+	0x00000375,
+	0x79766077, 0x2A799B8C, 0x329CF2B1, 0x58CF5FD4,
+	0x5134EEDE, 0x5728C83E, 0x42CBA794, 0x06E43022,
+	0x18BA0E96, 0x729F4EFC, 0x6166188B, 0x6CEDBD3B,
+	0x00000D6D,
+	0x34C443E0, 0x28036BB7, 0x7A69D266, 0x2C9629EE,
+	0x4201AE87, 0x1936AF2A, 0x4CABF806, 0x05BDE211,
+	0x2E3F4CAB, 0x1DC367D3, 0x69969B2B, 0x63EE7273,
+	0x000004A4,
+	0x452016DA, 0x7CDE6324, 0x7E0C205F, 0x663EFD7A,
+	0x12802C64, 0x594DCC33, 0x3031255A, 0x65A0E2EE,
+	0x273CC2B5, 0x318FF21F, 0x298A0F92, 0x0F022399,
+	0x000000EC,
+	0x590F2D67, 0x455946D9, 0x089AA26C, 0x44E77976,
+	0x3A887CB6, 0x52F9BFA2, 0x0C071369, 0x1E619DE6,
+	0x2CFB1E22, 0x0114B36F, 0x3C0D0C08, 0x3692B0A6,
+	0x00000E1D
+};
+
+static const uint32_t P521_GTAB[] = {
+	0x396F5998, 0x3F3F18E1, 0x6A429BF9, 0x1167830A,
+	0x7EA378CD, 0x6E093D17, 0x75928FE1, 0x6BCEFDFC,
+	0x4F6EA852, 0x57B035A6, 0x3521F828, 0x02720A7F,
+	0x510A7192, 0x5B311CAD, 0x1CD9E3EC, 0x56E0809D,
+	0x01A16381,
+	0x74599423, 0x5F4A3B4F, 0x72C24088, 0x78E10D44,
+	0x341D84D4, 0x05C809FD, 0x42640C55, 0x4E532BDE,
+	0x198B25FB, 0x5E8B939F, 0x446817AF, 0x0892AF36,
+	0x6F6663D5, 0x7DA163E8, 0x0045C8A5, 0x4F134778,
+	0x000E4A5A,
+	0x5ACCEB26, 0x6C867C43, 0x558F0B45, 0x7C35327D,
+	0x645ACF94, 0x0C0FAA4E, 0x09BE2D5D, 0x5E0805D8,
+	0x4ED5C6C7, 0x38BB5908, 0x044EE578, 0x5CE100E6,
+	0x63744740, 0x4F3D1571, 0x6FA9D1C1, 0x1286C69E,
+	0x000998B5,
+	0x758823BD, 0x264539B5, 0x37911A45, 0x08F9DF5C,
+	0x6316BB49, 0x62C9734D, 0x15BFC56A, 0x2C90736C,
+	0x7F98B9FD, 0x3370DDF3, 0x7B32FAC0, 0x7DC36EEE,
+	0x2B6ACAB0, 0x2998A88A, 0x4C955F86, 0x07C8C92F,
+	0x01C572EA,
+	0x5C4DD762, 0x1D9D6DF1, 0x4F187B86, 0x3BB08513,
+	0x492C43CB, 0x7B873B55, 0x01A9380C, 0x475CCAFB,
+	0x24715E01, 0x5858E43A, 0x7BF988AE, 0x66745C2F,
+	0x46E97AF9, 0x5E6A9569, 0x7F8C205C, 0x1F3DACD4,
+	0x01E84C8C,
+	0x69BB176F, 0x26CD1D81, 0x627BE322, 0x5F94837C,
+	0x2F2A2787, 0x7914E115, 0x3B84834D, 0x24D4102A,
+	0x67A58471, 0x4DECE5DA, 0x18ED2687, 0x186D1A25,
+	0x3C85DFB3, 0x3BDEB2B0, 0x65BAF686, 0x42A48566,
+	0x01F97771,
+	0x570CDED3, 0x577F090A, 0x1865967E, 0x7E4F9D8E,
+	0x36EFACD5, 0x13634B2A, 0x63A6A90C, 0x144F1436,
+	0x6448DAF3, 0x3D49476E, 0x25E9776B, 0x6A0ED8DB,
+	0x51EECAFB, 0x1D5071E3, 0x2EF805ED, 0x0B0CB3BE,
+	0x000A63BD,
+	0x69E7E343, 0x6EC49C9A, 0x172C6BE3, 0x56213943,
+	0x54E9359C, 0x0E5D703C, 0x6DE77AD4, 0x6A4FFA40,
+	0x66047781, 0x52605B0E, 0x360E1F55, 0x2DAAF4EA,
+	0x3F9A4A75, 0x67FA8197, 0x22C9F2BE, 0x18EC1E0C,
+	0x00037995,
+	0x11485ACB, 0x7232D7C2, 0x7AE51BD9, 0x2582578A,
+	0x07D349F4, 0x2FECDD58, 0x1D722AF6, 0x31509678,
+	0x0E0CBCBF, 0x6E13FA89, 0x325E8870, 0x3A2D190A,
+	0x5D67A2D4, 0x2EFC9718, 0x1C31A03D, 0x08DDFB69,
+	0x019ED79B,
+	0x5E994694, 0x138BA689, 0x6229CBB4, 0x4CC3A84A,
+	0x6BACFFE7, 0x02687F69, 0x3FAE1BBD, 0x5DE8AB76,
+	0x542270C7, 0x4CF203D1, 0x1E1A52DF, 0x737BDA85,
+	0x765D9452, 0x3DFB3F65, 0x46D75797, 0x2BF64E4B,
+	0x01DC28AD,
+	0x44CD56B6, 0x166C5744, 0x2F3522DD, 0x2297F974,
+	0x11AAFC08, 0x0C27A912, 0x6D0C5E62, 0x6ACA2D1C,
+	0x67AF3A35, 0x36018CD6, 0x3557580F, 0x3AAB852A,
+	0x537E2E75, 0x052B0C29, 0x6B623464, 0x6E5FDB3C,
+	0x01FD14A9,
+	0x0846ED77, 0x29723B8B, 0x6DF59409, 0x30E95CB9,
+	0x4A1D974F, 0x0D3DEC29, 0x33D982C2, 0x60679D86,
+	0x1F35512C, 0x12C69E2C, 0x619E0474, 0x2C5E92C5,
+	0x374D49F0, 0x7BD2D9AB, 0x49B0DBF0, 0x6E32B77F,
+	0x01235A0E,
+	0x2EC5D320, 0x4CFBE6CA, 0x566E5EFF, 0x36857B2C,
+	0x38EEAA41, 0x55F9AF5D, 0x4CE21DA1, 0x3EE36EC8,
+	0x0E830577, 0x60E02874, 0x19732920, 0x6DDA1EF6,
+	0x4E988DDD, 0x224ABD6F, 0x2D07E393, 0x1F322C1D,
+	0x00367823,
+	0x55C1F6A2, 0x7809AF33, 0x5596B054, 0x6CF11C5C,
+	0x31000565, 0x6A5C479D, 0x4BFE773D, 0x0A7C7F75,
+	0x48201FD5, 0x6124A135, 0x0F92551D, 0x6AE3C67F,
+	0x3E214A3F, 0x7204AC1A, 0x77CD78D1, 0x122FA0F4,
+	0x01081017,
+	0x0F44E0DA, 0x67093776, 0x05B18ED1, 0x7F301490,
+	0x6C7D3831, 0x228437E0, 0x60CA0659, 0x6075C125,
+	0x39702B05, 0x3BFCC5AF, 0x7BB5834C, 0x5EAEDA33,
+	0x2F44F9C8, 0x2257B3B8, 0x101AE8A9, 0x0A054F8E,
+	0x01F87444,
+	0x0C0C000E, 0x014FE965, 0x352ECD62, 0x58E59359,
+	0x376288D9, 0x4E0D5664, 0x3984DCF8, 0x46B7EBA3,
+	0x0354A570, 0x6886E8D4, 0x5ADD3434, 0x151EEFD2,
+	0x59802534, 0x013E8901, 0x2B303890, 0x4E652F23,
+	0x014CBEBC,
+	0x56908229, 0x40DAE083, 0x1C7FCC92, 0x0BC1CA8E,
+	0x413C02BF, 0x74179E43, 0x609469A6, 0x18634C52,
+	0x15C7D0C8, 0x5A5EA89E, 0x58FBE673, 0x26547B89,
+	0x6FA66DA1, 0x1A2164AE, 0x7B7A8CBE, 0x4AE45388,
+	0x0083DAB0,
+	0x5045508A, 0x260496E0, 0x47BEAF1B, 0x768BACEE,
+	0x55CD7B12, 0x625F246A, 0x3FD44685, 0x5F990C70,
+	0x7DD0279C, 0x6E29101F, 0x64AD615B, 0x35F6B634,
+	0x3A5B3067, 0x69A15BC1, 0x68728EF0, 0x2640BC75,
+	0x00887611,
+	0x195A5C4F, 0x4422B839, 0x720EFE6A, 0x1F97254F,
+	0x4505F371, 0x6DA7FEE1, 0x5C14F759, 0x6068BF2B,
+	0x15BC3C6F, 0x5EAD87EB, 0x40F70686, 0x406CDE88,
+	0x5B86717A, 0x4E71C43F, 0x62D20761, 0x2C14423B,
+	0x016A7BE3,
+	0x169B0446, 0x5E73FCC7, 0x482B6CD0, 0x67080DDB,
+	0x5626CAAC, 0x135283E5, 0x47EB7367, 0x6D9F8059,
+	0x38AAE21E, 0x3C819456, 0x6057651F, 0x086C0D74,
+	0x2BFA39FE, 0x0D95FFB9, 0x145D103B, 0x18C8D2B2,
+	0x00E50B3C,
+	0x01740F89, 0x258419AC, 0x1AB8CF20, 0x075CF4B4,
+	0x5BE220F0, 0x3713DF56, 0x53E60337, 0x4E275294,
+	0x63BA6C39, 0x4F409F85, 0x16E3790F, 0x584E9691,
+	0x7B3086CA, 0x48DF3FD7, 0x1CACE7C2, 0x14438209,
+	0x01443F85,
+	0x04C35A2F, 0x5D9853E9, 0x09146895, 0x51E54A99,
+	0x02292B0A, 0x3570AD8B, 0x72485523, 0x650538A1,
+	0x153B6F60, 0x7BA421A9, 0x5C29C87A, 0x7BEC7501,
+	0x64DB1DB5, 0x5A4AEC40, 0x20D7CE57, 0x705815D5,
+	0x01E3A572,
+	0x269028E1, 0x50C9E3C1, 0x732F4121, 0x6EB3520B,
+	0x50D4DE1E, 0x2A3B1B70, 0x26433BA1, 0x230C8D6B,
+	0x6F90FEE5, 0x6D6FEC74, 0x3D4781C1, 0x48596A2E,
+	0x5E64C516, 0x7A5F2E4D, 0x6E422D5E, 0x285FFC6D,
+	0x0082F796,
+	0x2F163966, 0x641DD2FA, 0x0698E3AF, 0x31C8F1AB,
+	0x1B6226D0, 0x01B8D0B9, 0x2291A1F6, 0x316AE5E1,
+	0x5989A969, 0x6D057E9A, 0x342F0E44, 0x7C685B12,
+	0x528A8FA6, 0x10DE1E0D, 0x11E91959, 0x4504BC83,
+	0x016F2C84,
+	0x2E882688, 0x5AFC4687, 0x5E2880A1, 0x6A8CD078,
+	0x6C97C412, 0x2C8D077D, 0x29982E93, 0x1ABEFD2E,
+	0x420C459E, 0x496D3EA1, 0x198F6EB9, 0x23EE16F8,
+	0x7CF8692A, 0x423B768F, 0x1313A679, 0x264A8CBC,
+	0x00862978,
+	0x521BF21E, 0x4238F5AC, 0x6AB9E2AF, 0x7B195736,
+	0x03E7A8E5, 0x13CE1086, 0x711B9942, 0x0CA8FBBB,
+	0x126C2CC6, 0x430D3F07, 0x41082910, 0x4D56986E,
+	0x401C2B01, 0x7A64E1A7, 0x31F67C76, 0x37CD53C0,
+	0x01CD8D7B,
+	0x33E965A4, 0x48C94FA6, 0x4098CF2E, 0x2D0E6708,
+	0x28DB7CEC, 0x521BF30B, 0x439AE0FE, 0x2EABBC1B,
+	0x31CEAFA9, 0x28736510, 0x4DE27210, 0x76C94CA6,
+	0x2BBD761A, 0x7A7D7BAC, 0x4CA0C65F, 0x29A67065,
+	0x01CE35EF,
+	0x6C8BF0B0, 0x5F3F12FB, 0x0537BEAA, 0x58F6DC27,
+	0x5F0C9113, 0x682E4AD6, 0x0245933C, 0x422B982C,
+	0x25184A29, 0x551A6F91, 0x524D05C1, 0x6BB17B63,
+	0x088CE7F0, 0x06AA5AFB, 0x0F3536AA, 0x7C6E077A,
+	0x018754A1,
+	0x1A9E01C5, 0x4D0396AF, 0x6EB1059F, 0x47150673,
+	0x76C6D3E6, 0x1A4AF8BE, 0x310B4150, 0x014D8E64,
+	0x1755F69E, 0x3C09A01D, 0x01E77B28, 0x102BCF89,
+	0x0F89AEC2, 0x4522BA61, 0x4441198C, 0x548CE7BF,
+	0x00AA36A4,
+	0x6DF38C5C, 0x6F99D75F, 0x686F1392, 0x11CA5094,
+	0x6E9FC859, 0x4D9D7F22, 0x41D83442, 0x0A26E72F,
+	0x3B89885B, 0x69E1E464, 0x3424CAC9, 0x40BC818E,
+	0x30FC1C45, 0x1D290CE4, 0x3B3008B9, 0x7718DE21,
+	0x002AC7B9,
+	0x2A313ECD, 0x535D1C08, 0x493E5D73, 0x27B2B3D9,
+	0x7A61C545, 0x2C0095AC, 0x442F17CA, 0x1B7DF5FA,
+	0x5DA47B70, 0x05115CE7, 0x017DB905, 0x2DFC8C9A,
+	0x3728F47A, 0x0D24103A, 0x41354178, 0x367166AA,
+	0x00FB7383,
+	0x0ACE708E, 0x09F1F757, 0x2181791A, 0x62103A78,
+	0x22DF1B10, 0x60A60D73, 0x5A3045CB, 0x2B377200,
+	0x6BB573C9, 0x60F49763, 0x2F0D14D7, 0x37FC3C5C,
+	0x33E570DE, 0x26944378, 0x517FC33E, 0x7A1589C3,
+	0x004BC539,
+	0x779222AF, 0x0F8A4BF6, 0x6E698E2F, 0x06C96463,
+	0x781238F4, 0x1961CD23, 0x237C488A, 0x7B1BD0DB,
+	0x5727202A, 0x776C83C4, 0x70816608, 0x73CDA314,
+	0x4C0F329A, 0x55486543, 0x78944F63, 0x5DA129F2,
+	0x01E10A07,
+	0x297DE8E9, 0x01B93EB5, 0x5A94A257, 0x066A2413,
+	0x733F5B67, 0x397CF56E, 0x6BCC1805, 0x7F1608BF,
+	0x236B3E56, 0x25891852, 0x06194BCD, 0x5443E01F,
+	0x4D04CA85, 0x15C8DE56, 0x44A612D8, 0x1B5C5757,
+	0x00FD084E,
+	0x4438219B, 0x49B2750A, 0x50F6797E, 0x16C76263,
+	0x2B851949, 0x1E6294D7, 0x10818F8F, 0x3911A6DF,
+	0x76AD6301, 0x3AF2C06B, 0x0C4916ED, 0x4E00A800,
+	0x7DEA3E1C, 0x150C21E2, 0x4119740A, 0x58ADCD00,
+	0x0023711A,
+	0x307F2F3E, 0x4950EB5D, 0x1CA20794, 0x79B02315,
+	0x341D4F35, 0x201D0E6F, 0x2B3FAD61, 0x65C92CE0,
+	0x4C8A4B48, 0x0FE4C1F1, 0x18F95BD0, 0x04F89B7D,
+	0x08A455F1, 0x54F8E2DA, 0x047D2594, 0x70BCC630,
+	0x0178081E,
+	0x6ABBDD4F, 0x7CC1C0B8, 0x4B076A6B, 0x39855182,
+	0x60F7151E, 0x33762663, 0x648F9C04, 0x41B44D05,
+	0x344BDFC4, 0x2C562527, 0x05EDE022, 0x737307B4,
+	0x06C2362A, 0x62A1CA38, 0x76EB1B1E, 0x24D05A58,
+	0x0063F266,
+	0x31519692, 0x308DFA4B, 0x720F8F0A, 0x4D6420E9,
+	0x00044742, 0x47941DB9, 0x05A27217, 0x30AB890E,
+	0x6A91AF5C, 0x0BF5F3CB, 0x0C95204B, 0x2A783483,
+	0x0FA60801, 0x5353E29B, 0x7EC0AC39, 0x74271CB0,
+	0x00907962,
+	0x6030AFE4, 0x089469EA, 0x4B48FF7A, 0x17017267,
+	0x2622A153, 0x00712092, 0x3B0B612E, 0x37A7D12E,
+	0x7E044B90, 0x59248394, 0x77D081F9, 0x506E164D,
+	0x5DFA0AC7, 0x290229EC, 0x7F366102, 0x77EED5E5,
+	0x00A19013,
+	0x1C194827, 0x2F76C3ED, 0x190FDC93, 0x5DFE40E5,
+	0x666C74D6, 0x67D8B3AF, 0x1D686F65, 0x24A9B06D,
+	0x209F839B, 0x1E2F0441, 0x6119C349, 0x65B49E2C,
+	0x689683B7, 0x100AC9B1, 0x66B7638D, 0x084EC111,
+	0x003B3860,
+	0x244F30AB, 0x7DCCCDFC, 0x61F4D702, 0x51068F92,
+	0x10D70E05, 0x648FBC68, 0x66AB3D54, 0x17995321,
+	0x0E62B2F4, 0x67046C24, 0x0ED63C8B, 0x72F3AA6E,
+	0x6B0E0FCF, 0x5E93A7E9, 0x7AA7449B, 0x3709CE79,
+	0x01B98517,
+	0x0111DDE9, 0x21AF122C, 0x7E76878A, 0x73A4F326,
+	0x34A1D0A6, 0x17181F22, 0x5F55F42C, 0x44795308,
+	0x6F0FBF79, 0x12C797D0, 0x096A752C, 0x65679D14,
+	0x143C6636, 0x30DB7976, 0x43F59B53, 0x13834554,
+	0x009693C8,
+	0x4017680D, 0x5DA45AA7, 0x4BC0C5FC, 0x1A6240A1,
+	0x320474AA, 0x60A9374D, 0x013F2B33, 0x1279CB0C,
+	0x45A22479, 0x11322446, 0x45E19941, 0x03830EB8,
+	0x6DC9E59B, 0x3695F06A, 0x0299DBC8, 0x1302AA7A,
+	0x0018EA0D,
+	0x510156CD, 0x2799804E, 0x32A2F518, 0x7D8577A4,
+	0x297AD6B6, 0x599542D1, 0x35F4C4E0, 0x2EED9C6A,
+	0x273E24E3, 0x0D0D078B, 0x093DD259, 0x53E9CF44,
+	0x40AE3728, 0x1980A2FC, 0x3ECB8746, 0x70DFC59D,
+	0x00205B5B,
+	0x1FEAF5BC, 0x3BA04415, 0x6F236E5B, 0x23CFE104,
+	0x42EF4C24, 0x680A6427, 0x00C1ABC4, 0x79B1E5C0,
+	0x2DC842E2, 0x3BBC16EF, 0x26A9D5FF, 0x6DF2FDF0,
+	0x3E503DE9, 0x137B2269, 0x7ED031CE, 0x104F1FB8,
+	0x0087ABF7,
+	0x02F0A85C, 0x5F8CA953, 0x57DCD516, 0x4822187B,
+	0x09830CB3, 0x015F8BC7, 0x4B29C3DF, 0x41184728,
+	0x0B8044C8, 0x69232CB4, 0x08C513AD, 0x568C2676,
+	0x3A921E48, 0x49928E3D, 0x5FF5B3E4, 0x07727017,
+	0x00279DF2,
+	0x1D196187, 0x7220202A, 0x62CB313C, 0x41E37C63,
+	0x28771949, 0x734480E0, 0x363BB802, 0x55D51F08,
+	0x328E57A6, 0x54B12666, 0x76E4FFD8, 0x17CDF53D,
+	0x1A3F84AA, 0x0C298DF4, 0x33685338, 0x00D44747,
+	0x010961E1,
+	0x39512676, 0x413A0A4B, 0x05003414, 0x665F2D1C,
+	0x72B71E81, 0x7D33B233, 0x6927C1C6, 0x7421931A,
+	0x1403E98E, 0x37CB6E61, 0x59C558CB, 0x6DADD49F,
+	0x2642B32D, 0x2CD983C3, 0x4FEE2A2F, 0x4F3A4499,
+	0x00B62C91,
+	0x1351DB04, 0x73DE21D4, 0x70F82FDB, 0x0CC26A1B,
+	0x5ACF7603, 0x1C8AF3CC, 0x0B6A5FDA, 0x30ADEA8C,
+	0x4A80F4C2, 0x767DFDAF, 0x481EDA60, 0x43990FEB,
+	0x79A6D150, 0x05BC994B, 0x31BE78F5, 0x5C1256F5,
+	0x002D5FBD,
+	0x69FA51FB, 0x561235EA, 0x2C0E9E2F, 0x2C1E2E78,
+	0x057B728D, 0x1DF53CCD, 0x7762636F, 0x12A7FEDB,
+	0x5043D478, 0x5C78F0C0, 0x1CD7791F, 0x484E0CB6,
+	0x52D67964, 0x39B374D2, 0x2D5492C7, 0x68FECC9D,
+	0x01A3C618,
+	0x27CA56D4, 0x592EF1E6, 0x01F758F8, 0x74D5FBA9,
+	0x65375DA8, 0x316B2EB8, 0x39C8B0F3, 0x0D628E50,
+	0x675CF41C, 0x633BC373, 0x2A66863F, 0x5BA97AA3,
+	0x5481E8C4, 0x245F17D8, 0x2A84F541, 0x21DA7F5F,
+	0x017E064D,
+	0x2E84C678, 0x6F159168, 0x128DE4DA, 0x1BEE241C,
+	0x74D2E3B0, 0x5A518523, 0x7E4B4BFB, 0x32DFCD81,
+	0x431309EA, 0x61BB7E1C, 0x1559F37A, 0x33251E3B,
+	0x6E7A8A3C, 0x0A4BC8BF, 0x35E59A81, 0x69E49CB7,
+	0x0055962D,
+	0x2432D1D4, 0x462A76F0, 0x2CC4B90B, 0x1DEA8757,
+	0x17451377, 0x6CFCAB7A, 0x30B7DAA5, 0x3D510DAB,
+	0x56A6D60A, 0x0AE02ECD, 0x1207A084, 0x30B13A8D,
+	0x55D83737, 0x04856A3E, 0x40391EF5, 0x3EFF938A,
+	0x010A1AD6,
+	0x06980CE8, 0x7945A734, 0x06A02D51, 0x11025EAB,
+	0x5D6FA64B, 0x4BBA91BF, 0x5AC3D654, 0x33891C8C,
+	0x51A8CE7B, 0x2AC6F52B, 0x3F5752B0, 0x65D44503,
+	0x16EAC6B5, 0x711E14DE, 0x31AFA48B, 0x4D7623C1,
+	0x0117775F,
+	0x6FC71749, 0x48DEC7EF, 0x4BBE746B, 0x17918A6B,
+	0x07C7A0A7, 0x78DF8765, 0x4129CF2B, 0x036C316E,
+	0x6C2E992F, 0x6C96D136, 0x49B05701, 0x343AC538,
+	0x73E4EEEF, 0x5803147C, 0x7D677932, 0x731C7727,
+	0x01BD374B,
+	0x1346AA50, 0x69F91CF4, 0x3E773350, 0x487A5301,
+	0x69FCF9D8, 0x788282F9, 0x73C418F1, 0x3A94DF9D,
+	0x233CD6D2, 0x2E9B8AB0, 0x7FE29702, 0x77B415B9,
+	0x1E6A339F, 0x4F67C77E, 0x55BDB484, 0x624CF0AB,
+	0x01FF9150,
+	0x0FE93BD2, 0x6A284532, 0x666F82C6, 0x1D19805E,
+	0x1E629295, 0x00CB496E, 0x6BEC534A, 0x5F8AC223,
+	0x7B75CEE4, 0x6E1A6717, 0x1DC08F6B, 0x36EAAF98,
+	0x4FE27574, 0x0225C7F7, 0x3DA8019D, 0x6A74BE78,
+	0x00632CD5,
+	0x58204462, 0x4BAE5C8E, 0x5131E881, 0x76298EDA,
+	0x0B80A108, 0x39083CC1, 0x17E16CD8, 0x4BCFCAB3,
+	0x4F250ECC, 0x4EBD3BE5, 0x0852076A, 0x21554007,
+	0x497EF055, 0x5C77A3DC, 0x1F84F0E3, 0x42DB552F,
+	0x01FBF4F6,
+	0x4C8060B2, 0x693F9DC6, 0x713AD239, 0x64B44AAF,
+	0x593552BD, 0x3405210F, 0x2D04E776, 0x5E21268D,
+	0x4E55E31D, 0x39960118, 0x50821C57, 0x0824004D,
+	0x04675843, 0x681CF838, 0x1E2BF2AF, 0x2241FC23,
+	0x016DE2AC,
+	0x203967F5, 0x2CE787EF, 0x569A5567, 0x38A31A38,
+	0x30CF9EF2, 0x1D7D9366, 0x365A29EF, 0x2FC38765,
+	0x02101533, 0x12A4C481, 0x691F056D, 0x7893D440,
+	0x34F4AE30, 0x656F67CF, 0x6B2DD6F6, 0x33D9B038,
+	0x0080A1FB,
+	0x21BF3964, 0x19542F04, 0x1E074909, 0x5321F8A7,
+	0x0AD203C8, 0x0292ECB1, 0x2A79E090, 0x33F70464,
+	0x1792BE05, 0x47DD2911, 0x608316BC, 0x309E7516,
+	0x4B5202BB, 0x54F3E45A, 0x0250EC2E, 0x501188E8,
+	0x00A21618,
+	0x694DFF17, 0x415CC50F, 0x7AEE917E, 0x029B2960,
+	0x6FD2781A, 0x744D21CD, 0x735DE2AC, 0x56C64AE5,
+	0x4B52509C, 0x764E5309, 0x4C3E4AA5, 0x20B61581,
+	0x2B39B6A1, 0x287F85B9, 0x5CBE50B9, 0x0FBD6F4D,
+	0x00CE3538
+};
+
 typedef struct {
 	const uint32_t *p;
 	const uint32_t *b;
 	const uint32_t *R2;
 	uint32_t p0i;
+	const uint32_t *gtab;
 } curve_params;
 
 static inline const curve_params *
 id_to_curve(int curve)
 {
 	static const curve_params pp[] = {
-		{ P256_P, P256_B, P256_R2, 0x00000001 },
-		{ P384_P, P384_B, P384_R2, 0x00000001 },
-		{ P521_P, P521_B, P521_R2, 0x00000001 }
+		{ P256_P, P256_B, P256_R2, 0x00000001, P256_GTAB },
+		{ P384_P, P384_B, P384_R2, 0x00000001, P384_GTAB },
+		{ P521_P, P521_B, P521_R2, 0x00000001, P521_GTAB }
 	};
 
 	return &pp[curve - BR_EC_secp256r1];
@@ -133,19 +896,65 @@ typedef struct {
 	uint32_t c[3][I31_LEN];
 } jacobian;
 
+/*
+ * Field operations shared by the interpreter and the compiled formulas:
+ * modular addition (d = d+a), modular subtraction (d = d-a), and
+ * inversion (d = 1/d, with a used as scratch; if d = 0, then it is
+ * left unchanged).
+ */
+static inline void
+mod_add(uint32_t *d, const uint32_t *a, const curve_params *cc)
+{
+	uint32_t ctl;
+
+	ctl = br_i31_add(d, a, 1);
+	ctl |= NOT(br_i31_sub(d, cc->p, 0));
+	br_i31_sub(d, cc->p, ctl);
+}
+
+static inline void
+mod_sub(uint32_t *d, const uint32_t *a, const curve_params *cc)
+{
+	br_i31_add(d, cc->p, br_i31_sub(d, a, 1));
+}
+
+static void
+mod_inv(uint32_t *d, uint32_t *a, const curve_params *cc)
+{
+	/*
+	 * Division of 1 by d; if d = 0, then the division fails and
+	 * leaves the 1 in d, which we then clear to 0.
+	 */
+	uint32_t tm[4 * I31_LEN];
+	uint32_t ctl;
+
+	memcpy(a, d, I31_LEN * sizeof(uint32_t));
+	br_i31_zero(d, cc->p[0]);
+	d[1] = 1;
+	ctl = br_i31_moddiv(d, a, cc->p, tm);
+	d[1] &= -ctl;
+}
+
+#if !BR_EC_COMPILED
+
 /*
  * We use a custom interpreter that uses a dozen registers, and
  * only four operations:
  *    MSET(d, a)       copy a into d
  *    MADD(d, a)       d = d+a (modular)
  *    MSUB(d, a)       d = d-a (modular)
- *    MMUL(d, a, b)    d = a*b (Montgomery multiplication)
+ *    MMUL(d, a, b)    d = a*b (Montgomery multiplication; a squaring
+ *                     if a and b are the same register)
  *    MINV(d, a, b)    invert d modulo p; a and b are used as scratch registers
  *    MTZ(d)           clear return value if d = 0
  * Destination of MMUL (d) must be distinct from operands (a and b).
  * There is no such constraint for MSUB and MADD.
  *
  * Registers include the operand coordinates, and temporaries.
+ *
+ * When BR_EC_COMPILED is set, the interpreter is not used; instead,
+ * the same sequences of operations are expanded into plain C functions
+ * (see further below).
  */
 #define MSET(d, a)      (0x0000 + ((d) << 8) + ((a) << 4))
 #define MADD(d, a)      (0x1000 + ((d) << 8) + ((a) << 4))
@@ -478,30 +1287,25 @@ run_code(jacobian *P1, const jacobian *P2,
 		b = op & 0x0F;
 		op >>= 12;
 		switch (op) {
-			uint32_t ctl;
-			size_t plen;
-			unsigned char tp[(BR_MAX_EC_SIZE + 7) >> 3];
-
 		case 0:
 			memcpy(t[d], t[a], I31_LEN * sizeof(uint32_t));
 			break;
 		case 1:
-			ctl = br_i31_add(t[d], t[a], 1);
-			ctl |= NOT(br_i31_sub(t[d], cc->p, 0));
-			br_i31_sub(t[d], cc->p, ctl);
+			mod_add(t[d], t[a], cc);
 			break;
 		case 2:
-			br_i31_add(t[d], cc->p, br_i31_sub(t[d], t[a], 1));
+			mod_sub(t[d], t[a], cc);
 			break;
 		case 3:
-			br_i31_montymul(t[d], t[a], t[b], cc->p, cc->p0i);
+			if (a == b) {
+				br_i31_montysqr(t[d], t[a], cc->p, cc->p0i);
+			} else {
+				br_i31_montymul(t[d], t[a], t[b],
+					cc->p, cc->p0i);
+			}
 			break;
 		case 4:
-			plen = (cc->p[0] - (cc->p[0] >> 5) + 7) >> 3;
-			br_i31_encode(tp, plen, cc->p);
-			tp[plen - 1] -= 2;
-			br_i31_modpow(t[d], tp, plen,
-				cc->p, cc->p0i, t[a], t[b]);
+			mod_inv(t[d], t[a], cc);
 			break;
 		default:
 			r &= ~br_i31_iszero(t[d]);
@@ -516,6 +1320,210 @@ run_code(jacobian *P1, const jacobian *P2,
 	return r;
 }
 
+#else
+
+/*
+ * Compiled versions of the formulas: this is the same sequence of
+ * operations as in the microcode (code_double, code_add, code_check
+ * and code_affine), written as straight-line C code, and working
+ * directly on the point coordinates (no dispatch, and no copy of the
+ * operands into registers). This is faster, but larger.
+ */
+
+static void
+comp_double(jacobian *P, const curve_params *cc)
+{
+	uint32_t t1[I31_LEN], t2[I31_LEN], t3[I31_LEN], t4[I31_LEN];
+
+	/*
+	 * Compute z^2 (in t1).
+	 */
+	br_i31_montysqr(t1, P->c[2], cc->p, cc->p0i);
+
+	/*
+	 * Compute x-z^2 (in t2) and then x+z^2 (in t1).
+	 */
+	memcpy(t2, P->c[0], I31_LEN * sizeof(uint32_t));
+	mod_sub(t2, t1, cc);
+	mod_add(t1, P->c[0], cc);
+
+	/*
+	 * Compute m = 3*(x+z^2)*(x-z^2) (in t1).
+	 */
+	br_i31_montymul(t3, t1, t2, cc->p, cc->p0i);
+	memcpy(t1, t3, I31_LEN * sizeof(uint32_t));
+	mod_add(t1, t3, cc);
+	mod_add(t1, t3, cc);
+
+	/*
+	 * Compute s = 4*x*y^2 (in t2) and 2*y^2 (in t3).
+	 */
+	br_i31_montysqr(t3, P->c[1], cc->p, cc->p0i);
+	mod_add(t3, t3, cc);
+	br_i31_montymul(t2, P->c[0], t3, cc->p, cc->p0i);
+	mod_add(t2, t2, cc);
+
+	/*
+	 * Compute x' = m^2 - 2*s.
+	 */
+	br_i31_montysqr(P->c[0], t1, cc->p, cc->p0i);
+	mod_sub(P->c[0], t2, cc);
+	mod_sub(P->c[0], t2, cc);
+
+	/*
+	 * Compute z' = 2*y*z.
+	 */
+	br_i31_montymul(t4, P->c[1], P->c[2], cc->p, cc->p0i);
+	memcpy(P->c[2], t4, I31_LEN * sizeof(uint32_t));
+	mod_add(P->c[2], t4, cc);
+
+	/*
+	 * Compute y' = m*(s - x') - 8*y^4. Note that we already have
+	 * 2*y^2 in t3.
+	 */
+	mod_sub(t2, P->c[0], cc);
+	br_i31_montymul(P->c[1], t1, t2, cc->p, cc->p0i);
+	br_i31_montysqr(t4, t3, cc->p, cc->p0i);
+	mod_sub(P->c[1], t4, cc);
+	mod_sub(P->c[1], t4, cc);
+}
+
+static uint32_t
+comp_add(jacobian *P1, const jacobian *P2, const curve_params *cc)
+{
+	uint32_t t1[I31_LEN], t2[I31_LEN], t3[I31_LEN], t4[I31_LEN];
+	uint32_t t5[I31_LEN], t6[I31_LEN], t7[I31_LEN];
+	uint32_t r;
+
+	r = 1;
+
+	/*
+	 * Compute u1 = x1*z2^2 (in t1) and s1 = y1*z2^3 (in t3).
+	 */
+	br_i31_montysqr(t3, P2->c[2], cc->p, cc->p0i);
+	br_i31_montymul(t1, P1->c[0], t3, cc->p, cc->p0i);
+	br_i31_montymul(t4, P2->c[2], t3, cc->p, cc->p0i);
+	br_i31_montymul(t3, P1->c[1], t4, cc->p, cc->p0i);
+
+	/*
+	 * Compute u2 = x2*z1^2 (in t2) and s2 = y2*z1^3 (in t4).
+	 */
+	br_i31_montysqr(t4, P1->c[2], cc->p, cc->p0i);
+	br_i31_montymul(t2, P2->c[0], t4, cc->p, cc->p0i);
+	br_i31_montymul(t5, P1->c[2], t4, cc->p, cc->p0i);
+	br_i31_montymul(t4, P2->c[1], t5, cc->p, cc->p0i);
+
+	/*
+	 * Compute h = u2 - u1 (in t2) and r = s2 - s1 (in t4).
+	 */
+	mod_sub(t2, t1, cc);
+	mod_sub(t4, t3, cc);
+
+	/*
+	 * Report cases where r = 0 through the returned flag.
+	 */
+	r &= ~br_i31_iszero(t4);
+
+	/*
+	 * Compute u1*h^2 (in t6) and h^3 (in t5).
+	 */
+	br_i31_montysqr(t7, t2, cc->p, cc->p0i);
+	br_i31_montymul(t6, t1, t7, cc->p, cc->p0i);
+	br_i31_montymul(t5, t7, t2, cc->p, cc->p0i);
+
+	/*
+	 * Compute x3 = r^2 - h^3 - 2*u1*h^2.
+	 * t1 and t7 can be used as scratch registers.
+	 */
+	br_i31_montysqr(P1->c[0], t4, cc->p, cc->p0i);
+	mod_sub(P1->c[0], t5, cc);
+	mod_sub(P1->c[0], t6, cc);
+	mod_sub(P1->c[0], t6, cc);
+
+	/*
+	 * Compute y3 = r*(u1*h^2 - x3) - s1*h^3.
+	 */
+	mod_sub(t6, P1->c[0], cc);
+	br_i31_montymul(P1->c[1], t4, t6, cc->p, cc->p0i);
+	br_i31_montymul(t1, t5, t3, cc->p, cc->p0i);
+	mod_sub(P1->c[1], t1, cc);
+
+	/*
+	 * Compute z3 = h*z1*z2.
+	 */
+	br_i31_montymul(t1, P1->c[2], P2->c[2], cc->p, cc->p0i);
+	br_i31_montymul(P1->c[2], t1, t2, cc->p, cc->p0i);
+	return r;
+}
+
+static uint32_t
+comp_check(jacobian *P1, const jacobian *P2, const curve_params *cc)
+{
+	uint32_t t1[I31_LEN], t2[I31_LEN];
+	uint32_t r;
+
+	r = 1;
+
+	/* Convert x and y to Montgomery representation. */
+	br_i31_montymul(t1, P1->c[0], P2->c[0], cc->p, cc->p0i);
+	br_i31_montymul(t2, P1->c[1], P2->c[0], cc->p, cc->p0i);
+	memcpy(P1->c[0], t1, I31_LEN * sizeof(uint32_t));
+	memcpy(P1->c[1], t2, I31_LEN * sizeof(uint32_t));
+
+	/* Compute x^3 in t1. */
+	br_i31_montysqr(t2, P1->c[0], cc->p, cc->p0i);
+	br_i31_montymul(t1, P1->c[0], t2, cc->p, cc->p0i);
+
+	/* Subtract 3*x from t1. */
+	mod_sub(t1, P1->c[0], cc);
+	mod_sub(t1, P1->c[0], cc);
+	mod_sub(t1, P1->c[0], cc);
+
+	/* Add b. */
+	mod_add(t1, P2->c[1], cc);
+
+	/* Compute y^2 in t2. */
+	br_i31_montysqr(t2, P1->c[1], cc->p, cc->p0i);
+
+	/* Compare y^2 with x^3 - 3*x + b; they must match. */
+	mod_sub(t1, t2, cc);
+	r &= ~br_i31_iszero(t1);
+
+	/* Set z to 1 (in Montgomery representation). */
+	br_i31_montymul(P1->c[2], P2->c[0], P2->c[2], cc->p, cc->p0i);
+	return r;
+}
+
+static void
+comp_affine(jacobian *P1, const jacobian *P2, const curve_params *cc)
+{
+	uint32_t t1[I31_LEN], t2[I31_LEN], t3[I31_LEN];
+
+	/* Save z*R in t1. */
+	memcpy(t1, P1->c[2], I31_LEN * sizeof(uint32_t));
+
+	/* Compute z^3 in t2. */
+	br_i31_montysqr(t2, P1->c[2], cc->p, cc->p0i);
+	br_i31_montymul(t3, P1->c[2], t2, cc->p, cc->p0i);
+	br_i31_montymul(t2, t3, P2->c[2], cc->p, cc->p0i);
+
+	/* Invert to (1/z^3) in t2. */
+	mod_inv(t2, t3, cc);
+
+	/* Compute y. */
+	memcpy(t3, P1->c[1], I31_LEN * sizeof(uint32_t));
+	br_i31_montymul(P1->c[1], t2, t3, cc->p, cc->p0i);
+
+	/* Compute (1/z^2) in t3. */
+	br_i31_montymul(t3, t2, t1, cc->p, cc->p0i);
+
+	/* Compute x. */
+	memcpy(t2, P1->c[0], I31_LEN * sizeof(uint32_t));
+	br_i31_montymul(P1->c[0], t2, t3, cc->p, cc->p0i);
+}
+
+#endif
+
 static void
 set_one(uint32_t *x, const uint32_t *p)
 {
@@ -537,13 +1545,41 @@ point_zero(jacobian *P, const curve_params *cc)
 static inline void
 point_double(jacobian *P, const curve_params *cc)
 {
+#if BR_EC_COMPILED
+	comp_double(P, cc);
+#else
 	run_code(P, P, cc, code_double);
+#endif
 }
 
 static inline uint32_t
 point_add(jacobian *P1, const jacobian *P2, const curve_params *cc)
 {
+#if BR_EC_COMPILED
+	return comp_add(P1, P2, cc);
+#else
 	return run_code(P1, P2, cc, code_add);
+#endif
+}
+
+static inline uint32_t
+point_check(jacobian *P1, const jacobian *P2, const curve_params *cc)
+{
+#if BR_EC_COMPILED
+	return comp_check(P1, P2, cc);
+#else
+	return run_code(P1, P2, cc, code_check);
+#endif
+}
+
+static inline void
+point_affine(jacobian *P1, const jacobian *P2, const curve_params *cc)
+{
+#if BR_EC_COMPILED
+	comp_affine(P1, P2, cc);
+#else
+	run_code(P1, P2, cc, code_affine);
+#endif
 }
 
 static void
@@ -599,6 +1635,189 @@ point_mul(jacobian *P, const unsigned char *x, size_t xlen,
 	memcpy(P, &Q, sizeof Q);
 }
 
+/*
+ * Point addition P1 = P1 + P2 that handles all special cases (either
+ * operand is infinity, P1 = P2, P1 = -P2) with explicit tests. This
+ * is NOT constant-time; it must be used only on public data.
+ */
+static void
+point_add_vartime(jacobian *P1, const jacobian *P2, const curve_params *cc)
+{
+	if (br_i31_iszero(P2->c[2])) {
+		return;
+	}
+	if (br_i31_iszero(P1->c[2])) {
+		memcpy(P1, P2, sizeof *P2);
+		return;
+	}
+	if (!point_add(P1, P2, cc) && br_i31_iszero(P1->c[2])) {
+		/*
+		 * P1 = P2, hence we must double.
+		 */
+		memcpy(P1, P2, sizeof *P2);
+		point_double(P1, cc);
+	}
+}
+
+/*
+ * Get byte i of a big-endian integer x of length xlen, left-padded
+ * with zeros to length len (len >= xlen).
+ */
+static inline unsigned
+get_byte(const unsigned char *x, size_t xlen, size_t len, size_t i)
+{
+	return i < len - xlen ? 0 : x[i - (len - xlen)];
+}
+
+/*
+ * Compute P = x*P + y*Q, with an interleaved (Straus-Shamir)
+ * double-and-add ladder: a single sequence of doublings is shared
+ * between both multipliers, and each 2-bit window of x and y (taken
+ * together) selects one addition with a point from a table of the 15
+ * combinations i*P + j*Q (0 <= i, j <= 3). This uses about half the
+ * work of two separate point_mul() calls.
+ *
+ * This function is NOT constant-time: it is meant for operations on
+ * public data (e.g. ECDSA signature verification).
+ */
+static void
+point_muladd_vartime(jacobian *P, const jacobian *Q,
+	const unsigned char *x, size_t xlen,
+	const unsigned char *y, size_t ylen, const curve_params *cc)
+{
+	jacobian W[16], R;
+	size_t len, u;
+	int i, j;
+
+	/*
+	 * W[i + 4*j] = i*P + j*Q (W[0] is unused).
+	 */
+	memcpy(&W[1], P, sizeof *P);
+	memcpy(&W[2], P, sizeof *P);
+	point_double(&W[2], cc);
+	memcpy(&W[3], &W[2], sizeof *P);
+	point_add_vartime(&W[3], P, cc);
+	memcpy(&W[4], Q, sizeof *Q);
+	memcpy(&W[8], Q, sizeof *Q);
+	point_double(&W[8], cc);
+	memcpy(&W[12], &W[8], sizeof *Q);
+	point_add_vartime(&W[12], Q, cc);
+	for (j = 4; j < 16; j += 4) {
+		for (i = 1; i < 4; i ++) {
+			memcpy(&W[i + j], &W[j], sizeof *P);
+			point_add_vartime(&W[i + j], &W[i], cc);
+		}
+	}
+
+	len = xlen > ylen ? xlen : ylen;
+	point_zero(&R, cc);
+	for (u = 0; u < len; u ++) {
+		unsigned bx, by;
+		int k;
+
+		bx = get_byte(x, xlen, len, u);
+		by = get_byte(y, ylen, len, u);
+		for (k = 6; k >= 0; k -= 2) {
+			unsigned idx;
+
+			point_double(&R, cc);
+			point_double(&R, cc);
+			idx = ((bx >> k) & 3) | (((by >> k) & 3) << 2);
+			if (idx != 0) {
+				point_add_vartime(&R, &W[idx], cc);
+			}
+		}
+	}
+	memcpy(P, &R, sizeof R);
+}
+
+/*
+ * Number of teeth in the comb used by point_mulgen().
+ */
+#define COMB_W   5
+
+static void
+point_mulgen(jacobian *P, const unsigned char *x, size_t xlen,
+	const curve_params *cc)
+{
+	/*
+	 * We use a fixed-base comb with COMB_W teeth. The multiplier is
+	 * split into COMB_W chunks of d bits each (d = ceil(n/COMB_W),
+	 * where n is the field modulus bit length, which is also the
+	 * order bit length for all supported curves). At each step, we
+	 * gather one bit from each chunk (the bits at the same position
+	 * in all chunks) into a COMB_W-bit index, and add the
+	 * corresponding precomputed point; this needs only d doublings
+	 * and d additions overall.
+	 *
+	 * Table lookups read all entries, so that the memory access
+	 * pattern does not depend on the multiplier.
+	 *
+	 * Since the multiplier is lower than the curve order, partial
+	 * sums are always lower than the order as well, and the
+	 * addition never has to handle the P = Q or P = -Q cases. The
+	 * point at infinity is handled with a flag, as in point_mul().
+	 */
+	uint32_t nbits, d, qz;
+	size_t len, elen;
+	int j;
+	jacobian Q, T, U;
+
+	nbits = cc->p[0] - (cc->p[0] >> 5);
+	d = (nbits + COMB_W - 1) / COMB_W;
+	len = (cc->p[0] + 31) >> 5;
+	elen = len << 1;
+
+	point_zero(&T, cc);
+	set_one(Q.c[0], cc->p);
+	br_i31_montymul(T.c[2], cc->R2, Q.c[0], cc->p, cc->p0i);
+
+	point_zero(&Q, cc);
+	qz = 1;
+	for (j = (int)d - 1; j >= 0; j --) {
+		const uint32_t *tab;
+		uint32_t idx, bnz;
+		int k;
+		size_t u;
+
+		point_double(&Q, cc);
+
+		idx = 0;
+		for (k = 0; k < COMB_W; k ++) {
+			uint32_t bp;
+			size_t v;
+
+			bp = (uint32_t)k * d + (uint32_t)j;
+			v = bp >> 3;
+			if (v < xlen) {
+				idx |= ((x[xlen - 1 - v] >> (bp & 7)) & 1) << k;
+			}
+		}
+
+		memset(&T.c[0][1], 0, len * sizeof(uint32_t));
+		memset(&T.c[1][1], 0, len * sizeof(uint32_t));
+		tab = cc->gtab;
+		for (k = 1; k < (1 << COMB_W); k ++) {
+			uint32_t m;
+
+			m = -EQ(idx, k);
+			for (u = 0; u < len; u ++) {
+				T.c[0][1 + u] |= m & tab[u];
+				T.c[1][1 + u] |= m & tab[len + u];
+			}
+			tab += elen;
+		}
+
+		memcpy(&U, &Q, sizeof U);
+		point_add(&U, &T, cc);
+		bnz = NEQ(idx, 0);
+		CCOPY(bnz & qz, &Q, &T, sizeof Q);
+		CCOPY(bnz & ~qz, &Q, &U, sizeof Q);
+		qz &= ~bnz;
+	}
+	memcpy(P, &Q, sizeof Q);
+}
+
 /*
  * Decode point into Jacobian coordinates. This function does not support
  * the point at infinity. If the point is invalid then this returns 0, but
@@ -654,7 +1873,7 @@ point_decode(jacobian *P, const void *src, size_t len, const curve_params *cc)
 	memcpy(Q.c[0], cc->R2, zlen);
 	memcpy(Q.c[1], cc->b, zlen);
 	set_one(Q.c[2], cc->p);
-	r &= ~run_code(P, &Q, cc, code_check);
+	r &= ~point_check(P, &Q, cc);
 	return r;
 }
 
@@ -678,7 +1897,7 @@ point_encode(void *dst, const jacobian *P, const curve_params *cc)
 	buf[0] = 0x04;
 	memcpy(&Q, P, sizeof *P);
 	set_one(T.c[2], cc->p);
-	run_code(&Q, &T, cc, code_affine);
+	point_affine(&Q, &T, cc);
 	br_i31_encode(buf + 1, plen, Q.c[0]);
 	br_i31_encode(buf + 1 + plen, plen, Q.c[1]);
 }
@@ -717,6 +1936,14 @@ api_order(int curve, size_t *len)
 	return cd->order;
 }
 
+static size_t
+api_xoff(int curve, size_t *len)
+{
+	api_generator(curve, len);
+	*len >>= 1;
+	return 1;
+}
+
 static uint32_t
 api_mul(unsigned char *G, size_t Glen,
 	const unsigned char *x, size_t xlen, int curve)
@@ -732,52 +1959,39 @@ api_mul(unsigned char *G, size_t Glen,
 	return r;
 }
 
+static size_t
+api_mulgen(unsigned char *R,
+	const unsigned char *x, size_t xlen, int curve)
+{
+	const curve_params *cc;
+	jacobian P;
+
+	cc = id_to_curve(curve);
+	point_mulgen(&P, x, xlen, cc);
+	point_encode(R, &P, cc);
+	return id_to_curve_def(curve)->generator_len;
+}
+
 static uint32_t
 api_muladd(unsigned char *A, const unsigned char *B, size_t len,
 	const unsigned char *x, size_t xlen,
 	const unsigned char *y, size_t ylen, int curve)
 {
-	uint32_t r, t, z;
+	uint32_t r;
 	const curve_params *cc;
 	jacobian P, Q;
 
-	/*
-	 * TODO: see about merging the two ladders. Right now, we do
-	 * two independant point multiplications, which is a bit
-	 * wasteful of CPU resources (but yields short code).
-	 */
-
 	cc = id_to_curve(curve);
 	r = point_decode(&P, A, len, cc);
 	r &= point_decode(&Q, B, len, cc);
-	point_mul(&P, x, xlen, cc);
-	point_mul(&Q, y, ylen, cc);
+	point_muladd_vartime(&P, &Q, x, xlen, y, ylen, cc);
 
 	/*
-	 * We want to compute P+Q. Since the base points A and B are distinct
-	 * from infinity, and the multipliers are non-zero and lower than the
-	 * curve order, then we know that P and Q are non-infinity. This
-	 * leaves two special situations to test for:
-	 * -- If P = Q then we must use point_double().
-	 * -- If P+Q = 0 then we must report an error.
+	 * The result may be infinity only if x*A+y*B = 0, which we
+	 * report as an error.
 	 */
-	t = point_add(&P, &Q, cc);
-	point_double(&Q, cc);
-	z = br_i31_iszero(P.c[2]);
-
-	/*
-	 * If z is 1 then either P+Q = 0 (t = 1) or P = Q (t = 0). So we
-	 * have the following:
-	 *
-	 *   z = 0, t = 0   return P (normal addition)
-	 *   z = 0, t = 1   return P (normal addition)
-	 *   z = 1, t = 0   return Q (a 'double' case)
-	 *   z = 1, t = 1   report an error (P+Q = 0)
-	 */
-	CCOPY(z & ~t, &P, &Q, sizeof Q);
+	r &= ~br_i31_iszero(P.c[2]);
 	point_encode(A, &P, cc);
-	r &= ~(z & t);
-
 	return r;
 }
 
@@ -786,6 +2000,8 @@ const br_ec_impl br_ec_prime_i31 = {
 	(uint32_t)0x03800000,
 	&api_generator,
 	&api_order,
+	&api_xoff,
 	&api_mul,
+	&api_mulgen,
 	&api_muladd
 };
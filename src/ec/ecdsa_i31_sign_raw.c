@@ -43,7 +43,7 @@ br_ecdsa_i31_sign_raw(const br_ec_impl *impl,
 	 */
 	const br_ec_curve_def *cd;
 	uint32_t n[I31_LEN], r[I31_LEN], s[I31_LEN], x[I31_LEN];
-	uint32_t m[I31_LEN], k[I31_LEN], t1[I31_LEN], t2[I31_LEN];
+	uint32_t m[I31_LEN], k[I31_LEN], t1[I31_LEN], tm[4 * I31_LEN];
 	unsigned char tt[ORDER_LEN << 1];
 	unsigned char eU[POINT_LEN];
 	size_t hash_len, nlen, ulen;
@@ -126,14 +126,11 @@ br_ecdsa_i31_sign_raw(const br_ec_impl *impl,
 	 * a subtraction.
 	 */
 	ulen = cd->generator_len;
-	memcpy(eU, cd->generator, ulen);
 	br_i31_encode(tt, nlen, k);
-	if (!impl->mul(eU, ulen, tt, nlen, sk->curve)) {
+	if (impl->mulgen(eU, tt, nlen, sk->curve) != ulen) {
 		/*
 		 * Point multiplication may fail here only if the
-		 * EC implementation does not support the curve, or the
-		 * private key is incorrect (x is a multiple of the curve
-		 * order).
+		 * EC implementation does not support the curve.
 		 */
 		return 0;
 	}
@@ -145,13 +142,15 @@ br_ecdsa_i31_sign_raw(const br_ec_impl *impl,
 	/*
 	 * Compute 1/k in double-Montgomery representation. We do so by
 	 * first converting _from_ Montgomery representation (twice),
-	 * then using a modular exponentiation.
+	 * then using a modular division of 1 by the result. Since k is
+	 * not zero and n is prime, the division cannot fail.
 	 */
 	br_i31_from_monty(k, n, n0i);
 	br_i31_from_monty(k, n, n0i);
-	memcpy(tt, cd->order, nlen);
-	tt[nlen - 1] -= 2;
-	br_i31_modpow(k, tt, nlen, n, n0i, t1, t2);
+	br_i31_zero(t1, n[0]);
+	t1[1] = 1;
+	br_i31_moddiv(t1, k, n, tm);
+	memcpy(k, t1, sizeof t1);
 
 	/*
 	 * Compute s = (m+xr)/k (mod n).
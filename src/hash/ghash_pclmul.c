@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This is the GHASH implementation that leverages the pclmulqdq opcode
+ * (from the AES-NI instructions).
+ *
+ * Each 16-byte block is byte-swapped on input, so that the polynomial
+ * coefficients appear in reverse bit order in the 128-bit registers.
+ * Carry-less multiplication of two such values yields the bit-reversed
+ * product, shifted by one bit; the final reduction then uses the
+ * "reflected" variant of the GCM polynomial.
+ *
+ * Data is processed by chunks of four blocks: with powers H, H^2, H^3
+ * and H^4 of the key precomputed, we compute:
+ *   y' = ((y + x0)*H^4) + (x1*H^3) + (x2*H^2) + (x3*H)
+ * Since products are linear over GF(2), the four 256-bit products are
+ * simply XORed together, and a single shift and reduction is performed
+ * for the whole chunk.
+ */
+
+#if BR_AES_X86NI
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "ghash_pclmul.h"
+
+/* see bearssl_hash.h */
+br_ghash
+br_ghash_pclmul_get(void)
+{
+	/*
+	 * Bit mask for features in ECX:
+	 *    1   PCLMULQDQ
+	 *    9   SSSE3
+	 * Bit mask for features in EDX:
+	 *   26   SSE2
+	 */
+	return br_cpuid(0, 0, 0x00000202, 0x04000000)
+		? &br_ghash_pclmul : 0;
+}
+
+/* see bearssl_hash.h */
+BR_TARGET("ssse3,pclmul")
+void
+br_ghash_pclmul(void *y, const void *h, const void *data, size_t len)
+{
+	const unsigned char *buf;
+	__m128i yw, h1w, h2w, h3w, h4w;
+	__m128i h1k, h2k, h3k, h4k;
+	__m128i byteswap_index;
+
+	byteswap_index = _mm_set_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	yw = _mm_shuffle_epi8(_mm_loadu_si128(y), byteswap_index);
+	h1w = _mm_shuffle_epi8(_mm_loadu_si128(h), byteswap_index);
+	h1k = kara_fold(h1w);
+	buf = data;
+
+	if (len >= 64) {
+		h2w = gmul(h1w, h1w);
+		h3w = gmul(h2w, h1w);
+		h4w = gmul(h2w, h2w);
+		h2k = kara_fold(h2w);
+		h3k = kara_fold(h3w);
+		h4k = kara_fold(h4w);
+		while (len >= 64) {
+			__m128i x0, x1, x2, x3;
+			__m128i lo, mid, hi;
+
+			x0 = _mm_shuffle_epi8(
+				_mm_loadu_si128((const void *)(buf +  0)),
+				byteswap_index);
+			x1 = _mm_shuffle_epi8(
+				_mm_loadu_si128((const void *)(buf + 16)),
+				byteswap_index);
+			x2 = _mm_shuffle_epi8(
+				_mm_loadu_si128((const void *)(buf + 32)),
+				byteswap_index);
+			x3 = _mm_shuffle_epi8(
+				_mm_loadu_si128((const void *)(buf + 48)),
+				byteswap_index);
+			x0 = _mm_xor_si128(x0, yw);
+			lo = _mm_setzero_si128();
+			mid = _mm_setzero_si128();
+			hi = _mm_setzero_si128();
+			PMUL_KARA(lo, mid, hi, x0, h4w, kara_fold(x0), h4k);
+			PMUL_KARA(lo, mid, hi, x1, h3w, kara_fold(x1), h3k);
+			PMUL_KARA(lo, mid, hi, x2, h2w, kara_fold(x2), h2k);
+			PMUL_KARA(lo, mid, hi, x3, h1w, kara_fold(x3), h1k);
+			yw = pmul_finish(lo, mid, hi);
+			buf += 64;
+			len -= 64;
+		}
+	}
+
+	while (len > 0) {
+		__m128i x, lo, mid, hi;
+
+		if (len >= 16) {
+			x = _mm_loadu_si128((const void *)buf);
+			buf += 16;
+			len -= 16;
+		} else {
+			unsigned char tmp[16];
+
+			memcpy(tmp, buf, len);
+			memset(tmp + len, 0, (sizeof tmp) - len);
+			x = _mm_loadu_si128((void *)tmp);
+			len = 0;
+		}
+		x = _mm_xor_si128(yw, _mm_shuffle_epi8(x, byteswap_index));
+		lo = _mm_setzero_si128();
+		mid = _mm_setzero_si128();
+		hi = _mm_setzero_si128();
+		PMUL_KARA(lo, mid, hi, x, h1w, kara_fold(x), h1k);
+		yw = pmul_finish(lo, mid, hi);
+	}
+
+	_mm_storeu_si128(y, _mm_shuffle_epi8(yw, byteswap_index));
+}
+
+#else
+
+/* see bearssl_hash.h */
+br_ghash
+br_ghash_pclmul_get(void)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Field multiplication for GHASH with the pclmulqdq opcode, shared by
+ * ghash_pclmul.c and the AES/GCM kernel (aes_x86ni_gcm.c). Field
+ * elements are byte-swapped 128-bit values (see ghash_pclmul.c). This
+ * file must be included after <emmintrin.h>, <tmmintrin.h> and
+ * <wmmintrin.h>, and the functions below may be used only in functions
+ * compiled for the "pclmul" target (see BR_TARGET()).
+ */
+
+/*
+ * Unreduced 256-bit product: lo, hi and Karatsuba middle word. The
+ * middle word is kept separate so that accumulation over several
+ * products costs only three XORs each.
+ */
+#define PMUL_KARA(lo, mid, hi, a, b, ak, bk)   do { \
+		lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00)); \
+		hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11)); \
+		mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(ak, bk, 0x00)); \
+	} while (0)
+
+/*
+ * Get the XOR of the two 64-bit halves of x (in the low word); this is
+ * the operand for the Karatsuba middle multiplication.
+ */
+BR_TARGET("sse2")
+static inline __m128i
+kara_fold(__m128i x)
+{
+	return _mm_xor_si128(x, _mm_shuffle_epi32(x, 0x0E));
+}
+
+/*
+ * Assemble the 256-bit product from the three Karatsuba values,
+ * shift it left by one bit (to account for the bit reversal), and
+ * reduce it modulo the GCM polynomial.
+ */
+BR_TARGET("sse2")
+static inline __m128i
+pmul_finish(__m128i lo, __m128i mid, __m128i hi)
+{
+	__m128i x0, x1, t0, t1, t2;
+
+	/*
+	 * Middle word: remove lo and hi contributions, then split it
+	 * across the two halves of the product. The product is then
+	 * hi:lo, with 'hi' holding the upper 128 bits.
+	 */
+	mid = _mm_xor_si128(mid, _mm_xor_si128(lo, hi));
+	x0 = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+	x1 = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+	/*
+	 * Shift the 256-bit value x1:x0 left by one bit.
+	 */
+	t0 = _mm_srli_epi64(x0, 63);
+	t1 = _mm_srli_epi64(x1, 63);
+	x0 = _mm_slli_epi64(x0, 1);
+	x1 = _mm_slli_epi64(x1, 1);
+	x1 = _mm_or_si128(x1, _mm_slli_si128(t1, 8));
+	x1 = _mm_or_si128(x1, _mm_srli_si128(t0, 8));
+	x0 = _mm_or_si128(x0, _mm_slli_si128(t0, 8));
+
+	/*
+	 * Reduction. We first fold the lowest 64-bit word into the
+	 * second one (multiplication by x^63 + x^62 + x^57), then the
+	 * two low words are added into the high ones, with shifts by
+	 * 1, 2 and 7 bits. This is the same algorithm as in
+	 * ghash_ctmul64.c, with two 64-bit lanes.
+	 */
+	t0 = _mm_slli_epi64(x0, 63);
+	t1 = _mm_slli_epi64(x0, 62);
+	t2 = _mm_slli_epi64(x0, 57);
+	t0 = _mm_xor_si128(t0, _mm_xor_si128(t1, t2));
+	x0 = _mm_xor_si128(x0, _mm_slli_si128(t0, 8));
+	t0 = _mm_srli_epi64(x0, 1);
+	t1 = _mm_srli_epi64(x0, 2);
+	t2 = _mm_srli_epi64(x0, 7);
+	x1 = _mm_xor_si128(x1, x0);
+	x1 = _mm_xor_si128(x1, _mm_xor_si128(t0, _mm_xor_si128(t1, t2)));
+	t0 = _mm_slli_epi64(x0, 63);
+	t1 = _mm_slli_epi64(x0, 62);
+	t2 = _mm_slli_epi64(x0, 57);
+	t0 = _mm_xor_si128(t0, _mm_xor_si128(t1, t2));
+	x1 = _mm_xor_si128(x1, _mm_srli_si128(t0, 8));
+	return x1;
+}
+
+/*
+ * Multiply two field elements (in reversed representation).
+ */
+BR_TARGET("sse2,pclmul")
+static inline __m128i
+gmul(__m128i a, __m128i b)
+{
+	__m128i lo, mid, hi;
+
+	lo = _mm_setzero_si128();
+	mid = _mm_setzero_si128();
+	hi = _mm_setzero_si128();
+	PMUL_KARA(lo, mid, hi, a, b, kara_fold(a), kara_fold(b));
+	return pmul_finish(lo, mid, hi);
+}
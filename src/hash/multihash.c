@@ -87,6 +87,7 @@ br_multihash_init(br_multihash_context *ctx)
 	int i;
 
 	ctx->count = 0;
+	ctx->dropped = 0;
 	for (i = 1; i <= 6; i ++) {
 		const br_hash_class *hc;
 
@@ -101,6 +102,13 @@ br_multihash_init(br_multihash_context *ctx)
 	}
 }
 
+/* see bearssl_hash.h */
+void
+br_multihash_restrict(br_multihash_context *ctx, unsigned keep)
+{
+	ctx->dropped |= (uint32_t)~keep & 0x7E;
+}
+
 /* see bearssl_hash.h */
 void
 br_multihash_update(br_multihash_context *ctx, const void *data, size_t len)
@@ -129,7 +137,7 @@ br_multihash_update(br_multihash_context *ctx, const void *data, size_t len)
 				const br_hash_class *hc;
 
 				hc = ctx->impl[i - 1];
-				if (hc != NULL) {
+				if (hc != NULL && !((ctx->dropped >> i) & 1)) {
 					gen_hash_context g;
 					unsigned char *state;
 
@@ -155,7 +163,7 @@ br_multihash_out(const br_multihash_context *ctx, int id, void *dst)
 	const unsigned char *state;
 
 	hc = ctx->impl[id - 1];
-	if (hc == NULL) {
+	if (hc == NULL || ((ctx->dropped >> id) & 1)) {
 		return 0;
 	}
 	state = (const unsigned char *)ctx + get_state_offset(id);
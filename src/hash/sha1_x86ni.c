@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This code implements SHA-1 with the x86 SHA extensions (sha1rnds4,
+ * sha1nexte, sha1msg1 and sha1msg2 opcodes). Context structure and
+ * state encoding are identical to those of the portable implementation
+ * (sha1.c), so that contexts and saved states can be exchanged between
+ * both implementations.
+ */
+
+#if BR_SHA_X86NI
+
+#include <immintrin.h>
+
+#include "sha_x86ni.h"
+
+static int
+supported(void)
+{
+	/*
+	 * Bit mask for features in ECX:
+	 *    9   SSSE3
+	 *   19   SSE4.1
+	 * Bit mask for features in EDX:
+	 *   26   SSE2
+	 * Bit mask for features in EBX (leaf 7):
+	 *   29   SHA
+	 */
+	return br_cpuid(0, 0, 0x00080200, 0x04000000)
+		&& br_cpuid7(0x20000000, 0);
+}
+
+/*
+ * Process num consecutive 64-byte blocks.
+ */
+BR_TARGET("ssse3,sse4.1,sha")
+static void
+sha1_x86ni_blocks(uint32_t *val, const unsigned char *buf, size_t num)
+{
+	__m128i abcd, abcd_save, abcd_prev, e0, e, bswap;
+	__m128i m[4];
+
+	/*
+	 * The opcodes expect A in the upper word of the register, and E
+	 * alone in the upper word of another register. Input words are
+	 * big-endian.
+	 */
+	abcd = _mm_loadu_si128((const __m128i *)val);
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	e0 = _mm_set_epi32((int)val[4], 0, 0, 0);
+	bswap = _mm_set_epi64x(0x0001020304050607, 0x08090A0B0C0D0E0F);
+
+	while (num -- > 0) {
+		abcd_save = abcd;
+		m[0] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(buf +  0)), bswap);
+		m[1] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(buf + 16)), bswap);
+		m[2] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(buf + 32)), bswap);
+		m[3] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(buf + 48)), bswap);
+
+		SHA1_ROUNDS4( 0, 0);
+		SHA1_ROUNDS4( 1, 0);
+		SHA1_ROUNDS4( 2, 0);
+		SHA1_ROUNDS4( 3, 0);
+		SHA1_ROUNDS4( 4, 0);
+		SHA1_ROUNDS4( 5, 1);
+		SHA1_ROUNDS4( 6, 1);
+		SHA1_ROUNDS4( 7, 1);
+		SHA1_ROUNDS4( 8, 1);
+		SHA1_ROUNDS4( 9, 1);
+		SHA1_ROUNDS4(10, 2);
+		SHA1_ROUNDS4(11, 2);
+		SHA1_ROUNDS4(12, 2);
+		SHA1_ROUNDS4(13, 2);
+		SHA1_ROUNDS4(14, 2);
+		SHA1_ROUNDS4(15, 3);
+		SHA1_ROUNDS4(16, 3);
+		SHA1_ROUNDS4(17, 3);
+		SHA1_ROUNDS4(18, 3);
+		SHA1_ROUNDS4(19, 3);
+
+		/*
+		 * sha1nexte computes the rotated A value from the state
+		 * before the last four rounds, and adds it to the saved E.
+		 */
+		e0 = _mm_sha1nexte_epu32(abcd_prev, e0);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+		buf += 64;
+	}
+
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	_mm_storeu_si128((__m128i *)val, abcd);
+	val[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+/* see bearssl_hash.h */
+void
+br_sha1_x86ni_init(br_sha1_context *cc)
+{
+	cc->vtable = &br_sha1_x86ni_vtable;
+	memcpy(cc->val, br_sha1_IV, sizeof cc->val);
+	cc->count = 0;
+}
+
+/* see bearssl_hash.h */
+void
+br_sha1_x86ni_update(br_sha1_context *cc, const void *data, size_t len)
+{
+	const unsigned char *buf;
+	size_t ptr, num;
+
+	buf = data;
+	ptr = (size_t)cc->count & 63;
+	cc->count += (uint64_t)len;
+	if (ptr != 0) {
+		size_t clen;
+
+		clen = 64 - ptr;
+		if (clen > len) {
+			clen = len;
+		}
+		memcpy(cc->buf + ptr, buf, clen);
+		ptr += clen;
+		buf += clen;
+		len -= clen;
+		if (ptr < 64) {
+			return;
+		}
+		sha1_x86ni_blocks(cc->val, cc->buf, 1);
+	}
+
+	/*
+	 * Full blocks are processed directly from the source buffer.
+	 */
+	num = len >> 6;
+	if (num > 0) {
+		sha1_x86ni_blocks(cc->val, buf, num);
+		buf += num << 6;
+		len &= 63;
+	}
+	memcpy(cc->buf, buf, len);
+}
+
+/* see bearssl_hash.h */
+void
+br_sha1_x86ni_out(const br_sha1_context *cc, void *dst)
+{
+	unsigned char buf[128];
+	uint32_t val[5];
+	size_t ptr, num;
+
+	ptr = (size_t)cc->count & 63;
+	memcpy(buf, cc->buf, ptr);
+	memcpy(val, cc->val, sizeof val);
+	buf[ptr ++] = 0x80;
+	num = (ptr > 56) ? 2 : 1;
+	memset(buf + ptr, 0, (num << 6) - 8 - ptr);
+	br_enc64be(buf + (num << 6) - 8, cc->count << 3);
+	sha1_x86ni_blocks(val, buf, num);
+	br_range_enc32be(dst, val, 5);
+}
+
+/* see bearssl_hash.h */
+const br_hash_class br_sha1_x86ni_vtable = {
+	sizeof(br_sha1_context),
+	BR_HASHDESC_ID(br_sha1_ID)
+		| BR_HASHDESC_OUT(20)
+		| BR_HASHDESC_STATE(20)
+		| BR_HASHDESC_LBLEN(6)
+		| BR_HASHDESC_MD_PADDING
+		| BR_HASHDESC_MD_PADDING_BE,
+	(void (*)(const br_hash_class **))&br_sha1_x86ni_init,
+	(void (*)(const br_hash_class **,
+		const void *, size_t))&br_sha1_x86ni_update,
+	(void (*)(const br_hash_class *const *, void *))&br_sha1_x86ni_out,
+	(uint64_t (*)(const br_hash_class *const *, void *))&br_sha1_state,
+	(void (*)(const br_hash_class **, const void *, uint64_t))
+		&br_sha1_set_state
+};
+
+/* see bearssl_hash.h */
+const br_hash_class *
+br_sha1_x86ni_get_vtable(void)
+{
+	return supported() ? &br_sha1_x86ni_vtable : NULL;
+}
+
+#else
+
+/* see bearssl_hash.h */
+const br_hash_class *
+br_sha1_x86ni_get_vtable(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * Maximum number of lanes supported by br_sha256_mb_update(); this
+ * must be at least as large as the 'lanes' field of all
+ * implementations.
+ */
+#define MAX_LANES   8
+
+/* see bearssl_hash.h */
+void
+br_sha256_mb_portable_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num)
+{
+	size_t u;
+
+	for (u = 0; u < num; u ++) {
+		br_sha2small_round(buf[u], val[u]);
+	}
+}
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl br_sha256_mb_portable = {
+	1,
+	&br_sha256_mb_portable_run
+};
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl *
+br_sha256_mb_get_default(void)
+{
+	const br_sha256_mb_impl *impl;
+
+	impl = br_sha256_mb_x86ni_get();
+	if (impl == NULL) {
+		impl = br_sha256_mb_avx2_get();
+	}
+	if (impl == NULL) {
+		impl = br_sha256_mb_sse2_get();
+	}
+	if (impl == NULL) {
+		impl = &br_sha256_mb_portable;
+	}
+	return impl;
+}
+
+/*
+ * Process up to impl->lanes contexts. Each round of the loop gathers
+ * the next complete block of every context that has one, either
+ * directly from the input data, or from the context buffer when some
+ * bytes were already buffered; these blocks are then processed in
+ * parallel. Since all contexts receive the same number of bytes, they
+ * run out of complete blocks within one round of each other.
+ */
+static void
+mb_update_group(const br_sha256_mb_impl *impl,
+	br_sha256_context *const *ctx, const void *const *data,
+	size_t len, size_t num)
+{
+	size_t pos[MAX_LANES];
+	uint32_t *val[MAX_LANES];
+	const unsigned char *blk[MAX_LANES];
+	size_t u;
+
+	for (u = 0; u < num; u ++) {
+		pos[u] = 0;
+	}
+	for (;;) {
+		size_t n;
+
+		n = 0;
+		for (u = 0; u < num; u ++) {
+			br_sha256_context *cc;
+			const unsigned char *buf;
+			size_t ptr, rem;
+
+			cc = ctx[u];
+			buf = (const unsigned char *)data[u] + pos[u];
+			ptr = (size_t)cc->count & 63;
+			rem = len - pos[u];
+			if (ptr == 0 && rem >= 64) {
+				blk[n] = buf;
+				pos[u] += 64;
+				cc->count += 64;
+			} else if (ptr + rem >= 64) {
+				memcpy(cc->buf + ptr, buf, 64 - ptr);
+				blk[n] = cc->buf;
+				pos[u] += 64 - ptr;
+				cc->count += (uint64_t)(64 - ptr);
+			} else {
+				memcpy(cc->buf + ptr, buf, rem);
+				pos[u] = len;
+				cc->count += (uint64_t)rem;
+				continue;
+			}
+			val[n ++] = cc->val;
+		}
+		if (n == 0) {
+			return;
+		}
+		impl->run(val, blk, n);
+	}
+}
+
+/* see bearssl_hash.h */
+void
+br_sha256_mb_update(const br_sha256_mb_impl *impl,
+	br_sha256_context *const *ctx, const void *const *data,
+	size_t len, size_t num)
+{
+	size_t lanes;
+
+	lanes = impl->lanes;
+	if (lanes > MAX_LANES) {
+		lanes = MAX_LANES;
+	}
+	while (num > 0) {
+		size_t n;
+
+		n = num < lanes ? num : lanes;
+		mb_update_group(impl, ctx, data, len, n);
+		ctx += n;
+		data += n;
+		num -= n;
+	}
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This implementation processes 8 independent SHA-256 computations in
+ * parallel, one per 32-bit lane of the 256-bit AVX2 registers. Each
+ * state word and each message word is held in a register, with lane i
+ * corresponding to input message i; blocks are loaded and transposed
+ * with scalar code, which is a small fraction of the total cost.
+ */
+
+#if BR_AVX2
+
+#include <immintrin.h>
+
+#define XOR(x, y)    _mm256_xor_si256(x, y)
+#define AND(x, y)    _mm256_and_si256(x, y)
+#define ANDN(x, y)   _mm256_andnot_si256(x, y)
+#define OR(x, y)     _mm256_or_si256(x, y)
+#define ADD(x, y)    _mm256_add_epi32(x, y)
+#define SHR(x, n)    _mm256_srli_epi32(x, n)
+#define ROTR(x, n)   OR(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+#define CH(X, Y, Z)    XOR(AND(X, Y), ANDN(X, Z))
+#define MAJ(X, Y, Z)   OR(AND(Y, Z), AND(OR(Y, Z), X))
+
+#define BSG2_0(x)      XOR(XOR(ROTR(x, 2), ROTR(x, 13)), ROTR(x, 22))
+#define BSG2_1(x)      XOR(XOR(ROTR(x, 6), ROTR(x, 11)), ROTR(x, 25))
+#define SSG2_0(x)      XOR(XOR(ROTR(x, 7), ROTR(x, 18)), SHR(x, 3))
+#define SSG2_1(x)      XOR(XOR(ROTR(x, 17), ROTR(x, 19)), SHR(x, 10))
+
+static const uint32_t K[64] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+	0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+	0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+	0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+	0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+	0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+	0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+	0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+	0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/*
+ * Gather 32-bit word j from the eight-word (state) or sixteen-word
+ * (message block) arrays of all lanes, into a single register.
+ */
+BR_TARGET("avx2")
+static __m256i
+gather_state(uint32_t *const *val, int j)
+{
+	return _mm256_set_epi32(
+		(int)val[7][j],
+		(int)val[6][j],
+		(int)val[5][j],
+		(int)val[4][j],
+		(int)val[3][j],
+		(int)val[2][j],
+		(int)val[1][j],
+		(int)val[0][j]);
+}
+
+BR_TARGET("avx2")
+static __m256i
+gather_block(const unsigned char *const *buf, int j)
+{
+	return _mm256_set_epi32(
+		(int)br_dec32be(buf[7] + (j << 2)),
+		(int)br_dec32be(buf[6] + (j << 2)),
+		(int)br_dec32be(buf[5] + (j << 2)),
+		(int)br_dec32be(buf[4] + (j << 2)),
+		(int)br_dec32be(buf[3] + (j << 2)),
+		(int)br_dec32be(buf[2] + (j << 2)),
+		(int)br_dec32be(buf[1] + (j << 2)),
+		(int)br_dec32be(buf[0] + (j << 2)));
+}
+
+/* see bearssl_hash.h */
+BR_TARGET("avx2")
+void
+br_sha256_mb_avx2_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num)
+{
+	static const unsigned char zero[64] = { 0 };
+
+	uint32_t dummy[8];
+	uint32_t *lval[8];
+	const unsigned char *lbuf[8];
+	__m256i s[8], w[16];
+	__m256i A, B, C, D, E, F, G, H;
+	uint32_t tmp[8];
+	size_t u;
+	int i, j;
+
+	/*
+	 * Unused lanes work on a dummy state and an all-zero block.
+	 */
+	memset(dummy, 0, sizeof dummy);
+	for (u = 0; u < 8; u ++) {
+		if (u < num) {
+			lval[u] = val[u];
+			lbuf[u] = buf[u];
+		} else {
+			lval[u] = dummy;
+			lbuf[u] = zero;
+		}
+	}
+
+	for (j = 0; j < 8; j ++) {
+		s[j] = gather_state(lval, j);
+	}
+	for (j = 0; j < 16; j ++) {
+		w[j] = gather_block(lbuf, j);
+	}
+
+	A = s[0];
+	B = s[1];
+	C = s[2];
+	D = s[3];
+	E = s[4];
+	F = s[5];
+	G = s[6];
+	H = s[7];
+	for (i = 0; i < 64; i ++) {
+		__m256i T1, T2, x;
+
+		if (i < 16) {
+			x = w[i];
+		} else {
+			x = ADD(ADD(SSG2_1(w[(i - 2) & 15]), w[(i - 7) & 15]),
+				ADD(SSG2_0(w[(i - 15) & 15]), w[i & 15]));
+			w[i & 15] = x;
+		}
+		T1 = ADD(ADD(H, BSG2_1(E)),
+			ADD(CH(E, F, G), ADD(_mm256_set1_epi32((int)K[i]), x)));
+		T2 = ADD(BSG2_0(A), MAJ(A, B, C));
+		H = G;
+		G = F;
+		F = E;
+		E = ADD(D, T1);
+		D = C;
+		C = B;
+		B = A;
+		A = ADD(T1, T2);
+	}
+	s[0] = ADD(s[0], A);
+	s[1] = ADD(s[1], B);
+	s[2] = ADD(s[2], C);
+	s[3] = ADD(s[3], D);
+	s[4] = ADD(s[4], E);
+	s[5] = ADD(s[5], F);
+	s[6] = ADD(s[6], G);
+	s[7] = ADD(s[7], H);
+
+	for (j = 0; j < 8; j ++) {
+		_mm256_storeu_si256((__m256i *)tmp, s[j]);
+		for (u = 0; u < num; u ++) {
+			val[u][j] = tmp[u];
+		}
+	}
+}
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl br_sha256_mb_avx2 = {
+	8,
+	&br_sha256_mb_avx2_run
+};
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl *
+br_sha256_mb_avx2_get(void)
+{
+	/*
+	 * Bit mask for features in EBX (leaf 7):
+	 *    5   AVX2
+	 */
+	if (br_cpu_avx_os() && br_cpuid7(0x00000020, 0)) {
+		return &br_sha256_mb_avx2;
+	} else {
+		return NULL;
+	}
+}
+
+#else
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl *
+br_sha256_mb_avx2_get(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This code implements SHA-224 and SHA-256 with the x86 SHA extensions
+ * (sha256rnds2, sha256msg1 and sha256msg2 opcodes). Context structure
+ * and state encoding are identical to those of the portable
+ * implementation (sha2small.c), so that contexts and saved states can
+ * be exchanged between both implementations.
+ */
+
+#if BR_SHA_X86NI
+
+#include <immintrin.h>
+
+#include "sha_x86ni.h"
+
+static int
+supported(void)
+{
+	/*
+	 * Bit mask for features in ECX:
+	 *    9   SSSE3
+	 *   19   SSE4.1
+	 * Bit mask for features in EDX:
+	 *   26   SSE2
+	 * Bit mask for features in EBX (leaf 7):
+	 *   29   SHA
+	 */
+	return br_cpuid(0, 0, 0x00080200, 0x04000000)
+		&& br_cpuid7(0x20000000, 0);
+}
+
+/*
+ * Process num consecutive 64-byte blocks.
+ */
+BR_TARGET("ssse3,sse4.1,sha")
+static void
+sha2small_x86ni_blocks(uint32_t *val, const unsigned char *buf, size_t num)
+{
+	__m128i abef, cdgh, abef_save, cdgh_save, bswap;
+	__m128i m[4];
+	int i;
+
+	sha256_x86ni_load_state(val, &abef, &cdgh);
+	bswap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+	while (num -- > 0) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+		for (i = 0; i < 16; i ++) {
+			SHA256_ROUNDS4(abef, cdgh, m, buf, i);
+		}
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+		buf += 64;
+	}
+	sha256_x86ni_store_state(val, abef, cdgh);
+}
+
+/*
+ * Multi-buffer variant (see br_sha256_mb_update()): two independent
+ * states are processed with interleaved instructions. The sha256rnds2
+ * opcode has a long latency and each round depends on the previous
+ * one, so a single computation leaves the execution units mostly idle.
+ */
+/* see bearssl_hash.h */
+BR_TARGET("ssse3,sse4.1,sha")
+void
+br_sha256_mb_x86ni_run(uint32_t *const *val,
+	const unsigned char *const *buf, size_t num)
+{
+	__m128i abef0, cdgh0, abef1, cdgh1;
+	__m128i abef0_save, cdgh0_save, abef1_save, cdgh1_save, bswap;
+	__m128i m0[4], m1[4];
+	const unsigned char *buf0, *buf1;
+	int i;
+
+	if (num < 2) {
+		if (num == 1) {
+			sha2small_x86ni_blocks(val[0], buf[0], 1);
+		}
+		return;
+	}
+	buf0 = buf[0];
+	buf1 = buf[1];
+	sha256_x86ni_load_state(val[0], &abef0, &cdgh0);
+	sha256_x86ni_load_state(val[1], &abef1, &cdgh1);
+	bswap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+	abef0_save = abef0;
+	cdgh0_save = cdgh0;
+	abef1_save = abef1;
+	cdgh1_save = cdgh1;
+	for (i = 0; i < 16; i ++) {
+		SHA256_ROUNDS4(abef0, cdgh0, m0, buf0, i);
+		SHA256_ROUNDS4(abef1, cdgh1, m1, buf1, i);
+	}
+	sha256_x86ni_store_state(val[0], _mm_add_epi32(abef0, abef0_save),
+		_mm_add_epi32(cdgh0, cdgh0_save));
+	sha256_x86ni_store_state(val[1], _mm_add_epi32(abef1, abef1_save),
+		_mm_add_epi32(cdgh1, cdgh1_save));
+}
+
+
+static void
+sha2small_x86ni_out(const br_sha224_context *cc, void *dst, int num)
+{
+	unsigned char buf[128];
+	uint32_t val[8];
+	size_t ptr, nb;
+
+	ptr = (size_t)cc->count & 63;
+	memcpy(buf, cc->buf, ptr);
+	memcpy(val, cc->val, sizeof val);
+	buf[ptr ++] = 0x80;
+	nb = (ptr > 56) ? 2 : 1;
+	memset(buf + ptr, 0, (nb << 6) - 8 - ptr);
+	br_enc64be(buf + (nb << 6) - 8, cc->count << 3);
+	sha2small_x86ni_blocks(val, buf, nb);
+	br_range_enc32be(dst, val, num);
+}
+
+/* see bearssl_hash.h */
+void
+br_sha224_x86ni_init(br_sha224_context *cc)
+{
+	cc->vtable = &br_sha224_x86ni_vtable;
+	memcpy(cc->val, br_sha224_IV, sizeof cc->val);
+	cc->count = 0;
+}
+
+/* see bearssl_hash.h */
+void
+br_sha224_x86ni_update(br_sha224_context *cc, const void *data, size_t len)
+{
+	const unsigned char *buf;
+	size_t ptr, num;
+
+	buf = data;
+	ptr = (size_t)cc->count & 63;
+	cc->count += (uint64_t)len;
+	if (ptr != 0) {
+		size_t clen;
+
+		clen = 64 - ptr;
+		if (clen > len) {
+			clen = len;
+		}
+		memcpy(cc->buf + ptr, buf, clen);
+		ptr += clen;
+		buf += clen;
+		len -= clen;
+		if (ptr < 64) {
+			return;
+		}
+		sha2small_x86ni_blocks(cc->val, cc->buf, 1);
+	}
+
+	/*
+	 * Full blocks are processed directly from the source buffer.
+	 */
+	num = len >> 6;
+	if (num > 0) {
+		sha2small_x86ni_blocks(cc->val, buf, num);
+		buf += num << 6;
+		len &= 63;
+	}
+	memcpy(cc->buf, buf, len);
+}
+
+/* see bearssl_hash.h */
+void
+br_sha224_x86ni_out(const br_sha224_context *cc, void *dst)
+{
+	sha2small_x86ni_out(cc, dst, 7);
+}
+
+/* see bearssl_hash.h */
+void
+br_sha256_x86ni_init(br_sha256_context *cc)
+{
+	cc->vtable = &br_sha256_x86ni_vtable;
+	memcpy(cc->val, br_sha256_IV, sizeof cc->val);
+	cc->count = 0;
+}
+
+/* see bearssl_hash.h */
+void
+br_sha256_x86ni_out(const br_sha256_context *cc, void *dst)
+{
+	sha2small_x86ni_out(cc, dst, 8);
+}
+
+/* see bearssl_hash.h */
+const br_hash_class br_sha224_x86ni_vtable = {
+	sizeof(br_sha224_context),
+	BR_HASHDESC_ID(br_sha224_ID)
+		| BR_HASHDESC_OUT(28)
+		| BR_HASHDESC_STATE(32)
+		| BR_HASHDESC_LBLEN(6)
+		| BR_HASHDESC_MD_PADDING
+		| BR_HASHDESC_MD_PADDING_BE,
+	(void (*)(const br_hash_class **))&br_sha224_x86ni_init,
+	(void (*)(const br_hash_class **,
+		const void *, size_t))&br_sha224_x86ni_update,
+	(void (*)(const br_hash_class *const *, void *))&br_sha224_x86ni_out,
+	(uint64_t (*)(const br_hash_class *const *, void *))&br_sha224_state,
+	(void (*)(const br_hash_class **, const void *, uint64_t))
+		&br_sha224_set_state
+};
+
+/* see bearssl_hash.h */
+const br_hash_class br_sha256_x86ni_vtable = {
+	sizeof(br_sha256_context),
+	BR_HASHDESC_ID(br_sha256_ID)
+		| BR_HASHDESC_OUT(32)
+		| BR_HASHDESC_STATE(32)
+		| BR_HASHDESC_LBLEN(6)
+		| BR_HASHDESC_MD_PADDING
+		| BR_HASHDESC_MD_PADDING_BE,
+	(void (*)(const br_hash_class **))&br_sha256_x86ni_init,
+	(void (*)(const br_hash_class **,
+		const void *, size_t))&br_sha256_x86ni_update,
+	(void (*)(const br_hash_class *const *, void *))&br_sha256_x86ni_out,
+	(uint64_t (*)(const br_hash_class *const *, void *))&br_sha256_state,
+	(void (*)(const br_hash_class **, const void *, uint64_t))
+		&br_sha256_set_state
+};
+
+/* see bearssl_hash.h */
+const br_hash_class *
+br_sha224_x86ni_get_vtable(void)
+{
+	return supported() ? &br_sha224_x86ni_vtable : NULL;
+}
+
+/* see bearssl_hash.h */
+const br_hash_class *
+br_sha256_x86ni_get_vtable(void)
+{
+	return supported() ? &br_sha256_x86ni_vtable : NULL;
+}
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl br_sha256_mb_x86ni = {
+	2,
+	&br_sha256_mb_x86ni_run
+};
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl *
+br_sha256_mb_x86ni_get(void)
+{
+	return supported() ? &br_sha256_mb_x86ni : NULL;
+}
+
+#else
+
+/* see bearssl_hash.h */
+const br_sha256_mb_impl *
+br_sha256_mb_x86ni_get(void)
+{
+	return NULL;
+}
+
+/* see bearssl_hash.h */
+const br_hash_class *
+br_sha224_x86ni_get_vtable(void)
+{
+	return NULL;
+}
+
+/* see bearssl_hash.h */
+const br_hash_class *
+br_sha256_x86ni_get_vtable(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Shared code for the implementations that use the x86 SHA opcodes
+ * (sha1_x86ni.c, sha2small_x86ni.c, and the stitched CBC+HMAC kernel in
+ * aes_x86ni_cbchmac.c). This file must be included after <immintrin.h>,
+ * and the macros and functions below may be used only in functions
+ * compiled for the "ssse3,sse4.1,sha" targets (see BR_TARGET()).
+ */
+
+/*
+ * SHA-1: four rounds (rounds 4*g to 4*g+3), with boolean function f.
+ * The message schedule is interleaved with the rounds: m[] holds four
+ * consecutive 128-bit words (16 32-bit words) of the expanded message,
+ * with word w[4*k..4*k+3] in m[k & 3]. Since g is a constant in each
+ * invocation, the tests are resolved at compile-time.
+ *
+ * The state is in the local variables abcd (A in the upper word), e0
+ * (E in the upper word, at the start of the block), and the scratch
+ * values abcd_prev and e. After the 20 invocations, the new E is
+ * obtained with sha1nexte(abcd_prev, e0).
+ */
+#define SHA1_ROUNDS4(g, f)   do { \
+		if ((g) == 0) { \
+			e = _mm_add_epi32(e0, m[0]); \
+		} else { \
+			e = _mm_sha1nexte_epu32(abcd_prev, m[(g) & 3]); \
+		} \
+		abcd_prev = abcd; \
+		abcd = _mm_sha1rnds4_epu32(abcd, e, f); \
+		if ((g) >= 3 && (g) <= 18) { \
+			m[((g) + 1) & 3] = _mm_sha1msg2_epu32( \
+				m[((g) + 1) & 3], m[(g) & 3]); \
+		} \
+		if ((g) >= 2 && (g) <= 17) { \
+			m[((g) + 2) & 3] = _mm_xor_si128( \
+				m[((g) + 2) & 3], m[(g) & 3]); \
+		} \
+		if ((g) >= 1 && (g) <= 16) { \
+			m[((g) + 3) & 3] = _mm_sha1msg1_epu32( \
+				m[((g) + 3) & 3], m[(g) & 3]); \
+		} \
+	} while (0)
+
+static const uint32_t SHA256_K[64] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+	0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+	0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+	0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+	0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+	0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+	0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+	0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+	0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/*
+ * sha256rnds2 uses the state split into two registers, with words
+ * A, B, E, F in one, and C, D, G, H in the other (in big-endian order,
+ * i.e. A and C in the upper words).
+ */
+BR_TARGET("ssse3,sse4.1,sha")
+static inline void
+sha256_x86ni_load_state(const uint32_t *val, __m128i *abef, __m128i *cdgh)
+{
+	__m128i t, u;
+
+	t = _mm_loadu_si128((const __m128i *)val);
+	u = _mm_loadu_si128((const __m128i *)(val + 4));
+	t = _mm_shuffle_epi32(t, 0xB1);
+	u = _mm_shuffle_epi32(u, 0x1B);
+	*abef = _mm_alignr_epi8(t, u, 8);
+	*cdgh = _mm_blend_epi16(u, t, 0xF0);
+}
+
+BR_TARGET("ssse3,sse4.1,sha")
+static inline void
+sha256_x86ni_store_state(uint32_t *val, __m128i abef, __m128i cdgh)
+{
+	__m128i t, u;
+
+	t = _mm_shuffle_epi32(abef, 0x1B);
+	u = _mm_shuffle_epi32(cdgh, 0xB1);
+	_mm_storeu_si128((__m128i *)val, _mm_blend_epi16(t, u, 0xF0));
+	_mm_storeu_si128((__m128i *)(val + 4), _mm_alignr_epi8(u, t, 8));
+}
+
+/*
+ * SHA-256: four rounds (rounds 4*i to 4*i+3). m[i & 3] first receives
+ * message words 4*i to 4*i+3, either from the input block (at buf,
+ * byte-swapped with the local 'bswap' constant), or computed from the
+ * previous 16 words. Each sha256rnds2 then computes two rounds, using
+ * the two low words of its third operand.
+ */
+#define SHA256_ROUNDS4(abef, cdgh, m, buf, i)   do { \
+		__m128i x; \
+ \
+		if ((i) < 4) { \
+			x = _mm_loadu_si128( \
+				(const __m128i *)((buf) + ((i) << 4))); \
+			x = _mm_shuffle_epi8(x, bswap); \
+		} else { \
+			x = _mm_sha256msg1_epu32( \
+				m[(i) & 3], m[((i) + 1) & 3]); \
+			x = _mm_add_epi32(x, _mm_alignr_epi8( \
+				m[((i) + 3) & 3], m[((i) + 2) & 3], 4)); \
+			x = _mm_sha256msg2_epu32(x, m[((i) + 3) & 3]); \
+		} \
+		m[(i) & 3] = x; \
+		x = _mm_add_epi32(x, _mm_loadu_si128( \
+			(const __m128i *)(SHA256_K + ((i) << 2)))); \
+		cdgh = _mm_sha256rnds2_epu32(cdgh, abef, x); \
+		x = _mm_shuffle_epi32(x, 0x0E); \
+		abef = _mm_sha256rnds2_epu32(abef, cdgh, x); \
+	} while (0)
@@ -96,6 +96,202 @@
 #endif
 #endif
 
+/*
+ * BR_INT128 is set when the 'unsigned __int128' type can be used for
+ * 64x64->128 multiplications. This may be overridden in config.h.
+ */
+#ifndef BR_INT128
+#if BR_64 && defined(__SIZEOF_INT128__)
+#define BR_INT128   1
+#endif
+#endif
+
+/*
+ * BR_I31_KARATSUBA is the modulus size (in 31-bit words) from which
+ * br_i31_modpow_opt() uses Karatsuba multiplication; 0 (the default)
+ * disables it. This may be overridden in config.h.
+ */
+#ifndef BR_I31_KARATSUBA
+#define BR_I31_KARATSUBA   0
+#endif
+
+/*
+ * BR_EC_COMPILED selects straight-line point formulas instead of the
+ * microcode interpreter in ec_prime_i31; 0 (the default) keeps the
+ * interpreter. This may be overridden in config.h.
+ */
+#ifndef BR_EC_COMPILED
+#define BR_EC_COMPILED   0
+#endif
+
+/*
+ * Detect x86 architectures (32-bit and 64-bit), and compilers that
+ * can be used to produce code for x86 opcodes that are not part of
+ * the baseline instruction set (SSE2, AES-NI...). With GCC (4.8+) and
+ * Clang (3.7+), such code can be produced on a per-function basis,
+ * with the "target" attribute (see BR_TARGET() below), so that the
+ * rest of the library can still be compiled for older CPU; the actual
+ * availability of the relevant opcodes is then tested at runtime with
+ * br_cpuid().
+ */
+#if defined(__i386__) || defined(_M_IX86) \
+	|| defined(__x86_64__) || defined(_M_X64)
+#define BR_x86   1
+#endif
+
+#if defined(__clang__)
+#if __clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 7)
+#define BR_TARGET_OK   1
+#endif
+#elif defined(__GNUC__)
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)
+#define BR_TARGET_OK   1
+#endif
+#endif
+
+/*
+ * BR_AES_X86NI is set when the AES-NI implementation of AES (and the
+ * GHASH implementation with pclmulqdq) can be compiled. This may be
+ * overridden in config.h.
+ */
+#ifndef BR_AES_X86NI
+#if BR_x86 && BR_TARGET_OK
+#define BR_AES_X86NI   1
+#endif
+#endif
+
+/*
+ * BR_SHA_X86NI is set when the SHA-1 and SHA-224/256 implementations
+ * that use the x86 SHA extensions can be compiled. This may be
+ * overridden in config.h.
+ */
+#ifndef BR_SHA_X86NI
+#if BR_x86 && BR_TARGET_OK
+#define BR_SHA_X86NI   1
+#endif
+#endif
+
+/*
+ * BR_SSE2 and BR_AVX2 are set when code using, respectively, SSE2 and
+ * AVX2 intrinsics can be compiled (e.g. the vectorized ChaCha20 and AES
+ * implementations). These may be overridden in config.h.
+ */
+#ifndef BR_SSE2
+#if BR_x86 && BR_TARGET_OK
+#define BR_SSE2   1
+#endif
+#endif
+
+#ifndef BR_AVX2
+#if BR_x86 && BR_TARGET_OK
+#define BR_AVX2   1
+#endif
+#endif
+
+#if BR_TARGET_OK
+#define BR_TARGET(x)   __attribute__((target(x)))
+#else
+#define BR_TARGET(x)
+#endif
+
+#if BR_x86 && BR_TARGET_OK
+#include <cpuid.h>
+#endif
+
+/*
+ * Test the CPU features reported by the 'cpuid' opcode (leaf 1). The
+ * provided masks are matched against the contents of the eax, ebx, ecx
+ * and edx registers, respectively; returned value is 1 if all bits set
+ * in the masks are also set in the registers, 0 otherwise. On non-x86
+ * architectures, or if cpuid cannot be invoked, 0 is returned.
+ */
+static inline int
+br_cpuid(uint32_t mask_eax, uint32_t mask_ebx,
+	uint32_t mask_ecx, uint32_t mask_edx)
+{
+#if BR_x86 && BR_TARGET_OK
+	unsigned eax, ebx, ecx, edx;
+
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		if ((eax & mask_eax) == mask_eax
+			&& (ebx & mask_ebx) == mask_ebx
+			&& (ecx & mask_ecx) == mask_ecx
+			&& (edx & mask_edx) == mask_edx)
+		{
+			return 1;
+		}
+	}
+#else
+	(void)mask_eax;
+	(void)mask_ebx;
+	(void)mask_ecx;
+	(void)mask_edx;
+#endif
+	return 0;
+}
+
+/*
+ * Test the CPU features reported by the 'cpuid' opcode, leaf 7
+ * (sub-leaf 0); masks are matched against the ebx and ecx registers.
+ * Returned value is 1 if all bits set in the masks are also set in the
+ * registers, 0 otherwise (including when leaf 7 is not supported, or
+ * on non-x86 architectures).
+ */
+static inline int
+br_cpuid7(uint32_t mask_ebx, uint32_t mask_ecx)
+{
+#if BR_x86 && BR_TARGET_OK
+	unsigned eax, ebx, ecx, edx;
+
+	if (__get_cpuid_max(0, 0) >= 7) {
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		(void)eax;
+		(void)edx;
+		if ((ebx & mask_ebx) == mask_ebx
+			&& (ecx & mask_ecx) == mask_ecx)
+		{
+			return 1;
+		}
+	}
+#else
+	(void)mask_ebx;
+	(void)mask_ecx;
+#endif
+	return 0;
+}
+
+/*
+ * Test whether the operating system saves and restores the full AVX
+ * state (ymm registers) on context switches. This checks the OSXSAVE
+ * and AVX feature bits, then the XCR0 register (with xgetbv). This
+ * MUST be verified before using any AVX or AVX2 opcode.
+ */
+static inline int
+br_cpu_avx_os(void)
+{
+#if BR_x86 && BR_TARGET_OK
+	uint32_t xlo, xhi;
+
+	/*
+	 * Bit mask for features in ECX:
+	 *   27   OSXSAVE
+	 *   28   AVX
+	 */
+	if (!br_cpuid(0, 0, 0x18000000, 0)) {
+		return 0;
+	}
+	__asm__ __volatile__ ("xgetbv" : "=a" (xlo), "=d" (xhi) : "c" (0));
+	(void)xhi;
+
+	/*
+	 * XCR0 bits 1 (SSE state) and 2 (AVX state) must both be set.
+	 */
+	return (xlo & 0x06) == 0x06;
+#else
+	return 0;
+#endif
+}
+
 /* ==================================================================== */
 /*
  * Encoding/decoding functions.
@@ -730,6 +926,19 @@ uint32_t br_i32_add(uint32_t *a, const uint32_t *b, uint32_t ctl);
  */
 uint32_t br_i32_sub(uint32_t *a, const uint32_t *b, uint32_t ctl);
 
+/*
+ * Compute x/y mod m, result in x. Values x and y MUST be integers
+ * modulo m, with the same announced bit length as m; m MUST be odd.
+ * The t[] array must have room for four integers of the same size as
+ * m (including the "bit length" word). If y is invertible modulo m,
+ * then x[] is set to x/y mod m and 1 is returned; otherwise, x[] is
+ * left unmodified and 0 is returned. This function is constant-time
+ * (it uses a binary extended GCD with a fixed number of iterations),
+ * and does not require m to be prime.
+ */
+uint32_t br_i32_moddiv(uint32_t *x, const uint32_t *y,
+	const uint32_t *m, uint32_t *t);
+
 /*
  * Compute d+a*b, result in d. The initial announced bit length of d[]
  * MUST match that of a[]. The d[] array MUST be large enough to
@@ -786,6 +995,16 @@ void br_i32_from_monty(uint32_t *x, const uint32_t *m, uint32_t m0i);
 void br_i32_montymul(uint32_t *d, const uint32_t *x, const uint32_t *y,
 	const uint32_t *m, uint32_t m0i);
 
+/*
+ * Compute a modular Montgomery squaring: d[] is filled with x*x/R
+ * modulo m[]. This is equivalent to br_i32_montymul(d, x, x, m, m0i),
+ * but faster (cross products are computed only once). The array d[]
+ * MUST be distinct from x[] and m[]. x[] MUST be numerically lower
+ * than m[].
+ */
+void br_i32_montysqr(uint32_t *d, const uint32_t *x,
+	const uint32_t *m, uint32_t m0i);
+
 /*
  * Compute a modular exponentiation. x[] MUST be an integer modulo m[]
  * (same announced bit length, lower value). m[] MUST be odd. The
@@ -798,6 +1017,43 @@ void br_i32_montymul(uint32_t *d, const uint32_t *x, const uint32_t *y,
 void br_i32_modpow(uint32_t *x, const unsigned char *e, size_t elen,
 	const uint32_t *m, uint32_t m0i, uint32_t *t1, uint32_t *t2);
 
+/*
+ * Compute a modular exponentiation. x[] MUST be an integer modulo m[]
+ * (same announced bit length, lower value). m[] MUST be odd. The
+ * exponent is in big-endian unsigned notation, over 'elen' bytes. The
+ * "m0i" parameter is equal to -(1/m0) mod 2^32, where m0 is the least
+ * significant value word of m[] (this works only if m[] is an odd
+ * integer). The tmp[] array is used for temporaries, and has size
+ * 'twlen' words; it must be large enough to accommodate at least two
+ * temporary values with the same size as m[] (including the leading
+ * "bit length" word). If there is room for more temporaries, then this
+ * function may use the extra room for window-based optimisation,
+ * resulting in faster computations (up to a 5-bit window, i.e. 33
+ * temporaries).
+ *
+ * Returned value is 1 on success, 0 on error. An error is reported if
+ * the provided tmp[] array is too short; in that case, x[] is left
+ * unmodified.
+ */
+uint32_t br_i32_modpow_opt(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen);
+
+/*
+ * Compute a modular exponentiation with a public exponent. This has
+ * the same parameters as br_i32_modpow_opt(), but only needs room for
+ * two temporaries in tmp[] (more room allows a sliding window for
+ * long exponents). This function is constant-time with regards to x[]
+ * and m[], but NOT to the exponent: leading zeros are skipped, and
+ * only the non-zero exponent bits incur a multiplication; e.g. the
+ * usual RSA exponent 65537 costs 16 squarings and one multiplication.
+ *
+ * Returned value is 1 on success, 0 on error (the provided tmp[] array
+ * is too short; x[] is then unmodified).
+ */
+uint32_t br_i32_modpow_vartime(uint32_t *x, const unsigned char *e,
+	size_t elen, const uint32_t *m, uint32_t m0i,
+	uint32_t *tmp, size_t twlen);
+
 /* ==================================================================== */
 
 /*
@@ -967,6 +1223,30 @@ uint32_t br_i31_ninv31(uint32_t x);
 void br_i31_montymul(uint32_t *d, const uint32_t *x, const uint32_t *y,
 	const uint32_t *m, uint32_t m0i);
 
+/*
+ * Compute a modular Montgomery squaring: d[] is filled with x*x/R
+ * modulo m[]. This is equivalent to br_i31_montymul(d, x, x, m, m0i),
+ * but faster (cross products are computed only once). The array d[]
+ * MUST be distinct from x[] and m[]. x[] MUST be numerically lower
+ * than m[].
+ */
+void br_i31_montysqr(uint32_t *d, const uint32_t *x,
+	const uint32_t *m, uint32_t m0i);
+
+/*
+ * Variants of br_i31_montymul() and br_i31_montysqr() that compute the
+ * full product with Karatsuba multiplication, then apply a separate
+ * Montgomery reduction. Parameters and results are identical. These
+ * functions are faster only for large moduli (see BR_I31_KARATSUBA);
+ * they use about 2.5 kB of stack, and moduli larger than the maximum
+ * RSA factor size are delegated to br_i31_montymul() and
+ * br_i31_montysqr().
+ */
+void br_i31_montymul_k(uint32_t *d, const uint32_t *x, const uint32_t *y,
+	const uint32_t *m, uint32_t m0i);
+void br_i31_montysqr_k(uint32_t *d, const uint32_t *x,
+	const uint32_t *m, uint32_t m0i);
+
 /*
  * Convert a modular integer to Montgomery representation. The integer x[]
  * MUST be lower than m[], but with the same announced bit length.
@@ -994,6 +1274,67 @@ void br_i31_from_monty(uint32_t *x, const uint32_t *m, uint32_t m0i);
 void br_i31_modpow(uint32_t *x, const unsigned char *e, size_t elen,
 	const uint32_t *m, uint32_t m0i, uint32_t *t1, uint32_t *t2);
 
+/*
+ * Compute a modular exponentiation. x[] MUST be an integer modulo m[]
+ * (same announced bit length, lower value). m[] MUST be odd. The
+ * exponent is in big-endian unsigned notation, over 'elen' bytes. The
+ * "m0i" parameter is equal to -(1/m0) mod 2^31, where m0 is the least
+ * significant value word of m[] (this works only if m[] is an odd
+ * integer). The tmp[] array is used for temporaries, and has size
+ * 'twlen' words; it must be large enough to accommodate at least two
+ * temporary values with the same size as m[] (including the leading
+ * "bit length" word). If there is room for more temporaries, then this
+ * function may use the extra room for window-based optimisation,
+ * resulting in faster computations (up to a 5-bit window, i.e. 33
+ * temporaries).
+ *
+ * Returned value is 1 on success, 0 on error. An error is reported if
+ * the provided tmp[] array is too short; in that case, x[] is left
+ * unmodified.
+ */
+uint32_t br_i31_modpow_opt(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen);
+
+/*
+ * Compute a modular exponentiation with a public exponent. This has
+ * the same parameters as br_i31_modpow_opt(), but only needs room for
+ * two temporaries in tmp[] (more room allows a sliding window for
+ * long exponents). This function is constant-time with regards to x[]
+ * and m[], but NOT to the exponent: leading zeros are skipped, and
+ * only the non-zero exponent bits incur a multiplication; e.g. the
+ * usual RSA exponent 65537 costs 16 squarings and one multiplication.
+ *
+ * Returned value is 1 on success, 0 on error (the provided tmp[] array
+ * is too short; x[] is then unmodified).
+ */
+uint32_t br_i31_modpow_vartime(uint32_t *x, const unsigned char *e,
+	size_t elen, const uint32_t *m, uint32_t m0i,
+	uint32_t *tmp, size_t twlen);
+
+/*
+ * Same as br_i31_modpow_opt(), but with a precomputed r2[] = R^2 mod m
+ * (with R = 2^(31*k), where k is the number of value words in m[]).
+ * The conversion of x[] into Montgomery representation then uses a
+ * single Montgomery multiplication instead of br_i31_to_monty().
+ */
+uint32_t br_i31_modpow_opt_r2(uint32_t *x,
+	const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, const uint32_t *r2,
+	uint32_t *tmp, size_t twlen);
+
+/*
+ * Compute x/y mod m, result in x. Values x and y MUST be integers
+ * modulo m, with the same announced bit length as m; m MUST be odd.
+ * The t[] array must have room for four integers of the same size as
+ * m (including the "bit length" word). If y is invertible modulo m,
+ * then x[] is set to x/y mod m and 1 is returned; otherwise, x[] is
+ * left unmodified and 0 is returned. This function is constant-time
+ * (it uses a binary extended GCD with a fixed number of iterations),
+ * and does not require m to be prime.
+ */
+uint32_t br_i31_moddiv(uint32_t *x, const uint32_t *y,
+	const uint32_t *m, uint32_t *t);
+
 /*
  * Compute d+a*b, result in d. The initial announced bit length of d[]
  * MUST match that of a[]. The d[] array MUST be large enough to
@@ -1009,6 +1350,71 @@ void br_i31_mulacc(uint32_t *d, const uint32_t *a, const uint32_t *b);
 
 /* ==================================================================== */
 
+/*
+ * Integers 'i62'
+ * --------------
+ *
+ * The 'i62' code works on big integers internally represented as
+ * arrays of 64-bit words, with 62 bits used per word, and relies on
+ * the 64x64->128 multiplication (this requires BR_INT128). Two i31
+ * words fit exactly in one i62 word; thus, the i62 functions take
+ * and return integers in i31 format, and only the expensive inner
+ * loops (modular exponentiation) work on the 62-bit words. Other
+ * operations (decoding, encoding, reduction...) use the i31 functions.
+ */
+
+/*
+ * Compute a modular exponentiation. x[] MUST be an integer modulo m[]
+ * (same announced bit length, lower value), in i31 format. m[] MUST be
+ * odd. The exponent is in big-endian unsigned notation, over 'elen'
+ * bytes. The "m0i" parameter is equal to -(1/m0) mod 2^31, where m0 is
+ * the least significant value word of m[] (as with the i31 functions).
+ * The tmp[] array is used for temporaries, and has size 'twlen' 64-bit
+ * words; it must be large enough to accommodate at least four
+ * temporary values with the same size as m[] (in 62-bit words, i.e.
+ * about half as many words as the i31 representation of m[]). If there
+ * is room for more temporaries, then a window-based exponentiation is
+ * used (up to a 5-bit window, i.e. 35 temporaries).
+ *
+ * Returned value is 1 on success, 0 on error. An error is reported if
+ * the provided tmp[] array is too short, or if the i62 code is not
+ * supported (BR_INT128 is not set); in that case, x[] is left
+ * unmodified.
+ */
+uint32_t br_i62_modpow_opt(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint64_t *tmp, size_t twlen);
+
+/* ==================================================================== */
+/*
+ * RSA support functions.
+ */
+
+/*
+ * Apply PKCS#1 v1.5 type 1 padding (for signatures) to a hash value;
+ * the hash OID and value are as described for br_rsa_pkcs1_sign. The
+ * padded value is written in x[], over exactly (n_bitlen+7)/8 bytes.
+ *
+ * Returned value is 1 on success, 0 on error (the modulus is too
+ * short for the provided hash OID and value).
+ */
+uint32_t br_rsa_pkcs1_sig_pad(const unsigned char *hash_oid,
+	const unsigned char *hash, size_t hash_len,
+	uint32_t n_bitlen, unsigned char *x);
+
+/*
+ * Check and remove the PKCS#1 v1.5 type 2 padding from a decrypted
+ * SSL/TLS premaster secret. The data[] buffer has length 'len', which
+ * the caller MUST have checked to be the modulus length and at least
+ * 59 bytes. The 'ok' parameter is the value returned by the private
+ * key operation. On success, the 48-byte premaster secret is moved to
+ * the start of data[] and 1 is returned; otherwise, 0 is returned.
+ * This function is constant-time.
+ */
+uint32_t br_rsa_ssl_decrypt_unpad(uint32_t ok, unsigned char *data,
+	size_t len);
+
+/* ==================================================================== */
+
 static inline size_t
 br_digest_size(const br_hash_class *digest_class)
 {
@@ -1016,6 +1422,13 @@ br_digest_size(const br_hash_class *digest_class)
 		& BR_HASHDESC_OUT_MASK;
 }
 
+static inline int
+br_digest_id(const br_hash_class *digest_class)
+{
+	return (int)(digest_class->desc >> BR_HASHDESC_ID_OFF)
+		& BR_HASHDESC_ID_MASK;
+}
+
 /*
  * Get the output size (in bytes) of a hash function.
  */
@@ -1306,6 +1719,27 @@ unsigned br_aes_ct64_keysched(uint64_t *comp_skey,
 void br_aes_ct64_skey_expand(uint64_t *skey,
 	unsigned num_rounds, const uint64_t *comp_skey);
 
+/*
+ * Test support for AES-NI opcodes.
+ */
+int br_aes_x86ni_supported(void);
+
+/*
+ * AES key schedule, using x86 AES-NI instructions. This yields the
+ * subkeys in the encryption direction. Number of rounds is returned.
+ * Key size MUST be 16, 24 or 32 bytes; otherwise, 0 is returned.
+ */
+unsigned br_aes_x86ni_keysched_enc(unsigned char *skni,
+	const void *key, size_t len);
+
+/*
+ * AES key schedule, using x86 AES-NI instructions. This yields the
+ * subkeys in the decryption direction. Number of rounds is returned.
+ * Key size MUST be 16, 24 or 32 bytes; otherwise, 0 is returned.
+ */
+unsigned br_aes_x86ni_keysched_dec(unsigned char *skni,
+	const void *key, size_t len);
+
 /* ==================================================================== */
 /*
  * Elliptic curves.
@@ -1524,6 +1958,56 @@ void br_ssl_engine_switch_gcm_out(br_ssl_engine_context *cc,
 	int is_client, int prf_id,
 	const br_block_ctr_class *bc_impl, size_t cipher_key_len);
 
+/*
+ * Switch to CCM decryption for incoming records.
+ *    cc               the engine context
+ *    is_client        non-zero for a client, zero for a server
+ *    prf_id           id of hash function for PRF
+ *    bc_impl          block cipher implementation (CBC encryption)
+ *    bcctr_impl       block cipher implementation (CTR)
+ *    cipher_key_len   block cipher key length (in bytes)
+ *    tag_len          authentication tag length (in bytes)
+ */
+void br_ssl_engine_switch_ccm_in(br_ssl_engine_context *cc,
+	int is_client, int prf_id,
+	const br_block_cbcenc_class *bc_impl,
+	const br_block_ctr_class *bcctr_impl,
+	size_t cipher_key_len, size_t tag_len);
+
+/*
+ * Switch to CCM encryption for outgoing records.
+ *    cc               the engine context
+ *    is_client        non-zero for a client, zero for a server
+ *    prf_id           id of hash function for PRF
+ *    bc_impl          block cipher implementation (CBC encryption)
+ *    bcctr_impl       block cipher implementation (CTR)
+ *    cipher_key_len   block cipher key length (in bytes)
+ *    tag_len          authentication tag length (in bytes)
+ */
+void br_ssl_engine_switch_ccm_out(br_ssl_engine_context *cc,
+	int is_client, int prf_id,
+	const br_block_cbcenc_class *bc_impl,
+	const br_block_ctr_class *bcctr_impl,
+	size_t cipher_key_len, size_t tag_len);
+
+/*
+ * Switch to ChaCha20+Poly1305 decryption for incoming records.
+ *    cc               the engine context
+ *    is_client        non-zero for a client, zero for a server
+ *    prf_id           id of hash function for PRF
+ */
+void br_ssl_engine_switch_chapol_in(br_ssl_engine_context *cc,
+	int is_client, int prf_id);
+
+/*
+ * Switch to ChaCha20+Poly1305 encryption for outgoing records.
+ *    cc               the engine context
+ *    is_client        non-zero for a client, zero for a server
+ *    prf_id           id of hash function for PRF
+ */
+void br_ssl_engine_switch_chapol_out(br_ssl_engine_context *cc,
+	int is_client, int prf_id);
+
 /*
  * Calls to T0-generated code.
  */
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * Conditionally swap a[] and b[] (len words each) if ctl is 1. ctl
+ * MUST be 0 or 1.
+ */
+static void
+cswap(uint32_t *a, uint32_t *b, size_t len, uint32_t ctl)
+{
+	uint32_t mask;
+	size_t u;
+
+	mask = -ctl;
+	for (u = 0; u < len; u ++) {
+		uint32_t w;
+
+		w = (a[u] ^ b[u]) & mask;
+		a[u] ^= w;
+		b[u] ^= w;
+	}
+}
+
+/*
+ * Divide x[] by 2, inserting the 'hi' bit (0 or 1) as the new top bit
+ * of the last value word. The announced bit length is not modified.
+ */
+static void
+rshift1(uint32_t *x, size_t len, uint32_t hi)
+{
+	size_t u;
+
+	for (u = 1; u < len; u ++) {
+		x[u] = ((x[u] >> 1) | (x[u + 1] << 30)) & 0x7FFFFFFF;
+	}
+	x[len] = (x[len] >> 1) | (hi << 30);
+}
+
+/* see inner.h */
+uint32_t
+br_i31_moddiv(uint32_t *x, const uint32_t *y,
+	const uint32_t *m, uint32_t *t)
+{
+	/*
+	 * Binary extended GCD, in constant time. We maintain four
+	 * values a, b, u and v, with the invariants:
+	 *
+	 *   a*x = u*y mod m
+	 *   b*x = v*y mod m
+	 *   b is odd
+	 *
+	 * starting with a = y, b = m, u = x and v = 0. At each
+	 * iteration, if a is odd, then we subtract b from a (swapping
+	 * the two values beforehand if a < b); a is then even and gets
+	 * divided by 2. Each iteration at least halves the product a*b,
+	 * thus 2*k iterations (with k the bit length of m) are enough
+	 * to reach a = 0, at which point b is the GCD of y and m. If
+	 * that GCD is 1, then v is x/y mod m.
+	 *
+	 * All operations are performed unconditionally, with masks;
+	 * the number of iterations depends only on the size of m.
+	 */
+	size_t len, u;
+	uint32_t *a, *b, *ua, *va;
+	uint32_t num, r;
+
+	len = (m[0] + 31) >> 5;
+	a = t;
+	b = a + 1 + len;
+	ua = b + 1 + len;
+	va = ua + 1 + len;
+	memcpy(a, y, (len + 1) * sizeof *y);
+	memcpy(b, m, (len + 1) * sizeof *m);
+	memcpy(ua, x, (len + 1) * sizeof *x);
+	br_i31_zero(va, m[0]);
+
+	num = (m[0] - (m[0] >> 5)) << 1;
+	while (num -- > 0) {
+		uint32_t odd, sw, c;
+
+		odd = a[1] & 1;
+		sw = odd & br_i31_sub(a, b, 0);
+		cswap(a + 1, b + 1, len, sw);
+		cswap(ua + 1, va + 1, len, sw);
+		br_i31_sub(a, b, odd);
+		c = odd & br_i31_sub(ua, va, odd);
+		br_i31_add(ua, m, c);
+		rshift1(a, len, 0);
+		c = ua[1] & 1;
+		rshift1(ua, len, c & br_i31_add(ua, m, c));
+	}
+
+	/*
+	 * Division is possible only if b = 1.
+	 */
+	r = b[1] ^ 1;
+	for (u = 2; u <= len; u ++) {
+		r |= b[u];
+	}
+	r = EQ(r, 0);
+	CCOPY(r, x + 1, va + 1, len * sizeof *x);
+	return r;
+}
@@ -59,7 +59,7 @@ br_i31_modpow(uint32_t *x,
 		ctl = (e[elen - 1 - (k >> 3)] >> (k & 7)) & 1;
 		br_i31_montymul(t2, x, t1, m, m0i);
 		CCOPY(ctl, x, t2, mlen);
-		br_i31_montymul(t2, t1, t1, m, m0i);
+		br_i31_montysqr(t2, t1, m, m0i);
 		memcpy(t1, t2, mlen);
 	}
 }
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * Common implementation for br_i31_modpow_opt() and
+ * br_i31_modpow_opt_r2(); if r2 is not NULL, then it contains R^2 mod m,
+ * which is used for the conversion of x into Montgomery representation.
+ */
+static uint32_t
+modpow_opt_inner(uint32_t *x,
+	const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, const uint32_t *r2,
+	uint32_t *tmp, size_t twlen)
+{
+	size_t mlen, mwlen;
+	uint32_t *t1, *t2, *base;
+	size_t u, v;
+	uint32_t acc;
+	int acc_len, win_len;
+	void (*mmul)(uint32_t *d, const uint32_t *x, const uint32_t *y,
+		const uint32_t *m, uint32_t m0i);
+	void (*msqr)(uint32_t *d, const uint32_t *x,
+		const uint32_t *m, uint32_t m0i);
+
+	/*
+	 * 'mwlen' is the length of m[] expressed in words (including
+	 * the "bit length" first field); 'mlen' is the same length in
+	 * bytes.
+	 */
+	mwlen = (m[0] + 63) >> 5;
+	mlen = mwlen * sizeof m[0];
+	t1 = tmp;
+	t2 = tmp + mwlen;
+
+	/*
+	 * We need at least two temporaries (t1 for multiplication
+	 * output, t2 for the selected window value). Each extra
+	 * temporary doubles the window table size, up to a 5-bit
+	 * window (32 table entries, one of which is the value 1 and
+	 * is not stored).
+	 */
+	if (twlen < (mwlen << 1)) {
+		return 0;
+	}
+	for (win_len = 5; win_len > 1; win_len --) {
+		if ((((uint32_t)1 << win_len) + 1) * mwlen <= twlen) {
+			break;
+		}
+	}
+
+	/*
+	 * Large moduli may use Karatsuba multiplication (see
+	 * BR_I31_KARATSUBA in config.h).
+	 */
+	mmul = &br_i31_montymul;
+	msqr = &br_i31_montysqr;
+#if BR_I31_KARATSUBA
+	if (mwlen > BR_I31_KARATSUBA) {
+		mmul = &br_i31_montymul_k;
+		msqr = &br_i31_montysqr_k;
+	}
+#endif
+
+	/*
+	 * Everything is done in Montgomery representation. With R^2,
+	 * the conversion is a single Montgomery multiplication.
+	 */
+	if (r2 != NULL) {
+		mmul(t1, x, r2, m, m0i);
+		memcpy(x, t1, mlen);
+	} else {
+		br_i31_to_monty(x, m);
+	}
+
+	/*
+	 * Compute window contents. If the window has size one bit only,
+	 * then t2 is set to x; otherwise, t2[0] is left untouched, and
+	 * t2[k] is set to x^k (for k >= 1).
+	 */
+	if (win_len == 1) {
+		memcpy(t2, x, mlen);
+	} else {
+		base = t2 + mwlen;
+		memcpy(base, x, mlen);
+		for (u = 2; u < ((unsigned)1 << win_len); u ++) {
+			mmul(base + mwlen, base, x, m, m0i);
+			base += mwlen;
+		}
+	}
+
+	/*
+	 * We need to set x to 1, in Montgomery representation. This can
+	 * be done efficiently by setting the high word to 1, then doing
+	 * one word-sized shift.
+	 */
+	br_i31_zero(x, m[0]);
+	x[(m[0] + 31) >> 5] = 1;
+	br_i31_muladd_small(x, 0, m);
+
+	/*
+	 * We process bits from most to least significant. At each
+	 * loop iteration, we have acc_len bits in acc.
+	 */
+	acc = 0;
+	acc_len = 0;
+	while (acc_len > 0 || elen > 0) {
+		int i, k;
+		uint32_t bits;
+
+		/*
+		 * Get the next bits.
+		 */
+		k = win_len;
+		if (acc_len < win_len) {
+			if (elen > 0) {
+				acc = (acc << 8) | *e ++;
+				elen --;
+				acc_len += 8;
+			} else {
+				k = acc_len;
+			}
+		}
+		bits = (acc >> (acc_len - k)) & (((uint32_t)1 << k) - 1);
+		acc_len -= k;
+
+		/*
+		 * We could get exactly k bits. Compute k squarings.
+		 */
+		for (i = 0; i < k; i ++) {
+			msqr(t1, x, m, m0i);
+			memcpy(x, t1, mlen);
+		}
+
+		/*
+		 * Window lookup: we want to set t2 to the window
+		 * lookup value, assuming the bits are non-zero. If
+		 * the window length is 1 bit only, then t2 is
+		 * already set; otherwise, we do a constant-time lookup
+		 * by reading all the table entries.
+		 */
+		if (win_len > 1) {
+			br_i31_zero(t2, m[0]);
+			base = t2 + mwlen;
+			for (u = 1; u < ((uint32_t)1 << k); u ++) {
+				uint32_t mask;
+
+				mask = -EQ((uint32_t)u, bits);
+				for (v = 1; v < mwlen; v ++) {
+					t2[v] |= mask & base[v];
+				}
+				base += mwlen;
+			}
+		}
+
+		/*
+		 * Multiply with the looked-up value. We keep the
+		 * product only if the exponent bits are not all-zero.
+		 */
+		mmul(t1, x, t2, m, m0i);
+		CCOPY(NEQ(bits, 0), x, t1, mlen);
+	}
+
+	/*
+	 * Convert back from Montgomery representation, and exit.
+	 */
+	br_i31_from_monty(x, m, m0i);
+	return 1;
+}
+
+/* see inner.h */
+uint32_t
+br_i31_modpow_opt(uint32_t *x,
+	const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	return modpow_opt_inner(x, e, elen, m, m0i, NULL, tmp, twlen);
+}
+
+/* see inner.h */
+uint32_t
+br_i31_modpow_opt_r2(uint32_t *x,
+	const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, const uint32_t *r2,
+	uint32_t *tmp, size_t twlen)
+{
+	return modpow_opt_inner(x, e, elen, m, m0i, r2, tmp, twlen);
+}
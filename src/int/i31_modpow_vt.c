@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * Get bit k of the exponent (bit 0 is the least significant).
+ */
+static inline uint32_t
+ebit(const unsigned char *e, size_t elen, uint32_t k)
+{
+	return (e[elen - 1 - (k >> 3)] >> (k & 7)) & 1;
+}
+
+/* see inner.h */
+uint32_t
+br_i31_modpow_vartime(uint32_t *x,
+	const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	size_t mlen, mwlen;
+	uint32_t *t1, *base;
+	uint32_t ebits, u;
+	int win_len;
+
+	/*
+	 * 'mwlen' is the length of m[] expressed in words (including
+	 * the "bit length" first field); 'mlen' is the same length in
+	 * bytes.
+	 */
+	mwlen = (m[0] + 63) >> 5;
+	mlen = mwlen * sizeof m[0];
+	if (twlen < (mwlen << 1)) {
+		return 0;
+	}
+	t1 = tmp;
+	base = tmp + mwlen;
+
+	/*
+	 * Skip leading zeros of the exponent (this is variable-time).
+	 * A zero exponent yields 1.
+	 */
+	while (elen > 0 && *e == 0) {
+		e ++;
+		elen --;
+	}
+	if (elen == 0) {
+		br_i31_zero(x, m[0]);
+		x[1] = 1;
+		return 1;
+	}
+	ebits = ((uint32_t)elen << 3) - 8 + BIT_LENGTH(e[0]);
+
+	/*
+	 * Window size is chosen after the exponent length; short
+	 * exponents (e.g. 3 or 65537) use plain square-and-multiply. The
+	 * window table contains the odd powers x, x^3, x^5... and its
+	 * size is also limited by the available space.
+	 */
+	if (ebits > 239) {
+		win_len = 5;
+	} else if (ebits > 79) {
+		win_len = 4;
+	} else if (ebits > 23) {
+		win_len = 3;
+	} else {
+		win_len = 1;
+	}
+	while (win_len > 1
+		&& (((uint32_t)1 << (win_len - 1)) + 1) * mwlen > twlen)
+	{
+		win_len --;
+	}
+
+	/*
+	 * Fill the window table, in Montgomery representation. The x[]
+	 * array is used to hold x^2 while the table is computed.
+	 */
+	br_i31_to_monty(x, m);
+	memcpy(base, x, mlen);
+	if (win_len > 1) {
+		br_i31_montysqr(t1, base, m, m0i);
+		memcpy(x, t1, mlen);
+		for (u = 1; u < ((uint32_t)1 << (win_len - 1)); u ++) {
+			br_i31_montymul(base + u * mwlen,
+				base + (u - 1) * mwlen, x, m, m0i);
+		}
+	}
+
+	/*
+	 * Process the exponent bits from most to least significant.
+	 * A window always starts and ends with a one bit. The top bit
+	 * is a one; the corresponding window initialises x[].
+	 */
+	u = ebits;
+	while (u > 0) {
+		uint32_t j, k, bits;
+
+		if (!ebit(e, elen, u - 1)) {
+			br_i31_montysqr(t1, x, m, m0i);
+			memcpy(x, t1, mlen);
+			u --;
+			continue;
+		}
+		j = (u > (uint32_t)win_len) ? u - win_len : 0;
+		while (!ebit(e, elen, j)) {
+			j ++;
+		}
+		bits = 0;
+		for (k = u; k > j; k --) {
+			bits = (bits << 1) | ebit(e, elen, k - 1);
+		}
+		if (u == ebits) {
+			memcpy(x, base + (bits >> 1) * mwlen, mlen);
+		} else {
+			for (k = u; k > j; k --) {
+				br_i31_montysqr(t1, x, m, m0i);
+				memcpy(x, t1, mlen);
+			}
+			br_i31_montymul(t1, x, base + (bits >> 1) * mwlen,
+				m, m0i);
+			memcpy(x, t1, mlen);
+		}
+		u = j;
+	}
+
+	/*
+	 * Convert back from Montgomery representation.
+	 */
+	br_i31_from_monty(x, m, m0i);
+	return 1;
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * Karatsuba multiplication and squaring work on plain arrays of 31-bit
+ * words (little-endian order, without the "bit length" header word).
+ * The Montgomery reduction is then applied as a separate step. All
+ * loops depend only on the operand lengths, so these functions are
+ * constant-time.
+ *
+ * Operands of fewer than KLEAF words use schoolbook code.
+ */
+#define KLEAF    32
+
+/*
+ * Maximum operand size (in words), and size of the scratch area for the
+ * recursive functions: for n words, the scratch size S(n) is at most
+ * 6*ceil(n/2)+1+S(ceil(n/2)), which is less than 6*n+64.
+ */
+#define MAXLEN   ((BR_MAX_RSA_FACTOR + 30) / 31)
+#define KTMP     (6 * MAXLEN + 64)
+
+/*
+ * d[0..2n-1] = a*b (schoolbook).
+ */
+static void
+mul_basic(uint32_t *d, const uint32_t *a, const uint32_t *b, size_t n)
+{
+	size_t u, v, n4;
+
+	n4 = n & ~(size_t)3;
+	memset(d, 0, 2 * n * sizeof *d);
+	for (u = 0; u < n; u ++) {
+		uint32_t au, cc;
+
+		au = a[u];
+		cc = 0;
+		for (v = 0; v < n4; v += 4) {
+			uint64_t z;
+
+			z = (uint64_t)d[u + v] + MUL31(au, b[v]) + cc;
+			d[u + v] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[u + v + 1] + MUL31(au, b[v + 1])
+				+ (z >> 31);
+			d[u + v + 1] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[u + v + 2] + MUL31(au, b[v + 2])
+				+ (z >> 31);
+			d[u + v + 2] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[u + v + 3] + MUL31(au, b[v + 3])
+				+ (z >> 31);
+			d[u + v + 3] = (uint32_t)z & 0x7FFFFFFF;
+			cc = (uint32_t)(z >> 31);
+		}
+		for (; v < n; v ++) {
+			uint64_t z;
+
+			z = (uint64_t)d[u + v] + MUL31(au, b[v]) + cc;
+			d[u + v] = (uint32_t)z & 0x7FFFFFFF;
+			cc = (uint32_t)(z >> 31);
+		}
+		d[u + n] = cc;
+	}
+}
+
+/*
+ * d[0..2n-1] = a^2 (schoolbook). Cross products are computed once and
+ * doubled, then the squares of the individual words are added.
+ */
+static void
+sqr_basic(uint32_t *d, const uint32_t *a, size_t n)
+{
+	size_t u, v;
+	uint32_t cc;
+
+	memset(d, 0, 2 * n * sizeof *d);
+	for (u = 0; u < n; u ++) {
+		uint32_t au;
+
+		au = a[u];
+		cc = 0;
+		for (v = u + 1; v + 4 <= n; v += 4) {
+			uint64_t z;
+
+			z = (uint64_t)d[u + v] + MUL31(au, a[v]) + cc;
+			d[u + v] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[u + v + 1] + MUL31(au, a[v + 1])
+				+ (z >> 31);
+			d[u + v + 1] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[u + v + 2] + MUL31(au, a[v + 2])
+				+ (z >> 31);
+			d[u + v + 2] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[u + v + 3] + MUL31(au, a[v + 3])
+				+ (z >> 31);
+			d[u + v + 3] = (uint32_t)z & 0x7FFFFFFF;
+			cc = (uint32_t)(z >> 31);
+		}
+		for (; v < n; v ++) {
+			uint64_t z;
+
+			z = (uint64_t)d[u + v] + MUL31(au, a[v]) + cc;
+			d[u + v] = (uint32_t)z & 0x7FFFFFFF;
+			cc = (uint32_t)(z >> 31);
+		}
+		d[u + n] = cc;
+	}
+	cc = 0;
+	for (u = 0; u < 2 * n; u ++) {
+		uint32_t w;
+
+		w = d[u];
+		d[u] = ((w << 1) | cc) & 0x7FFFFFFF;
+		cc = w >> 30;
+	}
+	cc = 0;
+	for (u = 0; u < n; u ++) {
+		uint64_t z;
+
+		z = (uint64_t)d[2 * u] + MUL31(a[u], a[u]) + cc;
+		d[2 * u] = (uint32_t)z & 0x7FFFFFFF;
+		z = (uint64_t)d[2 * u + 1] + (z >> 31);
+		d[2 * u + 1] = (uint32_t)z & 0x7FFFFFFF;
+		cc = (uint32_t)(z >> 31);
+	}
+}
+
+/*
+ * a[0..na-1] += b[0..nb-1] if neg == 0, or a[0..na-1] -= b[0..nb-1]
+ * if neg == 1 (nb <= na). Computations are modulo 2^(31*na).
+ */
+static void
+add_sub(uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t neg)
+{
+	size_t u;
+	uint32_t cc, m;
+
+	m = -neg;
+	cc = neg;
+	for (u = 0; u < na; u ++) {
+		uint32_t w;
+
+		w = u < nb ? b[u] : 0;
+		w = a[u] + ((w ^ m) & 0x7FFFFFFF) + cc;
+		a[u] = w & 0x7FFFFFFF;
+		cc = w >> 31;
+	}
+}
+
+/*
+ * d[0..n-1] = |a - b|, where a[] has n words and b[] has nb words
+ * (nb <= n). Returned value is 1 if a < b, 0 otherwise.
+ */
+static uint32_t
+abs_diff(uint32_t *d, const uint32_t *a, size_t n,
+	const uint32_t *b, size_t nb)
+{
+	size_t u;
+	uint32_t cc, neg, m;
+
+	cc = 0;
+	for (u = 0; u < n; u ++) {
+		uint32_t w;
+
+		w = a[u] - cc - (u < nb ? b[u] : 0);
+		d[u] = w & 0x7FFFFFFF;
+		cc = w >> 31;
+	}
+
+	/*
+	 * On borrow, negate the result (two's complement).
+	 */
+	neg = cc;
+	m = -neg;
+	for (u = 0; u < n; u ++) {
+		uint32_t w;
+
+		w = ((d[u] ^ m) & 0x7FFFFFFF) + cc;
+		d[u] = w & 0x7FFFFFFF;
+		cc = w >> 31;
+	}
+	return neg;
+}
+
+/*
+ * d[0..2n-1] = a*b, with a[] and b[] of n words each. The t[] array
+ * is scratch space (see KTMP).
+ *
+ * With h = ceil(n/2), a = a0 + a1*W^h and b = b0 + b1*W^h:
+ *   a*b = a0*b0 + (a0*b1 + a1*b0)*W^h + a1*b1*W^(2h)
+ *   a0*b1 + a1*b0 = a0*b0 + a1*b1 - (a0 - a1)*(b0 - b1)
+ * The middle product is computed over absolute values, and its sign
+ * is applied with a constant-time conditional negation.
+ */
+static void
+kmul(uint32_t *d, const uint32_t *a, const uint32_t *b, size_t n,
+	uint32_t *t)
+{
+	size_t h, l;
+	uint32_t *da, *db, *p, *mid;
+	uint32_t neg;
+
+	if (n < KLEAF) {
+		mul_basic(d, a, b, n);
+		return;
+	}
+	h = (n + 1) >> 1;
+	l = n - h;
+	da = t;
+	db = t + h;
+	p = t + 2 * h;
+	mid = t + 4 * h;
+
+	kmul(d, a, b, h, t);
+	kmul(d + 2 * h, a + h, b + h, l, t);
+	neg = abs_diff(da, a, h, a + h, l) ^ abs_diff(db, b, h, b + h, l);
+	kmul(p, da, db, h, t + 6 * h + 1);
+
+	memcpy(mid, d, 2 * h * sizeof *d);
+	mid[2 * h] = 0;
+	add_sub(mid, 2 * h + 1, d + 2 * h, 2 * l, 0);
+	add_sub(mid, 2 * h + 1, p, 2 * h, neg ^ 1);
+	add_sub(d + h, 2 * n - h, mid, 2 * h + 1, 0);
+}
+
+/*
+ * d[0..2n-1] = a^2, with a[] of n words. The t[] array is scratch
+ * space (see KTMP). This uses the same decomposition as kmul(), with
+ * a0*a1 + a1*a0 = a0^2 + a1^2 - (a0 - a1)^2.
+ */
+static void
+ksqr(uint32_t *d, const uint32_t *a, size_t n, uint32_t *t)
+{
+	size_t h, l;
+	uint32_t *da, *p, *mid;
+
+	if (n < KLEAF) {
+		sqr_basic(d, a, n);
+		return;
+	}
+	h = (n + 1) >> 1;
+	l = n - h;
+	da = t;
+	p = t + h;
+	mid = t + 3 * h;
+
+	ksqr(d, a, h, t);
+	ksqr(d + 2 * h, a + h, l, t);
+	abs_diff(da, a, h, a + h, l);
+	ksqr(p, da, h, t + 5 * h + 1);
+
+	memcpy(mid, d, 2 * h * sizeof *d);
+	mid[2 * h] = 0;
+	add_sub(mid, 2 * h + 1, d + 2 * h, 2 * l, 0);
+	add_sub(mid, 2 * h + 1, p, 2 * h, 1);
+	add_sub(d + h, 2 * n - h, mid, 2 * h + 1, 0);
+}
+
+/*
+ * Montgomery reduction: d = t/R mod m, where t[] holds a product of
+ * 2*len words (t[] is modified) and R = 2^(31*len).
+ */
+static void
+redc(uint32_t *d, uint32_t *t, const uint32_t *m, uint32_t m0i, size_t len)
+{
+	size_t u, v, len4;
+	uint32_t dh;
+
+	len4 = len & ~(size_t)3;
+	dh = 0;
+	for (u = 0; u < len; u ++) {
+		uint32_t f, cc;
+		uint64_t z;
+
+		f = (t[u] * m0i) & 0x7FFFFFFF;
+		cc = 0;
+		for (v = 0; v < len4; v += 4) {
+			z = (uint64_t)t[u + v] + MUL31(f, m[v + 1]) + cc;
+			t[u + v] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)t[u + v + 1] + MUL31(f, m[v + 2])
+				+ (z >> 31);
+			t[u + v + 1] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)t[u + v + 2] + MUL31(f, m[v + 3])
+				+ (z >> 31);
+			t[u + v + 2] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)t[u + v + 3] + MUL31(f, m[v + 4])
+				+ (z >> 31);
+			t[u + v + 3] = (uint32_t)z & 0x7FFFFFFF;
+			cc = (uint32_t)(z >> 31);
+		}
+		for (; v < len; v ++) {
+			z = (uint64_t)t[u + v] + MUL31(f, m[v + 1]) + cc;
+			t[u + v] = (uint32_t)z & 0x7FFFFFFF;
+			cc = (uint32_t)(z >> 31);
+		}
+		z = (uint64_t)t[u + len] + cc + dh;
+		t[u + len] = (uint32_t)z & 0x7FFFFFFF;
+		dh = (uint32_t)(z >> 31);
+	}
+
+	/*
+	 * The result is lower than 2*m; a single conditional subtraction
+	 * brings it in the proper range.
+	 */
+	d[0] = m[0];
+	memcpy(d + 1, t + len, len * sizeof *t);
+	br_i31_sub(d, m, NEQ(dh, 0) | NOT(br_i31_sub(d, m, 0)));
+}
+
+/* see inner.h */
+void
+br_i31_montymul_k(uint32_t *d, const uint32_t *x, const uint32_t *y,
+	const uint32_t *m, uint32_t m0i)
+{
+	uint32_t t[2 * MAXLEN], s[KTMP];
+	size_t len;
+
+	len = (m[0] + 31) >> 5;
+	if (len > MAXLEN) {
+		br_i31_montymul(d, x, y, m, m0i);
+		return;
+	}
+	kmul(t, x + 1, y + 1, len, s);
+	redc(d, t, m, m0i, len);
+}
+
+/* see inner.h */
+void
+br_i31_montysqr_k(uint32_t *d, const uint32_t *x,
+	const uint32_t *m, uint32_t m0i)
+{
+	uint32_t t[2 * MAXLEN], s[KTMP];
+	size_t len;
+
+	len = (m[0] + 31) >> 5;
+	if (len > MAXLEN) {
+		br_i31_montysqr(d, x, m, m0i);
+		return;
+	}
+	ksqr(t, x + 1, len, s);
+	redc(d, t, m, m0i, len);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/* see inner.h */
+void
+br_i31_montysqr(uint32_t *d, const uint32_t *x,
+	const uint32_t *m, uint32_t m0i)
+{
+	size_t len, u, v;
+	uint64_t dh;
+
+	/*
+	 * This follows br_i31_montymul(), with y = x. At step u, we
+	 * add x[u]*x[v] for v >= u only: the square term x[u]^2 once,
+	 * and the cross terms x[u]*x[v] (v > u) twice, since the
+	 * symmetric terms x[v]*x[u] will not be added at step v. The
+	 * positions below u (in the shifted accumulator) only receive
+	 * the reduction term f*m. Each term x[u]*x[v] is added at step
+	 * u <= u+v, i.e. before the word at position u+v is reduced.
+	 * This saves about one quarter of the multiplications.
+	 */
+	len = (m[0] + 31) >> 5;
+	br_i32_zero(d, m[0]);
+	dh = 0;
+	for (u = 0; u < len; u ++) {
+		uint32_t f, xu;
+		uint64_t r, z, zh;
+
+		xu = x[u + 1];
+		f = d[1];
+		if (u == 0) {
+			f += xu * xu;
+		}
+		f = (f * m0i) & 0x7FFFFFFF;
+
+		r = 0;
+		for (v = 0; v + 4 <= u; v += 4) {
+			z = (uint64_t)d[v + 1] + MUL31(f, m[v + 1]) + r;
+			d[v] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[v + 2] + MUL31(f, m[v + 2]) + (z >> 31);
+			d[v + 1] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[v + 3] + MUL31(f, m[v + 3]) + (z >> 31);
+			d[v + 2] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[v + 4] + MUL31(f, m[v + 4]) + (z >> 31);
+			d[v + 3] = (uint32_t)z & 0x7FFFFFFF;
+			r = z >> 31;
+		}
+		for (; v < u; v ++) {
+			z = (uint64_t)d[v + 1] + MUL31(f, m[v + 1]) + r;
+			r = z >> 31;
+			d[v] = (uint32_t)z & 0x7FFFFFFF;
+		}
+		z = (uint64_t)d[u + 1] + MUL31(f, m[u + 1])
+			+ MUL31(xu, xu) + r;
+		r = z >> 31;
+		d[u] = (uint32_t)z & 0x7FFFFFFF;
+		for (v = u + 1; v + 4 <= len; v += 4) {
+			z = (uint64_t)d[v + 1] + MUL31(f, m[v + 1])
+				+ (MUL31(xu, x[v + 1]) << 1) + r;
+			d[v] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[v + 2] + MUL31(f, m[v + 2])
+				+ (MUL31(xu, x[v + 2]) << 1) + (z >> 31);
+			d[v + 1] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[v + 3] + MUL31(f, m[v + 3])
+				+ (MUL31(xu, x[v + 3]) << 1) + (z >> 31);
+			d[v + 2] = (uint32_t)z & 0x7FFFFFFF;
+			z = (uint64_t)d[v + 4] + MUL31(f, m[v + 4])
+				+ (MUL31(xu, x[v + 4]) << 1) + (z >> 31);
+			d[v + 3] = (uint32_t)z & 0x7FFFFFFF;
+			r = z >> 31;
+		}
+		for (; v < len; v ++) {
+			z = (uint64_t)d[v + 1] + MUL31(f, m[v + 1])
+				+ (MUL31(xu, x[v + 1]) << 1) + r;
+			r = z >> 31;
+			d[v] = (uint32_t)z & 0x7FFFFFFF;
+		}
+
+		zh = dh + r;
+		d[len] = (uint32_t)zh & 0x7FFFFFFF;
+		dh = zh >> 31;
+	}
+
+	/*
+	 * Restore the bit length (overwritten in the loop), and do the
+	 * final conditional subtraction, as in br_i31_montymul().
+	 */
+	d[0] = m[0];
+	br_i31_sub(d, m, NEQ(dh, 0) | NOT(br_i31_sub(d, m, 0)));
+}
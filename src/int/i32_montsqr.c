@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/* see inner.h */
+void
+br_i32_montysqr(uint32_t *d, const uint32_t *x,
+	const uint32_t *m, uint32_t m0i)
+{
+	size_t len, u, v;
+	uint64_t dh;
+
+	/*
+	 * This follows br_i32_montymul(), with y = x. At step u, we
+	 * add x[u]*x[v] for v >= u only: the square term x[u]^2 once,
+	 * and the cross terms x[u]*x[v] (v > u) twice, since the
+	 * symmetric terms x[v]*x[u] will not be added at step v. The
+	 * positions below u (in the shifted accumulator) only receive
+	 * the reduction term f*m. Each product is computed once; the
+	 * cross terms are added in two separate carry chains (r1 and
+	 * r2), since twice a 64-bit product does not fit in 64 bits.
+	 */
+	len = (m[0] + 31) >> 5;
+	br_i32_zero(d, m[0]);
+	dh = 0;
+	for (u = 0; u < len; u ++) {
+		uint32_t f, xu;
+		uint64_t r1, r2, r3, zh;
+
+		xu = x[u + 1];
+		f = d[1];
+		if (u == 0) {
+			f += xu * xu;
+		}
+		f *= m0i;
+		r1 = 0;
+		r2 = 0;
+		r3 = 0;
+		for (v = 0; v < u; v ++) {
+			uint64_t z;
+
+			z = (uint64_t)d[v + 1] + MUL(f, m[v + 1]) + r3;
+			r3 = z >> 32;
+			if (v != 0) {
+				d[v] = (uint32_t)z;
+			}
+		}
+		for (; v < len; v ++) {
+			uint64_t z, p;
+			uint32_t t;
+
+			p = MUL(xu, x[v + 1]);
+			z = (uint64_t)d[v + 1] + p + r1;
+			r1 = z >> 32;
+			t = (uint32_t)z;
+			if (v != u) {
+				z = (uint64_t)t + p + r2;
+				r2 = z >> 32;
+				t = (uint32_t)z;
+			}
+			z = (uint64_t)t + MUL(f, m[v + 1]) + r3;
+			r3 = z >> 32;
+			if (v != 0) {
+				d[v] = (uint32_t)z;
+			}
+		}
+		zh = dh + r1 + r2 + r3;
+		d[len] = (uint32_t)zh;
+		dh = zh >> 32;
+	}
+
+	/*
+	 * d[] may still be greater than m[] at that point; notably, the
+	 * 'dh' word may be non-zero.
+	 */
+	br_i32_sub(d, m, NEQ(dh, 0) | NOT(br_i32_sub(d, m, 0)));
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+#if BR_INT128
+
+/*
+ * In this file, integers are arrays of 64-bit words, with 62 bits
+ * per word, in little-endian order, without a header word (the
+ * number of words is provided separately). Two i31 words map exactly
+ * to one i62 word.
+ */
+
+#define MASK62   ((uint64_t)0x3FFFFFFFFFFFFFFF)
+
+/*
+ * Subtract b[] from a[] (both over 'num' words), and return the final
+ * carry. If 'ctl' is 0, then a[] is unmodified, but the final carry is
+ * still computed and returned.
+ */
+static uint32_t
+i62_sub(uint64_t *a, const uint64_t *b, size_t num, uint32_t ctl)
+{
+	uint64_t cc, mask;
+	size_t u;
+
+	cc = 0;
+	mask = -(uint64_t)ctl;
+	for (u = 0; u < num; u ++) {
+		uint64_t aw, dw;
+
+		aw = a[u];
+		dw = aw - b[u] - cc;
+		cc = dw >> 63;
+		dw &= MASK62;
+		a[u] = aw ^ (mask & (dw ^ aw));
+	}
+	return (uint32_t)cc;
+}
+
+/*
+ * Montgomery multiplication: d[] is set to x*y/R mod m, with
+ * R = 2^(62*num). x[] and y[] must be lower than m[]; d[] must be
+ * distinct from x[], y[] and m[]. m0i is -(1/m[0]) mod 2^62.
+ */
+static void
+montymul(uint64_t *d, const uint64_t *x, const uint64_t *y,
+	const uint64_t *m, size_t num, uint64_t m0i)
+{
+	uint64_t dh;
+	size_t u, v;
+
+	memset(d, 0, num * sizeof *d);
+	dh = 0;
+	for (u = 0; u < num; u ++) {
+		uint64_t xu, f, r, zh;
+		unsigned __int128 z;
+
+		/*
+		 * f is chosen so that d + xu*y + f*m is a multiple of
+		 * 2^62; the division by 2^62 is then a word shift.
+		 *
+		 * The 62-bit boundary is moved to bit 64 by multiplying
+		 * everything by 4, so that the high and low parts of
+		 * the 128-bit value are obtained without shifting it.
+		 * The carry r may exceed 62 bits; its top bits, lost
+		 * in r << 2, are added back to the next carry.
+		 */
+		xu = x[u] << 2;
+		f = (((d[0] + x[u] * y[0]) * m0i) & MASK62) << 2;
+		z = (unsigned __int128)xu * y[0]
+			+ (unsigned __int128)f * m[0] + (d[0] << 2);
+		r = (uint64_t)(z >> 64);
+		for (v = 1; v < num; v ++) {
+			z = (unsigned __int128)xu * y[v]
+				+ (unsigned __int128)f * m[v]
+				+ (d[v] << 2) + (r << 2);
+			r = (uint64_t)(z >> 64) + (r >> 62);
+			d[v - 1] = (uint64_t)z >> 2;
+		}
+		zh = dh + r;
+		d[num - 1] = zh & MASK62;
+		dh = zh >> 62;
+	}
+
+	/*
+	 * The result is lower than 2*m; a conditional subtraction
+	 * yields a value lower than m.
+	 */
+	i62_sub(d, m, num, NEQ((uint32_t)dh, 0) | NOT(i62_sub(d, m, num, 0)));
+}
+
+/*
+ * Convert the 'num31' value words of an i31 integer into 62-bit words.
+ */
+static void
+from_i31(uint64_t *d, const uint32_t *x, size_t num31)
+{
+	while (num31 >= 2) {
+		*d ++ = (uint64_t)x[0] | ((uint64_t)x[1] << 31);
+		x += 2;
+		num31 -= 2;
+	}
+	if (num31 == 1) {
+		*d = x[0];
+	}
+}
+
+/*
+ * Convert 62-bit words back into 'num31' i31 value words. If num31 is
+ * odd, the top 62-bit word must fit on 31 bits.
+ */
+static void
+to_i31(uint32_t *d, const uint64_t *x, size_t num31)
+{
+	while (num31 >= 2) {
+		uint64_t w;
+
+		w = *x ++;
+		d[0] = (uint32_t)w & 0x7FFFFFFF;
+		d[1] = (uint32_t)(w >> 31);
+		d += 2;
+		num31 -= 2;
+	}
+	if (num31 == 1) {
+		d[0] = (uint32_t)*x;
+	}
+}
+
+/* see inner.h */
+uint32_t
+br_i62_modpow_opt(uint32_t *x31, const unsigned char *e, size_t elen,
+	const uint32_t *m31, uint32_t m0i31, uint64_t *tmp, size_t twlen)
+{
+	size_t num31, mwlen, mlen, u, v;
+	uint64_t *x, *m, *t1, *t2, *base;
+	uint64_t m0i;
+	uint32_t acc;
+	int win_len, acc_len;
+
+	/*
+	 * 'num31' is the number of i31 value words, 'mwlen' the number
+	 * of 62-bit words, and 'mlen' the corresponding length in bytes.
+	 */
+	num31 = (m31[0] + 31) >> 5;
+	mwlen = (num31 + 1) >> 1;
+	mlen = mwlen * sizeof *tmp;
+
+	/*
+	 * We need the modulus, the current value, a multiplication
+	 * output buffer and the window lookup value. Each extra
+	 * temporary doubles the window table size, up to a 5-bit
+	 * window.
+	 */
+	if (twlen < (mwlen << 2)) {
+		return 0;
+	}
+	for (win_len = 5; win_len > 1; win_len --) {
+		if ((((size_t)1 << win_len) + 3) * mwlen <= twlen) {
+			break;
+		}
+	}
+	m = tmp;
+	x = m + mwlen;
+	t1 = x + mwlen;
+	t2 = t1 + mwlen;
+
+	/*
+	 * Convert the modulus. Since m0i31 = -(1/m) mod 2^31, one
+	 * Newton iteration yields -(1/m) mod 2^62.
+	 */
+	from_i31(m, m31 + 1, num31);
+	m0i = m0i31;
+	m0i = (m0i * (2 + m0i * m[0])) & MASK62;
+
+	/*
+	 * Convert x to Montgomery representation. The i31 Montgomery
+	 * factor is 2^(31*num31); if num31 is odd, one extra 31-bit
+	 * shift is needed to get to 2^(62*mwlen).
+	 */
+	br_i31_to_monty(x31, m31);
+	if ((num31 & 1) != 0) {
+		br_i31_muladd_small(x31, 0, m31);
+	}
+	from_i31(x, x31 + 1, num31);
+
+	/*
+	 * Compute window contents. If the window has size one bit only,
+	 * then t2 is set to x; otherwise, t2[0] is left untouched, and
+	 * t2[k] is set to x^k (for k >= 1).
+	 */
+	if (win_len == 1) {
+		memcpy(t2, x, mlen);
+	} else {
+		base = t2 + mwlen;
+		memcpy(base, x, mlen);
+		for (u = 2; u < ((size_t)1 << win_len); u ++) {
+			montymul(base + mwlen, base, x, m, mwlen, m0i);
+			base += mwlen;
+		}
+	}
+
+	/*
+	 * Set x to 1, in Montgomery representation (i.e. R mod m),
+	 * with the same trick as in br_i31_modpow_opt().
+	 */
+	br_i31_zero(x31, m31[0]);
+	x31[num31] = 1;
+	br_i31_muladd_small(x31, 0, m31);
+	if ((num31 & 1) != 0) {
+		br_i31_muladd_small(x31, 0, m31);
+	}
+	from_i31(x, x31 + 1, num31);
+
+	/*
+	 * Process exponent bits from most to least significant. At each
+	 * loop iteration, we have acc_len bits in acc.
+	 */
+	acc = 0;
+	acc_len = 0;
+	while (acc_len > 0 || elen > 0) {
+		int i, k;
+		uint32_t bits;
+
+		k = win_len;
+		if (acc_len < win_len) {
+			if (elen > 0) {
+				acc = (acc << 8) | *e ++;
+				elen --;
+				acc_len += 8;
+			} else {
+				k = acc_len;
+			}
+		}
+		bits = (acc >> (acc_len - k)) & (((uint32_t)1 << k) - 1);
+		acc_len -= k;
+
+		for (i = 0; i < k; i ++) {
+			montymul(t1, x, x, m, mwlen, m0i);
+			memcpy(x, t1, mlen);
+		}
+
+		/*
+		 * Constant-time window lookup (reads all entries).
+		 */
+		if (win_len > 1) {
+			memset(t2, 0, mlen);
+			base = t2 + mwlen;
+			for (u = 1; u < ((size_t)1 << k); u ++) {
+				uint64_t mask;
+
+				mask = -(uint64_t)EQ((uint32_t)u, bits);
+				for (v = 0; v < mwlen; v ++) {
+					t2[v] |= mask & base[v];
+				}
+				base += mwlen;
+			}
+		}
+
+		/*
+		 * Multiply with the looked-up value. We keep the
+		 * product only if the exponent bits are not all-zero.
+		 */
+		montymul(t1, x, t2, m, mwlen, m0i);
+		CCOPY(NEQ(bits, 0), x, t1, mlen);
+	}
+
+	/*
+	 * Convert back from Montgomery representation (multiplication
+	 * by 1), then to i31 format. x31[0] already contains the proper
+	 * header word.
+	 */
+	memset(t2, 0, mlen);
+	t2[0] = 1;
+	montymul(t1, x, t2, m, mwlen, m0i);
+	to_i31(x31 + 1, t1, num31);
+	return 1;
+}
+
+#else
+
+/* see inner.h */
+uint32_t
+br_i62_modpow_opt(uint32_t *x31, const unsigned char *e, size_t elen,
+	const uint32_t *m31, uint32_t m0i31, uint64_t *tmp, size_t twlen)
+{
+	(void)x31;
+	(void)e;
+	(void)elen;
+	(void)m31;
+	(void)m0i31;
+	(void)tmp;
+	(void)twlen;
+	return 0;
+}
+
+#endif
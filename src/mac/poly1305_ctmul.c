@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * Poly1305 implementation, with 32x32->64 multiplications. Values
+ * modulo p = 2^130-5 are represented over five 26-bit limbs; since
+ * 2^130 = 5 mod p, the upper half of the product can be folded back
+ * with a multiplication by 5, which we precompute for the limbs of r.
+ */
+
+#define MASK26   ((uint32_t)0x03FFFFFF)
+
+/*
+ * Process provided data, by chunks of 16 bytes. If the data length is
+ * not a multiple of 16, then the last chunk is padded with zeros (this
+ * is the padding rule of the ChaCha20+Poly1305 AEAD mode).
+ *
+ * The accumulator is a[] and the key is r[]; all limbs of the key are
+ * lower than 2^26 (this is guaranteed by the key clamping). On input
+ * and output, accumulator limbs are lower than 2^26, except a[1] which
+ * may be slightly larger (up to 2^26 + 2^10).
+ */
+static void
+poly1305_inner(uint32_t *a, const uint32_t *r, const void *data, size_t len)
+{
+	const unsigned char *buf;
+	uint32_t a0, a1, a2, a3, a4;
+	uint32_t r0, r1, r2, r3, r4;
+	uint32_t u1, u2, u3, u4;
+
+	r0 = r[0];
+	r1 = r[1];
+	r2 = r[2];
+	r3 = r[3];
+	r4 = r[4];
+	u1 = r1 * 5;
+	u2 = r2 * 5;
+	u3 = r3 * 5;
+	u4 = r4 * 5;
+	a0 = a[0];
+	a1 = a[1];
+	a2 = a[2];
+	a3 = a[3];
+	a4 = a[4];
+	buf = data;
+	while (len > 0) {
+		uint64_t w0, w1, w2, w3, w4;
+		uint64_t c;
+		unsigned char tmp[16];
+
+		if (len < 16) {
+			memset(tmp, 0, sizeof tmp);
+			memcpy(tmp, buf, len);
+			buf = tmp;
+			len = 16;
+		}
+
+		/*
+		 * Decode the next block and add it to the accumulator,
+		 * including the extra bit at position 128.
+		 */
+		a0 += br_dec32le(buf) & MASK26;
+		a1 += (br_dec32le(buf +  3) >> 2) & MASK26;
+		a2 += (br_dec32le(buf +  6) >> 4) & MASK26;
+		a3 += (br_dec32le(buf +  9) >> 6) & MASK26;
+		a4 += (br_dec32le(buf + 12) >> 8) | 0x01000000;
+
+		/*
+		 * Multiply by r, with folding of the upper limbs.
+		 */
+#define M(x, y)   ((uint64_t)(x) * (uint64_t)(y))
+
+		w0 = M(a0, r0) + M(a1, u4) + M(a2, u3) + M(a3, u2) + M(a4, u1);
+		w1 = M(a0, r1) + M(a1, r0) + M(a2, u4) + M(a3, u3) + M(a4, u2);
+		w2 = M(a0, r2) + M(a1, r1) + M(a2, r0) + M(a3, u4) + M(a4, u3);
+		w3 = M(a0, r3) + M(a1, r2) + M(a2, r1) + M(a3, r0) + M(a4, u4);
+		w4 = M(a0, r4) + M(a1, r3) + M(a2, r2) + M(a3, r1) + M(a4, r0);
+
+#undef M
+
+		/*
+		 * Carry propagation. The carry out of the top limb is
+		 * multiplied by 5 and added back into the low limb.
+		 */
+		c = w0 >> 26;
+		a0 = (uint32_t)w0 & MASK26;
+		w1 += c;
+		c = w1 >> 26;
+		a1 = (uint32_t)w1 & MASK26;
+		w2 += c;
+		c = w2 >> 26;
+		a2 = (uint32_t)w2 & MASK26;
+		w3 += c;
+		c = w3 >> 26;
+		a3 = (uint32_t)w3 & MASK26;
+		w4 += c;
+		c = w4 >> 26;
+		a4 = (uint32_t)w4 & MASK26;
+		c = (uint64_t)a0 + c * 5;
+		a0 = (uint32_t)c & MASK26;
+		a1 += (uint32_t)(c >> 26);
+
+		buf += 16;
+		len -= 16;
+	}
+	a[0] = a0;
+	a[1] = a1;
+	a[2] = a2;
+	a[3] = a3;
+	a[4] = a4;
+}
+
+/* see bearssl_block.h */
+void
+br_poly1305_ctmul_run(const void *key, const void *iv,
+	void *data, size_t len, const void *aad, size_t aad_len,
+	void *tag, br_chacha20_run ichacha, int encrypt)
+{
+	unsigned char pkey[32], foot[16];
+	unsigned char *tb;
+	uint32_t r[5], acc[5], g[5];
+	uint32_t cc, ctl, h0, h1, h2, h3;
+	uint64_t w;
+	int i;
+
+	/*
+	 * Compute the MAC key (first 32 bytes of the key stream, with
+	 * counter 0); then, if encrypting, encrypt the data.
+	 */
+	memset(pkey, 0, sizeof pkey);
+	ichacha(key, iv, 0, pkey, sizeof pkey);
+	if (encrypt) {
+		ichacha(key, iv, 1, data, len);
+	}
+
+	/*
+	 * Decode r, with clamping.
+	 */
+	r[0] = br_dec32le(pkey) & 0x03FFFFFF;
+	r[1] = (br_dec32le(pkey +  3) >> 2) & 0x03FFFF03;
+	r[2] = (br_dec32le(pkey +  6) >> 4) & 0x03FFC0FF;
+	r[3] = (br_dec32le(pkey +  9) >> 6) & 0x03F03FFF;
+	r[4] = (br_dec32le(pkey + 12) >> 8) & 0x000FFFFF;
+
+	/*
+	 * Process the additional data, the ciphertext, and the lengths.
+	 */
+	memset(acc, 0, sizeof acc);
+	poly1305_inner(acc, r, aad, aad_len);
+	poly1305_inner(acc, r, data, len);
+	br_enc64le(foot, (uint64_t)aad_len);
+	br_enc64le(foot + 8, (uint64_t)len);
+	poly1305_inner(acc, r, foot, sizeof foot);
+
+	/*
+	 * Finish the carry propagation; then, compute acc + 5 - 2^130.
+	 * If that value is non-negative, then it is the reduced value.
+	 */
+	cc = 0;
+	for (i = 1; i < 5; i ++) {
+		acc[i] += cc;
+		cc = acc[i] >> 26;
+		acc[i] &= MASK26;
+	}
+	acc[0] += cc * 5;
+	cc = acc[0] >> 26;
+	acc[0] &= MASK26;
+	acc[1] += cc;
+	cc = 5;
+	for (i = 0; i < 5; i ++) {
+		g[i] = acc[i] + cc;
+		cc = g[i] >> 26;
+		g[i] &= MASK26;
+	}
+	ctl = -cc;
+	for (i = 0; i < 5; i ++) {
+		acc[i] ^= ctl & (acc[i] ^ g[i]);
+	}
+
+	/*
+	 * Convert back to 128 bits (the top bits are dropped) and add
+	 * the second half of the MAC key.
+	 */
+	h0 = acc[0] | (acc[1] << 26);
+	h1 = (acc[1] >> 6) | (acc[2] << 20);
+	h2 = (acc[2] >> 12) | (acc[3] << 14);
+	h3 = (acc[3] >> 18) | (acc[4] << 8);
+	tb = tag;
+	w = (uint64_t)h0 + (uint64_t)br_dec32le(pkey + 16);
+	br_enc32le(tb, (uint32_t)w);
+	w = (uint64_t)h1 + (uint64_t)br_dec32le(pkey + 20) + (w >> 32);
+	br_enc32le(tb + 4, (uint32_t)w);
+	w = (uint64_t)h2 + (uint64_t)br_dec32le(pkey + 24) + (w >> 32);
+	br_enc32le(tb + 8, (uint32_t)w);
+	w = (uint64_t)h3 + (uint64_t)br_dec32le(pkey + 28) + (w >> 32);
+	br_enc32le(tb + 12, (uint32_t)w);
+
+	/*
+	 * If decrypting, then the data is decrypted after MAC computation.
+	 */
+	if (!encrypt) {
+		ichacha(key, iv, 1, data, len);
+	}
+}
@@ -33,8 +33,7 @@ br_rsa_i31_public(unsigned char *x, size_t xlen,
 	size_t nlen;
 	uint32_t m[1 + ((BR_MAX_RSA_SIZE + 30) / 31)];
 	uint32_t a[1 + ((BR_MAX_RSA_SIZE + 30) / 31)];
-	uint32_t t1[1 + ((BR_MAX_RSA_SIZE + 30) / 31)];
-	uint32_t t2[1 + ((BR_MAX_RSA_SIZE + 30) / 31)];
+	uint32_t t[2 * (1 + ((BR_MAX_RSA_SIZE + 30) / 31))];
 	uint32_t m0i, r;
 
 	/*
@@ -65,9 +64,12 @@ br_rsa_i31_public(unsigned char *x, size_t xlen,
 	r &= br_i31_decode_mod(a, x, xlen, m);
 
 	/*
-	 * Compute the modular exponentiation.
+	 * Compute the modular exponentiation. The exponent is public,
+	 * so we can use the variable-time code, which is much faster
+	 * for small exponents such as 65537.
 	 */
-	br_i31_modpow(a, pk->e, pk->elen, m, m0i, t1, t2);
+	br_i31_modpow_vartime(a, pk->e, pk->elen, m, m0i,
+		t, (sizeof t) / (sizeof t[0]));
 
 	/*
 	 * Encode the result.
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+/*
+ * Copy an exponent into a fixed-size buffer. Leading zeros are skipped
+ * only as long as the exponent does not fit; this way, the exponent
+ * length used in the private key operations is the provided length,
+ * as with the non-expanded key.
+ */
+static int
+copy_exp(unsigned char *dst, size_t *dst_len, size_t max_len,
+	const unsigned char *src, size_t len)
+{
+	while (len > max_len && *src == 0) {
+		src ++;
+		len --;
+	}
+	if (len > max_len) {
+		return 0;
+	}
+	memcpy(dst, src, len);
+	*dst_len = len;
+	return 1;
+}
+
+/*
+ * Compute r2 = R^2 mod m, with R = 2^(31*k) (k is the number of value
+ * words in m[]).
+ */
+static void
+compute_r2(uint32_t *r2, const uint32_t *m)
+{
+	/*
+	 * We first get R mod m by setting the high word to 1, then doing
+	 * a word-sized shift. Then a conversion to Montgomery
+	 * representation yields R^2 mod m.
+	 */
+	br_i31_zero(r2, m[0]);
+	r2[(m[0] + 31) >> 5] = 1;
+	br_i31_muladd_small(r2, 0, m);
+	br_i31_to_monty(r2, m);
+}
+
+/* see bearssl_rsa.h */
+uint32_t
+br_rsa_i31_expand_key(br_rsa_i31_expanded_key *xsk,
+	const br_rsa_private_key *sk)
+{
+	const unsigned char *p, *q;
+	size_t plen, qlen;
+
+	/*
+	 * Compute the actual lengths (in bytes) of p and q, and check
+	 * that they fit within our buffers. The exponent buffers have
+	 * the size of the largest factor, and the word buffers are
+	 * large enough for a factor of that size.
+	 */
+	p = sk->p;
+	plen = sk->plen;
+	while (plen > 0 && *p == 0) {
+		p ++;
+		plen --;
+	}
+	q = sk->q;
+	qlen = sk->qlen;
+	while (qlen > 0 && *q == 0) {
+		q ++;
+		qlen --;
+	}
+	if (plen > (BR_MAX_RSA_FACTOR >> 3)
+		|| qlen > (BR_MAX_RSA_FACTOR >> 3)
+		|| plen > sizeof xsk->dp || qlen > sizeof xsk->dq)
+	{
+		return 0;
+	}
+
+	/*
+	 * Decode p and q, and compute the Montgomery parameters. Even
+	 * factors are rejected here, so that the private key operations
+	 * need not check them.
+	 */
+	br_i31_decode(xsk->mp, p, plen);
+	br_i31_decode(xsk->mq, q, qlen);
+	xsk->p0i = br_i31_ninv31(xsk->mp[1]);
+	xsk->q0i = br_i31_ninv31(xsk->mq[1]);
+	if ((xsk->p0i & xsk->q0i & 1) == 0) {
+		return 0;
+	}
+	compute_r2(xsk->r2p, xsk->mp);
+	compute_r2(xsk->r2q, xsk->mq);
+
+	/*
+	 * The CRT coefficient is only used in a Montgomery multiplication
+	 * modulo p, so we keep it in Montgomery representation. Since we
+	 * use br_i31_decode_reduce(), we tolerate improperly large
+	 * values, as br_rsa_i31_private() does.
+	 */
+	br_i31_decode_reduce(xsk->iq, sk->iq, sk->iqlen, xsk->mp);
+	br_i31_to_monty(xsk->iq, xsk->mp);
+
+	if (!copy_exp(xsk->dp, &xsk->dplen, sizeof xsk->dp, sk->dp, sk->dplen)
+		|| !copy_exp(xsk->dq, &xsk->dqlen, sizeof xsk->dq,
+			sk->dq, sk->dqlen))
+	{
+		return 0;
+	}
+	xsk->n_bitlen = sk->n_bitlen;
+	return 1;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "inner.h"
+
+#define U      (2 + ((BR_MAX_RSA_FACTOR + 30) / 31))
+#define TLEN   (6 * U)
+
+/* see bearssl_rsa.h */
+uint32_t
+br_rsa_i31_private_expanded(unsigned char *x,
+	const br_rsa_i31_expanded_key *xsk)
+{
+	size_t fwlen, pwlen, qwlen;
+	uint32_t tmp[TLEN];
+	uint32_t *s1, *s2, *t1, *t2, *t3;
+	size_t xlen;
+
+	/*
+	 * The factors are already decoded in the expanded key. Our
+	 * temporaries are sized after the largest factor; the t1
+	 * buffer and all the space that follows it are used by the
+	 * modular exponentiations. As in br_rsa_i31_private(), t3
+	 * shares its storage space with s2, s1 and t1, in that order.
+	 */
+	pwlen = (xsk->mp[0] + 63) >> 5;
+	qwlen = (xsk->mq[0] + 63) >> 5;
+	fwlen = pwlen > qwlen ? pwlen : qwlen;
+	t2 = tmp;
+	s2 = tmp + fwlen;
+	s1 = tmp + 2 * fwlen;
+	t1 = tmp + 3 * fwlen;
+	t3 = s2;
+
+	/*
+	 * Compute signature length (in bytes).
+	 */
+	xlen = (xsk->n_bitlen + 7) >> 3;
+
+	/*
+	 * Compute s1 = x^dp mod p and s2 = x^dq mod q. The expanded
+	 * key contains R^2 for both factors, for a fast conversion to
+	 * Montgomery representation.
+	 */
+	br_i31_decode_reduce(s1, x, xlen, xsk->mp);
+	if (!br_i31_modpow_opt_r2(s1, xsk->dp, xsk->dplen,
+		xsk->mp, xsk->p0i, xsk->r2p, t1, TLEN - 3 * fwlen))
+	{
+		br_i31_modpow(s1, xsk->dp, xsk->dplen,
+			xsk->mp, xsk->p0i, t1, t2);
+	}
+	br_i31_decode_reduce(s2, x, xlen, xsk->mq);
+	if (!br_i31_modpow_opt_r2(s2, xsk->dq, xsk->dqlen,
+		xsk->mq, xsk->q0i, xsk->r2q, t1, TLEN - 3 * fwlen))
+	{
+		br_i31_modpow(s2, xsk->dq, xsk->dqlen,
+			xsk->mq, xsk->q0i, t1, t2);
+	}
+
+	/*
+	 * Compute h = (s1 - s2)*(1/q) mod p. The expanded iq is in
+	 * Montgomery representation, so a single Montgomery
+	 * multiplication yields h (s1 needs not be converted).
+	 */
+	br_i31_reduce(t2, s2, xsk->mp);
+	br_i31_add(s1, xsk->mp, br_i31_sub(s1, t2, 1));
+	br_i31_montymul(t2, s1, xsk->iq, xsk->mp, xsk->p0i);
+
+	/*
+	 * Final result: s = s2 + q*h (non-modular), in t3.
+	 */
+	br_i31_mulacc(t3, xsk->mq, t2);
+	br_i31_encode(x, xlen, t3);
+
+	/*
+	 * Factors were checked when the key was expanded; this only
+	 * detects an expanded key that was not properly initialised.
+	 */
+	return xsk->p0i & xsk->q0i & 1;
+}
@@ -24,35 +24,20 @@
 
 #include "inner.h"
 
-#define U   (1 + (BR_MAX_RSA_FACTOR >> 5))
+#define U      (2 + (BR_MAX_RSA_FACTOR >> 5))
+#define TLEN   (8 * U)
 
 /* see bearssl_rsa.h */
 uint32_t
 br_rsa_i32_private(unsigned char *x, const br_rsa_private_key *sk)
 {
 	const unsigned char *p, *q;
-	size_t plen, qlen;
-	uint32_t tmp[6 * U];
+	size_t plen, qlen, fwlen;
+	uint32_t tmp[TLEN];
 	uint32_t *mp, *mq, *s1, *s2, *t1, *t2, *t3;
 	uint32_t p0i, q0i;
 	size_t xlen;
 
-	/*
-	 * All our temporary buffers are from the tmp[] array.
-	 *
-	 * The mp, mq, s1, s2, t1 and t2 buffers are large enough to
-	 * contain a RSA factor. The t3 buffer can contain a complete
-	 * RSA modulus. t3 shares its storage space with s2, s1 and t1,
-	 * in that order (this is important, see below).
-	 */
-	mq = tmp;
-	mp = tmp + U;
-	t2 = tmp + 2 * U;
-	s2 = tmp + 3 * U;
-	s1 = tmp + 4 * U;
-	t1 = tmp + 5 * U;
-	t3 = s2;
-
 	/*
 	 * Compute the actual lengths (in bytes) of p and q, and check
 	 * that they fit within our stack buffers.
@@ -75,6 +60,27 @@ br_rsa_i32_private(unsigned char *x, const br_rsa_private_key *sk)
 		return 0;
 	}
 
+	/*
+	 * All our temporary buffers are from the tmp[] array. Their
+	 * size 'fwlen' (in words) is adjusted to the actual length of
+	 * the factors, so that the remaining space can be used by
+	 * br_i32_modpow_opt() for its window table.
+	 *
+	 * The mp, mq, s1, s2, t1 and t2 buffers are large enough to
+	 * contain a RSA factor. The t3 buffer can contain a complete
+	 * RSA modulus. t3 shares its storage space with s2, s1 and t1,
+	 * in that order (this is important, see below). The modular
+	 * exponentiations use t1 and all the space that follows it.
+	 */
+	fwlen = 1 + ((((plen > qlen ? plen : qlen) << 3) + 31) >> 5);
+	mq = tmp;
+	mp = tmp + fwlen;
+	t2 = tmp + 2 * fwlen;
+	s2 = tmp + 3 * fwlen;
+	s1 = tmp + 4 * fwlen;
+	t1 = tmp + 5 * fwlen;
+	t3 = s2;
+
 	/*
 	 * Decode p and q.
 	 */
@@ -98,14 +104,22 @@ br_rsa_i32_private(unsigned char *x, const br_rsa_private_key *sk)
 	 */
 	p0i = br_i32_ninv32(mp[1]);
 	br_i32_decode_reduce(s1, x, xlen, mp);
-	br_i32_modpow(s1, sk->dp, sk->dplen, mp, p0i, t1, t2);
+	if (!br_i32_modpow_opt(s1, sk->dp, sk->dplen, mp, p0i,
+		t1, TLEN - 5 * fwlen))
+	{
+		br_i32_modpow(s1, sk->dp, sk->dplen, mp, p0i, t1, t2);
+	}
 
 	/*
 	 * Compute s2 = x^dq mod q.
 	 */
 	q0i = br_i32_ninv32(mq[1]);
 	br_i32_decode_reduce(s2, x, xlen, mq);
-	br_i32_modpow(s2, sk->dq, sk->dqlen, mq, q0i, t1, t2);
+	if (!br_i32_modpow_opt(s2, sk->dq, sk->dqlen, mq, q0i,
+		t1, TLEN - 5 * fwlen))
+	{
+		br_i32_modpow(s2, sk->dq, sk->dqlen, mq, q0i, t1, t2);
+	}
 
 	/*
 	 * Compute:
@@ -29,9 +29,6 @@ uint32_t
 br_rsa_ssl_decrypt(br_rsa_private core, const br_rsa_private_key *sk,
 	unsigned char *data, size_t len)
 {
-	uint32_t x;
-	size_t u;
-
 	/*
 	 * A first check on length. Since this test works only on the
 	 * buffer length, it needs not (and cannot) be constant-time.
@@ -39,8 +36,17 @@ br_rsa_ssl_decrypt(br_rsa_private core, const br_rsa_private_key *sk,
 	if (len < 59 || len != (sk->n_bitlen + 7) >> 3) {
 		return 0;
 	}
-	x = core(data, sk);
+	return br_rsa_ssl_decrypt_unpad(core(data, sk), data, len);
+}
+
+/* see inner.h */
+uint32_t
+br_rsa_ssl_decrypt_unpad(uint32_t ok, unsigned char *data, size_t len)
+{
+	uint32_t x;
+	size_t u;
 
+	x = ok;
 	x &= EQ(data[0], 0x00);
 	x &= EQ(data[1], 0x02);
 	for (u = 2; u < (len - 49); u ++) {
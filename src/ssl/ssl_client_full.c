@@ -42,7 +42,9 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 	 *    better than RSA key exchange (slightly more expensive on the
 	 *    client, but much cheaper on the server, and it implies smaller
 	 *    messages).
-	 * -- GCM is better than CBC.
+	 * -- GCM is better than ChaCha20+Poly1305, ChaCha20+Poly1305
+	 *    is better than CCM, and CCM is better than CBC (CCM_8 has
+	 *    a shorter authentication tag, and comes after CCM).
 	 * -- AES-128 is preferred over AES-256 (AES-128 is already
 	 *    strong enough, and AES-256 is 40% more expensive).
 	 */
@@ -51,6 +53,12 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 		BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
 		BR_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384,
+		BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+		BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CCM,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_256_CCM,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_256_CCM_8,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,
 		BR_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA384,
@@ -73,6 +81,10 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 		BR_TLS_ECDH_RSA_WITH_AES_256_CBC_SHA,
 		BR_TLS_RSA_WITH_AES_128_GCM_SHA256,
 		BR_TLS_RSA_WITH_AES_256_GCM_SHA384,
+		BR_TLS_RSA_WITH_AES_128_CCM,
+		BR_TLS_RSA_WITH_AES_256_CCM,
+		BR_TLS_RSA_WITH_AES_128_CCM_8,
+		BR_TLS_RSA_WITH_AES_256_CCM_8,
 		BR_TLS_RSA_WITH_AES_128_CBC_SHA256,
 		BR_TLS_RSA_WITH_AES_256_CBC_SHA256,
 		BR_TLS_RSA_WITH_AES_128_CBC_SHA,
@@ -84,20 +96,6 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 		BR_TLS_RSA_WITH_3DES_EDE_CBC_SHA
 	};
 
-	/*
-	 * All hash functions are activated.
-	 * Note: the X.509 validation engine will nonetheless refuse to
-	 * validate signatures that use MD5 as hash function.
-	 */
-	static const br_hash_class *hashes[] = {
-		&br_md5_vtable,
-		&br_sha1_vtable,
-		&br_sha224_vtable,
-		&br_sha256_vtable,
-		&br_sha384_vtable,
-		&br_sha512_vtable
-	};
-
 	int id;
 
 	/*
@@ -117,29 +115,31 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 	/*
 	 * Set suites and asymmetric crypto implementations. We use the
 	 * "i31" code for RSA (it is somewhat faster than the "i32"
-	 * implementation).
+	 * implementation), and the dedicated P-256 code for elliptic
+	 * curves (other curves use the "i31" code).
 	 * TODO: change that when better implementations are made available.
 	 */
 	br_ssl_engine_set_suites(&cc->eng, suites,
 		(sizeof suites) / (sizeof suites[0]));
 	br_ssl_client_set_rsapub(cc, &br_rsa_i31_public);
 	br_ssl_client_set_rsavrfy(cc, &br_rsa_i31_pkcs1_vrfy);
-	br_ssl_engine_set_ec(&cc->eng, &br_ec_prime_i31);
+	br_ssl_engine_set_ec(&cc->eng, &br_ec_all_m32);
 	br_ssl_client_set_ecdsa(cc, &br_ecdsa_i31_vrfy_asn1);
 	br_x509_minimal_set_rsa(xc, &br_rsa_i31_pkcs1_vrfy);
 	br_x509_minimal_set_ecdsa(xc,
-		&br_ec_prime_i31, &br_ecdsa_i31_vrfy_asn1);
+		&br_ec_p256_m32, &br_ecdsa_i31_vrfy_asn1);
 
 	/*
 	 * Set supported hash functions, for the SSL engine and for the
-	 * X.509 engine.
+	 * X.509 engine. All hash functions are activated; SHA-1 and
+	 * SHA-224/256 use the x86 SHA opcodes when available.
+	 * Note: the X.509 validation engine will nonetheless refuse to
+	 * validate signatures that use MD5 as hash function.
 	 */
+	br_ssl_engine_set_default_hashes(&cc->eng);
 	for (id = br_md5_ID; id <= br_sha512_ID; id ++) {
-		const br_hash_class *hc;
-
-		hc = hashes[id - 1];
-		br_ssl_engine_set_hash(&cc->eng, id, hc);
-		br_x509_minimal_set_hash(xc, id, hc);
+		br_x509_minimal_set_hash(xc, id,
+			br_ssl_engine_get_hash(&cc->eng, id));
 	}
 
 	/*
@@ -156,28 +156,16 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 
 	/*
 	 * Symmetric encryption. We use the "constant-time"
-	 * implementations, which are the safest.
+	 * implementations, which are the safest; when the CPU supports
+	 * the AES-NI opcodes, the x86ni implementation is used instead.
 	 *
 	 * On architectures detected as "64-bit", use the 64-bit
 	 * versions (aes_ct64, ghash_ctmul64).
 	 */
-#if BR_64
-	br_ssl_engine_set_aes_cbc(&cc->eng,
-		&br_aes_ct64_cbcenc_vtable,
-		&br_aes_ct64_cbcdec_vtable);
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct64_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul64);
-#else
-	br_ssl_engine_set_aes_cbc(&cc->eng,
-		&br_aes_ct_cbcenc_vtable,
-		&br_aes_ct_cbcdec_vtable);
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul);
-#endif
+	br_ssl_engine_set_default_aes_cbc(&cc->eng);
+	br_ssl_engine_set_default_aes_gcm(&cc->eng);
+	br_ssl_engine_set_default_aes_ccm(&cc->eng);
+	br_ssl_engine_set_default_chapol(&cc->eng);
 	br_ssl_engine_set_des_cbc(&cc->eng,
 		&br_des_ct_cbcenc_vtable,
 		&br_des_ct_cbcdec_vtable);
@@ -188,6 +176,9 @@ br_ssl_client_init_full(br_ssl_client_context *cc,
 	br_ssl_engine_set_cbc(&cc->eng,
 		&br_sslrec_in_cbc_vtable,
 		&br_sslrec_out_cbc_vtable);
+	br_ssl_engine_set_cbc_etm(&cc->eng,
+		&br_sslrec_in_cbc_etm_vtable,
+		&br_sslrec_out_cbc_etm_vtable);
 	br_ssl_engine_set_gcm(&cc->eng,
 		&br_sslrec_in_gcm_vtable,
 		&br_sslrec_out_gcm_vtable);
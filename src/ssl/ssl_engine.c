@@ -1348,6 +1348,7 @@ br_ssl_engine_switch_cbc_in(br_ssl_engine_context *cc,
 	unsigned char kb[192];
 	unsigned char *cipher_key, *mac_key, *iv;
 	const br_hash_class *imh;
+	const br_sslrec_in_cbc_class *rec;
 	size_t mac_key_len, mac_out_len, iv_len;
 
 	imh = br_ssl_engine_get_hash(cc, mac_id);
@@ -1376,7 +1377,8 @@ br_ssl_engine_switch_cbc_in(br_ssl_engine_context *cc,
 	if (iv_len == 0) {
 		iv = NULL;
 	}
-	cc->icbc_in->init(&cc->in.cbc.vtable,
+	rec = cc->etm ? cc->icbc_etm_in : cc->icbc_in;
+	rec->init(&cc->in.cbc.vtable,
 		bc_impl, cipher_key, cipher_key_len,
 		imh, mac_key, mac_key_len, mac_out_len, iv);
 	cc->incrypt = 1;
@@ -1391,6 +1393,7 @@ br_ssl_engine_switch_cbc_out(br_ssl_engine_context *cc,
 	unsigned char kb[192];
 	unsigned char *cipher_key, *mac_key, *iv;
 	const br_hash_class *imh;
+	const br_sslrec_out_cbc_class *rec;
 	size_t mac_key_len, mac_out_len, iv_len;
 
 	imh = br_ssl_engine_get_hash(cc, mac_id);
@@ -1419,9 +1422,13 @@ br_ssl_engine_switch_cbc_out(br_ssl_engine_context *cc,
 	if (iv_len == 0) {
 		iv = NULL;
 	}
-	cc->icbc_out->init(&cc->out.cbc.vtable,
+	rec = cc->etm ? cc->icbc_etm_out : cc->icbc_out;
+	rec->init(&cc->out.cbc.vtable,
 		bc_impl, cipher_key, cipher_key_len,
 		imh, mac_key, mac_key_len, mac_out_len, iv);
+	if (cc->icbc_kernel != NULL) {
+		br_sslrec_out_cbc_set_kernel(&cc->out.cbc, cc->icbc_kernel);
+	}
 }
 
 /* see inner.h */
@@ -1443,6 +1450,9 @@ br_ssl_engine_switch_gcm_in(br_ssl_engine_context *cc,
 	}
 	cc->igcm_in->init(&cc->in.gcm.vtable.in,
 		bc_impl, cipher_key, cipher_key_len, cc->ighash, iv);
+	if (cc->igcm_kernel != NULL) {
+		br_sslrec_gcm_set_kernel(&cc->in.gcm, cc->igcm_kernel);
+	}
 	cc->incrypt = 1;
 }
 
@@ -1465,4 +1475,97 @@ br_ssl_engine_switch_gcm_out(br_ssl_engine_context *cc,
 	}
 	cc->igcm_out->init(&cc->out.gcm.vtable.out,
 		bc_impl, cipher_key, cipher_key_len, cc->ighash, iv);
+	if (cc->igcm_kernel != NULL) {
+		br_sslrec_gcm_set_kernel(&cc->out.gcm, cc->igcm_kernel);
+	}
+}
+
+/* see inner.h */
+void
+br_ssl_engine_switch_ccm_in(br_ssl_engine_context *cc,
+	int is_client, int prf_id,
+	const br_block_cbcenc_class *bc_impl,
+	const br_block_ctr_class *bcctr_impl,
+	size_t cipher_key_len, size_t tag_len)
+{
+	unsigned char kb[72];
+	unsigned char *cipher_key, *iv;
+
+	compute_key_block(cc, prf_id, cipher_key_len + 4, kb);
+	if (is_client) {
+		cipher_key = &kb[cipher_key_len];
+		iv = &kb[(cipher_key_len << 1) + 4];
+	} else {
+		cipher_key = &kb[0];
+		iv = &kb[cipher_key_len << 1];
+	}
+	cc->iccm_in->init(&cc->in.ccm.vtable.in,
+		bc_impl, bcctr_impl, cipher_key, cipher_key_len,
+		iv, tag_len);
+	cc->incrypt = 1;
+}
+
+/* see inner.h */
+void
+br_ssl_engine_switch_ccm_out(br_ssl_engine_context *cc,
+	int is_client, int prf_id,
+	const br_block_cbcenc_class *bc_impl,
+	const br_block_ctr_class *bcctr_impl,
+	size_t cipher_key_len, size_t tag_len)
+{
+	unsigned char kb[72];
+	unsigned char *cipher_key, *iv;
+
+	compute_key_block(cc, prf_id, cipher_key_len + 4, kb);
+	if (is_client) {
+		cipher_key = &kb[0];
+		iv = &kb[cipher_key_len << 1];
+	} else {
+		cipher_key = &kb[cipher_key_len];
+		iv = &kb[(cipher_key_len << 1) + 4];
+	}
+	cc->iccm_out->init(&cc->out.ccm.vtable.out,
+		bc_impl, bcctr_impl, cipher_key, cipher_key_len,
+		iv, tag_len);
+}
+
+/* see inner.h */
+void
+br_ssl_engine_switch_chapol_in(br_ssl_engine_context *cc,
+	int is_client, int prf_id)
+{
+	unsigned char kb[88];
+	unsigned char *cipher_key, *iv;
+
+	compute_key_block(cc, prf_id, 44, kb);
+	if (is_client) {
+		cipher_key = &kb[32];
+		iv = &kb[76];
+	} else {
+		cipher_key = &kb[0];
+		iv = &kb[64];
+	}
+	cc->ichapol_in->init(&cc->in.chapol.vtable.in,
+		cc->ichacha, cc->ipoly, cipher_key, iv);
+	cc->incrypt = 1;
+}
+
+/* see inner.h */
+void
+br_ssl_engine_switch_chapol_out(br_ssl_engine_context *cc,
+	int is_client, int prf_id)
+{
+	unsigned char kb[88];
+	unsigned char *cipher_key, *iv;
+
+	compute_key_block(cc, prf_id, 44, kb);
+	if (is_client) {
+		cipher_key = &kb[0];
+		iv = &kb[64];
+	} else {
+		cipher_key = &kb[32];
+		iv = &kb[76];
+	}
+	cc->ichapol_out->init(&cc->out.chapol.vtable.out,
+		cc->ichacha, cc->ipoly, cipher_key, iv);
 }
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/* see bearssl_ssl.h */
+void
+br_ssl_engine_set_default_hashes(br_ssl_engine_context *cc)
+{
+	const br_hash_class *ihash;
+
+	br_ssl_engine_set_hash(cc, br_md5_ID, &br_md5_vtable);
+	ihash = br_sha1_x86ni_get_vtable();
+	if (ihash == NULL) {
+		ihash = &br_sha1_vtable;
+	}
+	br_ssl_engine_set_hash(cc, br_sha1_ID, ihash);
+	ihash = br_sha224_x86ni_get_vtable();
+	if (ihash == NULL) {
+		ihash = &br_sha224_vtable;
+	}
+	br_ssl_engine_set_hash(cc, br_sha224_ID, ihash);
+	ihash = br_sha256_x86ni_get_vtable();
+	if (ihash == NULL) {
+		ihash = &br_sha256_vtable;
+	}
+	br_ssl_engine_set_hash(cc, br_sha256_ID, ihash);
+	br_ssl_engine_set_hash(cc, br_sha384_ID, &br_sha384_vtable);
+	br_ssl_engine_set_hash(cc, br_sha512_ID, &br_sha512_vtable);
+}
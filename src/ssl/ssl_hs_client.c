@@ -220,6 +220,8 @@ verify_SKE_sig(br_ssl_client_context *ctx,
 	br_multihash_zero(&mhc);
 	br_multihash_copyimpl(&mhc, &ctx->eng.mhash);
 	br_multihash_init(&mhc);
+	br_multihash_restrict(&mhc, hash ? (1U << hash)
+		: ((1U << br_md5_ID) | (1U << br_sha1_ID)));
 	br_multihash_update(&mhc,
 		ctx->eng.client_random, sizeof ctx->eng.client_random);
 	br_multihash_update(&mhc,
@@ -283,8 +285,8 @@ make_pms_ecdh(br_ssl_client_context *ctx, unsigned ecdhe, int prf_id)
 {
 	int curve;
 	unsigned char key[66], point[133];
-	const unsigned char *generator, *order, *point_src;
-	size_t glen, olen, point_len;
+	const unsigned char *order, *point_src;
+	size_t glen, olen, point_len, xoff, xlen;
 	unsigned char mask;
 
 	if (ecdhe) {
@@ -324,7 +326,7 @@ make_pms_ecdh(br_ssl_client_context *ctx, unsigned ecdhe, int prf_id)
 	 * Compute the common ECDH point, whose X coordinate is the
 	 * pre-master secret.
 	 */
-	generator = ctx->eng.iec->generator(curve, &glen);
+	ctx->eng.iec->generator(curve, &glen);
 	if (glen != point_len) {
 		return -BR_ERR_INVALID_ALGORITHM;
 	}
@@ -337,10 +339,10 @@ make_pms_ecdh(br_ssl_client_context *ctx, unsigned ecdhe, int prf_id)
 	/*
 	 * The pre-master secret is the X coordinate.
 	 */
-	br_ssl_engine_compute_master(&ctx->eng, prf_id, point + 1, glen >> 1);
+	xoff = ctx->eng.iec->xoff(curve, &xlen);
+	br_ssl_engine_compute_master(&ctx->eng, prf_id, point + xoff, xlen);
 
-	memcpy(point, generator, glen);
-	if (!ctx->eng.iec->mul(point, glen, key, olen, curve)) {
+	if (ctx->eng.iec->mulgen(point, key, olen, curve) != glen) {
 		return -BR_ERR_INVALID_ALGORITHM;
 	}
 	memcpy(ctx->eng.pad, point, glen);
@@ -361,8 +363,11 @@ static const uint8_t t0_datablock[] = {
 	0x44, 0xC0, 0x28, 0x12, 0x55, 0xC0, 0x29, 0x31, 0x44, 0xC0, 0x2A, 0x32,
 	0x55, 0xC0, 0x2B, 0x23, 0x04, 0xC0, 0x2C, 0x24, 0x05, 0xC0, 0x2D, 0x43,
 	0x04, 0xC0, 0x2E, 0x44, 0x05, 0xC0, 0x2F, 0x13, 0x04, 0xC0, 0x30, 0x14,
-	0x05, 0xC0, 0x31, 0x33, 0x04, 0xC0, 0x32, 0x34, 0x05, 0xCC, 0xA8, 0x15,
-	0x04, 0xCC, 0xA9, 0x25, 0x04, 0x00, 0x00
+	0x05, 0xC0, 0x31, 0x33, 0x04, 0xC0, 0x32, 0x34, 0x05, 0xC0, 0x9C, 0x06,
+	0x04, 0xC0, 0x9D, 0x07, 0x04, 0xC0, 0xA0, 0x08, 0x04, 0xC0, 0xA1, 0x09,
+	0x04, 0xC0, 0xAC, 0x26, 0x04, 0xC0, 0xAD, 0x27, 0x04, 0xC0, 0xAE, 0x28,
+	0x04, 0xC0, 0xAF, 0x29, 0x04, 0xCC, 0xA8, 0x15, 0x04, 0xCC, 0xA9, 0x25,
+	0x04, 0x00, 0x00
 };
 
 static const uint8_t t0_codeblock[] = {
@@ -399,17 +404,17 @@ static const uint8_t t0_codeblock[] = {
 	0x00, 0x00, 0x01,
 	T0_INT2(offsetof(br_ssl_engine_context, ecdhe_point)), 0x00, 0x00,
 	0x01, T0_INT2(offsetof(br_ssl_engine_context, ecdhe_point_len)), 0x00,
-	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, log_max_frag_len)),
-	0x00, 0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, pad)), 0x00,
-	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, record_type_in)),
+	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, etm)), 0x00, 0x00,
+	0x01, T0_INT2(offsetof(br_ssl_engine_context, log_max_frag_len)), 0x00,
+	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, pad)), 0x00, 0x00,
+	0x01, T0_INT2(offsetof(br_ssl_engine_context, record_type_in)), 0x00,
+	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, record_type_out)),
+	0x00, 0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, reneg)),
 	0x00, 0x00, 0x01,
-	T0_INT2(offsetof(br_ssl_engine_context, record_type_out)), 0x00, 0x00,
-	0x01, T0_INT2(offsetof(br_ssl_engine_context, reneg)), 0x00, 0x00,
-	0x01, T0_INT2(offsetof(br_ssl_engine_context, saved_finished)), 0x00,
-	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, server_name)),
+	T0_INT2(offsetof(br_ssl_engine_context, saved_finished)), 0x00, 0x00,
+	0x01, T0_INT2(offsetof(br_ssl_engine_context, server_name)), 0x00,
+	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, server_random)),
 	0x00, 0x00, 0x01,
-	T0_INT2(offsetof(br_ssl_engine_context, server_random)), 0x00, 0x00,
-	0x01,
 	T0_INT2(offsetof(br_ssl_engine_context, session) + offsetof(br_ssl_session_parameters, session_id)),
 	0x00, 0x00, 0x01,
 	T0_INT2(offsetof(br_ssl_engine_context, session) + offsetof(br_ssl_session_parameters, session_id_len)),
@@ -424,208 +429,228 @@ static const uint8_t t0_codeblock[] = {
 	T0_INT2(offsetof(br_ssl_engine_context, version_max)), 0x00, 0x00,
 	0x01, T0_INT2(offsetof(br_ssl_engine_context, version_min)), 0x00,
 	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, version_out)),
-	0x00, 0x00, 0x09, 0x1B, 0x40, 0x06, 0x02, 0x50, 0x1C, 0x00, 0x00, 0x06,
-	0x08, 0x1E, 0x0D, 0x05, 0x02, 0x59, 0x1C, 0x04, 0x01, 0x2B, 0x00, 0x00,
-	0x01, 0x01, 0x00, 0x01, 0x03, 0x00, 0x79, 0x1B, 0x46, 0x32, 0x7D, 0x1B,
-	0x05, 0x04, 0x48, 0x01, 0x00, 0x00, 0x02, 0x00, 0x0D, 0x06, 0x02, 0x7D,
-	0x00, 0x46, 0x04, 0x6B, 0x00, 0x06, 0x02, 0x50, 0x1C, 0x00, 0x00, 0x1B,
-	0x6A, 0x32, 0x05, 0x03, 0x01, 0x0C, 0x08, 0x32, 0x5F, 0x1E, 0x81, 0x0A,
-	0x15, 0x66, 0x01, 0x0C, 0x22, 0x00, 0x00, 0x1B, 0x16, 0x01, 0x08, 0x0B,
-	0x32, 0x44, 0x16, 0x08, 0x00, 0x01, 0x03, 0x00, 0x01, 0x00, 0x5E, 0x2C,
-	0x1D, 0x13, 0x26, 0x06, 0x08, 0x02, 0x00, 0x81, 0x29, 0x03, 0x00, 0x04,
-	0x74, 0x01, 0x00, 0x81, 0x21, 0x02, 0x00, 0x1B, 0x13, 0x11, 0x06, 0x02,
-	0x57, 0x1C, 0x81, 0x29, 0x04, 0x75, 0x01, 0x01, 0x00, 0x5E, 0x2C, 0x01,
-	0x16, 0x68, 0x2C, 0x25, 0x81, 0x2D, 0x1D, 0x81, 0x11, 0x06, 0x0B, 0x01,
-	0x7F, 0x81, 0x0D, 0x01, 0x7F, 0x81, 0x2C, 0x04, 0x80, 0x42, 0x81, 0x0E,
-	0x5F, 0x1E, 0x81, 0x01, 0x01, T0_INT1(BR_KEYTYPE_SIGN), 0x11, 0x06,
-	0x02, 0x81, 0x12, 0x81, 0x15, 0x1B, 0x01, 0x0D, 0x0D, 0x06, 0x09, 0x1A,
-	0x81, 0x14, 0x81, 0x15, 0x01, 0x7F, 0x04, 0x02, 0x01, 0x00, 0x03, 0x00,
-	0x01, 0x0E, 0x0D, 0x05, 0x02, 0x5A, 0x1C, 0x06, 0x02, 0x4F, 0x1C, 0x24,
-	0x06, 0x02, 0x5A, 0x1C, 0x02, 0x00, 0x06, 0x02, 0x81, 0x33, 0x81, 0x2E,
-	0x01, 0x7F, 0x81, 0x2C, 0x01, 0x7F, 0x81, 0x0D, 0x01, 0x01, 0x5E, 0x2C,
-	0x01, 0x17, 0x68, 0x2C, 0x00, 0x00, 0x28, 0x28, 0x00, 0x00, 0x7A, 0x01,
-	0x0C, 0x10, 0x01, 0x00, 0x28, 0x0D, 0x06, 0x05, 0x1A, 0x01,
+	0x00, 0x00, 0x09, 0x1B, 0x46, 0x06, 0x02, 0x56, 0x1C, 0x00, 0x00, 0x06,
+	0x08, 0x1E, 0x0D, 0x05, 0x02, 0x5F, 0x1C, 0x04, 0x01, 0x2C, 0x00, 0x00,
+	0x01, 0x01, 0x00, 0x01, 0x03, 0x00, 0x81, 0x00, 0x1B, 0x4C, 0x34, 0x81,
+	0x04, 0x1B, 0x05, 0x04, 0x4E, 0x01, 0x00, 0x00, 0x02, 0x00, 0x0D, 0x06,
+	0x03, 0x81, 0x04, 0x00, 0x4C, 0x04, 0x69, 0x00, 0x06, 0x02, 0x56, 0x1C,
+	0x00, 0x00, 0x1B, 0x71, 0x34, 0x05, 0x03, 0x01, 0x0C, 0x08, 0x34, 0x65,
+	0x1E, 0x81, 0x12, 0x15, 0x6D, 0x01, 0x0C, 0x22, 0x00, 0x00, 0x1B, 0x16,
+	0x01, 0x08, 0x0B, 0x34, 0x4A, 0x16, 0x08, 0x00, 0x01, 0x03, 0x00, 0x01,
+	0x00, 0x64, 0x2D, 0x1D, 0x13, 0x27, 0x06, 0x08, 0x02, 0x00, 0x81, 0x32,
+	0x03, 0x00, 0x04, 0x74, 0x01, 0x00, 0x81, 0x2A, 0x02, 0x00, 0x1B, 0x13,
+	0x11, 0x06, 0x02, 0x5D, 0x1C, 0x81, 0x32, 0x04, 0x75, 0x01, 0x01, 0x00,
+	0x64, 0x2D, 0x01, 0x16, 0x6F, 0x2D, 0x25, 0x81, 0x36, 0x1D, 0x81, 0x19,
+	0x65, 0x1E, 0x81, 0x12, 0x26, 0x06, 0x0B, 0x01, 0x7F, 0x81, 0x15, 0x01,
+	0x7F, 0x81, 0x35, 0x04, 0x80, 0x42, 0x81, 0x16, 0x65, 0x1E, 0x81, 0x08,
+	0x01, T0_INT1(BR_KEYTYPE_SIGN), 0x11, 0x06, 0x02, 0x81, 0x1A, 0x81,
+	0x1D, 0x1B, 0x01, 0x0D, 0x0D, 0x06, 0x09, 0x1A, 0x81, 0x1C, 0x81, 0x1D,
+	0x01, 0x7F, 0x04, 0x02, 0x01, 0x00, 0x03, 0x00, 0x01, 0x0E, 0x0D, 0x05,
+	0x02, 0x60, 0x1C, 0x06, 0x02, 0x55, 0x1C, 0x24, 0x06, 0x02, 0x60, 0x1C,
+	0x02, 0x00, 0x06, 0x02, 0x81, 0x3C, 0x81, 0x37, 0x01, 0x7F, 0x81, 0x35,
+	0x01, 0x7F, 0x81, 0x15, 0x01, 0x01, 0x64, 0x2D, 0x01, 0x17, 0x6F, 0x2D,
+	0x00, 0x00, 0x29, 0x29, 0x00, 0x00, 0x81, 0x01, 0x01, 0x0C, 0x10, 0x01,
+	0x00, 0x29, 0x0D, 0x06, 0x05, 0x1A, 0x01,
 	T0_INT1(BR_KEYTYPE_RSA | BR_KEYTYPE_KEYX), 0x04, 0x30, 0x01, 0x01,
-	0x28, 0x0D, 0x06, 0x05, 0x1A, 0x01,
+	0x29, 0x0D, 0x06, 0x05, 0x1A, 0x01,
 	T0_INT1(BR_KEYTYPE_RSA | BR_KEYTYPE_SIGN), 0x04, 0x25, 0x01, 0x02,
-	0x28, 0x0D, 0x06, 0x05, 0x1A, 0x01,
+	0x29, 0x0D, 0x06, 0x05, 0x1A, 0x01,
 	T0_INT1(BR_KEYTYPE_EC  | BR_KEYTYPE_SIGN), 0x04, 0x1A, 0x01, 0x03,
-	0x28, 0x0D, 0x06, 0x05, 0x1A, 0x01,
+	0x29, 0x0D, 0x06, 0x05, 0x1A, 0x01,
 	T0_INT1(BR_KEYTYPE_EC  | BR_KEYTYPE_KEYX), 0x04, 0x0F, 0x01, 0x04,
-	0x28, 0x0D, 0x06, 0x05, 0x1A, 0x01,
+	0x29, 0x0D, 0x06, 0x05, 0x1A, 0x01,
 	T0_INT1(BR_KEYTYPE_EC  | BR_KEYTYPE_KEYX), 0x04, 0x04, 0x01, 0x00,
-	0x32, 0x1A, 0x00, 0x00, 0x65, 0x1F, 0x01, 0x0E, 0x0D, 0x06, 0x04, 0x01,
-	0x00, 0x04, 0x02, 0x01, 0x05, 0x00, 0x00, 0x2E, 0x06, 0x04, 0x01, 0x06,
-	0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x69, 0x1F, 0x1B, 0x06, 0x08, 0x01,
-	0x01, 0x09, 0x01, 0x11, 0x07, 0x04, 0x03, 0x1A, 0x01, 0x05, 0x00, 0x01,
-	0x2F, 0x03, 0x00, 0x1A, 0x01, 0x00, 0x31, 0x06, 0x03, 0x02, 0x00, 0x08,
-	0x30, 0x06, 0x03, 0x02, 0x00, 0x08, 0x1B, 0x06, 0x06, 0x01, 0x01, 0x0B,
-	0x01, 0x06, 0x08, 0x00, 0x00, 0x6B, 0x2D, 0x1B, 0x06, 0x03, 0x01, 0x09,
-	0x08, 0x00, 0x01, 0x2E, 0x1B, 0x06, 0x1E, 0x01, 0x00, 0x03, 0x00, 0x1B,
-	0x06, 0x0E, 0x1B, 0x01, 0x01, 0x11, 0x02, 0x00, 0x08, 0x03, 0x00, 0x01,
-	0x01, 0x10, 0x04, 0x6F, 0x1A, 0x02, 0x00, 0x01, 0x01, 0x0B, 0x01, 0x06,
-	0x08, 0x00, 0x00, 0x7F, 0x81, 0x28, 0x1B, 0x01, 0x07, 0x11, 0x01, 0x00,
-	0x28, 0x0D, 0x06, 0x09, 0x1A, 0x01, 0x10, 0x11, 0x06, 0x01, 0x7F, 0x04,
-	0x2C, 0x01, 0x01, 0x28, 0x0D, 0x06, 0x23, 0x1A, 0x1A, 0x01, 0x00, 0x5E,
-	0x2C, 0x81, 0x10, 0x69, 0x1F, 0x01, 0x01, 0x0D, 0x06, 0x11, 0x1D, 0x13,
-	0x26, 0x06, 0x05, 0x81, 0x28, 0x1A, 0x04, 0x77, 0x01, 0x80, 0x64, 0x81,
-	0x21, 0x04, 0x01, 0x7F, 0x04, 0x03, 0x5A, 0x1C, 0x1A, 0x04, 0xFF, 0x3C,
-	0x01, 0x1B, 0x03, 0x00, 0x09, 0x1B, 0x40, 0x06, 0x02, 0x50, 0x1C, 0x02,
-	0x00, 0x00, 0x00, 0x7A, 0x01, 0x0F, 0x11, 0x00, 0x00, 0x5D, 0x1F, 0x01,
-	0x00, 0x28, 0x0D, 0x06, 0x10, 0x1A, 0x1B, 0x01, 0x01, 0x0C, 0x06, 0x03,
-	0x1A, 0x01, 0x02, 0x5D, 0x2C, 0x01, 0x00, 0x04, 0x15, 0x01, 0x01, 0x28,
-	0x0D, 0x06, 0x09, 0x1A, 0x01, 0x00, 0x5D, 0x2C, 0x42, 0x00, 0x04, 0x06,
-	0x01, 0x82, 0x00, 0x08, 0x1C, 0x1A, 0x00, 0x00, 0x01, 0x00, 0x20, 0x06,
-	0x06, 0x2A, 0x81, 0x0B, 0x27, 0x04, 0x77, 0x1B, 0x06, 0x04, 0x01, 0x01,
-	0x6F, 0x2C, 0x00, 0x00, 0x20, 0x06, 0x0B, 0x67, 0x1F, 0x01, 0x14, 0x0C,
-	0x06, 0x02, 0x5A, 0x1C, 0x04, 0x12, 0x81, 0x28, 0x01, 0x07, 0x11, 0x1B,
-	0x01, 0x02, 0x0C, 0x06, 0x06, 0x06, 0x02, 0x5A, 0x1C, 0x04, 0x6F, 0x1A,
-	0x81, 0x1E, 0x01, 0x01, 0x0C, 0x24, 0x27, 0x06, 0x02, 0x49, 0x1C, 0x1B,
-	0x01, 0x01, 0x81, 0x24, 0x26, 0x81, 0x0F, 0x00, 0x01, 0x81, 0x15, 0x01,
-	0x0B, 0x0D, 0x05, 0x02, 0x5A, 0x1C, 0x5F, 0x1E, 0x81, 0x01, 0x3F, 0x81,
-	0x1C, 0x81, 0x09, 0x1B, 0x06, 0x26, 0x81, 0x1C, 0x81, 0x09, 0x1B, 0x3E,
-	0x1B, 0x06, 0x19, 0x1B, 0x01, 0x82, 0x00, 0x0E, 0x06, 0x05, 0x01, 0x82,
-	0x00, 0x04, 0x01, 0x1B, 0x03, 0x00, 0x66, 0x02, 0x00, 0x81, 0x13, 0x02,
-	0x00, 0x3B, 0x04, 0x64, 0x7B, 0x3C, 0x04, 0x57, 0x7B, 0x7B, 0x3D, 0x1B,
-	0x06, 0x01, 0x1C, 0x1A, 0x00, 0x00, 0x7C, 0x81, 0x15, 0x01, 0x14, 0x0C,
-	0x06, 0x02, 0x5A, 0x1C, 0x66, 0x01, 0x0C, 0x08, 0x01, 0x0C, 0x81, 0x13,
-	0x7B, 0x66, 0x1B, 0x01, 0x0C, 0x08, 0x01, 0x0C, 0x21, 0x05, 0x02, 0x4C,
-	0x1C, 0x00, 0x00, 0x81, 0x16, 0x06, 0x02, 0x5A, 0x1C, 0x06, 0x02, 0x4E,
-	0x1C, 0x00, 0x09, 0x81, 0x15, 0x01, 0x02, 0x0D, 0x05, 0x02, 0x5A, 0x1C,
-	0x81, 0x1B, 0x03, 0x00, 0x02, 0x00, 0x75, 0x1E, 0x0A, 0x02, 0x00, 0x74,
-	0x1E, 0x0E, 0x27, 0x06, 0x02, 0x5B, 0x1C, 0x02, 0x00, 0x73, 0x1E, 0x0C,
-	0x06, 0x02, 0x53, 0x1C, 0x02, 0x00, 0x76, 0x2B, 0x6C, 0x01, 0x20, 0x81,
-	0x13, 0x01, 0x00, 0x03, 0x01, 0x81, 0x1D, 0x03, 0x02, 0x02, 0x02, 0x01,
-	0x20, 0x0E, 0x06, 0x02, 0x58, 0x1C, 0x66, 0x02, 0x02, 0x81, 0x13, 0x02,
-	0x02, 0x6E, 0x1F, 0x0D, 0x02, 0x02, 0x01, 0x00, 0x0E, 0x11, 0x06, 0x0B,
-	0x6D, 0x66, 0x02, 0x02, 0x21, 0x06, 0x04, 0x01, 0x7F, 0x03, 0x01, 0x6D,
-	0x66, 0x02, 0x02, 0x22, 0x02, 0x02, 0x6E, 0x2C, 0x02, 0x00, 0x72, 0x02,
-	0x01, 0x78, 0x81, 0x1B, 0x1B, 0x81, 0x1F, 0x40, 0x06, 0x02, 0x4A, 0x1C,
-	0x5F, 0x02, 0x01, 0x78, 0x81, 0x1D, 0x06, 0x02, 0x4B, 0x1C, 0x1B, 0x06,
-	0x81, 0x3D, 0x81, 0x1B, 0x81, 0x09, 0x81, 0x06, 0x03, 0x03, 0x81, 0x04,
-	0x03, 0x04, 0x81, 0x02, 0x03, 0x05, 0x81, 0x05, 0x03, 0x06, 0x81, 0x07,
-	0x03, 0x07, 0x81, 0x03, 0x03, 0x08, 0x1B, 0x06, 0x81, 0x0B, 0x81, 0x1B,
-	0x01, 0x00, 0x28, 0x0D, 0x06, 0x10, 0x1A, 0x02, 0x03, 0x05, 0x02, 0x54,
-	0x1C, 0x01, 0x00, 0x03, 0x03, 0x81, 0x1A, 0x04, 0x80, 0x70, 0x01, 0x01,
-	0x28, 0x0D, 0x06, 0x10, 0x1A, 0x02, 0x05, 0x05, 0x02, 0x54, 0x1C, 0x01,
-	0x00, 0x03, 0x05, 0x81, 0x18, 0x04, 0x80, 0x5A, 0x01, 0x83, 0xFE, 0x01,
-	0x28, 0x0D, 0x06, 0x10, 0x1A, 0x02, 0x04, 0x05, 0x02, 0x54, 0x1C, 0x01,
-	0x00, 0x03, 0x04, 0x81, 0x19, 0x04, 0x80, 0x42, 0x01, 0x0D, 0x28, 0x0D,
-	0x06, 0x0F, 0x1A, 0x02, 0x06, 0x05, 0x02, 0x54, 0x1C, 0x01, 0x00, 0x03,
-	0x06, 0x81, 0x17, 0x04, 0x2D, 0x01, 0x0A, 0x28, 0x0D, 0x06, 0x0F, 0x1A,
-	0x02, 0x07, 0x05, 0x02, 0x54, 0x1C, 0x01, 0x00, 0x03, 0x07, 0x81, 0x17,
-	0x04, 0x18, 0x01, 0x0B, 0x28, 0x0D, 0x06, 0x0F, 0x1A, 0x02, 0x08, 0x05,
-	0x02, 0x54, 0x1C, 0x01, 0x00, 0x03, 0x08, 0x81, 0x17, 0x04, 0x03, 0x54,
-	0x1C, 0x1A, 0x04, 0xFE, 0x71, 0x02, 0x04, 0x06, 0x0D, 0x02, 0x04, 0x01,
-	0x05, 0x0E, 0x06, 0x02, 0x51, 0x1C, 0x01, 0x01, 0x69, 0x2C, 0x7B, 0x7B,
-	0x02, 0x01, 0x00, 0x04, 0x81, 0x15, 0x01, 0x0C, 0x0D, 0x05, 0x02, 0x5A,
-	0x1C, 0x81, 0x1D, 0x01, 0x03, 0x0D, 0x05, 0x02, 0x55, 0x1C, 0x81, 0x1B,
-	0x1B, 0x62, 0x2C, 0x1B, 0x01, 0x20, 0x0F, 0x06, 0x02, 0x55, 0x1C, 0x2E,
-	0x32, 0x10, 0x01, 0x01, 0x11, 0x05, 0x02, 0x55, 0x1C, 0x81, 0x1D, 0x1B,
-	0x01, 0x81, 0x05, 0x0E, 0x06, 0x02, 0x55, 0x1C, 0x1B, 0x64, 0x2C, 0x63,
-	0x32, 0x81, 0x13, 0x72, 0x1E, 0x01, 0x86, 0x03, 0x0F, 0x03, 0x00, 0x5F,
-	0x1E, 0x81, 0x26, 0x03, 0x01, 0x01, 0x02, 0x03, 0x02, 0x02, 0x00, 0x06,
-	0x23, 0x81, 0x1D, 0x1B, 0x1B, 0x01, 0x02, 0x0A, 0x32, 0x01, 0x06, 0x0E,
-	0x27, 0x06, 0x02, 0x55, 0x1C, 0x03, 0x02, 0x81, 0x1D, 0x02, 0x01, 0x01,
-	0x01, 0x0B, 0x01, 0x03, 0x08, 0x0D, 0x05, 0x02, 0x55, 0x1C, 0x04, 0x08,
-	0x02, 0x01, 0x06, 0x04, 0x01, 0x00, 0x03, 0x02, 0x81, 0x1B, 0x1B, 0x03,
-	0x03, 0x1B, 0x01, 0x84, 0x00, 0x0E, 0x06, 0x02, 0x56, 0x1C, 0x66, 0x32,
-	0x81, 0x13, 0x02, 0x02, 0x02, 0x01, 0x02, 0x03, 0x38, 0x1B, 0x06, 0x01,
-	0x1C, 0x1A, 0x7B, 0x00, 0x02, 0x03, 0x00, 0x03, 0x01, 0x02, 0x00, 0x77,
-	0x02, 0x01, 0x02, 0x00, 0x29, 0x1B, 0x01, 0x00, 0x0D, 0x06, 0x02, 0x48,
-	0x00, 0x81, 0x2A, 0x04, 0x73, 0x00, 0x1B, 0x06, 0x05, 0x81, 0x1D, 0x1A,
-	0x04, 0x78, 0x1A, 0x00, 0x00, 0x81, 0x16, 0x1B, 0x42, 0x06, 0x07, 0x1A,
-	0x06, 0x02, 0x4E, 0x1C, 0x04, 0x73, 0x00, 0x00, 0x81, 0x1E, 0x01, 0x03,
-	0x81, 0x1C, 0x32, 0x1A, 0x32, 0x00, 0x00, 0x81, 0x1B, 0x81, 0x22, 0x00,
-	0x00, 0x81, 0x1B, 0x01, 0x01, 0x0D, 0x05, 0x02, 0x4D, 0x1C, 0x81, 0x1D,
-	0x01, 0x08, 0x08, 0x65, 0x1F, 0x0D, 0x05, 0x02, 0x4D, 0x1C, 0x00, 0x00,
-	0x81, 0x1B, 0x69, 0x1F, 0x05, 0x16, 0x01, 0x01, 0x0D, 0x05, 0x02, 0x51,
-	0x1C, 0x81, 0x1D, 0x01, 0x00, 0x0D, 0x05, 0x02, 0x51, 0x1C, 0x01, 0x02,
-	0x69, 0x2C, 0x04, 0x1E, 0x01, 0x19, 0x0D, 0x05, 0x02, 0x51, 0x1C, 0x81,
-	0x1D, 0x01, 0x18, 0x0D, 0x05, 0x02, 0x51, 0x1C, 0x66, 0x01, 0x18, 0x81,
-	0x13, 0x6A, 0x66, 0x01, 0x18, 0x21, 0x05, 0x02, 0x51, 0x1C, 0x00, 0x00,
-	0x81, 0x1B, 0x06, 0x02, 0x52, 0x1C, 0x00, 0x00, 0x01, 0x02, 0x77, 0x81,
-	0x1E, 0x01, 0x08, 0x0B, 0x81, 0x1E, 0x08, 0x00, 0x00, 0x01, 0x03, 0x77,
-	0x81, 0x1E, 0x01, 0x08, 0x0B, 0x81, 0x1E, 0x08, 0x01, 0x08, 0x0B, 0x81,
-	0x1E, 0x08, 0x00, 0x00, 0x01, 0x01, 0x77, 0x81, 0x1E, 0x00, 0x00, 0x2A,
-	0x1B, 0x40, 0x05, 0x01, 0x00, 0x1A, 0x81, 0x2A, 0x04, 0x75, 0x02, 0x03,
-	0x00, 0x71, 0x1F, 0x03, 0x01, 0x01, 0x00, 0x1B, 0x02, 0x01, 0x0A, 0x06,
-	0x10, 0x1B, 0x01, 0x01, 0x0B, 0x70, 0x08, 0x1E, 0x02, 0x00, 0x0D, 0x06,
-	0x01, 0x00, 0x44, 0x04, 0x6A, 0x1A, 0x01, 0x7F, 0x00, 0x00, 0x01, 0x15,
-	0x68, 0x2C, 0x32, 0x3A, 0x1A, 0x3A, 0x1A, 0x1D, 0x00, 0x00, 0x01, 0x01,
-	0x32, 0x81, 0x20, 0x00, 0x00, 0x32, 0x28, 0x77, 0x32, 0x1B, 0x06, 0x06,
-	0x81, 0x1E, 0x1A, 0x45, 0x04, 0x77, 0x1A, 0x00, 0x00, 0x7A, 0x41, 0x00,
-	0x02, 0x03, 0x00, 0x5F, 0x1E, 0x7A, 0x03, 0x01, 0x02, 0x01, 0x01, 0x0F,
-	0x11, 0x02, 0x01, 0x01, 0x04, 0x10, 0x01, 0x0F, 0x11, 0x02, 0x01, 0x01,
-	0x08, 0x10, 0x01, 0x0F, 0x11, 0x01, 0x00, 0x28, 0x0D, 0x06, 0x10, 0x1A,
-	0x01, 0x00, 0x01, 0x18, 0x02, 0x00, 0x06, 0x03, 0x35, 0x04, 0x01, 0x36,
-	0x04, 0x80, 0x56, 0x01, 0x01, 0x28, 0x0D, 0x06, 0x10, 0x1A, 0x01, 0x01,
-	0x01, 0x10, 0x02, 0x00, 0x06, 0x03, 0x35, 0x04, 0x01, 0x36, 0x04, 0x80,
-	0x40, 0x01, 0x02, 0x28, 0x0D, 0x06, 0x0F, 0x1A, 0x01, 0x01, 0x01, 0x20,
-	0x02, 0x00, 0x06, 0x03, 0x35, 0x04, 0x01, 0x36, 0x04, 0x2B, 0x01, 0x03,
-	0x28, 0x0D, 0x06, 0x0E, 0x1A, 0x1A, 0x01, 0x10, 0x02, 0x00, 0x06, 0x03,
-	0x33, 0x04, 0x01, 0x34, 0x04, 0x17, 0x01, 0x04, 0x28, 0x0D, 0x06, 0x0E,
-	0x1A, 0x1A, 0x01, 0x20, 0x02, 0x00, 0x06, 0x03, 0x33, 0x04, 0x01, 0x34,
-	0x04, 0x03, 0x50, 0x1C, 0x1A, 0x00, 0x00, 0x7A, 0x01, 0x0C, 0x10, 0x1B,
-	0x43, 0x32, 0x01, 0x03, 0x0A, 0x11, 0x00, 0x00, 0x7A, 0x01, 0x0C, 0x10,
-	0x01, 0x01, 0x0D, 0x00, 0x00, 0x7A, 0x01, 0x0C, 0x10, 0x42, 0x00, 0x00,
-	0x14, 0x01, 0x00, 0x5C, 0x1F, 0x1B, 0x06, 0x1F, 0x01, 0x01, 0x28, 0x0D,
-	0x06, 0x06, 0x1A, 0x01, 0x00, 0x7E, 0x04, 0x11, 0x01, 0x02, 0x28, 0x0D,
-	0x06, 0x0A, 0x1A, 0x5E, 0x1F, 0x06, 0x03, 0x01, 0x10, 0x27, 0x04, 0x01,
-	0x1A, 0x04, 0x01, 0x1A, 0x61, 0x1F, 0x05, 0x34, 0x20, 0x06, 0x31, 0x67,
-	0x1F, 0x01, 0x14, 0x28, 0x0D, 0x06, 0x06, 0x1A, 0x01, 0x02, 0x27, 0x04,
-	0x23, 0x01, 0x15, 0x28, 0x0D, 0x06, 0x0A, 0x1A, 0x81, 0x0C, 0x06, 0x03,
-	0x01, 0x7F, 0x7E, 0x04, 0x13, 0x01, 0x16, 0x28, 0x0D, 0x06, 0x06, 0x1A,
-	0x01, 0x01, 0x27, 0x04, 0x07, 0x1A, 0x01, 0x04, 0x27, 0x01, 0x00, 0x1A,
-	0x13, 0x06, 0x03, 0x01, 0x08, 0x27, 0x00, 0x00, 0x14, 0x1B, 0x05, 0x10,
-	0x20, 0x06, 0x0D, 0x67, 0x1F, 0x01, 0x15, 0x0D, 0x06, 0x05, 0x1A, 0x81,
-	0x0C, 0x04, 0x01, 0x17, 0x00, 0x00, 0x81, 0x28, 0x01, 0x07, 0x11, 0x01,
-	0x01, 0x0E, 0x06, 0x02, 0x5A, 0x1C, 0x00, 0x01, 0x03, 0x00, 0x1D, 0x13,
-	0x06, 0x05, 0x02, 0x00, 0x68, 0x2C, 0x00, 0x81, 0x28, 0x1A, 0x04, 0x73,
-	0x00, 0x01, 0x14, 0x81, 0x2B, 0x01, 0x01, 0x81, 0x37, 0x1D, 0x1B, 0x01,
-	0x00, 0x81, 0x24, 0x01, 0x16, 0x81, 0x2B, 0x81, 0x2F, 0x1D, 0x00, 0x01,
-	0x81, 0x04, 0x81, 0x06, 0x08, 0x81, 0x02, 0x08, 0x81, 0x05, 0x08, 0x81,
-	0x07, 0x08, 0x81, 0x03, 0x08, 0x03, 0x00, 0x01, 0x01, 0x81, 0x37, 0x01,
-	0x27, 0x6E, 0x1F, 0x08, 0x71, 0x1F, 0x01, 0x01, 0x0B, 0x08, 0x02, 0x00,
-	0x06, 0x04, 0x46, 0x02, 0x00, 0x08, 0x81, 0x36, 0x74, 0x1E, 0x81, 0x35,
-	0x60, 0x01, 0x04, 0x12, 0x60, 0x01, 0x04, 0x08, 0x01, 0x1C, 0x23, 0x60,
-	0x01, 0x20, 0x81, 0x30, 0x6D, 0x6E, 0x1F, 0x81, 0x32, 0x71, 0x1F, 0x1B,
-	0x01, 0x01, 0x0B, 0x81, 0x35, 0x70, 0x32, 0x1B, 0x06, 0x11, 0x45, 0x28,
-	0x1E, 0x1B, 0x81, 0x23, 0x05, 0x02, 0x4A, 0x1C, 0x81, 0x35, 0x32, 0x46,
-	0x32, 0x04, 0x6C, 0x48, 0x01, 0x01, 0x81, 0x37, 0x01, 0x00, 0x81, 0x37,
-	0x02, 0x00, 0x06, 0x81, 0x2E, 0x02, 0x00, 0x81, 0x35, 0x81, 0x04, 0x06,
-	0x12, 0x01, 0x83, 0xFE, 0x01, 0x81, 0x35, 0x6A, 0x81, 0x04, 0x01, 0x04,
-	0x09, 0x1B, 0x81, 0x35, 0x45, 0x81, 0x32, 0x81, 0x06, 0x06, 0x1C, 0x01,
-	0x00, 0x81, 0x35, 0x6B, 0x81, 0x06, 0x01, 0x04, 0x09, 0x1B, 0x81, 0x35,
-	0x01, 0x02, 0x09, 0x1B, 0x81, 0x35, 0x01, 0x00, 0x81, 0x37, 0x01, 0x03,
-	0x09, 0x81, 0x31, 0x81, 0x02, 0x06, 0x0F, 0x01, 0x01, 0x81, 0x35, 0x01,
-	0x01, 0x81, 0x35, 0x65, 0x1F, 0x01, 0x08, 0x09, 0x81, 0x37, 0x81, 0x05,
-	0x06, 0x1F, 0x01, 0x0D, 0x81, 0x35, 0x81, 0x05, 0x01, 0x04, 0x09, 0x1B,
-	0x81, 0x35, 0x01, 0x02, 0x09, 0x81, 0x35, 0x30, 0x06, 0x04, 0x01, 0x03,
-	0x81, 0x34, 0x31, 0x06, 0x04, 0x01, 0x01, 0x81, 0x34, 0x81, 0x07, 0x1B,
-	0x06, 0x27, 0x01, 0x0A, 0x81, 0x35, 0x01, 0x04, 0x09, 0x1B, 0x81, 0x35,
-	0x47, 0x81, 0x35, 0x2E, 0x01, 0x00, 0x1B, 0x01, 0x20, 0x0A, 0x06, 0x0E,
-	0x81, 0x00, 0x10, 0x01, 0x01, 0x11, 0x06, 0x03, 0x1B, 0x81, 0x35, 0x44,
-	0x04, 0x6C, 0x48, 0x04, 0x01, 0x1A, 0x81, 0x03, 0x06, 0x0D, 0x01, 0x0B,
-	0x81, 0x35, 0x01, 0x02, 0x81, 0x35, 0x01, 0x82, 0x00, 0x81, 0x35, 0x00,
-	0x00, 0x01, 0x10, 0x81, 0x37, 0x5F, 0x1E, 0x1B, 0x81, 0x27, 0x06, 0x10,
-	0x81, 0x0A, 0x19, 0x1B, 0x46, 0x81, 0x36, 0x1B, 0x81, 0x35, 0x66, 0x32,
-	0x81, 0x30, 0x04, 0x12, 0x1B, 0x81, 0x25, 0x32, 0x81, 0x0A, 0x18, 0x1B,
-	0x44, 0x81, 0x36, 0x1B, 0x81, 0x37, 0x66, 0x32, 0x81, 0x30, 0x00, 0x00,
-	0x7C, 0x01, 0x14, 0x81, 0x37, 0x01, 0x0C, 0x81, 0x36, 0x66, 0x01, 0x0C,
-	0x81, 0x30, 0x00, 0x00, 0x39, 0x1B, 0x01, 0x00, 0x0D, 0x06, 0x02, 0x48,
-	0x00, 0x81, 0x28, 0x1A, 0x04, 0x72, 0x00, 0x1B, 0x81, 0x35, 0x81, 0x30,
-	0x00, 0x00, 0x1B, 0x81, 0x37, 0x81, 0x30, 0x00, 0x00, 0x01, 0x0B, 0x81,
-	0x37, 0x01, 0x03, 0x81, 0x36, 0x01, 0x00, 0x81, 0x36, 0x00, 0x01, 0x03,
-	0x00, 0x2F, 0x1A, 0x1B, 0x01, 0x10, 0x11, 0x06, 0x08, 0x01, 0x04, 0x81,
-	0x37, 0x02, 0x00, 0x81, 0x37, 0x1B, 0x01, 0x08, 0x11, 0x06, 0x08, 0x01,
-	0x03, 0x81, 0x37, 0x02, 0x00, 0x81, 0x37, 0x1B, 0x01, 0x20, 0x11, 0x06,
-	0x08, 0x01, 0x05, 0x81, 0x37, 0x02, 0x00, 0x81, 0x37, 0x1B, 0x01, 0x80,
-	0x40, 0x11, 0x06, 0x08, 0x01, 0x06, 0x81, 0x37, 0x02, 0x00, 0x81, 0x37,
-	0x01, 0x04, 0x11, 0x06, 0x08, 0x01, 0x02, 0x81, 0x37, 0x02, 0x00, 0x81,
-	0x37, 0x00, 0x00, 0x1B, 0x01, 0x08, 0x37, 0x81, 0x37, 0x81, 0x37, 0x00,
-	0x00, 0x1B, 0x01, 0x10, 0x37, 0x81, 0x37, 0x81, 0x35, 0x00, 0x00, 0x1B,
-	0x3A, 0x06, 0x02, 0x1A, 0x00, 0x81, 0x28, 0x1A, 0x04, 0x75
+	0x34, 0x1A, 0x00, 0x00, 0x32, 0x06, 0x04, 0x01, 0x04, 0x04, 0x02, 0x01,
+	0x00, 0x00, 0x00, 0x6C, 0x1F, 0x01, 0x0E, 0x0D, 0x06, 0x04, 0x01, 0x00,
+	0x04, 0x02, 0x01, 0x05, 0x00, 0x00, 0x2F, 0x06, 0x04, 0x01, 0x06, 0x04,
+	0x02, 0x01, 0x00, 0x00, 0x00, 0x70, 0x1F, 0x1B, 0x06, 0x08, 0x01, 0x01,
+	0x09, 0x01, 0x11, 0x07, 0x04, 0x03, 0x1A, 0x01, 0x05, 0x00, 0x01, 0x30,
+	0x03, 0x00, 0x1A, 0x01, 0x00, 0x33, 0x06, 0x03, 0x02, 0x00, 0x08, 0x31,
+	0x06, 0x03, 0x02, 0x00, 0x08, 0x1B, 0x06, 0x06, 0x01, 0x01, 0x0B, 0x01,
+	0x06, 0x08, 0x00, 0x00, 0x72, 0x2E, 0x1B, 0x06, 0x03, 0x01, 0x09, 0x08,
+	0x00, 0x01, 0x2F, 0x1B, 0x06, 0x1E, 0x01, 0x00, 0x03, 0x00, 0x1B, 0x06,
+	0x0E, 0x1B, 0x01, 0x01, 0x11, 0x02, 0x00, 0x08, 0x03, 0x00, 0x01, 0x01,
+	0x10, 0x04, 0x6F, 0x1A, 0x02, 0x00, 0x01, 0x01, 0x0B, 0x01, 0x06, 0x08,
+	0x00, 0x00, 0x81, 0x06, 0x81, 0x31, 0x1B, 0x01, 0x07, 0x11, 0x01, 0x00,
+	0x29, 0x0D, 0x06, 0x0A, 0x1A, 0x01, 0x10, 0x11, 0x06, 0x02, 0x81, 0x06,
+	0x04, 0x2D, 0x01, 0x01, 0x29, 0x0D, 0x06, 0x24, 0x1A, 0x1A, 0x01, 0x00,
+	0x64, 0x2D, 0x81, 0x18, 0x70, 0x1F, 0x01, 0x01, 0x0D, 0x06, 0x11, 0x1D,
+	0x13, 0x27, 0x06, 0x05, 0x81, 0x31, 0x1A, 0x04, 0x77, 0x01, 0x80, 0x64,
+	0x81, 0x2A, 0x04, 0x02, 0x81, 0x06, 0x04, 0x03, 0x60, 0x1C, 0x1A, 0x04,
+	0xFF, 0x3A, 0x01, 0x1B, 0x03, 0x00, 0x09, 0x1B, 0x46, 0x06, 0x02, 0x56,
+	0x1C, 0x02, 0x00, 0x00, 0x00, 0x81, 0x01, 0x01, 0x0F, 0x11, 0x00, 0x00,
+	0x63, 0x1F, 0x01, 0x00, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x1B, 0x01, 0x01,
+	0x0C, 0x06, 0x03, 0x1A, 0x01, 0x02, 0x63, 0x2D, 0x01, 0x00, 0x04, 0x15,
+	0x01, 0x01, 0x29, 0x0D, 0x06, 0x09, 0x1A, 0x01, 0x00, 0x63, 0x2D, 0x48,
+	0x00, 0x04, 0x06, 0x01, 0x82, 0x00, 0x08, 0x1C, 0x1A, 0x00, 0x00, 0x01,
+	0x00, 0x20, 0x06, 0x06, 0x2B, 0x81, 0x13, 0x28, 0x04, 0x77, 0x1B, 0x06,
+	0x04, 0x01, 0x01, 0x76, 0x2D, 0x00, 0x00, 0x20, 0x06, 0x0B, 0x6E, 0x1F,
+	0x01, 0x14, 0x0C, 0x06, 0x02, 0x60, 0x1C, 0x04, 0x12, 0x81, 0x31, 0x01,
+	0x07, 0x11, 0x1B, 0x01, 0x02, 0x0C, 0x06, 0x06, 0x06, 0x02, 0x60, 0x1C,
+	0x04, 0x6F, 0x1A, 0x81, 0x27, 0x01, 0x01, 0x0C, 0x24, 0x28, 0x06, 0x02,
+	0x4F, 0x1C, 0x1B, 0x01, 0x01, 0x81, 0x2D, 0x27, 0x81, 0x17, 0x00, 0x01,
+	0x81, 0x1D, 0x01, 0x0B, 0x0D, 0x05, 0x02, 0x60, 0x1C, 0x65, 0x1E, 0x81,
+	0x08, 0x45, 0x81, 0x25, 0x81, 0x11, 0x1B, 0x06, 0x27, 0x81, 0x25, 0x81,
+	0x11, 0x1B, 0x44, 0x1B, 0x06, 0x19, 0x1B, 0x01, 0x82, 0x00, 0x0E, 0x06,
+	0x05, 0x01, 0x82, 0x00, 0x04, 0x01, 0x1B, 0x03, 0x00, 0x6D, 0x02, 0x00,
+	0x81, 0x1B, 0x02, 0x00, 0x41, 0x04, 0x64, 0x81, 0x02, 0x42, 0x04, 0x56,
+	0x81, 0x02, 0x81, 0x02, 0x43, 0x1B, 0x06, 0x01, 0x1C, 0x1A, 0x00, 0x00,
+	0x81, 0x03, 0x81, 0x1D, 0x01, 0x14, 0x0C, 0x06, 0x02, 0x60, 0x1C, 0x6D,
+	0x01, 0x0C, 0x08, 0x01, 0x0C, 0x81, 0x1B, 0x81, 0x02, 0x6D, 0x1B, 0x01,
+	0x0C, 0x08, 0x01, 0x0C, 0x21, 0x05, 0x02, 0x52, 0x1C, 0x00, 0x00, 0x81,
+	0x1E, 0x06, 0x02, 0x60, 0x1C, 0x06, 0x02, 0x54, 0x1C, 0x00, 0x0A, 0x81,
+	0x1D, 0x01, 0x02, 0x0D, 0x05, 0x02, 0x60, 0x1C, 0x81, 0x24, 0x03, 0x00,
+	0x02, 0x00, 0x7C, 0x1E, 0x0A, 0x02, 0x00, 0x7B, 0x1E, 0x0E, 0x28, 0x06,
+	0x02, 0x61, 0x1C, 0x02, 0x00, 0x7A, 0x1E, 0x0C, 0x06, 0x02, 0x59, 0x1C,
+	0x02, 0x00, 0x7D, 0x2C, 0x73, 0x01, 0x20, 0x81, 0x1B, 0x01, 0x00, 0x03,
+	0x01, 0x81, 0x26, 0x03, 0x02, 0x02, 0x02, 0x01, 0x20, 0x0E, 0x06, 0x02,
+	0x5E, 0x1C, 0x6D, 0x02, 0x02, 0x81, 0x1B, 0x02, 0x02, 0x75, 0x1F, 0x0D,
+	0x02, 0x02, 0x01, 0x00, 0x0E, 0x11, 0x06, 0x0B, 0x74, 0x6D, 0x02, 0x02,
+	0x21, 0x06, 0x04, 0x01, 0x7F, 0x03, 0x01, 0x74, 0x6D, 0x02, 0x02, 0x22,
+	0x02, 0x02, 0x75, 0x2D, 0x02, 0x00, 0x79, 0x02, 0x01, 0x7F, 0x81, 0x24,
+	0x1B, 0x81, 0x28, 0x46, 0x06, 0x02, 0x50, 0x1C, 0x65, 0x02, 0x01, 0x7F,
+	0x81, 0x26, 0x06, 0x02, 0x51, 0x1C, 0x01, 0x00, 0x6B, 0x2D, 0x1B, 0x06,
+	0x81, 0x58, 0x81, 0x24, 0x81, 0x11, 0x81, 0x0E, 0x03, 0x03, 0x81, 0x0C,
+	0x03, 0x04, 0x81, 0x0A, 0x03, 0x05, 0x81, 0x0D, 0x03, 0x06, 0x81, 0x0F,
+	0x03, 0x07, 0x81, 0x0B, 0x03, 0x08, 0x81, 0x09, 0x03, 0x09, 0x1B, 0x06,
+	0x81, 0x21, 0x81, 0x24, 0x01, 0x00, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x02,
+	0x03, 0x05, 0x02, 0x5A, 0x1C, 0x01, 0x00, 0x03, 0x03, 0x81, 0x23, 0x04,
+	0x81, 0x06, 0x01, 0x01, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x02, 0x05, 0x05,
+	0x02, 0x5A, 0x1C, 0x01, 0x00, 0x03, 0x05, 0x81, 0x21, 0x04, 0x80, 0x70,
+	0x01, 0x83, 0xFE, 0x01, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x02, 0x04, 0x05,
+	0x02, 0x5A, 0x1C, 0x01, 0x00, 0x03, 0x04, 0x81, 0x22, 0x04, 0x80, 0x58,
+	0x01, 0x0D, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x02, 0x06, 0x05, 0x02, 0x5A,
+	0x1C, 0x01, 0x00, 0x03, 0x06, 0x81, 0x1F, 0x04, 0x80, 0x42, 0x01, 0x0A,
+	0x29, 0x0D, 0x06, 0x0F, 0x1A, 0x02, 0x07, 0x05, 0x02, 0x5A, 0x1C, 0x01,
+	0x00, 0x03, 0x07, 0x81, 0x1F, 0x04, 0x2D, 0x01, 0x0B, 0x29, 0x0D, 0x06,
+	0x0F, 0x1A, 0x02, 0x08, 0x05, 0x02, 0x5A, 0x1C, 0x01, 0x00, 0x03, 0x08,
+	0x81, 0x1F, 0x04, 0x18, 0x01, 0x16, 0x29, 0x0D, 0x06, 0x0F, 0x1A, 0x02,
+	0x09, 0x05, 0x02, 0x5A, 0x1C, 0x01, 0x00, 0x03, 0x09, 0x81, 0x20, 0x04,
+	0x03, 0x5A, 0x1C, 0x1A, 0x04, 0xFE, 0x5B, 0x02, 0x04, 0x06, 0x0D, 0x02,
+	0x04, 0x01, 0x05, 0x0E, 0x06, 0x02, 0x57, 0x1C, 0x01, 0x01, 0x70, 0x2D,
+	0x81, 0x02, 0x81, 0x02, 0x02, 0x01, 0x00, 0x04, 0x81, 0x1D, 0x01, 0x0C,
+	0x0D, 0x05, 0x02, 0x60, 0x1C, 0x81, 0x26, 0x01, 0x03, 0x0D, 0x05, 0x02,
+	0x5B, 0x1C, 0x81, 0x24, 0x1B, 0x68, 0x2D, 0x1B, 0x01, 0x20, 0x0F, 0x06,
+	0x02, 0x5B, 0x1C, 0x2F, 0x34, 0x10, 0x01, 0x01, 0x11, 0x05, 0x02, 0x5B,
+	0x1C, 0x81, 0x26, 0x1B, 0x01, 0x81, 0x05, 0x0E, 0x06, 0x02, 0x5B, 0x1C,
+	0x1B, 0x6A, 0x2D, 0x69, 0x34, 0x81, 0x1B, 0x79, 0x1E, 0x01, 0x86, 0x03,
+	0x0F, 0x03, 0x00, 0x65, 0x1E, 0x81, 0x2F, 0x03, 0x01, 0x01, 0x02, 0x03,
+	0x02, 0x02, 0x00, 0x06, 0x23, 0x81, 0x26, 0x1B, 0x1B, 0x01, 0x02, 0x0A,
+	0x34, 0x01, 0x06, 0x0E, 0x28, 0x06, 0x02, 0x5B, 0x1C, 0x03, 0x02, 0x81,
+	0x26, 0x02, 0x01, 0x01, 0x01, 0x0B, 0x01, 0x03, 0x08, 0x0D, 0x05, 0x02,
+	0x5B, 0x1C, 0x04, 0x08, 0x02, 0x01, 0x06, 0x04, 0x01, 0x00, 0x03, 0x02,
+	0x81, 0x24, 0x1B, 0x03, 0x03, 0x1B, 0x01, 0x84, 0x00, 0x0E, 0x06, 0x02,
+	0x5C, 0x1C, 0x6D, 0x34, 0x81, 0x1B, 0x02, 0x02, 0x02, 0x01, 0x02, 0x03,
+	0x3E, 0x1B, 0x06, 0x01, 0x1C, 0x1A, 0x81, 0x02, 0x00, 0x02, 0x03, 0x00,
+	0x03, 0x01, 0x02, 0x00, 0x7E, 0x02, 0x01, 0x02, 0x00, 0x2A, 0x1B, 0x01,
+	0x00, 0x0D, 0x06, 0x02, 0x4E, 0x00, 0x81, 0x33, 0x04, 0x73, 0x00, 0x1B,
+	0x06, 0x05, 0x81, 0x26, 0x1A, 0x04, 0x78, 0x1A, 0x00, 0x00, 0x81, 0x1E,
+	0x1B, 0x48, 0x06, 0x07, 0x1A, 0x06, 0x02, 0x54, 0x1C, 0x04, 0x73, 0x00,
+	0x00, 0x81, 0x27, 0x01, 0x03, 0x81, 0x25, 0x34, 0x1A, 0x34, 0x00, 0x00,
+	0x81, 0x24, 0x81, 0x2B, 0x00, 0x00, 0x81, 0x24, 0x06, 0x02, 0x54, 0x1C,
+	0x01, 0x01, 0x6B, 0x2D, 0x00, 0x00, 0x81, 0x24, 0x01, 0x01, 0x0D, 0x05,
+	0x02, 0x53, 0x1C, 0x81, 0x26, 0x01, 0x08, 0x08, 0x6C, 0x1F, 0x0D, 0x05,
+	0x02, 0x53, 0x1C, 0x00, 0x00, 0x81, 0x24, 0x70, 0x1F, 0x05, 0x16, 0x01,
+	0x01, 0x0D, 0x05, 0x02, 0x57, 0x1C, 0x81, 0x26, 0x01, 0x00, 0x0D, 0x05,
+	0x02, 0x57, 0x1C, 0x01, 0x02, 0x70, 0x2D, 0x04, 0x1E, 0x01, 0x19, 0x0D,
+	0x05, 0x02, 0x57, 0x1C, 0x81, 0x26, 0x01, 0x18, 0x0D, 0x05, 0x02, 0x57,
+	0x1C, 0x6D, 0x01, 0x18, 0x81, 0x1B, 0x71, 0x6D, 0x01, 0x18, 0x21, 0x05,
+	0x02, 0x57, 0x1C, 0x00, 0x00, 0x81, 0x24, 0x06, 0x02, 0x58, 0x1C, 0x00,
+	0x00, 0x01, 0x02, 0x7E, 0x81, 0x27, 0x01, 0x08, 0x0B, 0x81, 0x27, 0x08,
+	0x00, 0x00, 0x01, 0x03, 0x7E, 0x81, 0x27, 0x01, 0x08, 0x0B, 0x81, 0x27,
+	0x08, 0x01, 0x08, 0x0B, 0x81, 0x27, 0x08, 0x00, 0x00, 0x01, 0x01, 0x7E,
+	0x81, 0x27, 0x00, 0x00, 0x2B, 0x1B, 0x46, 0x05, 0x01, 0x00, 0x1A, 0x81,
+	0x33, 0x04, 0x75, 0x02, 0x03, 0x00, 0x78, 0x1F, 0x03, 0x01, 0x01, 0x00,
+	0x1B, 0x02, 0x01, 0x0A, 0x06, 0x10, 0x1B, 0x01, 0x01, 0x0B, 0x77, 0x08,
+	0x1E, 0x02, 0x00, 0x0D, 0x06, 0x01, 0x00, 0x4A, 0x04, 0x6A, 0x1A, 0x01,
+	0x7F, 0x00, 0x00, 0x01, 0x15, 0x6F, 0x2D, 0x34, 0x40, 0x1A, 0x40, 0x1A,
+	0x1D, 0x00, 0x00, 0x01, 0x01, 0x34, 0x81, 0x29, 0x00, 0x00, 0x34, 0x29,
+	0x7E, 0x34, 0x1B, 0x06, 0x06, 0x81, 0x27, 0x1A, 0x4B, 0x04, 0x77, 0x1A,
+	0x00, 0x00, 0x81, 0x01, 0x47, 0x00, 0x02, 0x03, 0x00, 0x65, 0x1E, 0x81,
+	0x01, 0x03, 0x01, 0x02, 0x01, 0x01, 0x0F, 0x11, 0x02, 0x01, 0x01, 0x04,
+	0x10, 0x01, 0x0F, 0x11, 0x02, 0x01, 0x01, 0x08, 0x10, 0x01, 0x0F, 0x11,
+	0x01, 0x00, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x01, 0x00, 0x01, 0x18, 0x02,
+	0x00, 0x06, 0x03, 0x39, 0x04, 0x01, 0x3A, 0x04, 0x81, 0x45, 0x01, 0x01,
+	0x29, 0x0D, 0x06, 0x10, 0x1A, 0x01, 0x01, 0x01, 0x10, 0x02, 0x00, 0x06,
+	0x03, 0x39, 0x04, 0x01, 0x3A, 0x04, 0x81, 0x2F, 0x01, 0x02, 0x29, 0x0D,
+	0x06, 0x10, 0x1A, 0x01, 0x01, 0x01, 0x20, 0x02, 0x00, 0x06, 0x03, 0x39,
+	0x04, 0x01, 0x3A, 0x04, 0x81, 0x19, 0x01, 0x03, 0x29, 0x0D, 0x06, 0x0F,
+	0x1A, 0x1A, 0x01, 0x10, 0x02, 0x00, 0x06, 0x03, 0x37, 0x04, 0x01, 0x38,
+	0x04, 0x81, 0x04, 0x01, 0x04, 0x29, 0x0D, 0x06, 0x0F, 0x1A, 0x1A, 0x01,
+	0x20, 0x02, 0x00, 0x06, 0x03, 0x37, 0x04, 0x01, 0x38, 0x04, 0x80, 0x6F,
+	0x01, 0x05, 0x29, 0x0D, 0x06, 0x0D, 0x1A, 0x1A, 0x02, 0x00, 0x06, 0x03,
+	0x3B, 0x04, 0x01, 0x3C, 0x04, 0x80, 0x5C, 0x01, 0x06, 0x29, 0x0D, 0x06,
+	0x11, 0x1A, 0x1A, 0x01, 0x10, 0x01, 0x10, 0x02, 0x00, 0x06, 0x03, 0x35,
+	0x04, 0x01, 0x36, 0x04, 0x80, 0x45, 0x01, 0x07, 0x29, 0x0D, 0x06, 0x10,
+	0x1A, 0x1A, 0x01, 0x20, 0x01, 0x10, 0x02, 0x00, 0x06, 0x03, 0x35, 0x04,
+	0x01, 0x36, 0x04, 0x2F, 0x01, 0x08, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x1A,
+	0x01, 0x10, 0x01, 0x08, 0x02, 0x00, 0x06, 0x03, 0x35, 0x04, 0x01, 0x36,
+	0x04, 0x19, 0x01, 0x09, 0x29, 0x0D, 0x06, 0x10, 0x1A, 0x1A, 0x01, 0x20,
+	0x01, 0x08, 0x02, 0x00, 0x06, 0x03, 0x35, 0x04, 0x01, 0x36, 0x04, 0x03,
+	0x56, 0x1C, 0x1A, 0x00, 0x00, 0x81, 0x01, 0x01, 0x0C, 0x10, 0x1B, 0x49,
+	0x34, 0x01, 0x03, 0x0A, 0x11, 0x00, 0x00, 0x81, 0x01, 0x01, 0x0C, 0x10,
+	0x01, 0x01, 0x0D, 0x00, 0x00, 0x81, 0x01, 0x01, 0x0C, 0x10, 0x48, 0x00,
+	0x00, 0x14, 0x01, 0x00, 0x62, 0x1F, 0x1B, 0x06, 0x20, 0x01, 0x01, 0x29,
+	0x0D, 0x06, 0x07, 0x1A, 0x01, 0x00, 0x81, 0x05, 0x04, 0x11, 0x01, 0x02,
+	0x29, 0x0D, 0x06, 0x0A, 0x1A, 0x64, 0x1F, 0x06, 0x03, 0x01, 0x10, 0x28,
+	0x04, 0x01, 0x1A, 0x04, 0x01, 0x1A, 0x67, 0x1F, 0x05, 0x35, 0x20, 0x06,
+	0x32, 0x6E, 0x1F, 0x01, 0x14, 0x29, 0x0D, 0x06, 0x06, 0x1A, 0x01, 0x02,
+	0x28, 0x04, 0x24, 0x01, 0x15, 0x29, 0x0D, 0x06, 0x0B, 0x1A, 0x81, 0x14,
+	0x06, 0x04, 0x01, 0x7F, 0x81, 0x05, 0x04, 0x13, 0x01, 0x16, 0x29, 0x0D,
+	0x06, 0x06, 0x1A, 0x01, 0x01, 0x28, 0x04, 0x07, 0x1A, 0x01, 0x04, 0x28,
+	0x01, 0x00, 0x1A, 0x13, 0x06, 0x03, 0x01, 0x08, 0x28, 0x00, 0x00, 0x14,
+	0x1B, 0x05, 0x10, 0x20, 0x06, 0x0D, 0x6E, 0x1F, 0x01, 0x15, 0x0D, 0x06,
+	0x05, 0x1A, 0x81, 0x14, 0x04, 0x01, 0x17, 0x00, 0x00, 0x81, 0x31, 0x01,
+	0x07, 0x11, 0x01, 0x01, 0x0E, 0x06, 0x02, 0x60, 0x1C, 0x00, 0x01, 0x03,
+	0x00, 0x1D, 0x13, 0x06, 0x05, 0x02, 0x00, 0x6F, 0x2D, 0x00, 0x81, 0x31,
+	0x1A, 0x04, 0x73, 0x00, 0x01, 0x14, 0x81, 0x34, 0x01, 0x01, 0x81, 0x40,
+	0x1D, 0x1B, 0x01, 0x00, 0x81, 0x2D, 0x01, 0x16, 0x81, 0x34, 0x81, 0x38,
+	0x1D, 0x00, 0x01, 0x81, 0x0C, 0x81, 0x0E, 0x08, 0x81, 0x0A, 0x08, 0x81,
+	0x0D, 0x08, 0x81, 0x0F, 0x08, 0x81, 0x0B, 0x08, 0x81, 0x09, 0x08, 0x03,
+	0x00, 0x01, 0x01, 0x81, 0x40, 0x01, 0x27, 0x75, 0x1F, 0x08, 0x78, 0x1F,
+	0x01, 0x01, 0x0B, 0x08, 0x02, 0x00, 0x06, 0x04, 0x4C, 0x02, 0x00, 0x08,
+	0x81, 0x3F, 0x7B, 0x1E, 0x81, 0x3E, 0x66, 0x01, 0x04, 0x12, 0x66, 0x01,
+	0x04, 0x08, 0x01, 0x1C, 0x23, 0x66, 0x01, 0x20, 0x81, 0x39, 0x74, 0x75,
+	0x1F, 0x81, 0x3B, 0x78, 0x1F, 0x1B, 0x01, 0x01, 0x0B, 0x81, 0x3E, 0x77,
+	0x34, 0x1B, 0x06, 0x11, 0x4B, 0x29, 0x1E, 0x1B, 0x81, 0x2C, 0x05, 0x02,
+	0x50, 0x1C, 0x81, 0x3E, 0x34, 0x4C, 0x34, 0x04, 0x6C, 0x4E, 0x01, 0x01,
+	0x81, 0x40, 0x01, 0x00, 0x81, 0x40, 0x02, 0x00, 0x06, 0x81, 0x4F, 0x02,
+	0x00, 0x81, 0x3E, 0x81, 0x0C, 0x06, 0x12, 0x01, 0x83, 0xFE, 0x01, 0x81,
+	0x3E, 0x71, 0x81, 0x0C, 0x01, 0x04, 0x09, 0x1B, 0x81, 0x3E, 0x4B, 0x81,
+	0x3B, 0x81, 0x0E, 0x06, 0x1C, 0x01, 0x00, 0x81, 0x3E, 0x72, 0x81, 0x0E,
+	0x01, 0x04, 0x09, 0x1B, 0x81, 0x3E, 0x01, 0x02, 0x09, 0x1B, 0x81, 0x3E,
+	0x01, 0x00, 0x81, 0x40, 0x01, 0x03, 0x09, 0x81, 0x3A, 0x81, 0x0A, 0x06,
+	0x0F, 0x01, 0x01, 0x81, 0x3E, 0x01, 0x01, 0x81, 0x3E, 0x6C, 0x1F, 0x01,
+	0x08, 0x09, 0x81, 0x40, 0x81, 0x0D, 0x06, 0x1F, 0x01, 0x0D, 0x81, 0x3E,
+	0x81, 0x0D, 0x01, 0x04, 0x09, 0x1B, 0x81, 0x3E, 0x01, 0x02, 0x09, 0x81,
+	0x3E, 0x31, 0x06, 0x04, 0x01, 0x03, 0x81, 0x3D, 0x33, 0x06, 0x04, 0x01,
+	0x01, 0x81, 0x3D, 0x81, 0x0F, 0x1B, 0x06, 0x3C, 0x01, 0x0A, 0x81, 0x3E,
+	0x01, 0x04, 0x09, 0x1B, 0x81, 0x3E, 0x4D, 0x81, 0x3E, 0x2F, 0x1B, 0x01,
+	0x82, 0x80, 0x80, 0x80, 0x00, 0x11, 0x06, 0x04, 0x01, 0x1D, 0x81, 0x3E,
+	0x01, 0xFD, 0xFF, 0xFF, 0xFF, 0x7F, 0x11, 0x01, 0x00, 0x1B, 0x01, 0x20,
+	0x0A, 0x06, 0x0E, 0x81, 0x07, 0x10, 0x01, 0x01, 0x11, 0x06, 0x03, 0x1B,
+	0x81, 0x3E, 0x4A, 0x04, 0x6C, 0x4E, 0x04, 0x01, 0x1A, 0x81, 0x0B, 0x06,
+	0x0D, 0x01, 0x0B, 0x81, 0x3E, 0x01, 0x02, 0x81, 0x3E, 0x01, 0x82, 0x00,
+	0x81, 0x3E, 0x81, 0x09, 0x06, 0x08, 0x01, 0x16, 0x81, 0x3E, 0x01, 0x00,
+	0x81, 0x3E, 0x00, 0x00, 0x01, 0x10, 0x81, 0x40, 0x65, 0x1E, 0x1B, 0x81,
+	0x30, 0x06, 0x10, 0x81, 0x12, 0x19, 0x1B, 0x4C, 0x81, 0x3F, 0x1B, 0x81,
+	0x3E, 0x6D, 0x34, 0x81, 0x39, 0x04, 0x12, 0x1B, 0x81, 0x2E, 0x34, 0x81,
+	0x12, 0x18, 0x1B, 0x4A, 0x81, 0x3F, 0x1B, 0x81, 0x40, 0x6D, 0x34, 0x81,
+	0x39, 0x00, 0x00, 0x81, 0x03, 0x01, 0x14, 0x81, 0x40, 0x01, 0x0C, 0x81,
+	0x3F, 0x6D, 0x01, 0x0C, 0x81, 0x39, 0x00, 0x00, 0x3F, 0x1B, 0x01, 0x00,
+	0x0D, 0x06, 0x02, 0x4E, 0x00, 0x81, 0x31, 0x1A, 0x04, 0x72, 0x00, 0x1B,
+	0x81, 0x3E, 0x81, 0x39, 0x00, 0x00, 0x1B, 0x81, 0x40, 0x81, 0x39, 0x00,
+	0x00, 0x01, 0x0B, 0x81, 0x40, 0x01, 0x03, 0x81, 0x3F, 0x01, 0x00, 0x81,
+	0x3F, 0x00, 0x01, 0x03, 0x00, 0x30, 0x1A, 0x1B, 0x01, 0x10, 0x11, 0x06,
+	0x08, 0x01, 0x04, 0x81, 0x40, 0x02, 0x00, 0x81, 0x40, 0x1B, 0x01, 0x08,
+	0x11, 0x06, 0x08, 0x01, 0x03, 0x81, 0x40, 0x02, 0x00, 0x81, 0x40, 0x1B,
+	0x01, 0x20, 0x11, 0x06, 0x08, 0x01, 0x05, 0x81, 0x40, 0x02, 0x00, 0x81,
+	0x40, 0x1B, 0x01, 0x80, 0x40, 0x11, 0x06, 0x08, 0x01, 0x06, 0x81, 0x40,
+	0x02, 0x00, 0x81, 0x40, 0x01, 0x04, 0x11, 0x06, 0x08, 0x01, 0x02, 0x81,
+	0x40, 0x02, 0x00, 0x81, 0x40, 0x00, 0x00, 0x1B, 0x01, 0x08, 0x3D, 0x81,
+	0x40, 0x81, 0x40, 0x00, 0x00, 0x1B, 0x01, 0x10, 0x3D, 0x81, 0x40, 0x81,
+	0x3E, 0x00, 0x00, 0x1B, 0x40, 0x06, 0x02, 0x1A, 0x00, 0x81, 0x31, 0x1A,
+	0x04, 0x75
 };
 
 static const uint16_t t0_caddr[] = {
@@ -685,73 +710,76 @@ static const uint16_t t0_caddr[] = {
 	245,
 	250,
 	255,
-	264,
-	277,
-	281,
-	306,
-	312,
-	332,
-	343,
-	380,
-	483,
-	487,
-	552,
-	567,
-	578,
-	596,
-	625,
-	635,
-	671,
-	741,
-	755,
-	761,
-	808,
-	828,
-	881,
-	950,
-	983,
-	995,
-	1320,
-	1477,
-	1502,
-	1513,
-	1528,
-	1539,
-	1545,
-	1568,
-	1628,
-	1636,
-	1649,
-	1668,
-	1675,
-	1687,
-	1722,
-	1734,
-	1741,
-	1757,
-	1761,
-	1899,
-	1912,
-	1921,
-	1928,
-	2032,
-	2054,
-	2068,
-	2085,
-	2108,
-	2397,
-	2444,
-	2460,
-	2475,
-	2482,
-	2489,
-	2503,
-	2579,
-	2589,
-	2599
+	260,
+	269,
+	282,
+	286,
+	314,
+	320,
+	340,
+	351,
+	388,
+	496,
+	500,
+	566,
+	577,
+	592,
+	603,
+	621,
+	650,
+	660,
+	696,
+	769,
+	783,
+	790,
+	837,
+	857,
+	910,
+	982,
+	1017,
+	1029,
+	1386,
+	1544,
+	1569,
+	1580,
+	1595,
+	1606,
+	1612,
+	1624,
+	1647,
+	1707,
+	1715,
+	1728,
+	1747,
+	1754,
+	1766,
+	1801,
+	1813,
+	1820,
+	1836,
+	1841,
+	2091,
+	2105,
+	2115,
+	2123,
+	2229,
+	2251,
+	2265,
+	2282,
+	2305,
+	2630,
+	2677,
+	2694,
+	2709,
+	2716,
+	2723,
+	2737,
+	2813,
+	2823,
+	2833
 };
 
-#define T0_INTERPRETED   64
+#define T0_INTERPRETED   70
 
 #define T0_ENTER(ip, rp, slot)   do { \
 		const unsigned char *t0_newip; \
@@ -772,7 +800,7 @@ name(void *ctx) \
 	T0_ENTER(t0ctx->ip, t0ctx->rp, slot); \
 }
 
-T0_DEFENTRY(br_ssl_hs_client_init_main, 136)
+T0_DEFENTRY(br_ssl_hs_client_init_main, 144)
 
 void
 br_ssl_hs_client_run(void *t0ctx)
@@ -1152,6 +1180,21 @@ br_ssl_hs_client_run(void *t0ctx)
 				}
 				break;
 			case 38: {
+				/* multihash-restrict */
+
+	int prf_id = T0_POPi();
+	unsigned keep;
+
+	if (ENG->session.version >= BR_TLS12) {
+		keep = 1U << prf_id;
+	} else {
+		keep = (1U << br_md5_ID) | (1U << br_sha1_ID);
+	}
+	br_multihash_restrict(&ENG->mhash, keep);
+
+				}
+				break;
+			case 39: {
 				/* not */
 
 	uint32_t a = T0_POP();
@@ -1159,7 +1202,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 39: {
+			case 40: {
 				/* or */
 
 	uint32_t b = T0_POP();
@@ -1168,12 +1211,12 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 40: {
+			case 41: {
 				/* over */
  T0_PUSH(T0_PEEK(1)); 
 				}
 				break;
-			case 41: {
+			case 42: {
 				/* read-chunk-native */
 
 	size_t clen = ENG->hlen_in;
@@ -1197,7 +1240,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 42: {
+			case 43: {
 				/* read8-native */
 
 	if (ENG->hlen_in > 0) {
@@ -1215,7 +1258,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 43: {
+			case 44: {
 				/* set16 */
 
 	size_t addr = (size_t)T0_POP();
@@ -1223,7 +1266,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 44: {
+			case 45: {
 				/* set8 */
 
 	size_t addr = (size_t)T0_POP();
@@ -1231,7 +1274,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 45: {
+			case 46: {
 				/* strlen */
 
 	void *str = (unsigned char *)ENG + (size_t)T0_POP();
@@ -1239,7 +1282,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 46: {
+			case 47: {
 				/* supported-curves */
 
 	uint32_t x = ENG->iec == NULL ? 0 : ENG->iec->supported_curves;
@@ -1247,7 +1290,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 47: {
+			case 48: {
 				/* supported-hash-functions */
 
 	int i;
@@ -1266,26 +1309,63 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 48: {
+			case 49: {
 				/* supports-ecdsa? */
 
 	T0_PUSHi(-(CTX->iecdsa != 0));
 
 				}
 				break;
-			case 49: {
+			case 50: {
+				/* supports-etm? */
+
+	T0_PUSHi(-(ENG->icbc_etm_in != 0 && ENG->icbc_etm_out != 0));
+
+				}
+				break;
+			case 51: {
 				/* supports-rsa-sign? */
 
 	T0_PUSHi(-(CTX->irsavrfy != 0));
 
 				}
 				break;
-			case 50: {
+			case 52: {
 				/* swap */
  T0_SWAP(); 
 				}
 				break;
-			case 51: {
+			case 53: {
+				/* switch-aesccm-in */
+
+	int is_client, prf_id;
+	unsigned cipher_key_len, tag_len;
+
+	tag_len = T0_POP();
+	cipher_key_len = T0_POP();
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_ccm_in(ENG, is_client, prf_id,
+		ENG->iaes_cbcenc, ENG->iaes_ctr, cipher_key_len, tag_len);
+
+				}
+				break;
+			case 54: {
+				/* switch-aesccm-out */
+
+	int is_client, prf_id;
+	unsigned cipher_key_len, tag_len;
+
+	tag_len = T0_POP();
+	cipher_key_len = T0_POP();
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_ccm_out(ENG, is_client, prf_id,
+		ENG->iaes_cbcenc, ENG->iaes_ctr, cipher_key_len, tag_len);
+
+				}
+				break;
+			case 55: {
 				/* switch-aesgcm-in */
 
 	int is_client, prf_id;
@@ -1299,7 +1379,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 52: {
+			case 56: {
 				/* switch-aesgcm-out */
 
 	int is_client, prf_id;
@@ -1313,7 +1393,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 53: {
+			case 57: {
 				/* switch-cbc-in */
 
 	int is_client, prf_id, mac_id, aes;
@@ -1329,7 +1409,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 54: {
+			case 58: {
 				/* switch-cbc-out */
 
 	int is_client, prf_id, mac_id, aes;
@@ -1345,7 +1425,29 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 55: {
+			case 59: {
+				/* switch-chapol-in */
+
+	int is_client, prf_id;
+
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_chapol_in(ENG, is_client, prf_id);
+
+				}
+				break;
+			case 60: {
+				/* switch-chapol-out */
+
+	int is_client, prf_id;
+
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_chapol_out(ENG, is_client, prf_id);
+
+				}
+				break;
+			case 61: {
 				/* u>> */
 
 	int c = (int)T0_POPi();
@@ -1354,7 +1456,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 56: {
+			case 62: {
 				/* verify-SKE-sig */
 
 	size_t sig_len = T0_POP();
@@ -1365,7 +1467,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 57: {
+			case 63: {
 				/* write-blob-chunk */
 
 	size_t clen = ENG->hlen_out;
@@ -1389,7 +1491,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 58: {
+			case 64: {
 				/* write8-native */
 
 	unsigned char x;
@@ -1408,7 +1510,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 59: {
+			case 65: {
 				/* x509-append */
 
 	const br_x509_class *xc;
@@ -1420,7 +1522,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 60: {
+			case 66: {
 				/* x509-end-cert */
 
 	const br_x509_class *xc;
@@ -1430,7 +1532,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 61: {
+			case 67: {
 				/* x509-end-chain */
 
 	const br_x509_class *xc;
@@ -1440,7 +1542,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 62: {
+			case 68: {
 				/* x509-start-cert */
 
 	const br_x509_class *xc;
@@ -1450,7 +1552,7 @@ br_ssl_hs_client_run(void *t0ctx)
 
 				}
 				break;
-			case 63: {
+			case 69: {
 				/* x509-start-chain */
 
 	const br_x509_class *xc;
@@ -140,21 +140,19 @@ do_rsa_decrypt(br_ssl_server_context *ctx, int prf_id,
  */
 static void
 ecdh_common(br_ssl_server_context *ctx, int prf_id,
-	unsigned char *cpoint, size_t cpoint_len, uint32_t ctl)
+	unsigned char *cpoint, size_t cpoint_len,
+	size_t xoff, size_t xlen, uint32_t ctl)
 {
 	unsigned char rpms[80];
-	size_t pms_len;
 
 	/*
-	 * The point length is supposed to be 1+2*Xlen, where Xlen is
-	 * the length (in bytes) of the X coordinate, i.e. the pre-master
-	 * secret. If the provided point is too large, then it is
-	 * obviously incorrect (i.e. everybody can see that it is
+	 * The X coordinate (at offset xoff, length xlen) is the
+	 * pre-master secret. If the provided point is too large, then it
+	 * is obviously incorrect (i.e. everybody can see that it is
 	 * incorrect), so leaking that fact is not a problem.
 	 */
-	pms_len = cpoint_len >> 1;
-	if (pms_len > sizeof rpms) {
-		pms_len = sizeof rpms;
+	if (xlen > sizeof rpms) {
+		xlen = sizeof rpms;
 		ctl = 0;
 	}
 
@@ -163,13 +161,13 @@ ecdh_common(br_ssl_server_context *ctx, int prf_id,
 	 * decryption failed. Note that we use a constant-time conditional
 	 * copy.
 	 */
-	br_hmac_drbg_generate(&ctx->eng.rng, rpms, pms_len);
-	br_ccopy(ctl ^ 1, cpoint + 1, rpms, pms_len);
+	br_hmac_drbg_generate(&ctx->eng.rng, rpms, xlen);
+	br_ccopy(ctl ^ 1, cpoint + xoff, rpms, xlen);
 
 	/*
 	 * Compute master secret.
 	 */
-	br_ssl_engine_compute_master(&ctx->eng, prf_id, cpoint + 1, pms_len);
+	br_ssl_engine_compute_master(&ctx->eng, prf_id, cpoint + xoff, xlen);
 
 	/*
 	 * Clear the pre-master secret from RAM: it is normally a buffer
@@ -192,7 +190,8 @@ do_ecdh(br_ssl_server_context *ctx, int prf_id,
 	 */
 	x = (*ctx->policy_vtable)->do_keyx(ctx->policy_vtable,
 		cpoint, cpoint_len);
-	ecdh_common(ctx, prf_id, cpoint, cpoint_len, x);
+	ecdh_common(ctx, prf_id, cpoint, cpoint_len,
+		1, cpoint_len >> 1, x);
 }
 
 /*
@@ -207,7 +206,7 @@ do_ecdhe_part1(br_ssl_server_context *ctx, int curve)
 {
 	int hash;
 	unsigned mask;
-	const unsigned char *order, *generator;
+	const unsigned char *order;
 	size_t olen, glen;
 	br_multihash_context mhc;
 	unsigned char head[4];
@@ -239,21 +238,22 @@ do_ecdhe_part1(br_ssl_server_context *ctx, int curve)
 	/*
 	 * Compute our ECDH point.
 	 */
-	generator = ctx->eng.iec->generator(curve, &glen);
-	memcpy(ctx->eng.ecdhe_point, generator, glen);
-	ctx->eng.ecdhe_point_len = glen;
-	if (!ctx->eng.iec->mul(ctx->eng.ecdhe_point, glen,
-		ctx->ecdhe_key, olen, curve))
-	{
+	glen = ctx->eng.iec->mulgen(ctx->eng.ecdhe_point,
+		ctx->ecdhe_key, olen, curve);
+	if (glen == 0) {
 		return -BR_ERR_INVALID_ALGORITHM;
 	}
+	ctx->eng.ecdhe_point_len = glen;
 
 	/*
 	 * Compute the signature.
 	 */
+	hash = ctx->sign_hash_id;
 	br_multihash_zero(&mhc);
 	br_multihash_copyimpl(&mhc, &ctx->eng.mhash);
 	br_multihash_init(&mhc);
+	br_multihash_restrict(&mhc, hash ? (1U << hash)
+		: ((1U << br_md5_ID) | (1U << br_sha1_ID)));
 	br_multihash_update(&mhc,
 		ctx->eng.client_random, sizeof ctx->eng.client_random);
 	br_multihash_update(&mhc,
@@ -265,7 +265,6 @@ do_ecdhe_part1(br_ssl_server_context *ctx, int curve)
 	br_multihash_update(&mhc, head, sizeof head);
 	br_multihash_update(&mhc,
 		ctx->eng.ecdhe_point, ctx->eng.ecdhe_point_len);
-	hash = ctx->sign_hash_id;
 	if (hash) {
 		hv_len = br_multihash_out(&mhc, hash, ctx->eng.pad);
 		if (hv_len == 0) {
@@ -295,6 +294,7 @@ do_ecdhe_part2(br_ssl_server_context *ctx, int prf_id,
 {
 	int curve;
 	uint32_t x;
+	size_t xoff, xlen;
 
 	curve = ctx->eng.ecdhe_curve;
 
@@ -303,7 +303,8 @@ do_ecdhe_part2(br_ssl_server_context *ctx, int prf_id,
 	 */
 	x = ctx->eng.iec->mul(cpoint, cpoint_len,
 		ctx->ecdhe_key, ctx->ecdhe_key_len, curve);
-	ecdh_common(ctx, prf_id, cpoint, cpoint_len, x);
+	xoff = ctx->eng.iec->xoff(curve, &xlen);
+	ecdh_common(ctx, prf_id, cpoint, cpoint_len, xoff, xlen, x);
 
 	/*
 	 * Clear the ECDHE private key. Forward Secrecy is achieved insofar
@@ -327,8 +328,11 @@ static const uint8_t t0_datablock[] = {
 	0x44, 0xC0, 0x28, 0x12, 0x55, 0xC0, 0x29, 0x31, 0x44, 0xC0, 0x2A, 0x32,
 	0x55, 0xC0, 0x2B, 0x23, 0x04, 0xC0, 0x2C, 0x24, 0x05, 0xC0, 0x2D, 0x43,
 	0x04, 0xC0, 0x2E, 0x44, 0x05, 0xC0, 0x2F, 0x13, 0x04, 0xC0, 0x30, 0x14,
-	0x05, 0xC0, 0x31, 0x33, 0x04, 0xC0, 0x32, 0x34, 0x05, 0xCC, 0xA8, 0x15,
-	0x04, 0xCC, 0xA9, 0x25, 0x04, 0x00, 0x00
+	0x05, 0xC0, 0x31, 0x33, 0x04, 0xC0, 0x32, 0x34, 0x05, 0xC0, 0x9C, 0x06,
+	0x04, 0xC0, 0x9D, 0x07, 0x04, 0xC0, 0xA0, 0x08, 0x04, 0xC0, 0xA1, 0x09,
+	0x04, 0xC0, 0xAC, 0x26, 0x04, 0xC0, 0xAD, 0x27, 0x04, 0xC0, 0xAE, 0x28,
+	0x04, 0xC0, 0xAF, 0x29, 0x04, 0xCC, 0xA8, 0x15, 0x04, 0xCC, 0xA9, 0x25,
+	0x04, 0x00, 0x00
 };
 
 static const uint8_t t0_codeblock[] = {
@@ -361,9 +365,10 @@ static const uint8_t t0_codeblock[] = {
 	0x01, T0_INT2(offsetof(br_ssl_server_context, curves)), 0x00, 0x00,
 	0x01, T0_INT2(offsetof(br_ssl_engine_context, ecdhe_point)), 0x00,
 	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, ecdhe_point_len)),
-	0x00, 0x00, 0x01, T0_INT2(offsetof(br_ssl_server_context, flags)),
-	0x00, 0x00, 0x01, T0_INT2(offsetof(br_ssl_server_context, hashes)),
-	0x00, 0x00, 0x5D, 0x01,
+	0x00, 0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, etm)), 0x00,
+	0x00, 0x01, T0_INT2(offsetof(br_ssl_server_context, flags)), 0x00,
+	0x00, 0x01, T0_INT2(offsetof(br_ssl_server_context, hashes)), 0x00,
+	0x00, 0x63, 0x01,
 	T0_INT2(BR_MAX_CIPHER_SUITES * sizeof(br_suite_translated)), 0x00,
 	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, log_max_frag_len)),
 	0x00, 0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, pad)), 0x00,
@@ -393,198 +398,218 @@ static const uint8_t t0_codeblock[] = {
 	T0_INT2(offsetof(br_ssl_engine_context, version_max)), 0x00, 0x00,
 	0x01, T0_INT2(offsetof(br_ssl_engine_context, version_min)), 0x00,
 	0x00, 0x01, T0_INT2(offsetof(br_ssl_engine_context, version_out)),
-	0x00, 0x00, 0x09, 0x22, 0x44, 0x06, 0x02, 0x50, 0x23, 0x00, 0x00, 0x01,
-	0x01, 0x00, 0x01, 0x03, 0x00, 0x7B, 0x22, 0x4A, 0x3B, 0x7F, 0x22, 0x05,
-	0x04, 0x4B, 0x01, 0x00, 0x00, 0x02, 0x00, 0x0E, 0x06, 0x02, 0x7F, 0x00,
-	0x4A, 0x04, 0x6B, 0x00, 0x06, 0x02, 0x50, 0x23, 0x00, 0x00, 0x22, 0x6C,
-	0x3B, 0x05, 0x03, 0x01, 0x0C, 0x08, 0x3B, 0x5A, 0x25, 0x81, 0x07, 0x19,
-	0x67, 0x01, 0x0C, 0x2A, 0x00, 0x00, 0x22, 0x1B, 0x01, 0x08, 0x0B, 0x3B,
-	0x48, 0x1B, 0x08, 0x00, 0x01, 0x03, 0x00, 0x01, 0x00, 0x59, 0x38, 0x24,
-	0x16, 0x2F, 0x06, 0x08, 0x02, 0x00, 0x81, 0x26, 0x03, 0x00, 0x04, 0x74,
-	0x01, 0x00, 0x81, 0x1E, 0x02, 0x00, 0x22, 0x16, 0x12, 0x06, 0x02, 0x54,
-	0x23, 0x81, 0x26, 0x04, 0x75, 0x00, 0x01, 0x00, 0x59, 0x38, 0x01, 0x16,
-	0x6A, 0x38, 0x2D, 0x81, 0x0B, 0x2C, 0x06, 0x02, 0x56, 0x23, 0x06, 0x0C,
-	0x81, 0x2C, 0x01, 0x00, 0x81, 0x29, 0x01, 0x00, 0x81, 0x0A, 0x04, 0x14,
-	0x81, 0x2C, 0x81, 0x2A, 0x81, 0x2E, 0x81, 0x2D, 0x24, 0x81, 0x0C, 0x01,
-	0x00, 0x81, 0x0A, 0x01, 0x00, 0x81, 0x29, 0x34, 0x01, 0x01, 0x59, 0x38,
-	0x01, 0x17, 0x6A, 0x38, 0x00, 0x00, 0x31, 0x31, 0x00, 0x01, 0x03, 0x00,
-	0x24, 0x16, 0x2F, 0x06, 0x05, 0x81, 0x25, 0x21, 0x04, 0x77, 0x01, 0x02,
-	0x02, 0x00, 0x81, 0x1D, 0x16, 0x2F, 0x06, 0x05, 0x81, 0x25, 0x21, 0x04,
-	0x77, 0x02, 0x00, 0x01, 0x84, 0x00, 0x08, 0x23, 0x00, 0x00, 0x63, 0x26,
-	0x3B, 0x11, 0x01, 0x01, 0x12, 0x2E, 0x00, 0x00, 0x01, 0x7F, 0x81, 0x01,
-	0x81, 0x25, 0x22, 0x01, 0x07, 0x12, 0x01, 0x00, 0x31, 0x0E, 0x06, 0x0A,
-	0x21, 0x01, 0x10, 0x12, 0x06, 0x02, 0x81, 0x1C, 0x04, 0x24, 0x01, 0x01,
-	0x31, 0x0E, 0x06, 0x1B, 0x21, 0x21, 0x6B, 0x27, 0x01, 0x01, 0x0D, 0x06,
-	0x06, 0x01, 0x00, 0x81, 0x01, 0x04, 0x0A, 0x24, 0x16, 0x2F, 0x06, 0x05,
-	0x81, 0x25, 0x21, 0x04, 0x77, 0x04, 0x03, 0x56, 0x23, 0x21, 0x04, 0x44,
-	0x01, 0x22, 0x03, 0x00, 0x09, 0x22, 0x44, 0x06, 0x02, 0x50, 0x23, 0x02,
-	0x00, 0x00, 0x00, 0x7C, 0x01, 0x0F, 0x12, 0x00, 0x00, 0x58, 0x27, 0x01,
-	0x00, 0x31, 0x0E, 0x06, 0x10, 0x21, 0x22, 0x01, 0x01, 0x0D, 0x06, 0x03,
-	0x21, 0x01, 0x02, 0x58, 0x38, 0x01, 0x00, 0x04, 0x15, 0x01, 0x01, 0x31,
-	0x0E, 0x06, 0x09, 0x21, 0x01, 0x00, 0x58, 0x38, 0x46, 0x00, 0x04, 0x06,
-	0x01, 0x82, 0x00, 0x08, 0x23, 0x21, 0x00, 0x00, 0x01, 0x00, 0x28, 0x06,
-	0x06, 0x33, 0x81, 0x08, 0x30, 0x04, 0x77, 0x22, 0x06, 0x04, 0x01, 0x01,
-	0x71, 0x38, 0x00, 0x00, 0x28, 0x06, 0x0B, 0x69, 0x27, 0x01, 0x14, 0x0D,
-	0x06, 0x02, 0x56, 0x23, 0x04, 0x12, 0x81, 0x25, 0x01, 0x07, 0x12, 0x22,
-	0x01, 0x02, 0x0D, 0x06, 0x06, 0x06, 0x02, 0x56, 0x23, 0x04, 0x6F, 0x21,
-	0x81, 0x1A, 0x01, 0x01, 0x0D, 0x2C, 0x30, 0x06, 0x02, 0x4C, 0x23, 0x22,
-	0x01, 0x01, 0x81, 0x20, 0x2F, 0x81, 0x0D, 0x00, 0x0A, 0x81, 0x12, 0x01,
-	0x01, 0x0E, 0x05, 0x02, 0x56, 0x23, 0x81, 0x17, 0x22, 0x03, 0x00, 0x5B,
-	0x36, 0x5C, 0x01, 0x20, 0x81, 0x0E, 0x81, 0x19, 0x22, 0x01, 0x20, 0x0F,
-	0x06, 0x02, 0x55, 0x23, 0x22, 0x70, 0x38, 0x6F, 0x3B, 0x81, 0x0E, 0x17,
-	0x03, 0x01, 0x81, 0x17, 0x81, 0x06, 0x01, 0x00, 0x03, 0x02, 0x01, 0x00,
-	0x03, 0x03, 0x65, 0x81, 0x02, 0x14, 0x31, 0x08, 0x03, 0x04, 0x03, 0x05,
-	0x22, 0x06, 0x80, 0x57, 0x81, 0x17, 0x22, 0x03, 0x06, 0x02, 0x01, 0x06,
-	0x0A, 0x22, 0x5A, 0x25, 0x0E, 0x06, 0x04, 0x01, 0x7F, 0x03, 0x03, 0x22,
-	0x01, 0x81, 0x7F, 0x0E, 0x06, 0x0A, 0x6B, 0x27, 0x06, 0x02, 0x51, 0x23,
-	0x01, 0x7F, 0x03, 0x02, 0x81, 0x1B, 0x22, 0x44, 0x06, 0x03, 0x21, 0x04,
-	0x27, 0x01, 0x00, 0x81, 0x04, 0x06, 0x0B, 0x01, 0x02, 0x0B, 0x5D, 0x08,
-	0x02, 0x06, 0x3B, 0x36, 0x04, 0x16, 0x21, 0x02, 0x05, 0x02, 0x04, 0x10,
-	0x06, 0x02, 0x4F, 0x23, 0x02, 0x06, 0x02, 0x05, 0x36, 0x02, 0x05, 0x01,
-	0x04, 0x08, 0x03, 0x05, 0x04, 0xFF, 0x25, 0x21, 0x01, 0x00, 0x03, 0x07,
-	0x81, 0x19, 0x81, 0x06, 0x22, 0x06, 0x0A, 0x81, 0x19, 0x05, 0x04, 0x01,
-	0x7F, 0x03, 0x07, 0x04, 0x73, 0x7D, 0x01, 0x00, 0x6D, 0x38, 0x01, 0x88,
-	0x04, 0x64, 0x36, 0x01, 0x84, 0x80, 0x80, 0x00, 0x60, 0x37, 0x22, 0x06,
-	0x80, 0x58, 0x81, 0x17, 0x81, 0x06, 0x22, 0x06, 0x80, 0x4F, 0x81, 0x17,
-	0x01, 0x00, 0x31, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x11, 0x04, 0x3F, 0x01,
-	0x01, 0x31, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x0F, 0x04, 0x34, 0x01, 0x83,
-	0xFE, 0x01, 0x31, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x10, 0x04, 0x27, 0x01,
-	0x0D, 0x31, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x15, 0x04, 0x1C, 0x01, 0x0A,
-	0x31, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x16, 0x04, 0x11, 0x01, 0x0B, 0x31,
-	0x0E, 0x06, 0x05, 0x21, 0x81, 0x14, 0x04, 0x06, 0x21, 0x81, 0x14, 0x01,
-	0x00, 0x21, 0x04, 0xFF, 0x2D, 0x7D, 0x7D, 0x02, 0x01, 0x02, 0x03, 0x12,
-	0x03, 0x01, 0x77, 0x25, 0x22, 0x02, 0x00, 0x0F, 0x06, 0x03, 0x21, 0x02,
-	0x00, 0x22, 0x01, 0x86, 0x00, 0x0A, 0x06, 0x02, 0x52, 0x23, 0x02, 0x00,
-	0x78, 0x25, 0x0A, 0x06, 0x05, 0x01, 0x80, 0x46, 0x81, 0x03, 0x02, 0x01,
-	0x06, 0x10, 0x75, 0x25, 0x02, 0x00, 0x0C, 0x06, 0x05, 0x21, 0x75, 0x25,
-	0x04, 0x04, 0x01, 0x00, 0x03, 0x01, 0x22, 0x75, 0x36, 0x22, 0x76, 0x36,
-	0x22, 0x79, 0x36, 0x01, 0x86, 0x03, 0x10, 0x03, 0x08, 0x02, 0x02, 0x06,
-	0x04, 0x01, 0x02, 0x6B, 0x38, 0x02, 0x07, 0x05, 0x04, 0x01, 0x28, 0x81,
-	0x03, 0x3A, 0x21, 0x01, 0x82, 0x01, 0x07, 0x64, 0x25, 0x12, 0x22, 0x64,
-	0x36, 0x45, 0x03, 0x09, 0x60, 0x26, 0x39, 0x12, 0x22, 0x60, 0x37, 0x05,
-	0x04, 0x01, 0x00, 0x03, 0x09, 0x02, 0x01, 0x06, 0x03, 0x01, 0x7F, 0x00,
-	0x6F, 0x01, 0x20, 0x2B, 0x5D, 0x22, 0x03, 0x05, 0x22, 0x02, 0x04, 0x0A,
-	0x06, 0x80, 0x47, 0x22, 0x25, 0x22, 0x7C, 0x02, 0x09, 0x05, 0x13, 0x22,
-	0x01, 0x0C, 0x11, 0x22, 0x01, 0x01, 0x0E, 0x3B, 0x01, 0x02, 0x0E, 0x30,
-	0x06, 0x04, 0x4B, 0x01, 0x00, 0x22, 0x02, 0x08, 0x05, 0x0E, 0x22, 0x01,
-	0x81, 0x70, 0x12, 0x01, 0x20, 0x0D, 0x06, 0x04, 0x4B, 0x01, 0x00, 0x22,
-	0x22, 0x06, 0x10, 0x02, 0x05, 0x4A, 0x36, 0x02, 0x05, 0x36, 0x02, 0x05,
-	0x01, 0x04, 0x08, 0x03, 0x05, 0x04, 0x01, 0x4B, 0x01, 0x04, 0x08, 0x04,
-	0xFF, 0x32, 0x21, 0x02, 0x05, 0x5D, 0x09, 0x01, 0x02, 0x11, 0x22, 0x05,
-	0x04, 0x01, 0x28, 0x81, 0x03, 0x5E, 0x38, 0x15, 0x05, 0x04, 0x01, 0x28,
-	0x81, 0x03, 0x01, 0x00, 0x00, 0x04, 0x81, 0x12, 0x01, 0x10, 0x0E, 0x05,
-	0x02, 0x56, 0x23, 0x5A, 0x25, 0x81, 0x24, 0x06, 0x19, 0x81, 0x17, 0x22,
-	0x01, 0x84, 0x00, 0x0F, 0x06, 0x02, 0x53, 0x23, 0x22, 0x03, 0x00, 0x67,
-	0x3B, 0x81, 0x0E, 0x02, 0x00, 0x5A, 0x25, 0x81, 0x07, 0x20, 0x5A, 0x25,
-	0x22, 0x81, 0x22, 0x3B, 0x81, 0x21, 0x03, 0x01, 0x03, 0x02, 0x02, 0x01,
-	0x02, 0x02, 0x30, 0x06, 0x17, 0x81, 0x19, 0x22, 0x03, 0x03, 0x67, 0x3B,
-	0x81, 0x0E, 0x02, 0x03, 0x5A, 0x25, 0x81, 0x07, 0x02, 0x02, 0x06, 0x03,
-	0x1F, 0x04, 0x01, 0x1D, 0x7D, 0x00, 0x00, 0x7E, 0x81, 0x12, 0x01, 0x14,
-	0x0D, 0x06, 0x02, 0x56, 0x23, 0x67, 0x01, 0x0C, 0x08, 0x01, 0x0C, 0x81,
-	0x0E, 0x7D, 0x67, 0x22, 0x01, 0x0C, 0x08, 0x01, 0x0C, 0x29, 0x05, 0x02,
-	0x4D, 0x23, 0x00, 0x02, 0x03, 0x00, 0x03, 0x01, 0x02, 0x00, 0x7A, 0x02,
-	0x01, 0x02, 0x00, 0x32, 0x22, 0x01, 0x00, 0x0E, 0x06, 0x02, 0x4B, 0x00,
-	0x81, 0x27, 0x04, 0x73, 0x00, 0x81, 0x17, 0x01, 0x01, 0x0D, 0x06, 0x02,
-	0x4E, 0x23, 0x81, 0x19, 0x22, 0x22, 0x46, 0x3B, 0x01, 0x05, 0x10, 0x30,
-	0x06, 0x02, 0x4E, 0x23, 0x01, 0x08, 0x08, 0x22, 0x66, 0x27, 0x0A, 0x06,
-	0x0D, 0x22, 0x01, 0x01, 0x3B, 0x0B, 0x35, 0x22, 0x66, 0x38, 0x68, 0x38,
-	0x04, 0x01, 0x21, 0x00, 0x00, 0x81, 0x17, 0x6B, 0x27, 0x01, 0x00, 0x31,
-	0x0E, 0x06, 0x14, 0x21, 0x01, 0x01, 0x0E, 0x05, 0x02, 0x51, 0x23, 0x81,
-	0x19, 0x06, 0x02, 0x51, 0x23, 0x01, 0x02, 0x6B, 0x38, 0x04, 0x2A, 0x01,
-	0x02, 0x31, 0x0E, 0x06, 0x21, 0x21, 0x01, 0x0D, 0x0E, 0x05, 0x02, 0x51,
-	0x23, 0x81, 0x19, 0x01, 0x0C, 0x0E, 0x05, 0x02, 0x51, 0x23, 0x67, 0x01,
-	0x0C, 0x81, 0x0E, 0x6C, 0x67, 0x01, 0x0C, 0x29, 0x05, 0x02, 0x51, 0x23,
-	0x04, 0x03, 0x51, 0x23, 0x21, 0x00, 0x00, 0x81, 0x17, 0x81, 0x06, 0x81,
-	0x17, 0x81, 0x06, 0x22, 0x06, 0x22, 0x81, 0x19, 0x06, 0x04, 0x81, 0x14,
-	0x04, 0x18, 0x81, 0x17, 0x22, 0x01, 0x81, 0x7F, 0x0C, 0x06, 0x0D, 0x22,
-	0x6D, 0x08, 0x01, 0x00, 0x3B, 0x38, 0x6D, 0x3B, 0x81, 0x0E, 0x04, 0x02,
-	0x81, 0x1F, 0x04, 0x5B, 0x7D, 0x7D, 0x00, 0x00, 0x81, 0x13, 0x22, 0x46,
-	0x06, 0x07, 0x21, 0x06, 0x02, 0x4F, 0x23, 0x04, 0x73, 0x00, 0x00, 0x81,
-	0x1A, 0x01, 0x03, 0x81, 0x18, 0x3B, 0x21, 0x3B, 0x00, 0x00, 0x81, 0x17,
-	0x81, 0x1F, 0x00, 0x02, 0x81, 0x17, 0x81, 0x06, 0x01, 0x00, 0x64, 0x36,
-	0x81, 0x17, 0x81, 0x06, 0x22, 0x06, 0x34, 0x81, 0x19, 0x03, 0x00, 0x81,
-	0x19, 0x03, 0x01, 0x02, 0x00, 0x01, 0x02, 0x10, 0x02, 0x00, 0x01, 0x06,
-	0x0C, 0x12, 0x02, 0x01, 0x01, 0x01, 0x0E, 0x02, 0x01, 0x01, 0x03, 0x0E,
-	0x30, 0x12, 0x06, 0x11, 0x64, 0x25, 0x01, 0x01, 0x02, 0x01, 0x49, 0x01,
-	0x02, 0x0B, 0x02, 0x00, 0x08, 0x0B, 0x30, 0x64, 0x36, 0x04, 0x49, 0x7D,
-	0x7D, 0x00, 0x00, 0x81, 0x17, 0x81, 0x06, 0x81, 0x17, 0x81, 0x06, 0x01,
-	0x00, 0x60, 0x37, 0x22, 0x06, 0x16, 0x81, 0x17, 0x22, 0x01, 0x20, 0x0A,
-	0x06, 0x0B, 0x01, 0x01, 0x3B, 0x0B, 0x60, 0x26, 0x30, 0x60, 0x37, 0x04,
-	0x01, 0x21, 0x04, 0x67, 0x7D, 0x7D, 0x00, 0x00, 0x01, 0x02, 0x7A, 0x81,
-	0x1A, 0x01, 0x08, 0x0B, 0x81, 0x1A, 0x08, 0x00, 0x00, 0x01, 0x03, 0x7A,
-	0x81, 0x1A, 0x01, 0x08, 0x0B, 0x81, 0x1A, 0x08, 0x01, 0x08, 0x0B, 0x81,
-	0x1A, 0x08, 0x00, 0x00, 0x01, 0x01, 0x7A, 0x81, 0x1A, 0x00, 0x00, 0x33,
-	0x22, 0x44, 0x05, 0x01, 0x00, 0x21, 0x81, 0x27, 0x04, 0x75, 0x02, 0x03,
-	0x00, 0x74, 0x27, 0x03, 0x01, 0x01, 0x00, 0x22, 0x02, 0x01, 0x0A, 0x06,
-	0x10, 0x22, 0x01, 0x01, 0x0B, 0x73, 0x08, 0x25, 0x02, 0x00, 0x0E, 0x06,
-	0x01, 0x00, 0x48, 0x04, 0x6A, 0x21, 0x01, 0x7F, 0x00, 0x00, 0x24, 0x16,
-	0x2F, 0x06, 0x05, 0x81, 0x25, 0x21, 0x04, 0x77, 0x01, 0x16, 0x6A, 0x38,
-	0x01, 0x00, 0x81, 0x33, 0x01, 0x00, 0x81, 0x32, 0x24, 0x01, 0x17, 0x6A,
-	0x38, 0x00, 0x00, 0x01, 0x15, 0x6A, 0x38, 0x3B, 0x43, 0x21, 0x43, 0x21,
-	0x24, 0x00, 0x00, 0x01, 0x01, 0x3B, 0x81, 0x1D, 0x00, 0x00, 0x3B, 0x31,
-	0x7A, 0x3B, 0x22, 0x06, 0x06, 0x81, 0x1A, 0x21, 0x49, 0x04, 0x77, 0x21,
-	0x00, 0x02, 0x03, 0x00, 0x5A, 0x25, 0x7C, 0x03, 0x01, 0x02, 0x01, 0x01,
+	0x00, 0x00, 0x09, 0x22, 0x4A, 0x06, 0x02, 0x56, 0x23, 0x00, 0x00, 0x01,
+	0x01, 0x00, 0x01, 0x03, 0x00, 0x81, 0x02, 0x22, 0x50, 0x3D, 0x81, 0x06,
+	0x22, 0x05, 0x04, 0x51, 0x01, 0x00, 0x00, 0x02, 0x00, 0x0E, 0x06, 0x03,
+	0x81, 0x06, 0x00, 0x50, 0x04, 0x69, 0x00, 0x06, 0x02, 0x56, 0x23, 0x00,
+	0x00, 0x22, 0x73, 0x3D, 0x05, 0x03, 0x01, 0x0C, 0x08, 0x3D, 0x60, 0x25,
+	0x81, 0x0E, 0x19, 0x6E, 0x01, 0x0C, 0x2A, 0x00, 0x00, 0x22, 0x1B, 0x01,
+	0x08, 0x0B, 0x3D, 0x4E, 0x1B, 0x08, 0x00, 0x01, 0x03, 0x00, 0x01, 0x00,
+	0x5F, 0x39, 0x24, 0x16, 0x30, 0x06, 0x08, 0x02, 0x00, 0x81, 0x2F, 0x03,
+	0x00, 0x04, 0x74, 0x01, 0x00, 0x81, 0x26, 0x02, 0x00, 0x22, 0x16, 0x12,
+	0x06, 0x02, 0x5A, 0x23, 0x81, 0x2F, 0x04, 0x75, 0x00, 0x01, 0x00, 0x5F,
+	0x39, 0x01, 0x16, 0x71, 0x39, 0x2D, 0x81, 0x12, 0x2C, 0x06, 0x02, 0x5C,
+	0x23, 0x60, 0x25, 0x81, 0x0E, 0x2E, 0x06, 0x0C, 0x81, 0x35, 0x01, 0x00,
+	0x81, 0x32, 0x01, 0x00, 0x81, 0x11, 0x04, 0x14, 0x81, 0x35, 0x81, 0x33,
+	0x81, 0x37, 0x81, 0x36, 0x24, 0x81, 0x13, 0x01, 0x00, 0x81, 0x11, 0x01,
+	0x00, 0x81, 0x32, 0x35, 0x01, 0x01, 0x5F, 0x39, 0x01, 0x17, 0x71, 0x39,
+	0x00, 0x00, 0x32, 0x32, 0x00, 0x01, 0x03, 0x00, 0x24, 0x16, 0x30, 0x06,
+	0x05, 0x81, 0x2E, 0x21, 0x04, 0x77, 0x01, 0x02, 0x02, 0x00, 0x81, 0x25,
+	0x16, 0x30, 0x06, 0x05, 0x81, 0x2E, 0x21, 0x04, 0x77, 0x02, 0x00, 0x01,
+	0x84, 0x00, 0x08, 0x23, 0x00, 0x00, 0x6A, 0x26, 0x3D, 0x11, 0x01, 0x01,
+	0x12, 0x2F, 0x00, 0x00, 0x01, 0x7F, 0x81, 0x08, 0x81, 0x2E, 0x22, 0x01,
+	0x07, 0x12, 0x01, 0x00, 0x32, 0x0E, 0x06, 0x0A, 0x21, 0x01, 0x10, 0x12,
+	0x06, 0x02, 0x81, 0x24, 0x04, 0x24, 0x01, 0x01, 0x32, 0x0E, 0x06, 0x1B,
+	0x21, 0x21, 0x72, 0x27, 0x01, 0x01, 0x0D, 0x06, 0x06, 0x01, 0x00, 0x81,
+	0x08, 0x04, 0x0A, 0x24, 0x16, 0x30, 0x06, 0x05, 0x81, 0x2E, 0x21, 0x04,
+	0x77, 0x04, 0x03, 0x5C, 0x23, 0x21, 0x04, 0x44, 0x01, 0x22, 0x03, 0x00,
+	0x09, 0x22, 0x4A, 0x06, 0x02, 0x56, 0x23, 0x02, 0x00, 0x00, 0x00, 0x81,
+	0x03, 0x01, 0x0F, 0x12, 0x00, 0x00, 0x5E, 0x27, 0x01, 0x00, 0x32, 0x0E,
+	0x06, 0x10, 0x21, 0x22, 0x01, 0x01, 0x0D, 0x06, 0x03, 0x21, 0x01, 0x02,
+	0x5E, 0x39, 0x01, 0x00, 0x04, 0x15, 0x01, 0x01, 0x32, 0x0E, 0x06, 0x09,
+	0x21, 0x01, 0x00, 0x5E, 0x39, 0x4C, 0x00, 0x04, 0x06, 0x01, 0x82, 0x00,
+	0x08, 0x23, 0x21, 0x00, 0x00, 0x01, 0x00, 0x28, 0x06, 0x06, 0x34, 0x81,
+	0x0F, 0x31, 0x04, 0x77, 0x22, 0x06, 0x04, 0x01, 0x01, 0x78, 0x39, 0x00,
+	0x00, 0x28, 0x06, 0x0B, 0x70, 0x27, 0x01, 0x14, 0x0D, 0x06, 0x02, 0x5C,
+	0x23, 0x04, 0x12, 0x81, 0x2E, 0x01, 0x07, 0x12, 0x22, 0x01, 0x02, 0x0D,
+	0x06, 0x06, 0x06, 0x02, 0x5C, 0x23, 0x04, 0x6F, 0x21, 0x81, 0x22, 0x01,
+	0x01, 0x0D, 0x2C, 0x31, 0x06, 0x02, 0x52, 0x23, 0x22, 0x01, 0x01, 0x81,
+	0x28, 0x30, 0x81, 0x14, 0x00, 0x0A, 0x81, 0x1A, 0x01, 0x01, 0x0E, 0x05,
+	0x02, 0x5C, 0x23, 0x81, 0x1F, 0x22, 0x03, 0x00, 0x61, 0x37, 0x62, 0x01,
+	0x20, 0x81, 0x15, 0x81, 0x21, 0x22, 0x01, 0x20, 0x0F, 0x06, 0x02, 0x5B,
+	0x23, 0x22, 0x77, 0x39, 0x76, 0x3D, 0x81, 0x15, 0x17, 0x03, 0x01, 0x81,
+	0x1F, 0x81, 0x0D, 0x01, 0x00, 0x03, 0x02, 0x01, 0x00, 0x03, 0x03, 0x6C,
+	0x81, 0x09, 0x14, 0x32, 0x08, 0x03, 0x04, 0x03, 0x05, 0x22, 0x06, 0x80,
+	0x57, 0x81, 0x1F, 0x22, 0x03, 0x06, 0x02, 0x01, 0x06, 0x0A, 0x22, 0x60,
+	0x25, 0x0E, 0x06, 0x04, 0x01, 0x7F, 0x03, 0x03, 0x22, 0x01, 0x81, 0x7F,
+	0x0E, 0x06, 0x0A, 0x72, 0x27, 0x06, 0x02, 0x57, 0x23, 0x01, 0x7F, 0x03,
+	0x02, 0x81, 0x23, 0x22, 0x4A, 0x06, 0x03, 0x21, 0x04, 0x27, 0x01, 0x00,
+	0x81, 0x0B, 0x06, 0x0B, 0x01, 0x02, 0x0B, 0x63, 0x08, 0x02, 0x06, 0x3D,
+	0x37, 0x04, 0x16, 0x21, 0x02, 0x05, 0x02, 0x04, 0x10, 0x06, 0x02, 0x55,
+	0x23, 0x02, 0x06, 0x02, 0x05, 0x37, 0x02, 0x05, 0x01, 0x04, 0x08, 0x03,
+	0x05, 0x04, 0xFF, 0x25, 0x21, 0x01, 0x00, 0x03, 0x07, 0x81, 0x21, 0x81,
+	0x0D, 0x22, 0x06, 0x0A, 0x81, 0x21, 0x05, 0x04, 0x01, 0x7F, 0x03, 0x07,
+	0x04, 0x73, 0x81, 0x04, 0x01, 0x00, 0x74, 0x39, 0x01, 0x88, 0x04, 0x6B,
+	0x37, 0x01, 0x84, 0x80, 0x80, 0x00, 0x66, 0x38, 0x01, 0x00, 0x69, 0x39,
+	0x22, 0x06, 0x80, 0x65, 0x81, 0x1F, 0x81, 0x0D, 0x22, 0x06, 0x80, 0x5B,
+	0x81, 0x1F, 0x01, 0x00, 0x32, 0x0E, 0x06, 0x06, 0x21, 0x81, 0x19, 0x04,
+	0x80, 0x4A, 0x01, 0x01, 0x32, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x17, 0x04,
+	0x3F, 0x01, 0x83, 0xFE, 0x01, 0x32, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x18,
+	0x04, 0x32, 0x01, 0x0D, 0x32, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x1D, 0x04,
+	0x27, 0x01, 0x0A, 0x32, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x1E, 0x04, 0x1C,
+	0x01, 0x0B, 0x32, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x1C, 0x04, 0x11, 0x01,
+	0x16, 0x32, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x16, 0x04, 0x06, 0x21, 0x81,
+	0x1C, 0x01, 0x00, 0x21, 0x04, 0xFF, 0x21, 0x81, 0x04, 0x81, 0x04, 0x02,
+	0x01, 0x02, 0x03, 0x12, 0x03, 0x01, 0x7E, 0x25, 0x22, 0x02, 0x00, 0x0F,
+	0x06, 0x03, 0x21, 0x02, 0x00, 0x22, 0x01, 0x86, 0x00, 0x0A, 0x06, 0x02,
+	0x58, 0x23, 0x02, 0x00, 0x7F, 0x25, 0x0A, 0x06, 0x05, 0x01, 0x80, 0x46,
+	0x81, 0x0A, 0x02, 0x01, 0x06, 0x10, 0x7C, 0x25, 0x02, 0x00, 0x0C, 0x06,
+	0x05, 0x21, 0x7C, 0x25, 0x04, 0x04, 0x01, 0x00, 0x03, 0x01, 0x22, 0x7C,
+	0x37, 0x22, 0x7D, 0x37, 0x22, 0x81, 0x00, 0x37, 0x01, 0x86, 0x03, 0x10,
+	0x03, 0x08, 0x02, 0x02, 0x06, 0x04, 0x01, 0x02, 0x72, 0x39, 0x02, 0x07,
+	0x05, 0x04, 0x01, 0x28, 0x81, 0x0A, 0x3B, 0x21, 0x01, 0x82, 0x01, 0x07,
+	0x6B, 0x25, 0x12, 0x22, 0x6B, 0x37, 0x4B, 0x03, 0x09, 0x66, 0x26, 0x3A,
+	0x12, 0x22, 0x66, 0x38, 0x05, 0x04, 0x01, 0x00, 0x03, 0x09, 0x02, 0x01,
+	0x06, 0x03, 0x01, 0x7F, 0x00, 0x76, 0x01, 0x20, 0x2B, 0x63, 0x22, 0x03,
+	0x05, 0x22, 0x02, 0x04, 0x0A, 0x06, 0x80, 0x48, 0x22, 0x25, 0x22, 0x81,
+	0x03, 0x02, 0x09, 0x05, 0x13, 0x22, 0x01, 0x0C, 0x11, 0x22, 0x01, 0x01,
+	0x0E, 0x3D, 0x01, 0x02, 0x0E, 0x31, 0x06, 0x04, 0x51, 0x01, 0x00, 0x22,
+	0x02, 0x08, 0x05, 0x0E, 0x22, 0x01, 0x81, 0x70, 0x12, 0x01, 0x20, 0x0D,
+	0x06, 0x04, 0x51, 0x01, 0x00, 0x22, 0x22, 0x06, 0x10, 0x02, 0x05, 0x50,
+	0x37, 0x02, 0x05, 0x37, 0x02, 0x05, 0x01, 0x04, 0x08, 0x03, 0x05, 0x04,
+	0x01, 0x51, 0x01, 0x04, 0x08, 0x04, 0xFF, 0x31, 0x21, 0x02, 0x05, 0x63,
+	0x09, 0x01, 0x02, 0x11, 0x22, 0x05, 0x04, 0x01, 0x28, 0x81, 0x0A, 0x64,
+	0x39, 0x15, 0x05, 0x04, 0x01, 0x28, 0x81, 0x0A, 0x01, 0x00, 0x00, 0x04,
+	0x81, 0x1A, 0x01, 0x10, 0x0E, 0x05, 0x02, 0x5C, 0x23, 0x60, 0x25, 0x81,
+	0x2D, 0x06, 0x19, 0x81, 0x1F, 0x22, 0x01, 0x84, 0x00, 0x0F, 0x06, 0x02,
+	0x59, 0x23, 0x22, 0x03, 0x00, 0x6E, 0x3D, 0x81, 0x15, 0x02, 0x00, 0x60,
+	0x25, 0x81, 0x0E, 0x20, 0x60, 0x25, 0x22, 0x81, 0x2B, 0x3D, 0x81, 0x2A,
+	0x03, 0x01, 0x03, 0x02, 0x02, 0x01, 0x02, 0x02, 0x31, 0x06, 0x17, 0x81,
+	0x21, 0x22, 0x03, 0x03, 0x6E, 0x3D, 0x81, 0x15, 0x02, 0x03, 0x60, 0x25,
+	0x81, 0x0E, 0x02, 0x02, 0x06, 0x03, 0x1F, 0x04, 0x01, 0x1D, 0x81, 0x04,
+	0x00, 0x00, 0x81, 0x05, 0x81, 0x1A, 0x01, 0x14, 0x0D, 0x06, 0x02, 0x5C,
+	0x23, 0x6E, 0x01, 0x0C, 0x08, 0x01, 0x0C, 0x81, 0x15, 0x81, 0x04, 0x6E,
+	0x22, 0x01, 0x0C, 0x08, 0x01, 0x0C, 0x29, 0x05, 0x02, 0x53, 0x23, 0x00,
+	0x02, 0x03, 0x00, 0x03, 0x01, 0x02, 0x00, 0x81, 0x01, 0x02, 0x01, 0x02,
+	0x00, 0x33, 0x22, 0x01, 0x00, 0x0E, 0x06, 0x02, 0x51, 0x00, 0x81, 0x30,
+	0x04, 0x73, 0x00, 0x81, 0x1F, 0x06, 0x02, 0x55, 0x23, 0x3C, 0x06, 0x04,
+	0x01, 0x01, 0x69, 0x39, 0x00, 0x00, 0x81, 0x1F, 0x01, 0x01, 0x0D, 0x06,
+	0x02, 0x54, 0x23, 0x81, 0x21, 0x22, 0x22, 0x4C, 0x3D, 0x01, 0x05, 0x10,
+	0x31, 0x06, 0x02, 0x54, 0x23, 0x01, 0x08, 0x08, 0x22, 0x6D, 0x27, 0x0A,
+	0x06, 0x0D, 0x22, 0x01, 0x01, 0x3D, 0x0B, 0x36, 0x22, 0x6D, 0x39, 0x6F,
+	0x39, 0x04, 0x01, 0x21, 0x00, 0x00, 0x81, 0x1F, 0x72, 0x27, 0x01, 0x00,
+	0x32, 0x0E, 0x06, 0x14, 0x21, 0x01, 0x01, 0x0E, 0x05, 0x02, 0x57, 0x23,
+	0x81, 0x21, 0x06, 0x02, 0x57, 0x23, 0x01, 0x02, 0x72, 0x39, 0x04, 0x2A,
+	0x01, 0x02, 0x32, 0x0E, 0x06, 0x21, 0x21, 0x01, 0x0D, 0x0E, 0x05, 0x02,
+	0x57, 0x23, 0x81, 0x21, 0x01, 0x0C, 0x0E, 0x05, 0x02, 0x57, 0x23, 0x6E,
+	0x01, 0x0C, 0x81, 0x15, 0x73, 0x6E, 0x01, 0x0C, 0x29, 0x05, 0x02, 0x57,
+	0x23, 0x04, 0x03, 0x57, 0x23, 0x21, 0x00, 0x00, 0x81, 0x1F, 0x81, 0x0D,
+	0x81, 0x1F, 0x81, 0x0D, 0x22, 0x06, 0x22, 0x81, 0x21, 0x06, 0x04, 0x81,
+	0x1C, 0x04, 0x18, 0x81, 0x1F, 0x22, 0x01, 0x81, 0x7F, 0x0C, 0x06, 0x0D,
+	0x22, 0x74, 0x08, 0x01, 0x00, 0x3D, 0x39, 0x74, 0x3D, 0x81, 0x15, 0x04,
+	0x02, 0x81, 0x27, 0x04, 0x5B, 0x81, 0x04, 0x81, 0x04, 0x00, 0x00, 0x81,
+	0x1B, 0x22, 0x4C, 0x06, 0x07, 0x21, 0x06, 0x02, 0x55, 0x23, 0x04, 0x73,
+	0x00, 0x00, 0x81, 0x22, 0x01, 0x03, 0x81, 0x20, 0x3D, 0x21, 0x3D, 0x00,
+	0x00, 0x81, 0x1F, 0x81, 0x27, 0x00, 0x02, 0x81, 0x1F, 0x81, 0x0D, 0x01,
+	0x00, 0x6B, 0x37, 0x81, 0x1F, 0x81, 0x0D, 0x22, 0x06, 0x34, 0x81, 0x21,
+	0x03, 0x00, 0x81, 0x21, 0x03, 0x01, 0x02, 0x00, 0x01, 0x02, 0x10, 0x02,
+	0x00, 0x01, 0x06, 0x0C, 0x12, 0x02, 0x01, 0x01, 0x01, 0x0E, 0x02, 0x01,
+	0x01, 0x03, 0x0E, 0x31, 0x12, 0x06, 0x11, 0x6B, 0x25, 0x01, 0x01, 0x02,
+	0x01, 0x4F, 0x01, 0x02, 0x0B, 0x02, 0x00, 0x08, 0x0B, 0x31, 0x6B, 0x37,
+	0x04, 0x49, 0x81, 0x04, 0x81, 0x04, 0x00, 0x00, 0x81, 0x1F, 0x81, 0x0D,
+	0x81, 0x1F, 0x81, 0x0D, 0x01, 0x00, 0x66, 0x38, 0x22, 0x06, 0x16, 0x81,
+	0x1F, 0x22, 0x01, 0x20, 0x0A, 0x06, 0x0B, 0x01, 0x01, 0x3D, 0x0B, 0x66,
+	0x26, 0x31, 0x66, 0x38, 0x04, 0x01, 0x21, 0x04, 0x67, 0x81, 0x04, 0x81,
+	0x04, 0x00, 0x00, 0x01, 0x02, 0x81, 0x01, 0x81, 0x22, 0x01, 0x08, 0x0B,
+	0x81, 0x22, 0x08, 0x00, 0x00, 0x01, 0x03, 0x81, 0x01, 0x81, 0x22, 0x01,
+	0x08, 0x0B, 0x81, 0x22, 0x08, 0x01, 0x08, 0x0B, 0x81, 0x22, 0x08, 0x00,
+	0x00, 0x01, 0x01, 0x81, 0x01, 0x81, 0x22, 0x00, 0x00, 0x34, 0x22, 0x4A,
+	0x05, 0x01, 0x00, 0x21, 0x81, 0x30, 0x04, 0x75, 0x02, 0x03, 0x00, 0x7B,
+	0x27, 0x03, 0x01, 0x01, 0x00, 0x22, 0x02, 0x01, 0x0A, 0x06, 0x10, 0x22,
+	0x01, 0x01, 0x0B, 0x7A, 0x08, 0x25, 0x02, 0x00, 0x0E, 0x06, 0x01, 0x00,
+	0x4E, 0x04, 0x6A, 0x21, 0x01, 0x7F, 0x00, 0x00, 0x24, 0x16, 0x30, 0x06,
+	0x05, 0x81, 0x2E, 0x21, 0x04, 0x77, 0x01, 0x16, 0x71, 0x39, 0x01, 0x00,
+	0x81, 0x3C, 0x01, 0x00, 0x81, 0x3B, 0x24, 0x01, 0x17, 0x71, 0x39, 0x00,
+	0x00, 0x01, 0x15, 0x71, 0x39, 0x3D, 0x49, 0x21, 0x49, 0x21, 0x24, 0x00,
+	0x00, 0x01, 0x01, 0x3D, 0x81, 0x25, 0x00, 0x00, 0x3D, 0x32, 0x81, 0x01,
+	0x3D, 0x22, 0x06, 0x06, 0x81, 0x22, 0x21, 0x4F, 0x04, 0x77, 0x21, 0x00,
+	0x02, 0x03, 0x00, 0x60, 0x25, 0x81, 0x03, 0x03, 0x01, 0x02, 0x01, 0x01,
 	0x0F, 0x12, 0x02, 0x01, 0x01, 0x04, 0x11, 0x01, 0x0F, 0x12, 0x02, 0x01,
-	0x01, 0x08, 0x11, 0x01, 0x0F, 0x12, 0x01, 0x00, 0x31, 0x0E, 0x06, 0x10,
-	0x21, 0x01, 0x00, 0x01, 0x18, 0x02, 0x00, 0x06, 0x03, 0x3E, 0x04, 0x01,
-	0x3F, 0x04, 0x80, 0x56, 0x01, 0x01, 0x31, 0x0E, 0x06, 0x10, 0x21, 0x01,
-	0x01, 0x01, 0x10, 0x02, 0x00, 0x06, 0x03, 0x3E, 0x04, 0x01, 0x3F, 0x04,
-	0x80, 0x40, 0x01, 0x02, 0x31, 0x0E, 0x06, 0x0F, 0x21, 0x01, 0x01, 0x01,
-	0x20, 0x02, 0x00, 0x06, 0x03, 0x3E, 0x04, 0x01, 0x3F, 0x04, 0x2B, 0x01,
-	0x03, 0x31, 0x0E, 0x06, 0x0E, 0x21, 0x21, 0x01, 0x10, 0x02, 0x00, 0x06,
-	0x03, 0x3C, 0x04, 0x01, 0x3D, 0x04, 0x17, 0x01, 0x04, 0x31, 0x0E, 0x06,
-	0x0E, 0x21, 0x21, 0x01, 0x20, 0x02, 0x00, 0x06, 0x03, 0x3C, 0x04, 0x01,
-	0x3D, 0x04, 0x03, 0x50, 0x23, 0x21, 0x00, 0x00, 0x7C, 0x01, 0x0C, 0x11,
-	0x01, 0x02, 0x0F, 0x00, 0x00, 0x7C, 0x01, 0x0C, 0x11, 0x22, 0x47, 0x3B,
-	0x01, 0x03, 0x0A, 0x12, 0x00, 0x00, 0x7C, 0x01, 0x0C, 0x11, 0x01, 0x01,
-	0x0E, 0x00, 0x00, 0x7C, 0x01, 0x0C, 0x11, 0x46, 0x00, 0x00, 0x18, 0x01,
-	0x00, 0x57, 0x27, 0x22, 0x06, 0x20, 0x01, 0x01, 0x31, 0x0E, 0x06, 0x07,
-	0x21, 0x01, 0x00, 0x81, 0x00, 0x04, 0x11, 0x01, 0x02, 0x31, 0x0E, 0x06,
-	0x0A, 0x21, 0x59, 0x27, 0x06, 0x03, 0x01, 0x10, 0x30, 0x04, 0x01, 0x21,
-	0x04, 0x01, 0x21, 0x5F, 0x27, 0x05, 0x35, 0x28, 0x06, 0x32, 0x69, 0x27,
-	0x01, 0x14, 0x31, 0x0E, 0x06, 0x06, 0x21, 0x01, 0x02, 0x30, 0x04, 0x24,
-	0x01, 0x15, 0x31, 0x0E, 0x06, 0x0B, 0x21, 0x81, 0x09, 0x06, 0x04, 0x01,
-	0x7F, 0x81, 0x00, 0x04, 0x13, 0x01, 0x16, 0x31, 0x0E, 0x06, 0x06, 0x21,
-	0x01, 0x01, 0x30, 0x04, 0x07, 0x21, 0x01, 0x04, 0x30, 0x01, 0x00, 0x21,
-	0x16, 0x06, 0x03, 0x01, 0x08, 0x30, 0x00, 0x00, 0x18, 0x22, 0x05, 0x10,
-	0x28, 0x06, 0x0D, 0x69, 0x27, 0x01, 0x15, 0x0E, 0x06, 0x05, 0x21, 0x81,
-	0x09, 0x04, 0x01, 0x1C, 0x00, 0x00, 0x81, 0x25, 0x01, 0x07, 0x12, 0x01,
-	0x01, 0x0F, 0x06, 0x02, 0x56, 0x23, 0x00, 0x01, 0x03, 0x00, 0x24, 0x16,
-	0x06, 0x05, 0x02, 0x00, 0x6A, 0x38, 0x00, 0x81, 0x25, 0x21, 0x04, 0x73,
-	0x00, 0x01, 0x14, 0x81, 0x28, 0x01, 0x01, 0x81, 0x33, 0x24, 0x22, 0x01,
-	0x00, 0x81, 0x20, 0x01, 0x16, 0x81, 0x28, 0x81, 0x2B, 0x24, 0x00, 0x00,
-	0x01, 0x0B, 0x81, 0x33, 0x40, 0x22, 0x01, 0x03, 0x08, 0x81, 0x32, 0x81,
-	0x32, 0x13, 0x22, 0x44, 0x06, 0x02, 0x21, 0x00, 0x81, 0x32, 0x1A, 0x22,
-	0x06, 0x06, 0x67, 0x3B, 0x81, 0x2F, 0x04, 0x76, 0x21, 0x04, 0x6A, 0x00,
-	0x7E, 0x01, 0x14, 0x81, 0x33, 0x01, 0x0C, 0x81, 0x32, 0x67, 0x01, 0x0C,
-	0x81, 0x2F, 0x00, 0x03, 0x03, 0x00, 0x01, 0x02, 0x81, 0x33, 0x01, 0x80,
-	0x46, 0x6B, 0x27, 0x01, 0x02, 0x0E, 0x06, 0x0C, 0x02, 0x00, 0x06, 0x04,
-	0x01, 0x05, 0x04, 0x02, 0x01, 0x1D, 0x04, 0x02, 0x01, 0x00, 0x03, 0x01,
-	0x68, 0x27, 0x06, 0x04, 0x01, 0x05, 0x04, 0x02, 0x01, 0x00, 0x03, 0x02,
-	0x02, 0x01, 0x02, 0x02, 0x08, 0x22, 0x06, 0x03, 0x01, 0x02, 0x08, 0x08,
-	0x81, 0x32, 0x75, 0x25, 0x81, 0x31, 0x6E, 0x01, 0x04, 0x14, 0x6E, 0x01,
-	0x04, 0x08, 0x01, 0x1C, 0x2B, 0x6E, 0x01, 0x20, 0x81, 0x2F, 0x01, 0x20,
-	0x81, 0x33, 0x6F, 0x01, 0x20, 0x81, 0x2F, 0x5A, 0x25, 0x81, 0x31, 0x01,
-	0x00, 0x81, 0x33, 0x02, 0x01, 0x02, 0x02, 0x08, 0x22, 0x06, 0x30, 0x81,
-	0x31, 0x02, 0x01, 0x22, 0x06, 0x13, 0x01, 0x83, 0xFE, 0x01, 0x81, 0x31,
-	0x01, 0x04, 0x09, 0x22, 0x81, 0x31, 0x49, 0x6C, 0x3B, 0x81, 0x30, 0x04,
-	0x01, 0x21, 0x02, 0x02, 0x06, 0x0F, 0x01, 0x01, 0x81, 0x31, 0x01, 0x01,
-	0x81, 0x31, 0x68, 0x27, 0x01, 0x08, 0x09, 0x81, 0x33, 0x04, 0x01, 0x21,
-	0x00, 0x00, 0x01, 0x0E, 0x81, 0x33, 0x01, 0x00, 0x81, 0x32, 0x00, 0x03,
-	0x5A, 0x25, 0x81, 0x22, 0x05, 0x01, 0x00, 0x60, 0x26, 0x01, 0x00, 0x81,
-	0x02, 0x11, 0x01, 0x01, 0x12, 0x46, 0x06, 0x03, 0x48, 0x04, 0x74, 0x03,
-	0x00, 0x21, 0x02, 0x00, 0x1E, 0x22, 0x44, 0x06, 0x02, 0x2E, 0x23, 0x03,
-	0x01, 0x75, 0x25, 0x01, 0x86, 0x03, 0x10, 0x03, 0x02, 0x01, 0x0C, 0x81,
-	0x33, 0x02, 0x01, 0x62, 0x27, 0x08, 0x02, 0x02, 0x01, 0x02, 0x12, 0x08,
-	0x01, 0x06, 0x08, 0x81, 0x32, 0x01, 0x03, 0x81, 0x33, 0x02, 0x00, 0x81,
-	0x31, 0x61, 0x62, 0x27, 0x81, 0x30, 0x02, 0x02, 0x06, 0x10, 0x72, 0x27,
-	0x81, 0x33, 0x5A, 0x25, 0x81, 0x23, 0x01, 0x01, 0x0B, 0x01, 0x03, 0x08,
-	0x81, 0x33, 0x02, 0x01, 0x81, 0x31, 0x67, 0x02, 0x01, 0x81, 0x2F, 0x00,
-	0x00, 0x42, 0x22, 0x01, 0x00, 0x0E, 0x06, 0x02, 0x4B, 0x00, 0x81, 0x25,
-	0x21, 0x04, 0x72, 0x00, 0x22, 0x81, 0x33, 0x81, 0x2F, 0x00, 0x00, 0x22,
-	0x01, 0x08, 0x41, 0x81, 0x33, 0x81, 0x33, 0x00, 0x00, 0x22, 0x01, 0x10,
-	0x41, 0x81, 0x33, 0x81, 0x31, 0x00, 0x00, 0x22, 0x43, 0x06, 0x02, 0x21,
-	0x00, 0x81, 0x25, 0x21, 0x04, 0x75
+	0x01, 0x08, 0x11, 0x01, 0x0F, 0x12, 0x01, 0x00, 0x32, 0x0E, 0x06, 0x10,
+	0x21, 0x01, 0x00, 0x01, 0x18, 0x02, 0x00, 0x06, 0x03, 0x42, 0x04, 0x01,
+	0x43, 0x04, 0x81, 0x45, 0x01, 0x01, 0x32, 0x0E, 0x06, 0x10, 0x21, 0x01,
+	0x01, 0x01, 0x10, 0x02, 0x00, 0x06, 0x03, 0x42, 0x04, 0x01, 0x43, 0x04,
+	0x81, 0x2F, 0x01, 0x02, 0x32, 0x0E, 0x06, 0x10, 0x21, 0x01, 0x01, 0x01,
+	0x20, 0x02, 0x00, 0x06, 0x03, 0x42, 0x04, 0x01, 0x43, 0x04, 0x81, 0x19,
+	0x01, 0x03, 0x32, 0x0E, 0x06, 0x0F, 0x21, 0x21, 0x01, 0x10, 0x02, 0x00,
+	0x06, 0x03, 0x40, 0x04, 0x01, 0x41, 0x04, 0x81, 0x04, 0x01, 0x04, 0x32,
+	0x0E, 0x06, 0x0F, 0x21, 0x21, 0x01, 0x20, 0x02, 0x00, 0x06, 0x03, 0x40,
+	0x04, 0x01, 0x41, 0x04, 0x80, 0x6F, 0x01, 0x05, 0x32, 0x0E, 0x06, 0x0D,
+	0x21, 0x21, 0x02, 0x00, 0x06, 0x03, 0x44, 0x04, 0x01, 0x45, 0x04, 0x80,
+	0x5C, 0x01, 0x06, 0x32, 0x0E, 0x06, 0x11, 0x21, 0x21, 0x01, 0x10, 0x01,
+	0x10, 0x02, 0x00, 0x06, 0x03, 0x3E, 0x04, 0x01, 0x3F, 0x04, 0x80, 0x45,
+	0x01, 0x07, 0x32, 0x0E, 0x06, 0x10, 0x21, 0x21, 0x01, 0x20, 0x01, 0x10,
+	0x02, 0x00, 0x06, 0x03, 0x3E, 0x04, 0x01, 0x3F, 0x04, 0x2F, 0x01, 0x08,
+	0x32, 0x0E, 0x06, 0x10, 0x21, 0x21, 0x01, 0x10, 0x01, 0x08, 0x02, 0x00,
+	0x06, 0x03, 0x3E, 0x04, 0x01, 0x3F, 0x04, 0x19, 0x01, 0x09, 0x32, 0x0E,
+	0x06, 0x10, 0x21, 0x21, 0x01, 0x20, 0x01, 0x08, 0x02, 0x00, 0x06, 0x03,
+	0x3E, 0x04, 0x01, 0x3F, 0x04, 0x03, 0x56, 0x23, 0x21, 0x00, 0x00, 0x81,
+	0x03, 0x01, 0x08, 0x11, 0x01, 0x0F, 0x12, 0x01, 0x03, 0x0A, 0x00, 0x00,
+	0x81, 0x03, 0x01, 0x0C, 0x11, 0x01, 0x02, 0x0F, 0x00, 0x00, 0x81, 0x03,
+	0x01, 0x0C, 0x11, 0x22, 0x4D, 0x3D, 0x01, 0x03, 0x0A, 0x12, 0x00, 0x00,
+	0x81, 0x03, 0x01, 0x0C, 0x11, 0x01, 0x01, 0x0E, 0x00, 0x00, 0x81, 0x03,
+	0x01, 0x0C, 0x11, 0x4C, 0x00, 0x00, 0x18, 0x01, 0x00, 0x5D, 0x27, 0x22,
+	0x06, 0x20, 0x01, 0x01, 0x32, 0x0E, 0x06, 0x07, 0x21, 0x01, 0x00, 0x81,
+	0x07, 0x04, 0x11, 0x01, 0x02, 0x32, 0x0E, 0x06, 0x0A, 0x21, 0x5F, 0x27,
+	0x06, 0x03, 0x01, 0x10, 0x31, 0x04, 0x01, 0x21, 0x04, 0x01, 0x21, 0x65,
+	0x27, 0x05, 0x35, 0x28, 0x06, 0x32, 0x70, 0x27, 0x01, 0x14, 0x32, 0x0E,
+	0x06, 0x06, 0x21, 0x01, 0x02, 0x31, 0x04, 0x24, 0x01, 0x15, 0x32, 0x0E,
+	0x06, 0x0B, 0x21, 0x81, 0x10, 0x06, 0x04, 0x01, 0x7F, 0x81, 0x07, 0x04,
+	0x13, 0x01, 0x16, 0x32, 0x0E, 0x06, 0x06, 0x21, 0x01, 0x01, 0x31, 0x04,
+	0x07, 0x21, 0x01, 0x04, 0x31, 0x01, 0x00, 0x21, 0x16, 0x06, 0x03, 0x01,
+	0x08, 0x31, 0x00, 0x00, 0x18, 0x22, 0x05, 0x10, 0x28, 0x06, 0x0D, 0x70,
+	0x27, 0x01, 0x15, 0x0E, 0x06, 0x05, 0x21, 0x81, 0x10, 0x04, 0x01, 0x1C,
+	0x00, 0x00, 0x81, 0x2E, 0x01, 0x07, 0x12, 0x01, 0x01, 0x0F, 0x06, 0x02,
+	0x5C, 0x23, 0x00, 0x01, 0x03, 0x00, 0x24, 0x16, 0x06, 0x05, 0x02, 0x00,
+	0x71, 0x39, 0x00, 0x81, 0x2E, 0x21, 0x04, 0x73, 0x00, 0x01, 0x14, 0x81,
+	0x31, 0x01, 0x01, 0x81, 0x3C, 0x24, 0x22, 0x01, 0x00, 0x81, 0x28, 0x01,
+	0x16, 0x81, 0x31, 0x81, 0x34, 0x24, 0x00, 0x00, 0x01, 0x0B, 0x81, 0x3C,
+	0x46, 0x22, 0x01, 0x03, 0x08, 0x81, 0x3B, 0x81, 0x3B, 0x13, 0x22, 0x4A,
+	0x06, 0x02, 0x21, 0x00, 0x81, 0x3B, 0x1A, 0x22, 0x06, 0x06, 0x6E, 0x3D,
+	0x81, 0x38, 0x04, 0x76, 0x21, 0x04, 0x6A, 0x00, 0x81, 0x05, 0x01, 0x14,
+	0x81, 0x3C, 0x01, 0x0C, 0x81, 0x3B, 0x6E, 0x01, 0x0C, 0x81, 0x38, 0x00,
+	0x04, 0x03, 0x00, 0x01, 0x02, 0x81, 0x3C, 0x01, 0x80, 0x46, 0x72, 0x27,
+	0x01, 0x02, 0x0E, 0x06, 0x0C, 0x02, 0x00, 0x06, 0x04, 0x01, 0x05, 0x04,
+	0x02, 0x01, 0x1D, 0x04, 0x02, 0x01, 0x00, 0x03, 0x01, 0x6F, 0x27, 0x06,
+	0x04, 0x01, 0x05, 0x04, 0x02, 0x01, 0x00, 0x03, 0x02, 0x60, 0x25, 0x81,
+	0x29, 0x05, 0x04, 0x01, 0x00, 0x69, 0x39, 0x69, 0x27, 0x06, 0x04, 0x01,
+	0x04, 0x04, 0x02, 0x01, 0x00, 0x03, 0x03, 0x02, 0x01, 0x02, 0x02, 0x08,
+	0x02, 0x03, 0x08, 0x22, 0x06, 0x03, 0x01, 0x02, 0x08, 0x08, 0x81, 0x3B,
+	0x7C, 0x25, 0x81, 0x3A, 0x75, 0x01, 0x04, 0x14, 0x75, 0x01, 0x04, 0x08,
+	0x01, 0x1C, 0x2B, 0x75, 0x01, 0x20, 0x81, 0x38, 0x01, 0x20, 0x81, 0x3C,
+	0x76, 0x01, 0x20, 0x81, 0x38, 0x60, 0x25, 0x81, 0x3A, 0x01, 0x00, 0x81,
+	0x3C, 0x02, 0x01, 0x02, 0x02, 0x08, 0x02, 0x03, 0x08, 0x22, 0x06, 0x3C,
+	0x81, 0x3A, 0x02, 0x01, 0x22, 0x06, 0x13, 0x01, 0x83, 0xFE, 0x01, 0x81,
+	0x3A, 0x01, 0x04, 0x09, 0x22, 0x81, 0x3A, 0x4F, 0x73, 0x3D, 0x81, 0x39,
+	0x04, 0x01, 0x21, 0x02, 0x02, 0x06, 0x0F, 0x01, 0x01, 0x81, 0x3A, 0x01,
+	0x01, 0x81, 0x3A, 0x6F, 0x27, 0x01, 0x08, 0x09, 0x81, 0x3C, 0x02, 0x03,
+	0x06, 0x08, 0x01, 0x16, 0x81, 0x3A, 0x01, 0x00, 0x81, 0x3A, 0x04, 0x01,
+	0x21, 0x00, 0x00, 0x01, 0x0E, 0x81, 0x3C, 0x01, 0x00, 0x81, 0x3B, 0x00,
+	0x03, 0x60, 0x25, 0x81, 0x2B, 0x05, 0x01, 0x00, 0x66, 0x26, 0x22, 0x01,
+	0x82, 0x80, 0x80, 0x80, 0x00, 0x12, 0x06, 0x05, 0x21, 0x01, 0x1D, 0x04,
+	0x10, 0x01, 0x00, 0x81, 0x09, 0x11, 0x01, 0x01, 0x12, 0x4C, 0x06, 0x03,
+	0x4E, 0x04, 0x74, 0x3D, 0x21, 0x03, 0x00, 0x02, 0x00, 0x1E, 0x22, 0x4A,
+	0x06, 0x02, 0x2F, 0x23, 0x03, 0x01, 0x7C, 0x25, 0x01, 0x86, 0x03, 0x10,
+	0x03, 0x02, 0x01, 0x0C, 0x81, 0x3C, 0x02, 0x01, 0x68, 0x27, 0x08, 0x02,
+	0x02, 0x01, 0x02, 0x12, 0x08, 0x01, 0x06, 0x08, 0x81, 0x3B, 0x01, 0x03,
+	0x81, 0x3C, 0x02, 0x00, 0x81, 0x3A, 0x67, 0x68, 0x27, 0x81, 0x39, 0x02,
+	0x02, 0x06, 0x10, 0x79, 0x27, 0x81, 0x3C, 0x60, 0x25, 0x81, 0x2C, 0x01,
+	0x01, 0x0B, 0x01, 0x03, 0x08, 0x81, 0x3C, 0x02, 0x01, 0x81, 0x3A, 0x6E,
+	0x02, 0x01, 0x81, 0x38, 0x00, 0x00, 0x48, 0x22, 0x01, 0x00, 0x0E, 0x06,
+	0x02, 0x51, 0x00, 0x81, 0x2E, 0x21, 0x04, 0x72, 0x00, 0x22, 0x81, 0x3C,
+	0x81, 0x38, 0x00, 0x00, 0x22, 0x01, 0x08, 0x47, 0x81, 0x3C, 0x81, 0x3C,
+	0x00, 0x00, 0x22, 0x01, 0x10, 0x47, 0x81, 0x3C, 0x81, 0x3A, 0x00, 0x00,
+	0x22, 0x49, 0x06, 0x02, 0x21, 0x00, 0x81, 0x2E, 0x21, 0x04, 0x75
 };
 
 static const uint16_t t0_caddr[] = {
@@ -622,7 +647,7 @@ static const uint16_t t0_caddr[] = {
 	143,
 	148,
 	153,
-	159,
+	158,
 	164,
 	169,
 	174,
@@ -643,66 +668,69 @@ static const uint16_t t0_caddr[] = {
 	249,
 	254,
 	259,
-	268,
-	272,
-	297,
-	303,
-	323,
-	334,
-	371,
-	431,
-	435,
-	471,
-	481,
-	546,
-	560,
-	566,
-	613,
-	633,
-	686,
-	1211,
-	1296,
-	1329,
-	1354,
-	1402,
-	1476,
-	1525,
-	1540,
-	1551,
-	1557,
-	1628,
-	1669,
-	1682,
-	1701,
-	1708,
-	1720,
-	1755,
-	1784,
-	1796,
-	1803,
-	1819,
-	1957,
-	1966,
-	1979,
-	1988,
-	1995,
-	2101,
-	2123,
-	2137,
-	2154,
-	2177,
-	2213,
-	2229,
-	2383,
-	2393,
-	2502,
-	2517,
-	2524,
-	2534,
-	2544
+	264,
+	273,
+	277,
+	305,
+	311,
+	331,
+	342,
+	379,
+	444,
+	448,
+	484,
+	494,
+	559,
+	573,
+	580,
+	627,
+	647,
+	700,
+	1246,
+	1332,
+	1367,
+	1393,
+	1408,
+	1456,
+	1530,
+	1581,
+	1596,
+	1607,
+	1613,
+	1686,
+	1729,
+	1743,
+	1763,
+	1771,
+	1783,
+	1818,
+	1847,
+	1859,
+	1866,
+	1883,
+	2133,
+	2146,
+	2156,
+	2170,
+	2180,
+	2188,
+	2294,
+	2316,
+	2330,
+	2347,
+	2370,
+	2406,
+	2423,
+	2617,
+	2627,
+	2752,
+	2767,
+	2774,
+	2784,
+	2794
 };
 
-#define T0_INTERPRETED   68
+#define T0_INTERPRETED   74
 
 #define T0_ENTER(ip, rp, slot)   do { \
 		const unsigned char *t0_newip; \
@@ -723,7 +751,7 @@ name(void *ctx) \
 	T0_ENTER(t0ctx->ip, t0ctx->rp, slot); \
 }
 
-T0_DEFENTRY(br_ssl_hs_server_init_main, 133)
+T0_DEFENTRY(br_ssl_hs_server_init_main, 140)
 
 void
 br_ssl_hs_server_run(void *t0ctx)
@@ -1184,6 +1212,21 @@ br_ssl_hs_server_run(void *t0ctx)
 				}
 				break;
 			case 46: {
+				/* multihash-restrict */
+
+	int prf_id = T0_POPi();
+	unsigned keep;
+
+	if (ENG->session.version >= BR_TLS12) {
+		keep = 1U << prf_id;
+	} else {
+		keep = (1U << br_md5_ID) | (1U << br_sha1_ID);
+	}
+	br_multihash_restrict(&ENG->mhash, keep);
+
+				}
+				break;
+			case 47: {
 				/* neg */
 
 	uint32_t a = T0_POP();
@@ -1191,7 +1234,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 47: {
+			case 48: {
 				/* not */
 
 	uint32_t a = T0_POP();
@@ -1199,7 +1242,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 48: {
+			case 49: {
 				/* or */
 
 	uint32_t b = T0_POP();
@@ -1208,12 +1251,12 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 49: {
+			case 50: {
 				/* over */
  T0_PUSH(T0_PEEK(1)); 
 				}
 				break;
-			case 50: {
+			case 51: {
 				/* read-chunk-native */
 
 	size_t clen = ENG->hlen_in;
@@ -1237,7 +1280,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 51: {
+			case 52: {
 				/* read8-native */
 
 	if (ENG->hlen_in > 0) {
@@ -1255,7 +1298,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 52: {
+			case 53: {
 				/* save-session */
 
 	if (CTX->cache_vtable != NULL) {
@@ -1265,7 +1308,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 53: {
+			case 54: {
 				/* set-max-frag-len */
 
 	size_t max_frag_len = T0_POP();
@@ -1284,7 +1327,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 54: {
+			case 55: {
 				/* set16 */
 
 	size_t addr = (size_t)T0_POP();
@@ -1292,7 +1335,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 55: {
+			case 56: {
 				/* set32 */
 
 	size_t addr = (size_t)T0_POP();
@@ -1300,7 +1343,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 56: {
+			case 57: {
 				/* set8 */
 
 	size_t addr = (size_t)T0_POP();
@@ -1308,7 +1351,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 57: {
+			case 58: {
 				/* supported-curves */
 
 	uint32_t x = ENG->iec == NULL ? 0 : ENG->iec->supported_curves;
@@ -1316,7 +1359,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 58: {
+			case 59: {
 				/* supported-hash-functions */
 
 	int i;
@@ -1335,12 +1378,49 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 59: {
+			case 60: {
+				/* supports-etm? */
+
+	T0_PUSHi(-(ENG->icbc_etm_in != 0 && ENG->icbc_etm_out != 0));
+
+				}
+				break;
+			case 61: {
 				/* swap */
  T0_SWAP(); 
 				}
 				break;
-			case 60: {
+			case 62: {
+				/* switch-aesccm-in */
+
+	int is_client, prf_id;
+	unsigned cipher_key_len, tag_len;
+
+	tag_len = T0_POP();
+	cipher_key_len = T0_POP();
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_ccm_in(ENG, is_client, prf_id,
+		ENG->iaes_cbcenc, ENG->iaes_ctr, cipher_key_len, tag_len);
+
+				}
+				break;
+			case 63: {
+				/* switch-aesccm-out */
+
+	int is_client, prf_id;
+	unsigned cipher_key_len, tag_len;
+
+	tag_len = T0_POP();
+	cipher_key_len = T0_POP();
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_ccm_out(ENG, is_client, prf_id,
+		ENG->iaes_cbcenc, ENG->iaes_ctr, cipher_key_len, tag_len);
+
+				}
+				break;
+			case 64: {
 				/* switch-aesgcm-in */
 
 	int is_client, prf_id;
@@ -1354,7 +1434,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 61: {
+			case 65: {
 				/* switch-aesgcm-out */
 
 	int is_client, prf_id;
@@ -1368,7 +1448,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 62: {
+			case 66: {
 				/* switch-cbc-in */
 
 	int is_client, prf_id, mac_id, aes;
@@ -1384,7 +1464,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 63: {
+			case 67: {
 				/* switch-cbc-out */
 
 	int is_client, prf_id, mac_id, aes;
@@ -1400,7 +1480,29 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 64: {
+			case 68: {
+				/* switch-chapol-in */
+
+	int is_client, prf_id;
+
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_chapol_in(ENG, is_client, prf_id);
+
+				}
+				break;
+			case 69: {
+				/* switch-chapol-out */
+
+	int is_client, prf_id;
+
+	prf_id = T0_POP();
+	is_client = T0_POP();
+	br_ssl_engine_switch_chapol_out(ENG, is_client, prf_id);
+
+				}
+				break;
+			case 70: {
 				/* total-chain-length */
 
 	size_t u;
@@ -1414,7 +1516,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 65: {
+			case 71: {
 				/* u>> */
 
 	int c = (int)T0_POPi();
@@ -1423,7 +1525,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 66: {
+			case 72: {
 				/* write-blob-chunk */
 
 	size_t clen = ENG->hlen_out;
@@ -1447,7 +1549,7 @@ br_ssl_hs_server_run(void *t0ctx)
 
 				}
 				break;
-			case 67: {
+			case 73: {
 				/* write8-native */
 
 	unsigned char x;
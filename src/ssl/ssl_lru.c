@@ -62,7 +62,9 @@
  * To do that, we replace the session ID (or the start of the session ID)
  * with a HMAC value computed over the replaced part; the hash function
  * implementation and the key are obtained from the server context upon
- * first save() call.
+ * first save() call. The HMAC key context is computed only once at that
+ * point, so that each lookup costs only the two compression function
+ * calls over the session ID itself.
  */
 #define SESSION_ID_LEN       32
 #define MASTER_SECRET_LEN    48
@@ -112,12 +114,10 @@ static void
 mask_id(br_ssl_session_cache_lru *cc,
 	const unsigned char *src, unsigned char *dst)
 {
-	br_hmac_key_context hkc;
 	br_hmac_context hc;
 
 	memcpy(dst, src, SESSION_ID_LEN);
-	br_hmac_key_init(&hkc, cc->hash, cc->index_key, sizeof cc->index_key);
-	br_hmac_init(&hc, &hkc, SESSION_ID_LEN);
+	br_hmac_init(&hc, &cc->index_key, SESSION_ID_LEN);
 	br_hmac_update(&hc, src, SESSION_ID_LEN);
 	br_hmac_out(&hc, dst);
 }
@@ -271,9 +271,12 @@ lru_save(const br_ssl_session_cache_class **ctx,
 	 * a random key for our indexing.
 	 */
 	if (!cc->init_done) {
-		br_hmac_drbg_generate(&server_ctx->eng.rng,
-			cc->index_key, sizeof cc->index_key);
-		cc->hash = br_hmac_drbg_get_hash(&server_ctx->eng.rng);
+		unsigned char key[32];
+
+		br_hmac_drbg_generate(&server_ctx->eng.rng, key, sizeof key);
+		br_hmac_key_init(&cc->index_key,
+			br_hmac_drbg_get_hash(&server_ctx->eng.rng),
+			key, sizeof key);
 		cc->init_done = 1;
 	}
 	mask_id(cc, params->session_id, id);
@@ -277,6 +277,7 @@ out_cbc_init(br_sslrec_out_cbc_context *cc,
 	bc_impl->init(&cc->bc.vtable, bc_key, bc_key_len);
 	br_hmac_key_init(&cc->mac, dig_impl, mac_key, mac_key_len);
 	cc->mac_len = mac_out_len;
+	cc->kern = NULL;
 	if (iv == NULL) {
 		memset(cc->iv, 0, sizeof cc->iv);
 		cc->explicit_IV = 1;
@@ -311,7 +312,7 @@ cbc_encrypt(br_sslrec_out_cbc_context *cc,
 	int record_type, unsigned version, void *data, size_t *data_len)
 {
 	unsigned char *buf, *rbuf;
-	size_t len, blen, plen;
+	size_t len, blen, plen, elen;
 	unsigned char tmp[13];
 	br_hmac_context hc;
 
@@ -375,7 +376,11 @@ cbc_encrypt(br_sslrec_out_cbc_context *cc,
 	}
 
 	/*
-	 * Compute MAC.
+	 * Compute MAC. With a CBC+HMAC kernel, the complete plaintext
+	 * blocks are hashed and encrypted in a single pass; since the
+	 * explicit IV block (if any) comes first in the CBC chain, it
+	 * must be encrypted beforehand. 'elen' is the length of the
+	 * data that is already encrypted.
 	 */
 	br_enc64be(tmp, cc->seq ++);
 	tmp[8] = record_type;
@@ -383,7 +388,17 @@ cbc_encrypt(br_sslrec_out_cbc_context *cc,
 	br_enc16be(tmp + 11, len);
 	br_hmac_init(&hc, &cc->mac, cc->mac_len);
 	br_hmac_update(&hc, tmp, 13);
-	br_hmac_update(&hc, buf, len);
+	elen = 0;
+	if (cc->kern != NULL) {
+		if (cc->explicit_IV) {
+			cc->bc.vtable->run(&cc->bc.vtable,
+				cc->iv, buf - blen, blen);
+		}
+		elen = len & ~(blen - 1);
+		cc->kern->mac_encrypt(&cc->bc.vtable,
+			cc->iv, &hc.dig.vtable, buf, elen);
+	}
+	br_hmac_update(&hc, buf + elen, len - elen);
 	br_hmac_out(&hc, buf + len);
 	len += cc->mac_len;
 
@@ -402,14 +417,17 @@ cbc_encrypt(br_sslrec_out_cbc_context *cc,
 	if (cc->explicit_IV) {
 		buf -= blen;
 		len += blen;
+		if (cc->kern != NULL) {
+			elen += blen;
+		}
 	}
 
 	/*
-	 * Encrypt the whole thing. If there is an explicit IV, we also
-	 * encrypt it, which is fine (encryption of a uniformly random
-	 * block is still a uniformly random block).
+	 * Encrypt the whole thing (or what remains of it). If there is
+	 * an explicit IV, we also encrypt it, which is fine (encryption
+	 * of a uniformly random block is still a uniformly random block).
 	 */
-	cc->bc.vtable->run(&cc->bc.vtable, cc->iv, buf, len);
+	cc->bc.vtable->run(&cc->bc.vtable, cc->iv, buf + elen, len - elen);
 
 	/*
 	 * Add the header and return.
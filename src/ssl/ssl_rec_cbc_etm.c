@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * Encrypt-then-MAC (RFC 7366) record processing for CBC cipher suites.
+ * The record layout is:
+ *
+ *   header || [IV] || CBC(plaintext || padding) || MAC
+ *
+ * where the MAC is computed over the sequence number, the record
+ * header (with the length of the encrypted part, including the
+ * explicit IV, if any), and the encrypted part itself. Since the MAC
+ * is verified before decryption, the incoming path does not need the
+ * constant-time MAC extraction and computation that protects the
+ * classic MAC-then-encrypt processing against Lucky13-style attacks:
+ * the padding is examined only for authenticated records.
+ *
+ * The contexts are the same as for MAC-then-encrypt; only the vtables
+ * differ.
+ */
+
+static void
+in_cbc_etm_init(br_sslrec_in_cbc_context *cc,
+	const br_block_cbcdec_class *bc_impl,
+	const void *bc_key, size_t bc_key_len,
+	const br_hash_class *dig_impl,
+	const void *mac_key, size_t mac_key_len, size_t mac_out_len,
+	const void *iv)
+{
+	cc->vtable = &br_sslrec_in_cbc_etm_vtable;
+	cc->seq = 0;
+	bc_impl->init(&cc->bc.vtable, bc_key, bc_key_len);
+	br_hmac_key_init(&cc->mac, dig_impl, mac_key, mac_key_len);
+	cc->mac_len = mac_out_len;
+	if (iv == NULL) {
+		memset(cc->iv, 0, sizeof cc->iv);
+		cc->explicit_IV = 1;
+	} else {
+		memcpy(cc->iv, iv, bc_impl->block_size);
+		cc->explicit_IV = 0;
+	}
+}
+
+static int
+cbc_etm_check_length(const br_sslrec_in_cbc_context *cc, size_t rlen)
+{
+	/*
+	 * Plaintext size: at most 16384 bytes
+	 * Padding: at most 256 bytes
+	 * TLS 1.1+: each record has an explicit IV
+	 * MAC: mac_len extra bytes, after the encrypted part
+	 *
+	 * The encrypted part must contain at least one block, and its
+	 * length must be a multiple of the block size.
+	 */
+	size_t blen;
+	size_t min_len, max_len;
+
+	blen = cc->bc.vtable->block_size;
+	if (rlen < cc->mac_len) {
+		return 0;
+	}
+	rlen -= cc->mac_len;
+	min_len = blen;
+	max_len = (16384 + 256) & ~(blen - 1);
+	if (cc->explicit_IV) {
+		min_len += blen;
+		max_len += blen;
+	}
+	return min_len <= rlen && rlen <= max_len && (rlen & (blen - 1)) == 0;
+}
+
+static unsigned char *
+cbc_etm_decrypt(br_sslrec_in_cbc_context *cc,
+	int record_type, unsigned version, void *data, size_t *data_len)
+{
+	unsigned char *buf;
+	size_t u, len, blen, pad_len;
+	unsigned char tmp[64];
+	br_hmac_context hc;
+	uint32_t bad;
+
+	buf = data;
+	len = *data_len - cc->mac_len;
+	blen = cc->bc.vtable->block_size;
+
+	/*
+	 * Recompute the MAC over the encrypted data, and compare it with
+	 * the received value. The comparison is constant-time, but the
+	 * MAC computation need not be: the encrypted length is public.
+	 */
+	br_enc64be(tmp, cc->seq ++);
+	tmp[8] = (unsigned char)record_type;
+	br_enc16be(tmp + 9, version);
+	br_enc16be(tmp + 11, len);
+	br_hmac_init(&hc, &cc->mac, cc->mac_len);
+	br_hmac_update(&hc, tmp, 13);
+	br_hmac_update(&hc, buf, len);
+	br_hmac_out(&hc, tmp);
+	bad = 0;
+	for (u = 0; u < cc->mac_len; u ++) {
+		bad |= tmp[u] ^ buf[len + u];
+	}
+	if (bad != 0) {
+		return NULL;
+	}
+
+	/*
+	 * Decrypt data, and skip the explicit IV (if applicable). As in
+	 * the MAC-then-encrypt case, the explicit IV is "decrypted" with
+	 * the chained IV, which is harmless.
+	 */
+	cc->bc.vtable->run(&cc->bc.vtable, cc->iv, buf, len);
+	if (cc->explicit_IV) {
+		buf += blen;
+		len -= blen;
+	}
+
+	/*
+	 * Check and remove the padding. The record is authenticated,
+	 * so there is no need for constant-time processing here.
+	 */
+	pad_len = buf[len - 1];
+	if (pad_len >= len) {
+		return NULL;
+	}
+	for (u = len - 1 - pad_len; u < len - 1; u ++) {
+		if (buf[u] != pad_len) {
+			return NULL;
+		}
+	}
+	len -= pad_len + 1;
+	if (len > 16384) {
+		return NULL;
+	}
+	*data_len = len;
+	return buf;
+}
+
+/* see bearssl_ssl.h */
+const br_sslrec_in_cbc_class br_sslrec_in_cbc_etm_vtable = {
+	{
+		sizeof(br_sslrec_in_cbc_context),
+		(int (*)(const br_sslrec_in_class *const *, size_t))
+			&cbc_etm_check_length,
+		(unsigned char *(*)(const br_sslrec_in_class **,
+			int, unsigned, void *, size_t *))
+			&cbc_etm_decrypt
+	},
+	(void (*)(const br_sslrec_in_cbc_class **,
+		const br_block_cbcdec_class *, const void *, size_t,
+		const br_hash_class *, const void *, size_t, size_t,
+		const void *))
+		&in_cbc_etm_init
+};
+
+/*
+ * For output, the explicit IV (TLS 1.1+) and the 1/n-1 split (TLS 1.0)
+ * follow the same rules as in the MAC-then-encrypt case (see
+ * ssl_rec_cbc.c).
+ */
+
+static void
+out_cbc_etm_init(br_sslrec_out_cbc_context *cc,
+	const br_block_cbcenc_class *bc_impl,
+	const void *bc_key, size_t bc_key_len,
+	const br_hash_class *dig_impl,
+	const void *mac_key, size_t mac_key_len, size_t mac_out_len,
+	const void *iv)
+{
+	cc->vtable = &br_sslrec_out_cbc_etm_vtable;
+	cc->seq = 0;
+	bc_impl->init(&cc->bc.vtable, bc_key, bc_key_len);
+	br_hmac_key_init(&cc->mac, dig_impl, mac_key, mac_key_len);
+	cc->mac_len = mac_out_len;
+	cc->kern = NULL;
+	if (iv == NULL) {
+		memset(cc->iv, 0, sizeof cc->iv);
+		cc->explicit_IV = 1;
+	} else {
+		memcpy(cc->iv, iv, bc_impl->block_size);
+		cc->explicit_IV = 0;
+	}
+}
+
+static void
+cbc_etm_max_plaintext(const br_sslrec_out_cbc_context *cc,
+	size_t *start, size_t *end)
+{
+	size_t blen, len;
+
+	blen = cc->bc.vtable->block_size;
+	if (cc->explicit_IV) {
+		*start += blen;
+	} else {
+		*start += 4 + blen + cc->mac_len;
+	}
+	len = (*end - *start - cc->mac_len) & ~(blen - 1);
+	len -= 1;
+	if (len > 16384) {
+		len = 16384;
+	}
+	*end = *start + len;
+}
+
+static unsigned char *
+cbc_etm_encrypt(br_sslrec_out_cbc_context *cc,
+	int record_type, unsigned version, void *data, size_t *data_len)
+{
+	unsigned char *buf, *rbuf;
+	size_t len, blen, plen;
+	unsigned char tmp[13];
+	br_hmac_context hc;
+
+	buf = data;
+	len = *data_len;
+	blen = cc->bc.vtable->block_size;
+
+	if (cc->explicit_IV) {
+		br_enc64be(tmp, cc->seq);
+		br_hmac_init(&hc, &cc->mac, blen);
+		br_hmac_update(&hc, tmp, 8);
+		br_hmac_out(&hc, buf - blen);
+		rbuf = buf - blen - 5;
+	} else {
+		if (len > 1 && record_type == BR_SSL_APPLICATION_DATA) {
+			/*
+			 * The one-byte record uses exactly one block
+			 * of encrypted data, followed by the MAC. As
+			 * in ssl_rec_cbc.c, it must end right before
+			 * the header of the main record, which will
+			 * start one byte later than the current 'buf'.
+			 */
+			size_t xlen;
+
+			rbuf = buf - 4 - blen - cc->mac_len;
+			rbuf[0] = buf[0];
+			xlen = 1;
+			rbuf = cbc_etm_encrypt(cc, record_type,
+				version, rbuf, &xlen);
+			buf ++;
+			len --;
+		} else {
+			rbuf = buf - 5;
+		}
+	}
+
+	/*
+	 * Add padding.
+	 */
+	plen = blen - (len & (blen - 1));
+	memset(buf + len, (unsigned)plen - 1, plen);
+	len += plen;
+
+	/*
+	 * Include the explicit IV block, if any, then encrypt and compute
+	 * the MAC over the encrypted data. With a CBC+HMAC kernel, both
+	 * are done in a single pass.
+	 */
+	if (cc->explicit_IV) {
+		buf -= blen;
+		len += blen;
+	}
+	br_enc64be(tmp, cc->seq ++);
+	tmp[8] = record_type;
+	br_enc16be(tmp + 9, version);
+	br_enc16be(tmp + 11, len);
+	br_hmac_init(&hc, &cc->mac, cc->mac_len);
+	br_hmac_update(&hc, tmp, 13);
+	if (cc->kern != NULL) {
+		cc->kern->encrypt_mac(&cc->bc.vtable,
+			cc->iv, &hc.dig.vtable, buf, len);
+	} else {
+		cc->bc.vtable->run(&cc->bc.vtable, cc->iv, buf, len);
+		br_hmac_update(&hc, buf, len);
+	}
+	br_hmac_out(&hc, buf + len);
+	len += cc->mac_len;
+
+	/*
+	 * Add the header and return.
+	 */
+	buf[-5] = record_type;
+	br_enc16be(buf - 4, version);
+	br_enc16be(buf - 2, len);
+	*data_len = (size_t)((buf + len) - rbuf);
+	return rbuf;
+}
+
+/* see bearssl_ssl.h */
+const br_sslrec_out_cbc_class br_sslrec_out_cbc_etm_vtable = {
+	{
+		sizeof(br_sslrec_out_cbc_context),
+		(void (*)(const br_sslrec_out_class *const *,
+			size_t *, size_t *))
+			&cbc_etm_max_plaintext,
+		(unsigned char *(*)(const br_sslrec_out_class **,
+			int, unsigned, void *, size_t *))
+			&cbc_etm_encrypt
+	},
+	(void (*)(const br_sslrec_out_cbc_class **,
+		const br_block_cbcenc_class *, const void *, size_t,
+		const br_hash_class *, const void *, size_t, size_t,
+		const void *))
+		&out_cbc_etm_init
+};
@@ -41,6 +41,7 @@ gen_gcm_init(br_sslrec_gcm_context *cc,
 	cc->seq = 0;
 	bc_impl->init(&cc->bc.vtable, key, key_len);
 	cc->gh = gh_impl;
+	cc->kern = NULL;
 	memcpy(cc->iv, iv, sizeof cc->iv);
 	memset(cc->h, 0, sizeof cc->h);
 	memset(tmp, 0, sizeof tmp);
@@ -70,6 +71,40 @@ gcm_check_length(const br_sslrec_gcm_context *cc, size_t rlen)
 	return rlen >= 24 && rlen <= (16384 + rlen);
 }
 
+/*
+ * Start the computation of the authentication tag: the 13-byte header
+ * (sequence number, record type, protocol version, record length) is
+ * injected, and the sequence number is incremented.
+ */
+static void
+do_tag_header(br_sslrec_gcm_context *cc,
+	int record_type, unsigned version, size_t len, void *tag)
+{
+	unsigned char header[13];
+
+	br_enc64be(header, cc->seq ++);
+	header[8] = (unsigned char)record_type;
+	br_enc16be(header + 9, version);
+	br_enc16be(header + 11, len);
+	memset(tag, 0, 16);
+	cc->gh(tag, cc->h, header, sizeof header);
+}
+
+/*
+ * Finish the computation of the authentication tag, with the word
+ * containing the encodings of the bit lengths of the header and the
+ * ciphertext. The value written in 'tag' must still be CTR-encrypted.
+ */
+static void
+do_tag_footer(br_sslrec_gcm_context *cc, size_t len, void *tag)
+{
+	unsigned char footer[16];
+
+	br_enc64be(footer, (uint64_t)13 << 3);
+	br_enc64be(footer + 8, (uint64_t)len << 3);
+	cc->gh(tag, cc->h, footer, sizeof footer);
+}
+
 /*
  * Compute the authentication tag. The value written in 'tag' must still
  * be CTR-encrypted.
@@ -79,9 +114,6 @@ do_tag(br_sslrec_gcm_context *cc,
 	int record_type, unsigned version,
 	void *data, size_t len, void *tag)
 {
-	unsigned char header[13];
-	unsigned char footer[16];
-
 	/*
 	 * Compute authentication tag. Three elements must be injected in
 	 * sequence, each possibly 0-padded to reach a length multiple
@@ -90,16 +122,9 @@ do_tag(br_sslrec_gcm_context *cc,
 	 * the word containing the encodings of the bit lengths of the two
 	 * other elements.
 	 */
-	br_enc64be(header, cc->seq ++);
-	header[8] = (unsigned char)record_type;
-	br_enc16be(header + 9, version);
-	br_enc16be(header + 11, len);
-	br_enc64be(footer, (uint64_t)(sizeof header) << 3);
-	br_enc64be(footer + 8, (uint64_t)len << 3);
-	memset(tag, 0, 16);
-	cc->gh(tag, cc->h, header, sizeof header);
+	do_tag_header(cc, record_type, version, len, tag);
 	cc->gh(tag, cc->h, data, len);
-	cc->gh(tag, cc->h, footer, sizeof footer);
+	do_tag_footer(cc, len, tag);
 }
 
 /*
@@ -119,6 +144,37 @@ do_ctr(br_sslrec_gcm_context *cc, const void *nonce, void *data, size_t len,
 	cc->bc.vtable->run(&cc->bc.vtable, iv, 1, xortag, 16);
 }
 
+/*
+ * Single-pass encryption or decryption with the GCM kernel. The complete
+ * tag is computed and written in 'tag' (already CTR-encrypted).
+ */
+static void
+do_kern(br_sslrec_gcm_context *cc, int encrypt,
+	int record_type, unsigned version,
+	const void *nonce, void *data, size_t len, void *tag)
+{
+	unsigned char iv[12];
+	unsigned char tmp[16];
+	unsigned char *tb;
+	size_t u;
+
+	memcpy(iv, cc->iv, 4);
+	memcpy(iv + 4, nonce, 8);
+	do_tag_header(cc, record_type, version, len, tag);
+	if (encrypt) {
+		cc->kern->encrypt(&cc->bc.vtable, iv, 2, cc->h, tag, data, len);
+	} else {
+		cc->kern->decrypt(&cc->bc.vtable, iv, 2, cc->h, tag, data, len);
+	}
+	do_tag_footer(cc, len, tag);
+	memset(tmp, 0, sizeof tmp);
+	cc->bc.vtable->run(&cc->bc.vtable, iv, 1, tmp, sizeof tmp);
+	tb = tag;
+	for (u = 0; u < sizeof tmp; u ++) {
+		tb[u] ^= tmp[u];
+	}
+}
+
 static unsigned char *
 gcm_decrypt(br_sslrec_gcm_context *cc,
 	int record_type, unsigned version, void *data, size_t *data_len)
@@ -130,8 +186,12 @@ gcm_decrypt(br_sslrec_gcm_context *cc,
 
 	buf = (unsigned char *)data + 8;
 	len = *data_len - 24;
-	do_tag(cc, record_type, version, buf, len, tag);
-	do_ctr(cc, data, buf, len, tag);
+	if (cc->kern != NULL) {
+		do_kern(cc, 0, record_type, version, data, buf, len, tag);
+	} else {
+		do_tag(cc, record_type, version, buf, len, tag);
+		do_ctr(cc, data, buf, len, tag);
+	}
 
 	/*
 	 * Compare the computed tag with the value from the record. It
@@ -201,12 +261,17 @@ gcm_encrypt(br_sslrec_gcm_context *cc,
 
 	buf = (unsigned char *)data;
 	len = *data_len;
-	memset(tmp, 0, sizeof tmp);
 	br_enc64be(buf - 8, cc->seq);
-	do_ctr(cc, buf - 8, buf, len, tmp);
-	do_tag(cc, record_type, version, buf, len, buf + len);
-	for (u = 0; u < 16; u ++) {
-		buf[len + u] ^= tmp[u];
+	if (cc->kern != NULL) {
+		do_kern(cc, 1, record_type, version,
+			buf - 8, buf, len, buf + len);
+	} else {
+		memset(tmp, 0, sizeof tmp);
+		do_ctr(cc, buf - 8, buf, len, tmp);
+		do_tag(cc, record_type, version, buf, len, buf + len);
+		for (u = 0; u < 16; u ++) {
+			buf[len + u] ^= tmp[u];
+		}
 	}
 	len += 24;
 	buf -= 13;
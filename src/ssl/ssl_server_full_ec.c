@@ -38,7 +38,9 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 	 *
 	 * -- Don't use 3DES if AES is available.
 	 * -- Try to have Forward Secrecy (ECDHE suite) if possible.
-	 * -- GCM is better than CBC.
+	 * -- GCM is better than ChaCha20+Poly1305, ChaCha20+Poly1305
+	 *    is better than CCM, and CCM is better than CBC (CCM_8 has
+	 *    a shorter authentication tag, and comes after CCM).
 	 * -- AES-128 is preferred over AES-256 (AES-128 is already
 	 *    strong enough, and AES-256 is 40% more expensive).
 	 *
@@ -48,6 +50,11 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 	static const uint16_t suites[] = {
 		BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
+		BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CCM,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_256_CCM,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8,
+		BR_TLS_ECDHE_ECDSA_WITH_AES_256_CCM_8,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA384,
 		BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA,
@@ -69,22 +76,6 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 		BR_TLS_ECDH_RSA_WITH_3DES_EDE_CBC_SHA
 	};
 
-	/*
-	 * All hash functions are activated.
-	 * Note: the X.509 validation engine will nonetheless refuse to
-	 * validate signatures that use MD5 as hash function.
-	 */
-	static const br_hash_class *hashes[] = {
-		&br_md5_vtable,
-		&br_sha1_vtable,
-		&br_sha224_vtable,
-		&br_sha256_vtable,
-		&br_sha384_vtable,
-		&br_sha512_vtable
-	};
-
-	int id;
-
 	/*
 	 * Reset server context and set supported versions from TLS-1.0
 	 * to TLS-1.2 (inclusive).
@@ -97,7 +88,7 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 	 */
 	br_ssl_engine_set_suites(&cc->eng, suites,
 		(sizeof suites) / (sizeof suites[0]));
-	br_ssl_engine_set_ec(&cc->eng, &br_ec_prime_i31);
+	br_ssl_engine_set_ec(&cc->eng, &br_ec_all_m32);
 
 	/*
 	 * Set the "server policy": handler for the certificate chain
@@ -106,17 +97,13 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 	br_ssl_server_set_single_ec(cc, chain, chain_len, sk,
 		BR_KEYTYPE_KEYX | BR_KEYTYPE_SIGN,
 		cert_issuer_key_type,
-		&br_ec_prime_i31, br_ecdsa_i31_sign_asn1);
+		&br_ec_p256_m32, br_ecdsa_i31_sign_asn1);
 
 	/*
-	 * Set supported hash functions.
+	 * Set supported hash functions. All hash functions are activated;
+	 * SHA-1 and SHA-224/256 use the x86 SHA opcodes when available.
 	 */
-	for (id = br_md5_ID; id <= br_sha512_ID; id ++) {
-		const br_hash_class *hc;
-
-		hc = hashes[id - 1];
-		br_ssl_engine_set_hash(&cc->eng, id, hc);
-	}
+	br_ssl_engine_set_default_hashes(&cc->eng);
 
 	/*
 	 * Set the PRF implementations.
@@ -127,28 +114,16 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 
 	/*
 	 * Symmetric encryption. We use the "constant-time"
-	 * implementations, which are the safest.
+	 * implementations, which are the safest; when the CPU supports
+	 * the AES-NI opcodes, the x86ni implementation is used instead.
 	 *
 	 * On architectures detected as "64-bit", use the 64-bit
 	 * versions (aes_ct64, ghash_ctmul64).
 	 */
-#if BR_64
-	br_ssl_engine_set_aes_cbc(&cc->eng,
-		&br_aes_ct64_cbcenc_vtable,
-		&br_aes_ct64_cbcdec_vtable);
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct64_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul64);
-#else
-	br_ssl_engine_set_aes_cbc(&cc->eng,
-		&br_aes_ct_cbcenc_vtable,
-		&br_aes_ct_cbcdec_vtable);
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul);
-#endif
+	br_ssl_engine_set_default_aes_cbc(&cc->eng);
+	br_ssl_engine_set_default_aes_gcm(&cc->eng);
+	br_ssl_engine_set_default_aes_ccm(&cc->eng);
+	br_ssl_engine_set_default_chapol(&cc->eng);
 	br_ssl_engine_set_des_cbc(&cc->eng,
 		&br_des_ct_cbcenc_vtable,
 		&br_des_ct_cbcdec_vtable);
@@ -159,6 +134,9 @@ br_ssl_server_init_full_ec(br_ssl_server_context *cc,
 	br_ssl_engine_set_cbc(&cc->eng,
 		&br_sslrec_in_cbc_vtable,
 		&br_sslrec_out_cbc_vtable);
+	br_ssl_engine_set_cbc_etm(&cc->eng,
+		&br_sslrec_in_cbc_etm_vtable,
+		&br_sslrec_out_cbc_etm_vtable);
 	br_ssl_engine_set_gcm(&cc->eng,
 		&br_sslrec_in_gcm_vtable,
 		&br_sslrec_out_gcm_vtable);
@@ -38,19 +38,26 @@ br_ssl_server_init_full_rsa(br_ssl_server_context *cc,
 	 *
 	 * -- Don't use 3DES if AES is available.
 	 * -- Try to have Forward Secrecy (ECDHE suite) if possible.
-	 * -- GCM is better than CBC.
+	 * -- GCM is better than ChaCha20+Poly1305, ChaCha20+Poly1305
+	 *    is better than CCM, and CCM is better than CBC (CCM_8 has
+	 *    a shorter authentication tag, and comes after CCM).
 	 * -- AES-128 is preferred over AES-256 (AES-128 is already
 	 *    strong enough, and AES-256 is 40% more expensive).
 	 */
 	static const uint16_t suites[] = {
 		BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
 		BR_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384,
+		BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
 		BR_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,
 		BR_TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA384,
 		BR_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA,
 		BR_TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA,
 		BR_TLS_RSA_WITH_AES_128_GCM_SHA256,
 		BR_TLS_RSA_WITH_AES_256_GCM_SHA384,
+		BR_TLS_RSA_WITH_AES_128_CCM,
+		BR_TLS_RSA_WITH_AES_256_CCM,
+		BR_TLS_RSA_WITH_AES_128_CCM_8,
+		BR_TLS_RSA_WITH_AES_256_CCM_8,
 		BR_TLS_RSA_WITH_AES_128_CBC_SHA256,
 		BR_TLS_RSA_WITH_AES_256_CBC_SHA256,
 		BR_TLS_RSA_WITH_AES_128_CBC_SHA,
@@ -59,22 +66,6 @@ br_ssl_server_init_full_rsa(br_ssl_server_context *cc,
 		BR_TLS_RSA_WITH_3DES_EDE_CBC_SHA
 	};
 
-	/*
-	 * All hash functions are activated.
-	 * Note: the X.509 validation engine will nonetheless refuse to
-	 * validate signatures that use MD5 as hash function.
-	 */
-	static const br_hash_class *hashes[] = {
-		&br_md5_vtable,
-		&br_sha1_vtable,
-		&br_sha224_vtable,
-		&br_sha256_vtable,
-		&br_sha384_vtable,
-		&br_sha512_vtable
-	};
-
-	int id;
-
 	/*
 	 * Reset server context and set supported versions from TLS-1.0
 	 * to TLS-1.2 (inclusive).
@@ -87,7 +78,7 @@ br_ssl_server_init_full_rsa(br_ssl_server_context *cc,
 	 */
 	br_ssl_engine_set_suites(&cc->eng, suites,
 		(sizeof suites) / (sizeof suites[0]));
-	br_ssl_engine_set_ec(&cc->eng, &br_ec_prime_i31);
+	br_ssl_engine_set_ec(&cc->eng, &br_ec_all_m32);
 
 	/*
 	 * Set the "server policy": handler for the certificate chain
@@ -98,14 +89,10 @@ br_ssl_server_init_full_rsa(br_ssl_server_context *cc,
 		br_rsa_i31_private, br_rsa_i31_pkcs1_sign);
 
 	/*
-	 * Set supported hash functions.
+	 * Set supported hash functions. All hash functions are activated;
+	 * SHA-1 and SHA-224/256 use the x86 SHA opcodes when available.
 	 */
-	for (id = br_md5_ID; id <= br_sha512_ID; id ++) {
-		const br_hash_class *hc;
-
-		hc = hashes[id - 1];
-		br_ssl_engine_set_hash(&cc->eng, id, hc);
-	}
+	br_ssl_engine_set_default_hashes(&cc->eng);
 
 	/*
 	 * Set the PRF implementations.
@@ -116,28 +103,16 @@ br_ssl_server_init_full_rsa(br_ssl_server_context *cc,
 
 	/*
 	 * Symmetric encryption. We use the "constant-time"
-	 * implementations, which are the safest.
+	 * implementations, which are the safest; when the CPU supports
+	 * the AES-NI opcodes, the x86ni implementation is used instead.
 	 *
 	 * On architectures detected as "64-bit", use the 64-bit
 	 * versions (aes_ct64, ghash_ctmul64).
 	 */
-#if BR_64
-	br_ssl_engine_set_aes_cbc(&cc->eng,
-		&br_aes_ct64_cbcenc_vtable,
-		&br_aes_ct64_cbcdec_vtable);
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct64_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul64);
-#else
-	br_ssl_engine_set_aes_cbc(&cc->eng,
-		&br_aes_ct_cbcenc_vtable,
-		&br_aes_ct_cbcdec_vtable);
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul);
-#endif
+	br_ssl_engine_set_default_aes_cbc(&cc->eng);
+	br_ssl_engine_set_default_aes_gcm(&cc->eng);
+	br_ssl_engine_set_default_aes_ccm(&cc->eng);
+	br_ssl_engine_set_default_chapol(&cc->eng);
 	br_ssl_engine_set_des_cbc(&cc->eng,
 		&br_des_ct_cbcenc_vtable,
 		&br_des_ct_cbcdec_vtable);
@@ -148,6 +123,9 @@ br_ssl_server_init_full_rsa(br_ssl_server_context *cc,
 	br_ssl_engine_set_cbc(&cc->eng,
 		&br_sslrec_in_cbc_vtable,
 		&br_sslrec_out_cbc_vtable);
+	br_ssl_engine_set_cbc_etm(&cc->eng,
+		&br_sslrec_in_cbc_etm_vtable,
+		&br_sslrec_out_cbc_etm_vtable);
 	br_ssl_engine_set_gcm(&cc->eng,
 		&br_sslrec_in_gcm_vtable,
 		&br_sslrec_out_gcm_vtable);
@@ -66,22 +66,13 @@ br_ssl_server_init_mine2g(br_ssl_server_context *cc,
 
 	/*
 	 * Symmetric encryption. We use the "constant-time"
-	 * implementations, which are the safest.
+	 * implementations, which are the safest; when the CPU supports
+	 * the AES-NI opcodes, the x86ni implementation is used instead.
 	 *
 	 * On architectures detected as "64-bit", use the 64-bit
 	 * versions (aes_ct64, ghash_ctmul64).
 	 */
-#if BR_64
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct64_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul64);
-#else
-	br_ssl_engine_set_aes_ctr(&cc->eng,
-		&br_aes_ct_ctr_vtable);
-	br_ssl_engine_set_ghash(&cc->eng,
-		&br_ghash_ctmul);
-#endif
+	br_ssl_engine_set_default_aes_gcm(&cc->eng);
 
 	/*
 	 * Set the SSL record engines (CBC, GCM).
@@ -71,6 +71,13 @@ sr_do_keyx(const br_ssl_server_policy_class **pctx,
 	br_ssl_server_policy_rsa_context *pc;
 
 	pc = (br_ssl_server_policy_rsa_context *)pctx;
+	if (pc->xsk != NULL) {
+		if (len < 59 || len != (pc->xsk->n_bitlen + 7) >> 3) {
+			return 0;
+		}
+		return br_rsa_ssl_decrypt_unpad(
+			br_rsa_i31_private_expanded(data, pc->xsk), data, len);
+	}
 	return br_rsa_ssl_decrypt(pc->irsacore, pc->sk, data, len);
 }
 
@@ -123,6 +130,14 @@ sr_do_sign(const br_ssl_server_policy_class **pctx,
 	} else {
 		return 0;
 	}
+	if (pc->xsk != NULL) {
+		sig_len = (pc->xsk->n_bitlen + 7) >> 3;
+		if (len < sig_len) {
+			return 0;
+		}
+		return br_rsa_i31_pkcs1_sign_expanded(hash_oid,
+			hv, hv_len, pc->xsk, data) ? sig_len : 0;
+	}
 	sig_len = (pc->sk->n_bitlen + 7) >> 3;
 	if (len < sig_len) {
 		return 0;
@@ -148,8 +163,26 @@ br_ssl_server_set_single_rsa(br_ssl_server_context *cc,
 	cc->chain_handler.single_rsa.chain = chain;
 	cc->chain_handler.single_rsa.chain_len = chain_len;
 	cc->chain_handler.single_rsa.sk = sk;
+	cc->chain_handler.single_rsa.xsk = NULL;
 	cc->chain_handler.single_rsa.allowed_usages = allowed_usages;
 	cc->chain_handler.single_rsa.irsacore = irsacore;
 	cc->chain_handler.single_rsa.irsasign = irsasign;
 	cc->policy_vtable = &cc->chain_handler.single_rsa.vtable;
 }
+
+/* see bearssl_ssl.h */
+void
+br_ssl_server_set_single_rsa_expanded(br_ssl_server_context *cc,
+	const br_x509_certificate *chain, size_t chain_len,
+	const br_rsa_i31_expanded_key *xsk, unsigned allowed_usages)
+{
+	cc->chain_handler.single_rsa.vtable = &sr_policy_vtable;
+	cc->chain_handler.single_rsa.chain = chain;
+	cc->chain_handler.single_rsa.chain_len = chain_len;
+	cc->chain_handler.single_rsa.sk = NULL;
+	cc->chain_handler.single_rsa.xsk = xsk;
+	cc->chain_handler.single_rsa.allowed_usages = allowed_usages;
+	cc->chain_handler.single_rsa.irsacore = 0;
+	cc->chain_handler.single_rsa.irsasign = 0;
+	cc->policy_vtable = &cc->chain_handler.single_rsa.vtable;
+}
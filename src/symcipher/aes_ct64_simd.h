@@ -0,0 +1,688 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * This file is not a standalone header: it contains the shared code
+ * for aes_ct64_sse2.c and aes_ct64_avx2.c, and is included by these
+ * files once the vector type and operations are defined.
+ *
+ * This is the aes_ct64 implementation (see aes_ct64.c) with each 64-bit
+ * word replaced by a SIMD register. Every 64-bit lane holds its own
+ * instance of the ct64 bitsliced representation (four blocks), so that
+ * CT64_NB blocks are processed in parallel (four per lane). All the
+ * ct64 operations are bitwise or shifts within 64-bit words, hence
+ * lane-wise; rotations of each 64-bit word by 16 or 32 bits are word
+ * shuffles. The subkeys are those of aes_ct64 (br_aes_ct64_keysched()),
+ * broadcast to all lanes.
+ *
+ * Only CTR and CBC decryption are provided: CBC encryption is serial
+ * and cannot use the extra lanes.
+ *
+ * The including file must define:
+ *
+ *   VEC              the vector type
+ *   XOR, AND, OR     bitwise operations (two operands)
+ *   NOT              bitwise negation
+ *   SHL, SHR         left and right shifts of each 64-bit word
+ *   SET64            broadcast a 64-bit constant to all words
+ *   ROT16, ROT32     rotation of each 64-bit word by 16 or 32 bits
+ *   LOADU, STOREU    unaligned load and store
+ *   CT64_NB          number of blocks processed in parallel
+ *   CT64_TARGET      the target name, for BR_TARGET()
+ *   CT64_NAME(x)     the name of the public symbol for 'x'
+ *
+ * and a supported() function that tests CPU support at runtime.
+ */
+
+#define CT64_NL       (CT64_NB >> 2)
+#define CT64_NW       (CT64_NB << 2)
+#define CT64_NBYTES   (CT64_NB << 4)
+
+BR_TARGET(CT64_TARGET)
+static void
+bitslice_Sbox(VEC *q)
+{
+	/*
+	 * Same circuit as br_aes_ct64_bitslice_Sbox().
+	 */
+
+	VEC x0, x1, x2, x3, x4, x5, x6, x7;
+	VEC y1, y2, y3, y4, y5, y6, y7, y8, y9;
+	VEC y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+	VEC y20, y21;
+	VEC z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+	VEC z10, z11, z12, z13, z14, z15, z16, z17;
+	VEC t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+	VEC t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+	VEC t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+	VEC t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+	VEC t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+	VEC t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+	VEC t60, t61, t62, t63, t64, t65, t66, t67;
+	VEC s0, s1, s2, s3, s4, s5, s6, s7;
+
+	x0 = q[7];
+	x1 = q[6];
+	x2 = q[5];
+	x3 = q[4];
+	x4 = q[3];
+	x5 = q[2];
+	x6 = q[1];
+	x7 = q[0];
+
+	/*
+	 * Top linear transformation.
+	 */
+	y14 = XOR(x3, x5);
+	y13 = XOR(x0, x6);
+	y9 = XOR(x0, x3);
+	y8 = XOR(x0, x5);
+	t0 = XOR(x1, x2);
+	y1 = XOR(t0, x7);
+	y4 = XOR(y1, x3);
+	y12 = XOR(y13, y14);
+	y2 = XOR(y1, x0);
+	y5 = XOR(y1, x6);
+	y3 = XOR(y5, y8);
+	t1 = XOR(x4, y12);
+	y15 = XOR(t1, x5);
+	y20 = XOR(t1, x1);
+	y6 = XOR(y15, x7);
+	y10 = XOR(y15, t0);
+	y11 = XOR(y20, y9);
+	y7 = XOR(x7, y11);
+	y17 = XOR(y10, y11);
+	y19 = XOR(y10, y8);
+	y16 = XOR(t0, y11);
+	y21 = XOR(y13, y16);
+	y18 = XOR(x0, y16);
+
+	/*
+	 * Non-linear section.
+	 */
+	t2 = AND(y12, y15);
+	t3 = AND(y3, y6);
+	t4 = XOR(t3, t2);
+	t5 = AND(y4, x7);
+	t6 = XOR(t5, t2);
+	t7 = AND(y13, y16);
+	t8 = AND(y5, y1);
+	t9 = XOR(t8, t7);
+	t10 = AND(y2, y7);
+	t11 = XOR(t10, t7);
+	t12 = AND(y9, y11);
+	t13 = AND(y14, y17);
+	t14 = XOR(t13, t12);
+	t15 = AND(y8, y10);
+	t16 = XOR(t15, t12);
+	t17 = XOR(t4, t14);
+	t18 = XOR(t6, t16);
+	t19 = XOR(t9, t14);
+	t20 = XOR(t11, t16);
+	t21 = XOR(t17, y20);
+	t22 = XOR(t18, y19);
+	t23 = XOR(t19, y21);
+	t24 = XOR(t20, y18);
+
+	t25 = XOR(t21, t22);
+	t26 = AND(t21, t23);
+	t27 = XOR(t24, t26);
+	t28 = AND(t25, t27);
+	t29 = XOR(t28, t22);
+	t30 = XOR(t23, t24);
+	t31 = XOR(t22, t26);
+	t32 = AND(t31, t30);
+	t33 = XOR(t32, t24);
+	t34 = XOR(t23, t33);
+	t35 = XOR(t27, t33);
+	t36 = AND(t24, t35);
+	t37 = XOR(t36, t34);
+	t38 = XOR(t27, t36);
+	t39 = AND(t29, t38);
+	t40 = XOR(t25, t39);
+
+	t41 = XOR(t40, t37);
+	t42 = XOR(t29, t33);
+	t43 = XOR(t29, t40);
+	t44 = XOR(t33, t37);
+	t45 = XOR(t42, t41);
+	z0 = AND(t44, y15);
+	z1 = AND(t37, y6);
+	z2 = AND(t33, x7);
+	z3 = AND(t43, y16);
+	z4 = AND(t40, y1);
+	z5 = AND(t29, y7);
+	z6 = AND(t42, y11);
+	z7 = AND(t45, y17);
+	z8 = AND(t41, y10);
+	z9 = AND(t44, y12);
+	z10 = AND(t37, y3);
+	z11 = AND(t33, y4);
+	z12 = AND(t43, y13);
+	z13 = AND(t40, y5);
+	z14 = AND(t29, y2);
+	z15 = AND(t42, y9);
+	z16 = AND(t45, y14);
+	z17 = AND(t41, y8);
+
+	/*
+	 * Bottom linear transformation.
+	 */
+	t46 = XOR(z15, z16);
+	t47 = XOR(z10, z11);
+	t48 = XOR(z5, z13);
+	t49 = XOR(z9, z10);
+	t50 = XOR(z2, z12);
+	t51 = XOR(z2, z5);
+	t52 = XOR(z7, z8);
+	t53 = XOR(z0, z3);
+	t54 = XOR(z6, z7);
+	t55 = XOR(z16, z17);
+	t56 = XOR(z12, t48);
+	t57 = XOR(t50, t53);
+	t58 = XOR(z4, t46);
+	t59 = XOR(z3, t54);
+	t60 = XOR(t46, t57);
+	t61 = XOR(z14, t57);
+	t62 = XOR(t52, t58);
+	t63 = XOR(t49, t58);
+	t64 = XOR(z4, t59);
+	t65 = XOR(t61, t62);
+	t66 = XOR(z1, t63);
+	s0 = XOR(t59, t63);
+	s6 = XOR(t56, NOT(t62));
+	s7 = XOR(t48, NOT(t60));
+	t67 = XOR(t64, t65);
+	s3 = XOR(t53, t66);
+	s4 = XOR(t51, t66);
+	s5 = XOR(t47, t65);
+	s1 = XOR(t64, NOT(s3));
+	s2 = XOR(t55, NOT(t67));
+
+	q[7] = s0;
+	q[6] = s1;
+	q[5] = s2;
+	q[4] = s3;
+	q[3] = s4;
+	q[2] = s5;
+	q[1] = s6;
+	q[0] = s7;
+}
+
+/*
+ * Linear layer around the S-box for the inverse S-box; see
+ * br_aes_ct64_bitslice_invSbox().
+ */
+BR_TARGET(CT64_TARGET)
+static void
+inv_affine(VEC *q)
+{
+	VEC q0, q1, q2, q3, q4, q5, q6, q7;
+
+	q0 = NOT(q[0]);
+	q1 = NOT(q[1]);
+	q2 = q[2];
+	q3 = q[3];
+	q4 = q[4];
+	q5 = NOT(q[5]);
+	q6 = NOT(q[6]);
+	q7 = q[7];
+	q[7] = XOR(XOR(q1, q4), q6);
+	q[6] = XOR(XOR(q0, q3), q5);
+	q[5] = XOR(XOR(q7, q2), q4);
+	q[4] = XOR(XOR(q6, q1), q3);
+	q[3] = XOR(XOR(q5, q0), q2);
+	q[2] = XOR(XOR(q4, q7), q1);
+	q[1] = XOR(XOR(q3, q6), q0);
+	q[0] = XOR(XOR(q2, q5), q7);
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+bitslice_invSbox(VEC *q)
+{
+	inv_affine(q);
+	bitslice_Sbox(q);
+	inv_affine(q);
+}
+
+/*
+ * Same as br_aes_ct64_ortho(), in each 64-bit lane.
+ */
+BR_TARGET(CT64_TARGET)
+static void
+ortho(VEC *q)
+{
+#define SWAPN(cl, ch, s, x, y)   do { \
+		VEC a, b; \
+		a = (x); \
+		b = (y); \
+		(x) = OR(AND(a, SET64(cl)), SHL(AND(b, SET64(cl)), s)); \
+		(y) = OR(SHR(AND(a, SET64(ch)), s), AND(b, SET64(ch))); \
+	} while (0)
+
+#define SWAP2(x, y)    SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA,  1, x, y)
+#define SWAP4(x, y)    SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC,  2, x, y)
+#define SWAP8(x, y)    SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0,  4, x, y)
+
+	SWAP2(q[0], q[1]);
+	SWAP2(q[2], q[3]);
+	SWAP2(q[4], q[5]);
+	SWAP2(q[6], q[7]);
+
+	SWAP4(q[0], q[2]);
+	SWAP4(q[1], q[3]);
+	SWAP4(q[4], q[6]);
+	SWAP4(q[5], q[7]);
+
+	SWAP8(q[0], q[4]);
+	SWAP8(q[1], q[5]);
+	SWAP8(q[2], q[6]);
+	SWAP8(q[3], q[7]);
+
+#undef SWAP8
+#undef SWAP4
+#undef SWAP2
+#undef SWAPN
+}
+
+/*
+ * Convert CT64_NB blocks (CT64_NW words, decoded with little-endian
+ * convention) into the bitsliced representation. Lane j receives blocks
+ * 4*j to 4*j+3.
+ */
+BR_TARGET(CT64_TARGET)
+static void
+load_blocks(VEC *q, const uint32_t *w)
+{
+	uint64_t t[8][CT64_NL];
+	int i, j;
+
+	for (j = 0; j < CT64_NL; j ++) {
+		for (i = 0; i < 4; i ++) {
+			br_aes_ct64_interleave_in(&t[i][j], &t[i + 4][j],
+				w + (j << 4) + (i << 2));
+		}
+	}
+	for (i = 0; i < 8; i ++) {
+		q[i] = LOADU((const void *)t[i]);
+	}
+	ortho(q);
+}
+
+/*
+ * Perform the opposite of load_blocks(). The q[] array is modified.
+ */
+BR_TARGET(CT64_TARGET)
+static void
+store_blocks(uint32_t *w, VEC *q)
+{
+	uint64_t t[8][CT64_NL];
+	int i, j;
+
+	ortho(q);
+	for (i = 0; i < 8; i ++) {
+		STOREU((void *)t[i], q[i]);
+	}
+	for (j = 0; j < CT64_NL; j ++) {
+		for (i = 0; i < 4; i ++) {
+			br_aes_ct64_interleave_out(w + (j << 4) + (i << 2),
+				t[i][j], t[i + 4][j]);
+		}
+	}
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+add_round_key(VEC *q, const uint64_t *sk)
+{
+	int i;
+
+	for (i = 0; i < 8; i ++) {
+		q[i] = XOR(q[i], SET64(sk[i]));
+	}
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+shift_rows(VEC *q)
+{
+	int i;
+
+	for (i = 0; i < 8; i ++) {
+		VEC x;
+
+		x = q[i];
+		q[i] = OR(OR(OR(AND(x, SET64(0x000000000000FFFF)),
+			SHR(AND(x, SET64(0x00000000FFF00000)), 4)),
+			OR(SHL(AND(x, SET64(0x00000000000F0000)), 12),
+			SHR(AND(x, SET64(0x0000FF0000000000)), 8))),
+			OR(OR(SHL(AND(x, SET64(0x000000FF00000000)), 8),
+			SHR(AND(x, SET64(0xF000000000000000)), 12)),
+			SHL(AND(x, SET64(0x0FFF000000000000)), 4)));
+	}
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+inv_shift_rows(VEC *q)
+{
+	int i;
+
+	for (i = 0; i < 8; i ++) {
+		VEC x;
+
+		x = q[i];
+		q[i] = OR(OR(OR(AND(x, SET64(0x000000000000FFFF)),
+			SHL(AND(x, SET64(0x000000000FFF0000)), 4)),
+			OR(SHR(AND(x, SET64(0x00000000F0000000)), 12),
+			SHL(AND(x, SET64(0x000000FF00000000)), 8))),
+			OR(OR(SHR(AND(x, SET64(0x0000FF0000000000)), 8),
+			SHL(AND(x, SET64(0x000F000000000000)), 12)),
+			SHR(AND(x, SET64(0xFFF0000000000000)), 4)));
+	}
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+mix_columns(VEC *q)
+{
+	VEC q0, q1, q2, q3, q4, q5, q6, q7;
+	VEC r0, r1, r2, r3, r4, r5, r6, r7;
+	VEC t;
+
+	q0 = q[0];
+	q1 = q[1];
+	q2 = q[2];
+	q3 = q[3];
+	q4 = q[4];
+	q5 = q[5];
+	q6 = q[6];
+	q7 = q[7];
+	r0 = ROT16(q0);
+	r1 = ROT16(q1);
+	r2 = ROT16(q2);
+	r3 = ROT16(q3);
+	r4 = ROT16(q4);
+	r5 = ROT16(q5);
+	r6 = ROT16(q6);
+	r7 = ROT16(q7);
+
+	t = XOR(q0, r0);
+	q[0] = XOR(XOR(XOR(q7, r7), r0), ROT32(t));
+	t = XOR(q1, r1);
+	q[1] = XOR(XOR(XOR(XOR(XOR(q0, r0), q7), r7), r1), ROT32(t));
+	t = XOR(q2, r2);
+	q[2] = XOR(XOR(XOR(q1, r1), r2), ROT32(t));
+	t = XOR(q3, r3);
+	q[3] = XOR(XOR(XOR(XOR(XOR(q2, r2), q7), r7), r3), ROT32(t));
+	t = XOR(q4, r4);
+	q[4] = XOR(XOR(XOR(XOR(XOR(q3, r3), q7), r7), r4), ROT32(t));
+	t = XOR(q5, r5);
+	q[5] = XOR(XOR(XOR(q4, r4), r5), ROT32(t));
+	t = XOR(q6, r6);
+	q[6] = XOR(XOR(XOR(q5, r5), r6), ROT32(t));
+	t = XOR(q7, r7);
+	q[7] = XOR(XOR(XOR(q6, r6), r7), ROT32(t));
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+inv_mix_columns(VEC *q)
+{
+	VEC q0, q1, q2, q3, q4, q5, q6, q7;
+	VEC r0, r1, r2, r3, r4, r5, r6, r7;
+	VEC t;
+
+	q0 = q[0];
+	q1 = q[1];
+	q2 = q[2];
+	q3 = q[3];
+	q4 = q[4];
+	q5 = q[5];
+	q6 = q[6];
+	q7 = q[7];
+	r0 = ROT16(q0);
+	r1 = ROT16(q1);
+	r2 = ROT16(q2);
+	r3 = ROT16(q3);
+	r4 = ROT16(q4);
+	r5 = ROT16(q5);
+	r6 = ROT16(q6);
+	r7 = ROT16(q7);
+
+	t = XOR(XOR(XOR(XOR(q0, q5), q6), r0), r5);
+	q[0] = XOR(XOR(XOR(XOR(q5, q6), q7),
+		XOR(XOR(r0, r5), r7)), ROT32(t));
+	t = XOR(XOR(XOR(q1, q5), q7),
+		XOR(XOR(r1, r5), r6));
+	q[1] = XOR(XOR(XOR(XOR(q0, q5), r0),
+		XOR(XOR(XOR(r1, r5), r6), r7)), ROT32(t));
+	t = XOR(XOR(XOR(q0, q2), q6),
+		XOR(XOR(r2, r6), r7));
+	q[2] = XOR(XOR(XOR(XOR(q0, q1), q6),
+		XOR(XOR(XOR(r1, r2), r6), r7)), ROT32(t));
+	t = XOR(XOR(XOR(XOR(XOR(q0, q1), q3), q5), q6),
+		XOR(XOR(XOR(XOR(q7, r0), r3), r5), r7));
+	q[3] = XOR(XOR(XOR(XOR(XOR(q0, q1), q2), q5),
+		XOR(XOR(XOR(XOR(q6, r0), r2), r3), r5)), ROT32(t));
+	t = XOR(XOR(XOR(XOR(q1, q2), q4), q5),
+		XOR(XOR(XOR(XOR(q7, r1), r4), r5), r6));
+	q[4] = XOR(XOR(XOR(XOR(XOR(XOR(q1, q2), q3), q5), r1),
+		XOR(XOR(XOR(XOR(r3, r4), r5), r6), r7)), ROT32(t));
+	t = XOR(XOR(XOR(XOR(q2, q3), q5), q6),
+		XOR(XOR(XOR(r2, r5), r6), r7));
+	q[5] = XOR(XOR(XOR(XOR(XOR(q2, q3), q4), q6),
+		XOR(XOR(XOR(XOR(r2, r4), r5), r6), r7)), ROT32(t));
+	t = XOR(XOR(XOR(q3, q4), q6),
+		XOR(XOR(XOR(q7, r3), r6), r7));
+	q[6] = XOR(XOR(XOR(XOR(XOR(q3, q4), q5), q7),
+		XOR(XOR(XOR(r3, r5), r6), r7)), ROT32(t));
+	t = XOR(XOR(XOR(XOR(q4, q5), q7), r4), r7);
+	q[7] = XOR(XOR(XOR(XOR(q4, q5), q6),
+		XOR(XOR(r4, r6), r7)), ROT32(t));
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+bitslice_encrypt(unsigned num_rounds, const uint64_t *skey, VEC *q)
+{
+	unsigned u;
+
+	add_round_key(q, skey);
+	for (u = 1; u < num_rounds; u ++) {
+		bitslice_Sbox(q);
+		shift_rows(q);
+		mix_columns(q);
+		add_round_key(q, skey + (u << 3));
+	}
+	bitslice_Sbox(q);
+	shift_rows(q);
+	add_round_key(q, skey + (num_rounds << 3));
+}
+
+BR_TARGET(CT64_TARGET)
+static void
+bitslice_decrypt(unsigned num_rounds, const uint64_t *skey, VEC *q)
+{
+	unsigned u;
+
+	add_round_key(q, skey + (num_rounds << 3));
+	for (u = num_rounds - 1; u > 0; u --) {
+		inv_shift_rows(q);
+		bitslice_invSbox(q);
+		add_round_key(q, skey + (u << 3));
+		inv_mix_columns(q);
+	}
+	inv_shift_rows(q);
+	bitslice_invSbox(q);
+	add_round_key(q, skey);
+}
+
+/* see bearssl_block.h */
+const br_block_ctr_class *
+CT64_NAME(ctr_get_vtable)(void)
+{
+	return supported() ? &CT64_NAME(ctr_vtable) : NULL;
+}
+
+/* see bearssl_block.h */
+const br_block_cbcdec_class *
+CT64_NAME(cbcdec_get_vtable)(void)
+{
+	return supported() ? &CT64_NAME(cbcdec_vtable) : NULL;
+}
+
+/* see bearssl_block.h */
+void
+CT64_NAME(ctr_init)(CT64_NAME(ctr_keys) *ctx,
+	const void *key, size_t len)
+{
+	ctx->vtable = &CT64_NAME(ctr_vtable);
+	ctx->num_rounds = br_aes_ct64_keysched(ctx->skey, key, len);
+}
+
+/* see bearssl_block.h */
+void
+CT64_NAME(cbcdec_init)(CT64_NAME(cbcdec_keys) *ctx,
+	const void *key, size_t len)
+{
+	ctx->vtable = &CT64_NAME(cbcdec_vtable);
+	ctx->num_rounds = br_aes_ct64_keysched(ctx->skey, key, len);
+}
+
+/* see bearssl_block.h */
+BR_TARGET(CT64_TARGET)
+uint32_t
+CT64_NAME(ctr_run)(const CT64_NAME(ctr_keys) *ctx,
+	const void *iv, uint32_t cc, void *data, size_t len)
+{
+	unsigned char *buf;
+	uint32_t ivw[CT64_NW];
+	uint64_t sk_exp[240];
+	int i;
+
+	br_aes_ct64_skey_expand(sk_exp, ctx->num_rounds, ctx->skey);
+	br_range_dec32le(ivw, 3, iv);
+	for (i = 4; i < CT64_NW; i += 4) {
+		memcpy(ivw + i, ivw, 3 * sizeof(uint32_t));
+	}
+	buf = data;
+	while (len > 0) {
+		VEC q[8];
+		uint32_t w[CT64_NW];
+		unsigned char tmp[CT64_NBYTES];
+		size_t u;
+
+		memcpy(w, ivw, sizeof ivw);
+		for (i = 0; i < CT64_NB; i ++) {
+			w[(i << 2) + 3] = br_swap32(cc + (uint32_t)i);
+		}
+		load_blocks(q, w);
+		bitslice_encrypt(ctx->num_rounds, sk_exp, q);
+		store_blocks(w, q);
+		br_range_enc32le(tmp, w, CT64_NW);
+		if (len < CT64_NBYTES) {
+			for (u = 0; u < len; u ++) {
+				buf[u] ^= tmp[u];
+			}
+			cc += (uint32_t)len >> 4;
+			break;
+		}
+		for (u = 0; u < CT64_NBYTES; u += sizeof(VEC)) {
+			STOREU((void *)(buf + u),
+				XOR(LOADU((const void *)(buf + u)),
+				LOADU((const void *)(tmp + u))));
+		}
+		buf += CT64_NBYTES;
+		len -= CT64_NBYTES;
+		cc += CT64_NB;
+	}
+	return cc;
+}
+
+/* see bearssl_block.h */
+BR_TARGET(CT64_TARGET)
+void
+CT64_NAME(cbcdec_run)(const CT64_NAME(cbcdec_keys) *ctx,
+	void *iv, void *data, size_t len)
+{
+	unsigned char *buf;
+	uint64_t sk_exp[240];
+	uint32_t ivw[4];
+
+	br_aes_ct64_skey_expand(sk_exp, ctx->num_rounds, ctx->skey);
+	br_range_dec32le(ivw, 4, iv);
+	buf = data;
+	while (len > 0) {
+		VEC q[8];
+		uint32_t w1[CT64_NW], w2[CT64_NW];
+		size_t clen;
+		int i, j;
+
+		clen = len < CT64_NBYTES ? len : CT64_NBYTES;
+		j = (int)(clen >> 2);
+		br_range_dec32le(w1, j, buf);
+		if (j < CT64_NW) {
+			memset(w1 + j, 0, (CT64_NW - j) * sizeof(uint32_t));
+		}
+		load_blocks(q, w1);
+		bitslice_decrypt(ctx->num_rounds, sk_exp, q);
+		store_blocks(w2, q);
+		for (i = 0; i < 4; i ++) {
+			w2[i] ^= ivw[i];
+		}
+		for (i = 4; i < j; i ++) {
+			w2[i] ^= w1[i - 4];
+		}
+		memcpy(ivw, w1 + j - 4, sizeof ivw);
+		br_range_enc32le(buf, w2, j);
+		buf += clen;
+		len -= clen;
+	}
+	br_range_enc32le(iv, ivw, 4);
+}
+
+/* see bearssl_block.h */
+const br_block_ctr_class CT64_NAME(ctr_vtable) = {
+	sizeof(CT64_NAME(ctr_keys)),
+	16,
+	4,
+	(void (*)(const br_block_ctr_class **, const void *, size_t))
+		&CT64_NAME(ctr_init),
+	(uint32_t (*)(const br_block_ctr_class *const *,
+		const void *, uint32_t, void *, size_t))
+		&CT64_NAME(ctr_run)
+};
+
+/* see bearssl_block.h */
+const br_block_cbcdec_class CT64_NAME(cbcdec_vtable) = {
+	sizeof(CT64_NAME(cbcdec_keys)),
+	16,
+	4,
+	(void (*)(const br_block_cbcdec_class **, const void *, size_t))
+		&CT64_NAME(cbcdec_init),
+	(void (*)(const br_block_cbcdec_class *const *, void *, void *, size_t))
+		&CT64_NAME(cbcdec_run)
+};
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+#if BR_SSE2
+
+#include <emmintrin.h>
+
+/*
+ * 128-bit variant of the vectorized aes_ct64 code: 8 blocks are processed
+ * in parallel. See aes_ct64_simd.h for the shared code.
+ */
+
+#define VEC           __m128i
+#define XOR(x, y)     _mm_xor_si128(x, y)
+#define AND(x, y)     _mm_and_si128(x, y)
+#define OR(x, y)      _mm_or_si128(x, y)
+#define NOT(x)        _mm_xor_si128(x, _mm_set1_epi32(-1))
+#define SHL(x, n)     _mm_slli_epi64(x, n)
+#define SHR(x, n)     _mm_srli_epi64(x, n)
+#define SET64(x)      _mm_set1_epi64x((long long)(x))
+#define ROT16(x)      _mm_shufflehi_epi16( \
+		_mm_shufflelo_epi16(x, 0x39), 0x39)
+#define ROT32(x)      _mm_shuffle_epi32(x, 0xB1)
+#define LOADU(p)      _mm_loadu_si128(p)
+#define STOREU(p, x)  _mm_storeu_si128(p, x)
+
+#define CT64_NB       8
+#define CT64_TARGET   "sse2"
+#define CT64_NAME(x)  br_aes_ct64_sse2_ ## x
+
+static int
+supported(void)
+{
+	/*
+	 * Bit mask for features in EDX:
+	 *   26   SSE2
+	 */
+	return br_cpuid(0, 0, 0, 0x04000000);
+}
+
+#include "aes_ct64_simd.h"
+
+#else
+
+/* see bearssl_block.h */
+const br_block_ctr_class *
+br_aes_ct64_sse2_ctr_get_vtable(void)
+{
+	return NULL;
+}
+
+/* see bearssl_block.h */
+const br_block_cbcdec_class *
+br_aes_ct64_sse2_cbcdec_get_vtable(void)
+{
+	return NULL;
+}
+
+#endif
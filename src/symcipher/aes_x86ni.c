@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This code contains the AES key schedule implementation using the
+ * AES-NI opcodes.
+ */
+
+#if BR_AES_X86NI
+
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+/* see inner.h */
+int
+br_aes_x86ni_supported(void)
+{
+	/*
+	 * Bit mask for features in ECX:
+	 *   25   AES-NI
+	 * Bit mask for features in EDX:
+	 *   26   SSE2
+	 */
+	return br_cpuid(0, 0, 0x02000000, 0x04000000);
+}
+
+static const uint32_t Rcon[] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36
+};
+
+/*
+ * Apply the AES S-box on each byte of a 32-bit word. We use the
+ * aeskeygenassist opcode, which computes SubWord() on the second and
+ * fourth words of its input; this is constant-time.
+ */
+BR_TARGET("sse2,aes")
+static uint32_t
+SubWord(uint32_t x)
+{
+	__m128i t;
+
+	t = _mm_aeskeygenassist_si128(_mm_set1_epi32((int)x), 0);
+	return (uint32_t)_mm_cvtsi128_si32(t);
+}
+
+/*
+ * Compute the key schedule, as a sequence of 32-bit words. Words
+ * use little-endian convention, since this matches the in-memory
+ * layout expected by the AES-NI opcodes.
+ */
+static unsigned
+keysched_words(uint32_t *skey, const void *key, size_t len)
+{
+	unsigned num_rounds;
+	int i, j, k, nk, nkf;
+	uint32_t tmp;
+
+	switch (len) {
+	case 16:
+		num_rounds = 10;
+		break;
+	case 24:
+		num_rounds = 12;
+		break;
+	case 32:
+		num_rounds = 14;
+		break;
+	default:
+		/* abort(); */
+		return 0;
+	}
+	nk = (int)(len >> 2);
+	nkf = (int)((num_rounds + 1) << 2);
+	br_range_dec32le(skey, nk, key);
+	tmp = skey[nk - 1];
+	for (i = nk, j = 0, k = 0; i < nkf; i ++) {
+		if (j == 0) {
+			tmp = (tmp << 24) | (tmp >> 8);
+			tmp = SubWord(tmp) ^ Rcon[k];
+		} else if (nk > 6 && j == 4) {
+			tmp = SubWord(tmp);
+		}
+		tmp ^= skey[i - nk];
+		skey[i] = tmp;
+		if (++ j == nk) {
+			j = 0;
+			k ++;
+		}
+	}
+	return num_rounds;
+}
+
+/* see inner.h */
+unsigned
+br_aes_x86ni_keysched_enc(unsigned char *skni, const void *key, size_t len)
+{
+	uint32_t skey[60];
+	unsigned num_rounds;
+
+	num_rounds = keysched_words(skey, key, len);
+	br_range_enc32le(skni, skey, (num_rounds + 1) << 2);
+	return num_rounds;
+}
+
+/* see inner.h */
+BR_TARGET("sse2,aes")
+unsigned
+br_aes_x86ni_keysched_dec(unsigned char *skni, const void *key, size_t len)
+{
+	uint32_t skey[60];
+	unsigned char tmp[16 * 15];
+	unsigned u, num_rounds;
+
+	/*
+	 * Decryption uses the "equivalent inverse cipher": subkeys are
+	 * used in reverse order, and InvMixColumns is applied on all
+	 * subkeys except the first and the last one.
+	 */
+	num_rounds = keysched_words(skey, key, len);
+	br_range_enc32le(tmp, skey, (num_rounds + 1) << 2);
+	memcpy(skni, tmp + (num_rounds << 4), 16);
+	for (u = 1; u < num_rounds; u ++) {
+		__m128i k;
+
+		k = _mm_loadu_si128((void *)(tmp + ((num_rounds - u) << 4)));
+		k = _mm_aesimc_si128(k);
+		_mm_storeu_si128((void *)(skni + (u << 4)), k);
+	}
+	memcpy(skni + (num_rounds << 4), tmp, 16);
+	return num_rounds;
+}
+
+#endif
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This file implements a CBC+HMAC kernel (stitched AES/CBC encryption
+ * and SHA-1 or SHA-256 hashing) with the AES-NI and SHA opcodes. Both
+ * CBC encryption and the hash compression function are long chains of
+ * dependent high-latency operations; each loop iteration below
+ * processes one 64-byte hash block and four AES blocks, with the AES
+ * blocks interspersed within the hash rounds, so that the two chains
+ * are executed in parallel. The hash round code is shared with
+ * sha1_x86ni.c and sha2small_x86ni.c (see hash/sha_x86ni.h).
+ *
+ * The hashed and encrypted data are the same bytes, but the stitched
+ * loop works on two distinct 64-byte areas: with MAC-then-encrypt,
+ * hashing runs at least one block ahead of encryption (which modifies
+ * the data in place); with Encrypt-then-MAC, it runs at least one
+ * block behind. The hash is first brought to a block boundary with
+ * the normal update() function, and the remaining bytes are processed
+ * without stitching.
+ */
+
+#if BR_AES_X86NI && BR_SHA_X86NI
+
+#include <immintrin.h>
+
+#include "hash/sha_x86ni.h"
+
+/* see bearssl_ssl.h */
+const br_cbc_hmac_kernel_class *
+br_aes_x86ni_cbc_hmac_kernel_get(void)
+{
+	/*
+	 * Bit mask for features in ECX:
+	 *    9   SSSE3
+	 *   19   SSE4.1
+	 * Bit mask for features in EBX (leaf 7):
+	 *   29   SHA
+	 */
+	if (br_aes_x86ni_supported()
+		&& br_cpuid(0, 0, 0x00080200, 0)
+		&& br_cpuid7(0x20000000, 0))
+	{
+		return &br_aes_x86ni_cbc_hmac_kernel;
+	}
+	return NULL;
+}
+
+/*
+ * Encrypt one block at address p, with the CBC chaining value in ivx.
+ */
+#define AES_BLOCK(p)   do { \
+		__m128i x; \
+		unsigned r; \
+ \
+		x = _mm_xor_si128(_mm_loadu_si128((void *)(p)), ivx); \
+		x = _mm_xor_si128(x, sk[0]); \
+		for (r = 1; r < num_rounds; r ++) { \
+			x = _mm_aesenc_si128(x, sk[r]); \
+		} \
+		ivx = _mm_aesenclast_si128(x, sk[num_rounds]); \
+		_mm_storeu_si128((void *)(p), ivx); \
+	} while (0)
+
+/*
+ * Hash num 64-byte blocks from hbuf (SHA-1), and encrypt num 64-byte
+ * chunks at cbuf (AES/CBC). The two areas must not overlap within an
+ * iteration.
+ */
+BR_TARGET("ssse3,sse4.1,aes,sha")
+static void
+sha1_cbc_stitch(uint32_t *val, const unsigned char *hbuf,
+	const br_aes_x86ni_cbcenc_keys *ctx, void *iv,
+	unsigned char *cbuf, size_t num)
+{
+	__m128i abcd, abcd_save, abcd_prev, e0, e, bswap, ivx;
+	__m128i m[4], sk[15];
+	unsigned u, num_rounds;
+
+	num_rounds = ctx->num_rounds;
+	for (u = 0; u <= num_rounds; u ++) {
+		sk[u] = _mm_loadu_si128((void *)(ctx->skey.skni + (u << 4)));
+	}
+	ivx = _mm_loadu_si128(iv);
+	abcd = _mm_loadu_si128((const __m128i *)val);
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	e0 = _mm_set_epi32((int)val[4], 0, 0, 0);
+	bswap = _mm_set_epi64x(0x0001020304050607, 0x08090A0B0C0D0E0F);
+
+	while (num -- > 0) {
+		abcd_save = abcd;
+		m[0] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(hbuf +  0)), bswap);
+		m[1] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(hbuf + 16)), bswap);
+		m[2] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(hbuf + 32)), bswap);
+		m[3] = _mm_shuffle_epi8(_mm_loadu_si128(
+			(const __m128i *)(hbuf + 48)), bswap);
+
+		AES_BLOCK(cbuf);
+		SHA1_ROUNDS4( 0, 0);
+		SHA1_ROUNDS4( 1, 0);
+		SHA1_ROUNDS4( 2, 0);
+		SHA1_ROUNDS4( 3, 0);
+		SHA1_ROUNDS4( 4, 0);
+		AES_BLOCK(cbuf + 16);
+		SHA1_ROUNDS4( 5, 1);
+		SHA1_ROUNDS4( 6, 1);
+		SHA1_ROUNDS4( 7, 1);
+		SHA1_ROUNDS4( 8, 1);
+		SHA1_ROUNDS4( 9, 1);
+		AES_BLOCK(cbuf + 32);
+		SHA1_ROUNDS4(10, 2);
+		SHA1_ROUNDS4(11, 2);
+		SHA1_ROUNDS4(12, 2);
+		SHA1_ROUNDS4(13, 2);
+		SHA1_ROUNDS4(14, 2);
+		AES_BLOCK(cbuf + 48);
+		SHA1_ROUNDS4(15, 3);
+		SHA1_ROUNDS4(16, 3);
+		SHA1_ROUNDS4(17, 3);
+		SHA1_ROUNDS4(18, 3);
+		SHA1_ROUNDS4(19, 3);
+
+		e0 = _mm_sha1nexte_epu32(abcd_prev, e0);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+		hbuf += 64;
+		cbuf += 64;
+	}
+
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	_mm_storeu_si128((__m128i *)val, abcd);
+	val[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+	_mm_storeu_si128(iv, ivx);
+}
+
+/*
+ * Same as sha1_cbc_stitch(), for SHA-224 and SHA-256.
+ */
+BR_TARGET("ssse3,sse4.1,aes,sha")
+static void
+sha256_cbc_stitch(uint32_t *val, const unsigned char *hbuf,
+	const br_aes_x86ni_cbcenc_keys *ctx, void *iv,
+	unsigned char *cbuf, size_t num)
+{
+	__m128i abef, cdgh, abef_save, cdgh_save, bswap, ivx;
+	__m128i m[4], sk[15];
+	unsigned u, num_rounds;
+	int i;
+
+	num_rounds = ctx->num_rounds;
+	for (u = 0; u <= num_rounds; u ++) {
+		sk[u] = _mm_loadu_si128((void *)(ctx->skey.skni + (u << 4)));
+	}
+	ivx = _mm_loadu_si128(iv);
+	sha256_x86ni_load_state(val, &abef, &cdgh);
+	bswap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+
+	while (num -- > 0) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+		for (i = 0; i < 16; i ++) {
+			if ((i & 3) == 0) {
+				AES_BLOCK(cbuf + (i << 2));
+			}
+			SHA256_ROUNDS4(abef, cdgh, m, hbuf, i);
+		}
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+		hbuf += 64;
+		cbuf += 64;
+	}
+
+	sha256_x86ni_store_state(val, abef, cdgh);
+	_mm_storeu_si128(iv, ivx);
+}
+
+#undef AES_BLOCK
+
+typedef void (*stitch_fn)(uint32_t *val, const unsigned char *hbuf,
+	const br_aes_x86ni_cbcenc_keys *ctx, void *iv,
+	unsigned char *cbuf, size_t num);
+
+/*
+ * Get the stitched function for the hash context, and pointers to the
+ * state words and byte counter in that context.
+ */
+static stitch_fn
+get_stitch(const br_hash_class **hc, uint32_t **val, uint64_t **count)
+{
+	if (br_digest_id(*hc) == br_sha1_ID) {
+		br_sha1_context *sc;
+
+		sc = (br_sha1_context *)hc;
+		*val = sc->val;
+		*count = &sc->count;
+		return &sha1_cbc_stitch;
+	} else {
+		br_sha224_context *sc;
+
+		sc = (br_sha224_context *)hc;
+		*val = sc->val;
+		*count = &sc->count;
+		return &sha256_cbc_stitch;
+	}
+}
+
+static void
+cbc_mac_encrypt(const br_aes_x86ni_cbcenc_keys *ctx, void *iv,
+	const br_hash_class **hc, void *data, size_t len)
+{
+	unsigned char *buf;
+	uint32_t *val;
+	uint64_t *count;
+	stitch_fn sf;
+	size_t n0, num, h, e;
+
+	buf = data;
+	sf = get_stitch(hc, &val, &count);
+	n0 = (size_t)(-*count) & 63;
+	if (len < n0 + 128) {
+		(*hc)->update(hc, buf, len);
+		br_aes_x86ni_cbcenc_run(ctx, iv, buf, len);
+		return;
+	}
+
+	/*
+	 * Hashing must stay ahead of encryption: we bring the hash to a
+	 * block boundary, and hash one extra block.
+	 */
+	h = n0 + 64;
+	(*hc)->update(hc, buf, h);
+	num = (len - h) >> 6;
+	sf(val, buf + h, ctx, iv, buf, num);
+	*count += (uint64_t)num << 6;
+	h += num << 6;
+	e = num << 6;
+	(*hc)->update(hc, buf + h, len - h);
+	br_aes_x86ni_cbcenc_run(ctx, iv, buf + e, len - e);
+}
+
+static void
+cbc_encrypt_mac(const br_aes_x86ni_cbcenc_keys *ctx, void *iv,
+	const br_hash_class **hc, void *data, size_t len)
+{
+	unsigned char *buf;
+	uint32_t *val;
+	uint64_t *count;
+	stitch_fn sf;
+	size_t n0, num, h, e;
+
+	buf = data;
+	sf = get_stitch(hc, &val, &count);
+	n0 = (size_t)(-*count) & 63;
+	if (len < n0 + 128) {
+		br_aes_x86ni_cbcenc_run(ctx, iv, buf, len);
+		(*hc)->update(hc, buf, len);
+		return;
+	}
+
+	/*
+	 * Encryption must stay ahead of hashing: we encrypt at least
+	 * one block more than what is needed to bring the hash to a
+	 * block boundary.
+	 */
+	e = (n0 + 64 + 15) & ~(size_t)15;
+	br_aes_x86ni_cbcenc_run(ctx, iv, buf, e);
+	h = n0;
+	(*hc)->update(hc, buf, h);
+	num = (len - e) >> 6;
+	sf(val, buf + h, ctx, iv, buf + e, num);
+	*count += (uint64_t)num << 6;
+	h += num << 6;
+	e += num << 6;
+	br_aes_x86ni_cbcenc_run(ctx, iv, buf + e, len - e);
+	(*hc)->update(hc, buf + h, len - h);
+}
+
+/* see bearssl_ssl.h */
+const br_cbc_hmac_kernel_class br_aes_x86ni_cbc_hmac_kernel = {
+	&br_aes_x86ni_cbcenc_vtable,
+	((uint32_t)1 << br_sha1_ID)
+		| ((uint32_t)1 << br_sha224_ID)
+		| ((uint32_t)1 << br_sha256_ID),
+	(void (*)(const br_block_cbcenc_class *const *, void *,
+		const br_hash_class **, void *, size_t))
+		&cbc_mac_encrypt,
+	(void (*)(const br_block_cbcenc_class *const *, void *,
+		const br_hash_class **, void *, size_t))
+		&cbc_encrypt_mac
+};
+
+#else
+
+/* see bearssl_ssl.h */
+const br_cbc_hmac_kernel_class *
+br_aes_x86ni_cbc_hmac_kernel_get(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "inner.h"
+
+/*
+ * This file implements a GCM kernel (fused CTR encryption and GHASH)
+ * with the AES-NI and pclmulqdq opcodes. Data is processed by chunks of
+ * four blocks: the four AES computations and the four carry-less
+ * multiplications of a chunk are independent of each other, and are
+ * interleaved by the CPU. The GHASH computation follows the same
+ * strategy as ghash_pclmul.c (byte-swapped inputs, aggregated
+ * reduction with precomputed powers of H), and shares its field
+ * multiplication code (ghash_pclmul.h).
+ */
+
+#if BR_AES_X86NI
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "hash/ghash_pclmul.h"
+
+/* see bearssl_block.h */
+const br_gcm_kernel_class *
+br_aes_x86ni_gcm_kernel_get(void)
+{
+	/*
+	 * Bit mask for features in ECX:
+	 *    1   PCLMULQDQ
+	 *    9   SSSE3
+	 */
+	if (br_aes_x86ni_supported() && br_cpuid(0, 0, 0x00000202, 0)) {
+		return &br_aes_x86ni_gcm_kernel;
+	}
+	return NULL;
+}
+
+/*
+ * Common code for encryption and decryption. If 'encrypt' is non-zero,
+ * then GHASH is computed over the output; otherwise, it is computed over
+ * the input.
+ */
+BR_TARGET("ssse3,aes,pclmul")
+static uint32_t
+gcm_run(const br_aes_x86ni_ctr_keys *ctx, const void *iv, uint32_t cc,
+	const void *h, void *y, void *data, size_t len, int encrypt)
+{
+	unsigned char *buf;
+	unsigned char ivbuf[12];
+	unsigned num_rounds;
+	__m128i sk[15];
+	__m128i byteswap_index;
+	__m128i yw, h1w, h2w, h3w, h4w, h1k, h2k, h3k, h4k;
+	uint32_t iv0, iv1, iv2;
+	unsigned u;
+
+	buf = data;
+	num_rounds = ctx->num_rounds;
+	for (u = 0; u <= num_rounds; u ++) {
+		sk[u] = _mm_loadu_si128((void *)(ctx->skey.skni + (u << 4)));
+	}
+	memcpy(ivbuf, iv, 12);
+	iv0 = br_dec32le(ivbuf);
+	iv1 = br_dec32le(ivbuf + 4);
+	iv2 = br_dec32le(ivbuf + 8);
+
+	byteswap_index = _mm_set_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	yw = _mm_shuffle_epi8(_mm_loadu_si128(y), byteswap_index);
+	h1w = _mm_shuffle_epi8(_mm_loadu_si128(h), byteswap_index);
+	h2w = gmul(h1w, h1w);
+	h3w = gmul(h2w, h1w);
+	h4w = gmul(h2w, h2w);
+	h1k = kara_fold(h1w);
+	h2k = kara_fold(h2w);
+	h3k = kara_fold(h3w);
+	h4k = kara_fold(h4w);
+
+	while (len > 0) {
+		__m128i x0, x1, x2, x3;
+		__m128i d0, d1, d2, d3;
+		__m128i lo, mid, hi;
+		unsigned char tmp[64];
+		size_t clen;
+
+		/*
+		 * Compute the next four blocks of key stream.
+		 */
+		x0 = _mm_set_epi32((int)br_swap32(cc),
+			(int)iv2, (int)iv1, (int)iv0);
+		x1 = _mm_set_epi32((int)br_swap32(cc + 1),
+			(int)iv2, (int)iv1, (int)iv0);
+		x2 = _mm_set_epi32((int)br_swap32(cc + 2),
+			(int)iv2, (int)iv1, (int)iv0);
+		x3 = _mm_set_epi32((int)br_swap32(cc + 3),
+			(int)iv2, (int)iv1, (int)iv0);
+		x0 = _mm_xor_si128(x0, sk[0]);
+		x1 = _mm_xor_si128(x1, sk[0]);
+		x2 = _mm_xor_si128(x2, sk[0]);
+		x3 = _mm_xor_si128(x3, sk[0]);
+		for (u = 1; u < num_rounds; u ++) {
+			x0 = _mm_aesenc_si128(x0, sk[u]);
+			x1 = _mm_aesenc_si128(x1, sk[u]);
+			x2 = _mm_aesenc_si128(x2, sk[u]);
+			x3 = _mm_aesenc_si128(x3, sk[u]);
+		}
+		x0 = _mm_aesenclast_si128(x0, sk[num_rounds]);
+		x1 = _mm_aesenclast_si128(x1, sk[num_rounds]);
+		x2 = _mm_aesenclast_si128(x2, sk[num_rounds]);
+		x3 = _mm_aesenclast_si128(x3, sk[num_rounds]);
+
+		/*
+		 * Load the data chunk. A partial final chunk is copied
+		 * into a zero-padded buffer.
+		 */
+		if (len >= 64) {
+			clen = 64;
+			d0 = _mm_loadu_si128((void *)(buf +  0));
+			d1 = _mm_loadu_si128((void *)(buf + 16));
+			d2 = _mm_loadu_si128((void *)(buf + 32));
+			d3 = _mm_loadu_si128((void *)(buf + 48));
+		} else {
+			clen = len;
+			memcpy(tmp, buf, clen);
+			memset(tmp + clen, 0, (sizeof tmp) - clen);
+			d0 = _mm_loadu_si128((void *)(tmp +  0));
+			d1 = _mm_loadu_si128((void *)(tmp + 16));
+			d2 = _mm_loadu_si128((void *)(tmp + 32));
+			d3 = _mm_loadu_si128((void *)(tmp + 48));
+		}
+		x0 = _mm_xor_si128(x0, d0);
+		x1 = _mm_xor_si128(x1, d1);
+		x2 = _mm_xor_si128(x2, d2);
+		x3 = _mm_xor_si128(x3, d3);
+
+		if (clen == 64) {
+			_mm_storeu_si128((void *)(buf +  0), x0);
+			_mm_storeu_si128((void *)(buf + 16), x1);
+			_mm_storeu_si128((void *)(buf + 32), x2);
+			_mm_storeu_si128((void *)(buf + 48), x3);
+
+			/*
+			 * GHASH input is the ciphertext: the output
+			 * when encrypting, the input when decrypting.
+			 */
+			if (encrypt) {
+				d0 = x0;
+				d1 = x1;
+				d2 = x2;
+				d3 = x3;
+			}
+			d0 = _mm_shuffle_epi8(d0, byteswap_index);
+			d1 = _mm_shuffle_epi8(d1, byteswap_index);
+			d2 = _mm_shuffle_epi8(d2, byteswap_index);
+			d3 = _mm_shuffle_epi8(d3, byteswap_index);
+			d0 = _mm_xor_si128(d0, yw);
+			lo = _mm_setzero_si128();
+			mid = _mm_setzero_si128();
+			hi = _mm_setzero_si128();
+			PMUL_KARA(lo, mid, hi, d0, h4w, kara_fold(d0), h4k);
+			PMUL_KARA(lo, mid, hi, d1, h3w, kara_fold(d1), h3k);
+			PMUL_KARA(lo, mid, hi, d2, h2w, kara_fold(d2), h2k);
+			PMUL_KARA(lo, mid, hi, d3, h1w, kara_fold(d3), h1k);
+			yw = pmul_finish(lo, mid, hi);
+			buf += 64;
+			len -= 64;
+			cc += 4;
+		} else {
+			/*
+			 * Final partial chunk. When encrypting, the
+			 * ciphertext must be padded with zeros before
+			 * being injected into GHASH.
+			 */
+			_mm_storeu_si128((void *)(tmp +  0), x0);
+			_mm_storeu_si128((void *)(tmp + 16), x1);
+			_mm_storeu_si128((void *)(tmp + 32), x2);
+			_mm_storeu_si128((void *)(tmp + 48), x3);
+			memcpy(buf, tmp, clen);
+			if (encrypt) {
+				memset(tmp + clen, 0, (sizeof tmp) - clen);
+			} else {
+				_mm_storeu_si128((void *)(tmp +  0), d0);
+				_mm_storeu_si128((void *)(tmp + 16), d1);
+				_mm_storeu_si128((void *)(tmp + 32), d2);
+				_mm_storeu_si128((void *)(tmp + 48), d3);
+			}
+			for (u = 0; u < clen; u += 16) {
+				__m128i x;
+
+				x = _mm_loadu_si128((void *)(tmp + u));
+				x = _mm_xor_si128(yw,
+					_mm_shuffle_epi8(x, byteswap_index));
+				lo = _mm_setzero_si128();
+				mid = _mm_setzero_si128();
+				hi = _mm_setzero_si128();
+				PMUL_KARA(lo, mid, hi, x, h1w,
+					kara_fold(x), h1k);
+				yw = pmul_finish(lo, mid, hi);
+			}
+			cc += (uint32_t)clen >> 4;
+			break;
+		}
+	}
+
+	_mm_storeu_si128(y, _mm_shuffle_epi8(yw, byteswap_index));
+	return cc;
+}
+
+static uint32_t
+gcm_encrypt(const br_aes_x86ni_ctr_keys *ctx, const void *iv, uint32_t cc,
+	const void *h, void *y, void *data, size_t len)
+{
+	return gcm_run(ctx, iv, cc, h, y, data, len, 1);
+}
+
+static uint32_t
+gcm_decrypt(const br_aes_x86ni_ctr_keys *ctx, const void *iv, uint32_t cc,
+	const void *h, void *y, void *data, size_t len)
+{
+	return gcm_run(ctx, iv, cc, h, y, data, len, 0);
+}
+
+/* see bearssl_block.h */
+const br_gcm_kernel_class br_aes_x86ni_gcm_kernel = {
+	&br_aes_x86ni_ctr_vtable,
+	(uint32_t (*)(const br_block_ctr_class *const *, const void *,
+		uint32_t, const void *, void *, void *, size_t))
+		&gcm_encrypt,
+	(uint32_t (*)(const br_block_ctr_class *const *, const void *,
+		uint32_t, const void *, void *, void *, size_t))
+		&gcm_decrypt
+};
+
+#else
+
+/* see bearssl_block.h */
+const br_gcm_kernel_class *
+br_aes_x86ni_gcm_kernel_get(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "inner.h"
+
+/*
+ * The CBC-MAC is computed with the CBC encryption implementation: data
+ * is accumulated in a buffer, which is CBC-encrypted in place (with the
+ * current MAC value as IV) whenever it is full. The run() function
+ * leaves the last encrypted block in the IV, which is exactly the
+ * updated CBC-MAC value.
+ */
+typedef struct {
+	const br_block_cbcenc_class *const *bc;
+	unsigned char mac[16];
+	unsigned char buf[256];
+	size_t ptr;
+} cbcmac_context;
+
+static void
+cbcmac_flush(cbcmac_context *cm)
+{
+	if (cm->ptr > 0) {
+		(*cm->bc)->run(cm->bc, cm->mac, cm->buf, cm->ptr);
+		cm->ptr = 0;
+	}
+}
+
+static void
+cbcmac_update(cbcmac_context *cm, const void *data, size_t len)
+{
+	const unsigned char *buf;
+
+	buf = data;
+	while (len > 0) {
+		size_t clen;
+
+		clen = (sizeof cm->buf) - cm->ptr;
+		if (clen > len) {
+			clen = len;
+		}
+		memcpy(cm->buf + cm->ptr, buf, clen);
+		cm->ptr += clen;
+		buf += clen;
+		len -= clen;
+		if (cm->ptr == sizeof cm->buf) {
+			cbcmac_flush(cm);
+		}
+	}
+}
+
+/*
+ * Pad the current input with zeros up to the next block boundary.
+ */
+static void
+cbcmac_pad(cbcmac_context *cm)
+{
+	size_t plen;
+
+	plen = cm->ptr & 15;
+	if (plen != 0) {
+		plen = 16 - plen;
+		memset(cm->buf + cm->ptr, 0, plen);
+		cm->ptr += plen;
+	}
+}
+
+/* see bearssl_block.h */
+void
+br_ccm_run(const br_block_cbcenc_class *const *bc_cbc,
+	const br_block_ctr_class *const *bc_ctr,
+	const void *nonce, size_t nonce_len,
+	const void *aad, size_t aad_len,
+	void *data, size_t len,
+	void *tag, size_t tag_len, int encrypt)
+{
+	cbcmac_context cm;
+	unsigned char b0[16], ctr0[16], s0[16];
+	unsigned char *tb;
+	size_t u, lsize;
+	uint32_t cc;
+
+	/*
+	 * Counter blocks are: flags (L-1), nonce, counter (L bytes).
+	 * The CTR implementation uses the first 12 bytes as IV, and the
+	 * last 4 bytes as a big-endian 32-bit counter; since the message
+	 * length is bounded by the counter size, the counter never
+	 * overflows into the nonce bytes.
+	 */
+	lsize = 15 - nonce_len;
+	memset(ctr0, 0, sizeof ctr0);
+	ctr0[0] = (unsigned char)(lsize - 1);
+	memcpy(ctr0 + 1, nonce, nonce_len);
+	cc = br_dec32be(ctr0 + 12);
+
+	/*
+	 * First block for the CBC-MAC: flags, nonce, message length.
+	 */
+	memcpy(b0, ctr0, sizeof b0);
+	b0[0] |= (unsigned char)(((tag_len - 2) >> 1) << 3);
+	if (aad_len > 0) {
+		b0[0] |= 0x40;
+	}
+	for (u = 0; u < lsize && u < sizeof(size_t); u ++) {
+		b0[15 - u] = (unsigned char)(len >> (u << 3));
+	}
+
+	/*
+	 * When decrypting, the MAC is computed over the plaintext, so
+	 * decryption comes first.
+	 */
+	if (!encrypt) {
+		(*bc_ctr)->run(bc_ctr, ctr0, cc + 1, data, len);
+	}
+
+	cm.bc = bc_cbc;
+	memset(cm.mac, 0, sizeof cm.mac);
+	cm.ptr = 0;
+	cbcmac_update(&cm, b0, sizeof b0);
+	if (aad_len > 0) {
+		unsigned char alen[6];
+
+		if (aad_len < 0xFF00) {
+			br_enc16be(alen, (unsigned)aad_len);
+			cbcmac_update(&cm, alen, 2);
+		} else {
+			alen[0] = 0xFF;
+			alen[1] = 0xFE;
+			br_enc32be(alen + 2, (uint32_t)aad_len);
+			cbcmac_update(&cm, alen, 6);
+		}
+		cbcmac_update(&cm, aad, aad_len);
+		cbcmac_pad(&cm);
+	}
+	cbcmac_update(&cm, data, len);
+	cbcmac_pad(&cm);
+	cbcmac_flush(&cm);
+
+	if (encrypt) {
+		(*bc_ctr)->run(bc_ctr, ctr0, cc + 1, data, len);
+	}
+
+	/*
+	 * Tag is the CBC-MAC, masked with the first key stream block
+	 * (counter 0), and truncated.
+	 */
+	memset(s0, 0, sizeof s0);
+	(*bc_ctr)->run(bc_ctr, ctr0, cc, s0, sizeof s0);
+	tb = tag;
+	for (u = 0; u < tag_len; u ++) {
+		tb[u] = cm.mac[u] ^ s0[u];
+	}
+}
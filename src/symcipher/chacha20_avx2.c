@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "inner.h"
+
+#if BR_AVX2
+
+#include <immintrin.h>
+
+/*
+ * This implementation processes eight ChaCha20 blocks in parallel,
+ * with the same "transposed" state layout as the SSE2 implementation
+ * (see chacha20_sse2.c), but with 256-bit registers. Rotations by 16
+ * and 8 bits are byte permutations and use vpshufb.
+ */
+
+/* see bearssl_block.h */
+br_chacha20_run
+br_chacha20_avx2_get(void)
+{
+	/*
+	 * Bit mask for features in EBX (leaf 7):
+	 *    5   AVX2
+	 */
+	if (br_cpu_avx_os() && br_cpuid7(0x00000020, 0)) {
+		return &br_chacha20_avx2_run;
+	} else {
+		return 0;
+	}
+}
+
+/* see bearssl_block.h */
+BR_TARGET("avx2")
+uint32_t
+br_chacha20_avx2_run(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len)
+{
+	unsigned char *buf;
+	uint32_t kw[8], ivw[3];
+	__m256i init[16], rot16, rot8;
+	size_t u;
+
+	static const uint32_t CW[] = {
+		0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+	};
+
+	buf = data;
+	for (u = 0; u < 8; u ++) {
+		kw[u] = br_dec32le((const unsigned char *)key + (u << 2));
+	}
+	for (u = 0; u < 3; u ++) {
+		ivw[u] = br_dec32le((const unsigned char *)iv + (u << 2));
+	}
+	for (u = 0; u < 4; u ++) {
+		init[u] = _mm256_set1_epi32((int)CW[u]);
+	}
+	for (u = 0; u < 8; u ++) {
+		init[u + 4] = _mm256_set1_epi32((int)kw[u]);
+	}
+	for (u = 0; u < 3; u ++) {
+		init[u + 13] = _mm256_set1_epi32((int)ivw[u]);
+	}
+	rot16 = _mm256_setr_epi8(
+		2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+		2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+	rot8 = _mm256_setr_epi8(
+		3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+		3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+
+	while (len > 0) {
+		__m256i s[16], w[16];
+		unsigned char tmp[512];
+		unsigned char *dst;
+		int i;
+
+		init[12] = _mm256_add_epi32(_mm256_set1_epi32((int)cc),
+			_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		memcpy(s, init, sizeof s);
+		for (i = 0; i < 10; i ++) {
+
+#define ROTL(x, n)   _mm256_or_si256( \
+		_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+
+#define QROUND(a, b, c, d)   do { \
+		s[a] = _mm256_add_epi32(s[a], s[b]); \
+		s[d] = _mm256_shuffle_epi8( \
+			_mm256_xor_si256(s[d], s[a]), rot16); \
+		s[c] = _mm256_add_epi32(s[c], s[d]); \
+		s[b] = ROTL(_mm256_xor_si256(s[b], s[c]), 12); \
+		s[a] = _mm256_add_epi32(s[a], s[b]); \
+		s[d] = _mm256_shuffle_epi8( \
+			_mm256_xor_si256(s[d], s[a]), rot8); \
+		s[c] = _mm256_add_epi32(s[c], s[d]); \
+		s[b] = ROTL(_mm256_xor_si256(s[b], s[c]),  7); \
+	} while (0)
+
+			QROUND( 0,  4,  8, 12);
+			QROUND( 1,  5,  9, 13);
+			QROUND( 2,  6, 10, 14);
+			QROUND( 3,  7, 11, 15);
+			QROUND( 0,  5, 10, 15);
+			QROUND( 1,  6, 11, 12);
+			QROUND( 2,  7,  8, 13);
+			QROUND( 3,  4,  9, 14);
+
+#undef QROUND
+#undef ROTL
+
+		}
+
+		/*
+		 * Add the initial state, then transpose each group of
+		 * four words within each 128-bit lane: w[u + k] then
+		 * contains words u..u+3 of block k (low lane) and of
+		 * block k+4 (high lane).
+		 */
+		for (u = 0; u < 16; u += 4) {
+			__m256i x0, x1, x2, x3, t0, t1, t2, t3;
+
+			x0 = _mm256_add_epi32(s[u + 0], init[u + 0]);
+			x1 = _mm256_add_epi32(s[u + 1], init[u + 1]);
+			x2 = _mm256_add_epi32(s[u + 2], init[u + 2]);
+			x3 = _mm256_add_epi32(s[u + 3], init[u + 3]);
+			t0 = _mm256_unpacklo_epi32(x0, x1);
+			t1 = _mm256_unpacklo_epi32(x2, x3);
+			t2 = _mm256_unpackhi_epi32(x0, x1);
+			t3 = _mm256_unpackhi_epi32(x2, x3);
+			w[u + 0] = _mm256_unpacklo_epi64(t0, t1);
+			w[u + 1] = _mm256_unpackhi_epi64(t0, t1);
+			w[u + 2] = _mm256_unpacklo_epi64(t2, t3);
+			w[u + 3] = _mm256_unpackhi_epi64(t2, t3);
+		}
+
+		/*
+		 * Reassemble the blocks: block k is made of the low
+		 * lanes of w[k], w[k + 4], w[k + 8] and w[k + 12];
+		 * block k+4 uses the high lanes.
+		 */
+		dst = len >= 512 ? buf : tmp;
+		for (u = 0; u < 4; u ++) {
+			__m256i b0, b1, b2, b3;
+
+			b0 = _mm256_permute2x128_si256(w[u], w[u + 4], 0x20);
+			b1 = _mm256_permute2x128_si256(w[u + 8], w[u + 12], 0x20);
+			b2 = _mm256_permute2x128_si256(w[u], w[u + 4], 0x31);
+			b3 = _mm256_permute2x128_si256(w[u + 8], w[u + 12], 0x31);
+			if (dst == buf) {
+				b0 = _mm256_xor_si256(b0, _mm256_loadu_si256(
+					(void *)(buf + (u << 6))));
+				b1 = _mm256_xor_si256(b1, _mm256_loadu_si256(
+					(void *)(buf + (u << 6) + 32)));
+				b2 = _mm256_xor_si256(b2, _mm256_loadu_si256(
+					(void *)(buf + (u << 6) + 256)));
+				b3 = _mm256_xor_si256(b3, _mm256_loadu_si256(
+					(void *)(buf + (u << 6) + 288)));
+			}
+			_mm256_storeu_si256((void *)(dst + (u << 6)), b0);
+			_mm256_storeu_si256((void *)(dst + (u << 6) + 32), b1);
+			_mm256_storeu_si256((void *)(dst + (u << 6) + 256), b2);
+			_mm256_storeu_si256((void *)(dst + (u << 6) + 288), b3);
+		}
+
+		if (len >= 512) {
+			buf += 512;
+			len -= 512;
+			cc += 8;
+		} else {
+			for (u = 0; u < len; u ++) {
+				buf[u] ^= tmp[u];
+			}
+			cc += (uint32_t)((len + 63) >> 6);
+			len = 0;
+		}
+	}
+	return cc;
+}
+
+#else
+
+/* see bearssl_block.h */
+br_chacha20_run
+br_chacha20_avx2_get(void)
+{
+	return 0;
+}
+
+#endif
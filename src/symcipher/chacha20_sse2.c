@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining 
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "inner.h"
+
+#if BR_SSE2
+
+#include <emmintrin.h>
+
+/*
+ * This implementation processes four ChaCha20 blocks in parallel. The
+ * state is "transposed": each SSE2 register holds the same state word
+ * for the four blocks, so that the quarter-rounds are plain 32-bit
+ * lane-wise additions, XORs and rotations. Rotations use shifts since
+ * SSE2 has no rotation opcode. At the end, the four keystream blocks
+ * are transposed back into the normal byte order.
+ */
+
+/* see bearssl_block.h */
+br_chacha20_run
+br_chacha20_sse2_get(void)
+{
+	/*
+	 * Bit mask for features in EDX:
+	 *   26   SSE2
+	 */
+	if (br_cpuid(0, 0, 0, 0x04000000)) {
+		return &br_chacha20_sse2_run;
+	} else {
+		return 0;
+	}
+}
+
+/* see bearssl_block.h */
+BR_TARGET("sse2")
+uint32_t
+br_chacha20_sse2_run(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len)
+{
+	unsigned char *buf;
+	uint32_t kw[8], ivw[3];
+	__m128i init[16];
+	size_t u;
+
+	static const uint32_t CW[] = {
+		0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+	};
+
+	buf = data;
+	for (u = 0; u < 8; u ++) {
+		kw[u] = br_dec32le((const unsigned char *)key + (u << 2));
+	}
+	for (u = 0; u < 3; u ++) {
+		ivw[u] = br_dec32le((const unsigned char *)iv + (u << 2));
+	}
+	for (u = 0; u < 4; u ++) {
+		init[u] = _mm_set1_epi32((int)CW[u]);
+	}
+	for (u = 0; u < 8; u ++) {
+		init[u + 4] = _mm_set1_epi32((int)kw[u]);
+	}
+	for (u = 0; u < 3; u ++) {
+		init[u + 13] = _mm_set1_epi32((int)ivw[u]);
+	}
+
+	while (len > 0) {
+		__m128i s[16];
+		unsigned char tmp[256];
+		int i;
+
+		init[12] = _mm_add_epi32(_mm_set1_epi32((int)cc),
+			_mm_setr_epi32(0, 1, 2, 3));
+		memcpy(s, init, sizeof s);
+		for (i = 0; i < 10; i ++) {
+
+#define ROTL(x, n)   _mm_or_si128( \
+		_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+
+#define QROUND(a, b, c, d)   do { \
+		s[a] = _mm_add_epi32(s[a], s[b]); \
+		s[d] = ROTL(_mm_xor_si128(s[d], s[a]), 16); \
+		s[c] = _mm_add_epi32(s[c], s[d]); \
+		s[b] = ROTL(_mm_xor_si128(s[b], s[c]), 12); \
+		s[a] = _mm_add_epi32(s[a], s[b]); \
+		s[d] = ROTL(_mm_xor_si128(s[d], s[a]),  8); \
+		s[c] = _mm_add_epi32(s[c], s[d]); \
+		s[b] = ROTL(_mm_xor_si128(s[b], s[c]),  7); \
+	} while (0)
+
+			QROUND( 0,  4,  8, 12);
+			QROUND( 1,  5,  9, 13);
+			QROUND( 2,  6, 10, 14);
+			QROUND( 3,  7, 11, 15);
+			QROUND( 0,  5, 10, 15);
+			QROUND( 1,  6, 11, 12);
+			QROUND( 2,  7,  8, 13);
+			QROUND( 3,  4,  9, 14);
+
+#undef QROUND
+#undef ROTL
+
+		}
+
+		/*
+		 * Add the initial state, then transpose each group of
+		 * four words: after the transposition, t0..t3 contain
+		 * words 4*j..4*j+3 of blocks 0..3, respectively.
+		 */
+		for (u = 0; u < 16; u += 4) {
+			__m128i x0, x1, x2, x3, t0, t1, t2, t3;
+
+			x0 = _mm_add_epi32(s[u + 0], init[u + 0]);
+			x1 = _mm_add_epi32(s[u + 1], init[u + 1]);
+			x2 = _mm_add_epi32(s[u + 2], init[u + 2]);
+			x3 = _mm_add_epi32(s[u + 3], init[u + 3]);
+			t0 = _mm_unpacklo_epi32(x0, x1);
+			t1 = _mm_unpacklo_epi32(x2, x3);
+			t2 = _mm_unpackhi_epi32(x0, x1);
+			t3 = _mm_unpackhi_epi32(x2, x3);
+			x0 = _mm_unpacklo_epi64(t0, t1);
+			x1 = _mm_unpackhi_epi64(t0, t1);
+			x2 = _mm_unpacklo_epi64(t2, t3);
+			x3 = _mm_unpackhi_epi64(t2, t3);
+			if (len >= 256) {
+				_mm_storeu_si128((void *)(buf + (u << 2)),
+					_mm_xor_si128(x0, _mm_loadu_si128(
+					(void *)(buf + (u << 2)))));
+				_mm_storeu_si128((void *)(buf + 64 + (u << 2)),
+					_mm_xor_si128(x1, _mm_loadu_si128(
+					(void *)(buf + 64 + (u << 2)))));
+				_mm_storeu_si128((void *)(buf + 128 + (u << 2)),
+					_mm_xor_si128(x2, _mm_loadu_si128(
+					(void *)(buf + 128 + (u << 2)))));
+				_mm_storeu_si128((void *)(buf + 192 + (u << 2)),
+					_mm_xor_si128(x3, _mm_loadu_si128(
+					(void *)(buf + 192 + (u << 2)))));
+			} else {
+				_mm_storeu_si128((void *)(tmp + (u << 2)), x0);
+				_mm_storeu_si128((void *)(tmp + 64 + (u << 2)), x1);
+				_mm_storeu_si128((void *)(tmp + 128 + (u << 2)), x2);
+				_mm_storeu_si128((void *)(tmp + 192 + (u << 2)), x3);
+			}
+		}
+
+		if (len >= 256) {
+			buf += 256;
+			len -= 256;
+			cc += 4;
+		} else {
+			for (u = 0; u < len; u ++) {
+				buf[u] ^= tmp[u];
+			}
+			cc += (uint32_t)((len + 63) >> 6);
+			len = 0;
+		}
+	}
+	return cc;
+}
+
+#else
+
+/* see bearssl_block.h */
+br_chacha20_run
+br_chacha20_sse2_get(void)
+{
+	return 0;
+}
+
+#endif
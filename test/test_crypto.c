@@ -269,6 +269,231 @@ test_SHA512(void)
 	fflush(stdout);
 }
 
+/*
+ * Check an alternate hash implementation (given as a vtable) against
+ * a known answer. Input is processed in one chunk, then byte by byte,
+ * then split at every possible position, with a state save and restore
+ * at the block boundary which is closest to the split.
+ */
+static void
+test_hash_impl_KAT(char *name, const br_hash_class *hc,
+	const char *data, const char *refres)
+{
+	br_hash_compat_context mc, mc2;
+	unsigned char res[64], ref[64], st[64];
+	size_t u, n, hlen;
+
+	hlen = hextobin(ref, refres);
+	n = strlen(data);
+	hc->init(&mc.vtable);
+	hc->update(&mc.vtable, data, n);
+	hc->out(&mc.vtable, res);
+	check_equals(name, res, ref, hlen);
+	hc->init(&mc.vtable);
+	for (u = 0; u < n; u ++) {
+		hc->update(&mc.vtable, data + u, 1);
+	}
+	hc->out(&mc.vtable, res);
+	check_equals(name, res, ref, hlen);
+	for (u = 0; u < n; u ++) {
+		size_t v;
+		uint64_t count;
+
+		v = u & ~(size_t)63;
+		hc->init(&mc.vtable);
+		hc->update(&mc.vtable, data, v);
+		count = hc->state(&mc.vtable, st);
+		memset(&mc2, 0, sizeof mc2);
+		hc->init(&mc2.vtable);
+		hc->set_state(&mc2.vtable, st, count);
+		hc->update(&mc2.vtable, data + v, u - v);
+		hc->update(&mc2.vtable, data + u, n - u);
+		hc->out(&mc2.vtable, res);
+		check_equals(name, res, ref, hlen);
+	}
+}
+
+/*
+ * Compare an alternate hash implementation with the reference one,
+ * on pseudorandom inputs of all lengths up to 1000 bytes, split in
+ * several chunks.
+ */
+static void
+test_hash_impl_cross(char *name,
+	const br_hash_class *ref_hc, const br_hash_class *hc)
+{
+	unsigned char buf[1000], res1[64], res2[64];
+	br_hmac_drbg_context rc;
+	size_t u, hlen;
+
+	hlen = (hc->desc >> BR_HASHDESC_OUT_OFF) & BR_HASHDESC_OUT_MASK;
+	br_hmac_drbg_init(&rc, &br_sha256_vtable, name, strlen(name));
+	br_hmac_drbg_generate(&rc, buf, sizeof buf);
+	for (u = 0; u <= sizeof buf; u ++) {
+		br_hash_compat_context c1, c2;
+		size_t v, w;
+
+		ref_hc->init(&c1.vtable);
+		ref_hc->update(&c1.vtable, buf, u);
+		ref_hc->out(&c1.vtable, res1);
+		hc->init(&c2.vtable);
+		v = u / 3;
+		w = u - (u / 7);
+		hc->update(&c2.vtable, buf, v);
+		hc->update(&c2.vtable, buf + v, w - v);
+		hc->update(&c2.vtable, buf + w, u - w);
+		hc->out(&c2.vtable, res2);
+		check_equals(name, res1, res2, hlen);
+		if (u % 100 == 0) {
+			printf(".");
+			fflush(stdout);
+		}
+	}
+}
+
+static void
+test_hash_impl_million_a(char *name,
+	const br_hash_class *hc, const char *refres)
+{
+	br_hash_compat_context mc;
+	unsigned char buf[1000], res[64], ref[64];
+	size_t hlen;
+	int i;
+
+	hlen = hextobin(ref, refres);
+	memset(buf, 'a', sizeof buf);
+	hc->init(&mc.vtable);
+	for (i = 0; i < 1000; i ++) {
+		hc->update(&mc.vtable, buf, sizeof buf);
+	}
+	hc->out(&mc.vtable, res);
+	check_equals(name, res, ref, hlen);
+}
+
+static void
+test_SHA_x86ni(void)
+{
+	const br_hash_class *hc;
+
+	printf("Test SHA-1/SHA-224/SHA-256 x86ni: ");
+	fflush(stdout);
+
+	hc = br_sha1_x86ni_get_vtable();
+	if (hc == NULL) {
+		printf("UNAVAILABLE\n");
+		return;
+	}
+	test_hash_impl_KAT("KAT SHA-1 x86ni", hc, "abc",
+		"a9993e364706816aba3e25717850c26c9cd0d89d");
+	test_hash_impl_KAT("KAT SHA-1 x86ni", hc,
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		"84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+	test_hash_impl_million_a("KAT SHA-1 x86ni", hc,
+		"34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+	test_hash_impl_cross("SHA-1 x86ni", &br_sha1_vtable, hc);
+
+	hc = br_sha224_x86ni_get_vtable();
+	test_hash_impl_KAT("KAT SHA-224 x86ni", hc, "abc",
+		"23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7");
+	test_hash_impl_KAT("KAT SHA-224 x86ni", hc,
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		"75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525");
+	test_hash_impl_million_a("KAT SHA-224 x86ni", hc,
+		"20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67");
+	test_hash_impl_cross("SHA-224 x86ni", &br_sha224_vtable, hc);
+
+	hc = br_sha256_x86ni_get_vtable();
+	test_hash_impl_KAT("KAT SHA-256 x86ni", hc, "abc",
+   "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	test_hash_impl_KAT("KAT SHA-256 x86ni", hc,
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+   "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+	test_hash_impl_million_a("KAT SHA-256 x86ni", hc,
+   "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+	test_hash_impl_cross("SHA-256 x86ni", &br_sha256_vtable, hc);
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_SHA256_mb_impl(const char *name, const br_sha256_mb_impl *impl)
+{
+	unsigned char buf[12][300];
+	br_sha256_context ctx[12], ref[12];
+	br_sha256_context *pc[12];
+	const void *pd[12];
+	br_hmac_drbg_context rc;
+	size_t num, len;
+
+	printf("[%s]", name);
+	fflush(stdout);
+	if (impl == NULL) {
+		printf(" UNAVAILABLE ");
+		fflush(stdout);
+		return;
+	}
+	br_hmac_drbg_init(&rc, &br_sha256_vtable, name, strlen(name));
+	for (num = 0; num <= 12; num ++) {
+		for (len = 0; len <= 200; len += 13) {
+			unsigned char h1[32], h2[32];
+			size_t u;
+
+			/*
+			 * Each context first receives a different number of
+			 * bytes with the normal API, so that the lanes have
+			 * distinct buffered lengths. Half of the contexts
+			 * use SHA-224.
+			 */
+			br_hmac_drbg_generate(&rc, buf, sizeof buf);
+			for (u = 0; u < num; u ++) {
+				size_t pre;
+
+				pre = (u * 37) % 100;
+				if (u & 1) {
+					br_sha224_init(&ctx[u]);
+				} else {
+					br_sha256_init(&ctx[u]);
+				}
+				br_sha256_update(&ctx[u], buf[u], pre);
+				ref[u] = ctx[u];
+				br_sha256_update(&ref[u], buf[u] + pre, len);
+				pc[u] = &ctx[u];
+				pd[u] = buf[u] + pre;
+			}
+			br_sha256_mb_update(impl, pc, pd, len, num);
+			for (u = 0; u < num; u ++) {
+				if (u & 1) {
+					br_sha224_out(&ctx[u], h1);
+					br_sha224_out(&ref[u], h2);
+					check_equals("KAT SHA-224 mb", h1, h2, 28);
+				} else {
+					br_sha256_out(&ctx[u], h1);
+					br_sha256_out(&ref[u], h2);
+					check_equals("KAT SHA-256 mb", h1, h2, 32);
+				}
+			}
+		}
+		printf(".");
+		fflush(stdout);
+	}
+	printf(" ");
+	fflush(stdout);
+}
+
+static void
+test_SHA256_mb(void)
+{
+	printf("Test SHA-256 multi-buffer: ");
+	fflush(stdout);
+	test_SHA256_mb_impl("portable", &br_sha256_mb_portable);
+	test_SHA256_mb_impl("sse2", br_sha256_mb_sse2_get());
+	test_SHA256_mb_impl("avx2", br_sha256_mb_avx2_get());
+	test_SHA256_mb_impl("x86ni", br_sha256_mb_x86ni_get());
+	printf("done.\n");
+	fflush(stdout);
+}
+
 static void
 test_MD5_SHA1(void)
 {
@@ -512,6 +737,42 @@ test_multihash(void)
 	printf(".");
 	fflush(stdout);
 
+	/*
+	 * Drop some hash functions in the middle of the computation;
+	 * the remaining ones must still be correct, the dropped ones
+	 * must yield no output.
+	 */
+	{
+		unsigned char buf[300], tmp[64], tmp2[64];
+		size_t u, olen;
+		int i;
+
+		for (u = 0; u < sizeof buf; u ++) {
+			buf[u] = (unsigned char)(u * 7 + 1);
+		}
+		br_multihash_init(&mc);
+		br_multihash_update(&mc, buf, 150);
+		br_multihash_restrict(&mc,
+			(1U << br_sha1_ID) | (1U << br_sha384_ID));
+		br_multihash_update(&mc, buf + 150, 150);
+		for (i = 1; i <= 6; i ++) {
+			olen = br_multihash_out(&mc, i, tmp);
+			if (i == br_sha1_ID || i == br_sha384_ID) {
+				do_hash(i, buf, sizeof buf, tmp2);
+				check_equals("Restricted hash output",
+					tmp, tmp2, olen);
+			} else if (olen != 0) {
+				fprintf(stderr, "Dropped hash %d\n", i);
+				exit(EXIT_FAILURE);
+			}
+		}
+		if (test_multihash_inner(&mc) != 258 * 6) {
+			fprintf(stderr, "Failed test count\n");
+		}
+	}
+	printf(".");
+	fflush(stdout);
+
 	printf("done.\n");
 	fflush(stdout);
 }
@@ -3271,174 +3532,1531 @@ test_AES_ct64(void)
 		1, 1);
 }
 
+static void
+test_AES_x86ni(void)
+{
+	const br_block_cbcenc_class *x_cbcenc;
+	const br_block_cbcdec_class *x_cbcdec;
+	const br_block_ctr_class *x_ctr;
+
+	x_cbcenc = br_aes_x86ni_cbcenc_get_vtable();
+	x_cbcdec = br_aes_x86ni_cbcdec_get_vtable();
+	x_ctr = br_aes_x86ni_ctr_get_vtable();
+	if (x_cbcenc == NULL || x_cbcdec == NULL || x_ctr == NULL) {
+		printf("Test AES_x86ni: UNAVAILABLE\n");
+		return;
+	}
+	test_AES_generic("AES_x86ni", x_cbcenc, x_cbcdec, x_ctr, 1, 1);
+}
+
 /*
- * DES known-answer tests. Order: plaintext, key, ciphertext.
- * (mostly from NIST SP 800-20).
+ * Encrypt and decrypt records of various lengths with the GCM record
+ * engines, with and without the kernel, and check that the records are
+ * identical and interoperable, and that altered records are rejected.
  */
-static const char *const KAT_DES[] = {
-	"10316E028C8F3B4A", "0000000000000000", "82DCBAFBDEAB6602",
-	"8000000000000000", "0000000000000000", "95A8D72813DAA94D",
-	"4000000000000000", "0000000000000000", "0EEC1487DD8C26D5",
-	"2000000000000000", "0000000000000000", "7AD16FFB79C45926",
-	"1000000000000000", "0000000000000000", "D3746294CA6A6CF3",
-	"0800000000000000", "0000000000000000", "809F5F873C1FD761",
-	"0400000000000000", "0000000000000000", "C02FAFFEC989D1FC",
-	"0200000000000000", "0000000000000000", "4615AA1D33E72F10",
-	"0100000000000000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0080000000000000", "0000000000000000", "2055123350C00858",
-	"0040000000000000", "0000000000000000", "DF3B99D6577397C8",
-	"0020000000000000", "0000000000000000", "31FE17369B5288C9",
-	"0010000000000000", "0000000000000000", "DFDD3CC64DAE1642",
-	"0008000000000000", "0000000000000000", "178C83CE2B399D94",
-	"0004000000000000", "0000000000000000", "50F636324A9B7F80",
-	"0002000000000000", "0000000000000000", "A8468EE3BC18F06D",
-	"0001000000000000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000800000000000", "0000000000000000", "A2DC9E92FD3CDE92",
-	"0000400000000000", "0000000000000000", "CAC09F797D031287",
-	"0000200000000000", "0000000000000000", "90BA680B22AEB525",
-	"0000100000000000", "0000000000000000", "CE7A24F350E280B6",
-	"0000080000000000", "0000000000000000", "882BFF0AA01A0B87",
-	"0000040000000000", "0000000000000000", "25610288924511C2",
-	"0000020000000000", "0000000000000000", "C71516C29C75D170",
-	"0000010000000000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000008000000000", "0000000000000000", "5199C29A52C9F059",
-	"0000004000000000", "0000000000000000", "C22F0A294A71F29F",
-	"0000002000000000", "0000000000000000", "EE371483714C02EA",
-	"0000001000000000", "0000000000000000", "A81FBD448F9E522F",
-	"0000000800000000", "0000000000000000", "4F644C92E192DFED",
-	"0000000400000000", "0000000000000000", "1AFA9A66A6DF92AE",
-	"0000000200000000", "0000000000000000", "B3C1CC715CB879D8",
-	"0000000100000000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000000080000000", "0000000000000000", "19D032E64AB0BD8B",
-	"0000000040000000", "0000000000000000", "3CFAA7A7DC8720DC",
-	"0000000020000000", "0000000000000000", "B7265F7F447AC6F3",
-	"0000000010000000", "0000000000000000", "9DB73B3C0D163F54",
-	"0000000008000000", "0000000000000000", "8181B65BABF4A975",
-	"0000000004000000", "0000000000000000", "93C9B64042EAA240",
-	"0000000002000000", "0000000000000000", "5570530829705592",
-	"0000000001000000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000000000800000", "0000000000000000", "8638809E878787A0",
-	"0000000000400000", "0000000000000000", "41B9A79AF79AC208",
-	"0000000000200000", "0000000000000000", "7A9BE42F2009A892",
-	"0000000000100000", "0000000000000000", "29038D56BA6D2745",
-	"0000000000080000", "0000000000000000", "5495C6ABF1E5DF51",
-	"0000000000040000", "0000000000000000", "AE13DBD561488933",
-	"0000000000020000", "0000000000000000", "024D1FFA8904E389",
-	"0000000000010000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000000000008000", "0000000000000000", "D1399712F99BF02E",
-	"0000000000004000", "0000000000000000", "14C1D7C1CFFEC79E",
-	"0000000000002000", "0000000000000000", "1DE5279DAE3BED6F",
-	"0000000000001000", "0000000000000000", "E941A33F85501303",
-	"0000000000000800", "0000000000000000", "DA99DBBC9A03F379",
-	"0000000000000400", "0000000000000000", "B7FC92F91D8E92E9",
-	"0000000000000200", "0000000000000000", "AE8E5CAA3CA04E85",
-	"0000000000000100", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000000000000080", "0000000000000000", "9CC62DF43B6EED74",
-	"0000000000000040", "0000000000000000", "D863DBB5C59A91A0",
-	"0000000000000020", "0000000000000000", "A1AB2190545B91D7",
-	"0000000000000010", "0000000000000000", "0875041E64C570F7",
-	"0000000000000008", "0000000000000000", "5A594528BEBEF1CC",
-	"0000000000000004", "0000000000000000", "FCDB3291DE21F0C0",
-	"0000000000000002", "0000000000000000", "869EFD7F9F265A09",
-	"0000000000000001", "0000000000000000", "8CA64DE9C1B123A7",
-	"0000000000000000", "8000000000000000", "95F8A5E5DD31D900",
-	"0000000000000000", "4000000000000000", "DD7F121CA5015619",
-	"0000000000000000", "2000000000000000", "2E8653104F3834EA",
-	"0000000000000000", "1000000000000000", "4BD388FF6CD81D4F",
-	"0000000000000000", "0800000000000000", "20B9E767B2FB1456",
-	"0000000000000000", "0400000000000000", "55579380D77138EF",
-	"0000000000000000", "0200000000000000", "6CC5DEFAAF04512F",
-	"0000000000000000", "0100000000000000", "0D9F279BA5D87260",
-	"0000000000000000", "0080000000000000", "D9031B0271BD5A0A",
-	"0000000000000000", "0040000000000000", "424250B37C3DD951",
-	"0000000000000000", "0020000000000000", "B8061B7ECD9A21E5",
-	"0000000000000000", "0010000000000000", "F15D0F286B65BD28",
-	"0000000000000000", "0008000000000000", "ADD0CC8D6E5DEBA1",
-	"0000000000000000", "0004000000000000", "E6D5F82752AD63D1",
-	"0000000000000000", "0002000000000000", "ECBFE3BD3F591A5E",
-	"0000000000000000", "0001000000000000", "F356834379D165CD",
-	"0000000000000000", "0000800000000000", "2B9F982F20037FA9",
-	"0000000000000000", "0000400000000000", "889DE068A16F0BE6",
-	"0000000000000000", "0000200000000000", "E19E275D846A1298",
-	"0000000000000000", "0000100000000000", "329A8ED523D71AEC",
-	"0000000000000000", "0000080000000000", "E7FCE22557D23C97",
-	"0000000000000000", "0000040000000000", "12A9F5817FF2D65D",
-	"0000000000000000", "0000020000000000", "A484C3AD38DC9C19",
-	"0000000000000000", "0000010000000000", "FBE00A8A1EF8AD72",
-	"0000000000000000", "0000008000000000", "750D079407521363",
-	"0000000000000000", "0000004000000000", "64FEED9C724C2FAF",
-	"0000000000000000", "0000002000000000", "F02B263B328E2B60",
-	"0000000000000000", "0000001000000000", "9D64555A9A10B852",
-	"0000000000000000", "0000000800000000", "D106FF0BED5255D7",
-	"0000000000000000", "0000000400000000", "E1652C6B138C64A5",
-	"0000000000000000", "0000000200000000", "E428581186EC8F46",
-	"0000000000000000", "0000000100000000", "AEB5F5EDE22D1A36",
-	"0000000000000000", "0000000080000000", "E943D7568AEC0C5C",
-	"0000000000000000", "0000000040000000", "DF98C8276F54B04B",
-	"0000000000000000", "0000000020000000", "B160E4680F6C696F",
-	"0000000000000000", "0000000010000000", "FA0752B07D9C4AB8",
-	"0000000000000000", "0000000008000000", "CA3A2B036DBC8502",
-	"0000000000000000", "0000000004000000", "5E0905517BB59BCF",
-	"0000000000000000", "0000000002000000", "814EEB3B91D90726",
-	"0000000000000000", "0000000001000000", "4D49DB1532919C9F",
-	"0000000000000000", "0000000000800000", "25EB5FC3F8CF0621",
-	"0000000000000000", "0000000000400000", "AB6A20C0620D1C6F",
-	"0000000000000000", "0000000000200000", "79E90DBC98F92CCA",
-	"0000000000000000", "0000000000100000", "866ECEDD8072BB0E",
-	"0000000000000000", "0000000000080000", "8B54536F2F3E64A8",
-	"0000000000000000", "0000000000040000", "EA51D3975595B86B",
-	"0000000000000000", "0000000000020000", "CAFFC6AC4542DE31",
-	"0000000000000000", "0000000000010000", "8DD45A2DDF90796C",
-	"0000000000000000", "0000000000008000", "1029D55E880EC2D0",
-	"0000000000000000", "0000000000004000", "5D86CB23639DBEA9",
-	"0000000000000000", "0000000000002000", "1D1CA853AE7C0C5F",
-	"0000000000000000", "0000000000001000", "CE332329248F3228",
-	"0000000000000000", "0000000000000800", "8405D1ABE24FB942",
-	"0000000000000000", "0000000000000400", "E643D78090CA4207",
-	"0000000000000000", "0000000000000200", "48221B9937748A23",
-	"0000000000000000", "0000000000000100", "DD7C0BBD61FAFD54",
-	"0000000000000000", "0000000000000080", "2FBC291A570DB5C4",
-	"0000000000000000", "0000000000000040", "E07C30D7E4E26E12",
-	"0000000000000000", "0000000000000020", "0953E2258E8E90A1",
-	"0000000000000000", "0000000000000010", "5B711BC4CEEBF2EE",
-	"0000000000000000", "0000000000000008", "CC083F1E6D9E85F6",
-	"0000000000000000", "0000000000000004", "D2FD8867D50D2DFE",
-	"0000000000000000", "0000000000000002", "06E7EA22CE92708F",
-	"0000000000000000", "0000000000000001", "166B40B44ABA4BD6",
-	"0000000000000000", "0000000000000000", "8CA64DE9C1B123A7",
-	"0101010101010101", "0101010101010101", "994D4DC157B96C52",
-	"0202020202020202", "0202020202020202", "E127C2B61D98E6E2",
-	"0303030303030303", "0303030303030303", "984C91D78A269CE3",
-	"0404040404040404", "0404040404040404", "1F4570BB77550683",
-	"0505050505050505", "0505050505050505", "3990ABF98D672B16",
-	"0606060606060606", "0606060606060606", "3F5150BBA081D585",
-	"0707070707070707", "0707070707070707", "C65242248C9CF6F2",
-	"0808080808080808", "0808080808080808", "10772D40FAD24257",
-	"0909090909090909", "0909090909090909", "F0139440647A6E7B",
-	"0A0A0A0A0A0A0A0A", "0A0A0A0A0A0A0A0A", "0A288603044D740C",
-	"0B0B0B0B0B0B0B0B", "0B0B0B0B0B0B0B0B", "6359916942F7438F",
-	"0C0C0C0C0C0C0C0C", "0C0C0C0C0C0C0C0C", "934316AE443CF08B",
-	"0D0D0D0D0D0D0D0D", "0D0D0D0D0D0D0D0D", "E3F56D7F1130A2B7",
-	"0E0E0E0E0E0E0E0E", "0E0E0E0E0E0E0E0E", "A2E4705087C6B6B4",
-	"0F0F0F0F0F0F0F0F", "0F0F0F0F0F0F0F0F", "D5D76E09A447E8C3",
-	"1010101010101010", "1010101010101010", "DD7515F2BFC17F85",
-	"1111111111111111", "1111111111111111", "F40379AB9E0EC533",
-	"1212121212121212", "1212121212121212", "96CD27784D1563E5",
-	"1313131313131313", "1313131313131313", "2911CF5E94D33FE1",
-	"1414141414141414", "1414141414141414", "377B7F7CA3E5BBB3",
-	"1515151515151515", "1515151515151515", "701AA63832905A92",
-	"1616161616161616", "1616161616161616", "2006E716C4252D6D",
-	"1717171717171717", "1717171717171717", "452C1197422469F8",
-	"1818181818181818", "1818181818181818", "C33FD1EB49CB64DA",
-	"1919191919191919", "1919191919191919", "7572278F364EB50D",
-	"1A1A1A1A1A1A1A1A", "1A1A1A1A1A1A1A1A", "69E51488403EF4C3",
-	"1B1B1B1B1B1B1B1B", "1B1B1B1B1B1B1B1B", "FF847E0ADF192825",
-	"1C1C1C1C1C1C1C1C", "1C1C1C1C1C1C1C1C", "521B7FB3B41BB791",
-	"1D1D1D1D1D1D1D1D", "1D1D1D1D1D1D1D1D", "26059A6A0F3F6B35",
-	"1E1E1E1E1E1E1E1E", "1E1E1E1E1E1E1E1E", "F24A8D2231C77538",
-	"1F1F1F1F1F1F1F1F", "1F1F1F1F1F1F1F1F", "4FD96EC0D3304EF6",
-	"2020202020202020", "2020202020202020", "18A9D580A900B699",
-	"2121212121212121", "2121212121212121", "88586E1D755B9B5A",
+static void
+check_GCM_kernel_records(const br_gcm_kernel_class *kern, size_t key_len)
+{
+	br_sslrec_gcm_context oc1, oc2, ic1, ic2, ic3;
+	unsigned char key[32], iv[4];
+	unsigned char rec1[16384 + 100], rec2[16384 + 100];
+	unsigned char tmp[16384 + 100];
+	size_t u, len;
+
+	memset(key, 'K', sizeof key);
+	memset(iv, 'I', sizeof iv);
+	br_sslrec_out_gcm_vtable.init(&oc1.vtable.out, kern->ctr_vtable,
+		key, key_len, &br_ghash_ctmul, iv);
+	br_sslrec_out_gcm_vtable.init(&oc2.vtable.out, kern->ctr_vtable,
+		key, key_len, &br_ghash_ctmul, iv);
+	br_sslrec_gcm_set_kernel(&oc2, kern);
+	br_sslrec_in_gcm_vtable.init(&ic1.vtable.in, kern->ctr_vtable,
+		key, key_len, &br_ghash_ctmul, iv);
+	br_sslrec_in_gcm_vtable.init(&ic2.vtable.in, kern->ctr_vtable,
+		key, key_len, &br_ghash_ctmul, iv);
+	br_sslrec_gcm_set_kernel(&ic2, kern);
+	if (oc1.kern != NULL || oc2.kern != kern || ic2.kern != kern) {
+		fprintf(stderr, "GCM kernel not set\n");
+		exit(EXIT_FAILURE);
+	}
+	for (len = 0; len <= 16384; len += (len < 300) ? 1 : 4021) {
+		size_t a1, b1, a2, b2, r1, r2;
+		unsigned char *p1, *p2, *d;
+
+		a1 = 5;
+		b1 = sizeof rec1;
+		oc1.vtable.out->inner.max_plaintext(
+			(const br_sslrec_out_class *const *)&oc1.vtable.out,
+			&a1, &b1);
+		a2 = 5;
+		b2 = sizeof rec2;
+		oc2.vtable.out->inner.max_plaintext(
+			(const br_sslrec_out_class *const *)&oc2.vtable.out,
+			&a2, &b2);
+		for (u = 0; u < len; u ++) {
+			rec1[a1 + u] = (unsigned char)(u * 11 + len);
+			rec2[a2 + u] = (unsigned char)(u * 11 + len);
+		}
+		r1 = len;
+		p1 = oc1.vtable.out->inner.encrypt(
+			(const br_sslrec_out_class **)&oc1.vtable.out,
+			23, 0x0303, rec1 + a1, &r1);
+		r2 = len;
+		p2 = oc2.vtable.out->inner.encrypt(
+			(const br_sslrec_out_class **)&oc2.vtable.out,
+			23, 0x0303, rec2 + a2, &r2);
+		if (r1 != r2) {
+			fprintf(stderr, "GCM kernel record length\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("GCM kernel record", p1, p2, r1);
+
+		/*
+		 * Altered record: flip one bit (in the data, or in the
+		 * tag for empty records).
+		 */
+		ic3 = ic2;
+		memcpy(tmp, p2, r2);
+		tmp[13 + (len >> 1)] ^= 0x01;
+		r2 -= 5;
+		if (ic3.vtable.in->inner.decrypt(
+			(const br_sslrec_in_class **)&ic3.vtable.in,
+			23, 0x0303, tmp + 5, &r2) != NULL)
+		{
+			fprintf(stderr, "GCM kernel: altered record accepted\n");
+			exit(EXIT_FAILURE);
+		}
+
+		/*
+		 * Decrypt with the kernel the record produced without the
+		 * kernel, and vice versa.
+		 */
+		r1 -= 5;
+		d = ic2.vtable.in->inner.decrypt(
+			(const br_sslrec_in_class **)&ic2.vtable.in,
+			23, 0x0303, p1 + 5, &r1);
+		if (d == NULL || r1 != len) {
+			fprintf(stderr, "GCM kernel: decryption failed\n");
+			exit(EXIT_FAILURE);
+		}
+		for (u = 0; u < len; u ++) {
+			if (d[u] != (unsigned char)(u * 11 + len)) {
+				fprintf(stderr, "GCM kernel: wrong plaintext\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+		r2 = len + 24;
+		d = ic1.vtable.in->inner.decrypt(
+			(const br_sslrec_in_class **)&ic1.vtable.in,
+			23, 0x0303, p2 + 5, &r2);
+		if (d == NULL || r2 != len) {
+			fprintf(stderr, "GCM kernel: decryption failed\n");
+			exit(EXIT_FAILURE);
+		}
+		for (u = 0; u < len; u ++) {
+			if (d[u] != (unsigned char)(u * 11 + len)) {
+				fprintf(stderr, "GCM kernel: wrong plaintext\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+}
+
+static void
+test_GCM_kernel_x86ni(void)
+{
+	const br_gcm_kernel_class *kern;
+	br_aes_x86ni_ctr_keys kc;
+	br_sslrec_gcm_context gc;
+	unsigned char key[32], iv[12], h[16];
+	unsigned char ref[300], buf[300], y1[16], y2[16];
+	size_t u, len;
+
+	kern = br_aes_x86ni_gcm_kernel_get();
+	if (kern == NULL) {
+		printf("Test GCM_kernel_x86ni: UNAVAILABLE\n");
+		return;
+	}
+	printf("Test GCM_kernel_x86ni: ");
+	fflush(stdout);
+
+	/*
+	 * Compare the kernel output with separate CTR and GHASH passes,
+	 * for all key sizes and data lengths up to 300 bytes.
+	 */
+	for (u = 0; u < sizeof key; u ++) {
+		key[u] = (unsigned char)(u * 17 + 5);
+	}
+	memset(iv, 'X', sizeof iv);
+	memset(h, 'H', sizeof h);
+	for (u = 16; u <= 32; u += 8) {
+		kern->ctr_vtable->init(&kc.vtable, key, u);
+		for (len = 0; len <= sizeof ref; len ++) {
+			size_t v;
+			uint32_t cc1, cc2;
+
+			for (v = 0; v < len; v ++) {
+				ref[v] = (unsigned char)(v * 3 + len);
+			}
+			memcpy(buf, ref, len);
+			memset(y1, (int)len, sizeof y1);
+			memset(y2, (int)len, sizeof y2);
+			cc1 = kc.vtable->run(&kc.vtable, iv, 7, ref, len);
+			br_ghash_ctmul(y1, h, ref, len);
+			cc2 = kern->encrypt(&kc.vtable, iv, 7, h, y2, buf, len);
+			check_equals("GCM kernel encrypt", ref, buf, len);
+			check_equals("GCM kernel encrypt (tag)", y1, y2, 16);
+			if (cc1 != cc2) {
+				fprintf(stderr, "GCM kernel: wrong counter\n");
+				exit(EXIT_FAILURE);
+			}
+			memset(y2, (int)len, sizeof y2);
+			kern->decrypt(&kc.vtable, iv, 7, h, y2, buf, len);
+			kc.vtable->run(&kc.vtable, iv, 7, ref, len);
+			check_equals("GCM kernel decrypt", ref, buf, len);
+			check_equals("GCM kernel decrypt (tag)", y1, y2, 16);
+		}
+		printf(".");
+		fflush(stdout);
+	}
+
+	/*
+	 * Records must not depend on whether the kernel is used. The
+	 * kernel must be refused for another CTR implementation.
+	 */
+	check_GCM_kernel_records(kern, 16);
+	check_GCM_kernel_records(kern, 32);
+	printf(".");
+	fflush(stdout);
+	br_sslrec_out_gcm_vtable.init(&gc.vtable.out,
+		&br_aes_ct_ctr_vtable, key, 16, &br_ghash_ctmul, iv);
+	br_sslrec_gcm_set_kernel(&gc, kern);
+	if (gc.kern != NULL) {
+		fprintf(stderr, "GCM kernel accepted (cipher)\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+/*
+ * Compare CBC decryption and CTR with aes_ct64, for lengths that cover
+ * full and partial groups of parallel blocks, and counters that wrap
+ * around.
+ */
+static void
+test_AES_ct64_cross(char *name,
+	const br_block_cbcdec_class *vd, const br_block_ctr_class *vc)
+{
+	unsigned char key[32], iv[16], iv2[16];
+	unsigned char ref[1024], buf1[1024], buf2[1024];
+	size_t u, key_len, len;
+
+	printf("Test %s (cross-check): ", name);
+	fflush(stdout);
+
+	for (u = 0; u < sizeof ref; u ++) {
+		ref[u] = (unsigned char)(u * 11 + 5);
+	}
+	for (key_len = 16; key_len <= 32; key_len += 8) {
+		br_aes_ct64_cbcdec_keys d_ref;
+		br_aes_ct64_ctr_keys c_ref;
+		br_aes_gen_cbcdec_keys v_dc;
+		br_aes_gen_ctr_keys v_xc;
+
+		for (u = 0; u < key_len; u ++) {
+			key[u] = (unsigned char)(u * 3 + key_len);
+		}
+		br_aes_ct64_cbcdec_init(&d_ref, key, key_len);
+		br_aes_ct64_ctr_init(&c_ref, key, key_len);
+		vd->init(&v_dc.vtable, key, key_len);
+		vc->init(&v_xc.vtable, key, key_len);
+
+		for (len = 0; len <= sizeof ref; len += 16) {
+			uint32_t cc0, cc1, cc2;
+
+			memset(iv, (int)len, sizeof iv);
+			memcpy(iv2, iv, sizeof iv);
+			memcpy(buf1, ref, len);
+			memcpy(buf2, ref, len);
+			br_aes_ct64_cbcdec_run(&d_ref, iv, buf1, len);
+			vd->run(&v_dc.vtable, iv2, buf2, len);
+			check_equals("CBC decrypt (cross-check)",
+				buf1, buf2, len);
+			check_equals("CBC decrypt IV (cross-check)",
+				iv, iv2, sizeof iv);
+
+			cc0 = (uint32_t)len * 0x01000193;
+			if ((len & 16) != 0) {
+				cc0 = 0xFFFFFFF8 + (uint32_t)((len >> 5) & 7);
+			}
+			memcpy(buf1, ref, len);
+			memcpy(buf2, ref, len);
+			cc1 = br_aes_ct64_ctr_run(&c_ref, iv, cc0, buf1, len);
+			cc2 = vc->run(&v_xc.vtable, iv, cc0, buf2, len);
+			check_equals("CTR (cross-check)", buf1, buf2, len);
+			if (cc1 != cc2) {
+				fprintf(stderr, "%s: wrong counter (%lu)\n",
+					name, (unsigned long)len);
+				exit(EXIT_FAILURE);
+			}
+		}
+		printf(".");
+		fflush(stdout);
+	}
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_AES_ct64_sse2(void)
+{
+	const br_block_cbcdec_class *x_cbcdec;
+	const br_block_ctr_class *x_ctr;
+
+	x_cbcdec = br_aes_ct64_sse2_cbcdec_get_vtable();
+	x_ctr = br_aes_ct64_sse2_ctr_get_vtable();
+	if (x_cbcdec == NULL || x_ctr == NULL) {
+		printf("Test AES_ct64_sse2: UNAVAILABLE\n");
+		return;
+	}
+	test_AES_generic("AES_ct64_sse2",
+		&br_aes_ct64_cbcenc_vtable, x_cbcdec, x_ctr, 1, 1);
+	test_AES_ct64_cross("AES_ct64_sse2", x_cbcdec, x_ctr);
+}
+
+static void
+test_AES_ct64_avx2(void)
+{
+	const br_block_cbcdec_class *x_cbcdec;
+	const br_block_ctr_class *x_ctr;
+
+	x_cbcdec = br_aes_ct64_avx2_cbcdec_get_vtable();
+	x_ctr = br_aes_ct64_avx2_ctr_get_vtable();
+	if (x_cbcdec == NULL || x_ctr == NULL) {
+		printf("Test AES_ct64_avx2: UNAVAILABLE\n");
+		return;
+	}
+	test_AES_generic("AES_ct64_avx2",
+		&br_aes_ct64_cbcenc_vtable, x_cbcdec, x_ctr, 1, 1);
+	test_AES_ct64_cross("AES_ct64_avx2", x_cbcdec, x_ctr);
+}
+
+/*
+ * Check one CBC+HMAC kernel call against separate CBC and hash passes;
+ * the hash context first receives 'plen' bytes from 'pre'.
+ */
+static void
+check_CBC_HMAC_kernel(const br_cbc_hmac_kernel_class *kern,
+	const br_block_cbcenc_class **kc, const br_hash_class *hf,
+	const unsigned char *pre, size_t plen, size_t len, int etm)
+{
+	br_hash_compat_context hc1, hc2;
+	unsigned char ref[320], buf[320], iv1[16], iv2[16], h1[64], h2[64];
+	size_t v;
+
+	for (v = 0; v < len; v ++) {
+		ref[v] = (unsigned char)(v * 3 + len + plen);
+	}
+	memcpy(buf, ref, len);
+	memset(iv1, (int)plen, sizeof iv1);
+	memset(iv2, (int)plen, sizeof iv2);
+	hf->init(&hc1.vtable);
+	hf->update(&hc1.vtable, pre, plen);
+	hf->init(&hc2.vtable);
+	hf->update(&hc2.vtable, pre, plen);
+	if (etm) {
+		(*kc)->run(kc, iv1, ref, len);
+		hf->update(&hc1.vtable, ref, len);
+		kern->encrypt_mac(kc, iv2, &hc2.vtable, buf, len);
+	} else {
+		hf->update(&hc1.vtable, ref, len);
+		(*kc)->run(kc, iv1, ref, len);
+		kern->mac_encrypt(kc, iv2, &hc2.vtable, buf, len);
+	}
+	hf->out(&hc1.vtable, h1);
+	hf->out(&hc2.vtable, h2);
+	check_equals("CBC+HMAC kernel (data)", ref, buf, len);
+	check_equals("CBC+HMAC kernel (IV)", iv1, iv2, 16);
+	check_equals("CBC+HMAC kernel (hash)", h1, h2, br_digest_size(hf));
+}
+
+/*
+ * Encrypt records of various lengths with an outgoing CBC record
+ * engine, with and without the kernel, and check that the records are
+ * identical.
+ */
+static void
+check_CBC_HMAC_kernel_records(const br_cbc_hmac_kernel_class *kern,
+	const br_sslrec_out_cbc_class *ro, const br_hash_class *dig,
+	unsigned version)
+{
+	br_sslrec_out_cbc_context oc1, oc2;
+	unsigned char key[16], mkey[32], iv[16];
+	unsigned char rec1[16384 + 400], rec2[16384 + 400];
+	size_t u, len, mlen;
+	const void *ivp;
+
+	memset(key, 'K', sizeof key);
+	memset(mkey, 'M', sizeof mkey);
+	memset(iv, 'I', sizeof iv);
+	mlen = br_digest_size(dig);
+	ivp = version >= 0x0302 ? NULL : iv;
+	ro->init(&oc1.vtable, kern->cbcenc_vtable, key, sizeof key,
+		dig, mkey, mlen, mlen, ivp);
+	ro->init(&oc2.vtable, kern->cbcenc_vtable, key, sizeof key,
+		dig, mkey, mlen, mlen, ivp);
+	br_sslrec_out_cbc_set_kernel(&oc2, kern);
+	if (oc1.kern != NULL || oc2.kern != kern) {
+		fprintf(stderr, "CBC+HMAC kernel not set\n");
+		exit(EXIT_FAILURE);
+	}
+	for (len = 0; len <= 16384; len += (len < 300) ? 1 : 4021) {
+		size_t a1, b1, a2, b2, r1, r2;
+		unsigned char *p1, *p2;
+
+		a1 = 5;
+		b1 = sizeof rec1;
+		oc1.vtable->inner.max_plaintext(
+			(const br_sslrec_out_class *const *)&oc1.vtable,
+			&a1, &b1);
+		a2 = 5;
+		b2 = sizeof rec2;
+		oc2.vtable->inner.max_plaintext(
+			(const br_sslrec_out_class *const *)&oc2.vtable,
+			&a2, &b2);
+		for (u = 0; u < len; u ++) {
+			rec1[a1 + u] = (unsigned char)(u * 11 + len);
+			rec2[a2 + u] = (unsigned char)(u * 11 + len);
+		}
+		r1 = len;
+		p1 = oc1.vtable->inner.encrypt(
+			(const br_sslrec_out_class **)&oc1.vtable,
+			23, version, rec1 + a1, &r1);
+		r2 = len;
+		p2 = oc2.vtable->inner.encrypt(
+			(const br_sslrec_out_class **)&oc2.vtable,
+			23, version, rec2 + a2, &r2);
+		if (r1 != r2) {
+			fprintf(stderr, "CBC+HMAC kernel record length\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("CBC+HMAC kernel record", p1, p2, r1);
+	}
+}
+
+static void
+test_CBC_HMAC_kernel_x86ni(void)
+{
+	const br_hash_class *hashes[5];
+	const br_cbc_hmac_kernel_class *kern;
+	br_aes_x86ni_cbcenc_keys kc;
+	unsigned char key[32], pre[64];
+	size_t u, w, plen, len;
+
+	kern = br_aes_x86ni_cbc_hmac_kernel_get();
+	if (kern == NULL) {
+		printf("Test CBC_HMAC_kernel_x86ni: UNAVAILABLE\n");
+		return;
+	}
+	printf("Test CBC_HMAC_kernel_x86ni: ");
+	fflush(stdout);
+
+	/*
+	 * Compare the kernel output with separate CBC and hash passes,
+	 * for all key sizes, all supported hash functions (with both
+	 * the portable and the SHA-opcode implementations, which share
+	 * the same context structure), data lengths up to 320 bytes,
+	 * and hash contexts that already contain 0 to 63 bytes, in both
+	 * MAC-then-encrypt and Encrypt-then-MAC order.
+	 */
+	hashes[0] = &br_sha1_vtable;
+	hashes[1] = &br_sha224_vtable;
+	hashes[2] = &br_sha256_vtable;
+	hashes[3] = br_sha1_x86ni_get_vtable();
+	hashes[4] = br_sha256_x86ni_get_vtable();
+	for (u = 0; u < sizeof key; u ++) {
+		key[u] = (unsigned char)(u * 17 + 5);
+	}
+	for (u = 0; u < sizeof pre; u ++) {
+		pre[u] = (unsigned char)(u * 7 + 3);
+	}
+	for (u = 16; u <= 32; u += 8) {
+		kern->cbcenc_vtable->init(&kc.vtable, key, u);
+		for (w = 0; w < (sizeof hashes) / (sizeof hashes[0]); w ++) {
+			if (hashes[w] == NULL) {
+				continue;
+			}
+			for (plen = 0; plen < sizeof pre; plen ++) {
+				for (len = 0; len <= 320; len += 16) {
+					check_CBC_HMAC_kernel(kern, &kc.vtable,
+						hashes[w], pre, plen, len, 0);
+					check_CBC_HMAC_kernel(kern, &kc.vtable,
+						hashes[w], pre, plen, len, 1);
+				}
+			}
+			printf(".");
+			fflush(stdout);
+		}
+	}
+
+	/*
+	 * Records must not depend on whether the kernel is used. The
+	 * kernel must be refused for another CBC implementation, or an
+	 * unsupported hash function.
+	 */
+	for (u = 0x0301; u <= 0x0303; u ++) {
+		check_CBC_HMAC_kernel_records(kern,
+			&br_sslrec_out_cbc_vtable, &br_sha1_vtable, u);
+		check_CBC_HMAC_kernel_records(kern,
+			&br_sslrec_out_cbc_vtable, &br_sha256_vtable, u);
+		check_CBC_HMAC_kernel_records(kern,
+			&br_sslrec_out_cbc_etm_vtable, &br_sha1_vtable, u);
+		printf(".");
+		fflush(stdout);
+	}
+	{
+		br_sslrec_out_cbc_context oc;
+
+		br_sslrec_out_cbc_vtable.init(&oc.vtable,
+			&br_aes_ct_cbcenc_vtable, key, 16,
+			&br_sha1_vtable, key, 20, 20, NULL);
+		br_sslrec_out_cbc_set_kernel(&oc, kern);
+		if (oc.kern != NULL) {
+			fprintf(stderr, "CBC+HMAC kernel accepted (cipher)\n");
+			exit(EXIT_FAILURE);
+		}
+		br_sslrec_out_cbc_vtable.init(&oc.vtable,
+			kern->cbcenc_vtable, key, 16,
+			&br_sha384_vtable, key, 32, 32, NULL);
+		br_sslrec_out_cbc_set_kernel(&oc, kern);
+		if (oc.kern != NULL) {
+			fprintf(stderr, "CBC+HMAC kernel accepted (hash)\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+/*
+ * Decrypt a sequence of records (as produced by an outgoing record
+ * engine), and check that the concatenated plaintext matches 'ref'.
+ */
+static void
+check_CBC_EtM_records(br_sslrec_in_cbc_context *ic, unsigned version,
+	unsigned char *rec, size_t rlen, const unsigned char *ref, size_t len)
+{
+	size_t off;
+
+	off = 0;
+	while (rlen > 0) {
+		unsigned char *buf;
+		size_t blen, dlen;
+
+		if (rlen < 5 || rec[0] != 23 || br_dec16be(rec + 1) != version) {
+			fprintf(stderr, "EtM: wrong record header\n");
+			exit(EXIT_FAILURE);
+		}
+		blen = br_dec16be(rec + 3);
+		if (blen > rlen - 5 || !ic->vtable->inner.check_length(
+			(const br_sslrec_in_class *const *)&ic->vtable, blen))
+		{
+			fprintf(stderr, "EtM: wrong record length\n");
+			exit(EXIT_FAILURE);
+		}
+		dlen = blen;
+		buf = ic->vtable->inner.decrypt(
+			(const br_sslrec_in_class **)&ic->vtable,
+			23, version, rec + 5, &dlen);
+		if (buf == NULL || dlen > len - off) {
+			fprintf(stderr, "EtM: decryption failed\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("EtM (data)", buf, ref + off, dlen);
+		off += dlen;
+		rec += 5 + blen;
+		rlen -= 5 + blen;
+	}
+	if (off != len) {
+		fprintf(stderr, "EtM: wrong plaintext length\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+/*
+ * Build a TLS 1.1+ Encrypt-then-MAC record "by hand", from a plaintext
+ * that already includes its padding (which may be invalid). The record
+ * body (without header) is written in 'rec', and its length returned.
+ */
+static size_t
+make_CBC_EtM_record(unsigned char *rec, const unsigned char *key,
+	const unsigned char *mkey, uint64_t seq,
+	const unsigned char *plain, size_t plen)
+{
+	br_aes_ct_cbcenc_keys ec;
+	br_hmac_key_context kc;
+	br_hmac_context hc;
+	unsigned char iv[16], tmp[13];
+	size_t len;
+
+	memset(rec, 0xA5, 16);
+	memcpy(iv, rec, 16);
+	memcpy(rec + 16, plain, plen);
+	br_aes_ct_cbcenc_init(&ec, key, 16);
+	br_aes_ct_cbcenc_run(&ec, iv, rec + 16, plen);
+	len = 16 + plen;
+	br_enc64be(tmp, seq);
+	tmp[8] = 23;
+	br_enc16be(tmp + 9, 0x0303);
+	br_enc16be(tmp + 11, len);
+	br_hmac_key_init(&kc, &br_sha1_vtable, mkey, 20);
+	br_hmac_init(&hc, &kc, 20);
+	br_hmac_update(&hc, tmp, 13);
+	br_hmac_update(&hc, rec, len);
+	br_hmac_out(&hc, rec + len);
+	return len + 20;
+}
+
+static void
+test_CBC_EtM(void)
+{
+	static const br_hash_class *const hashes[] = {
+		&br_sha1_vtable, &br_sha256_vtable
+	};
+
+	unsigned char rec[5 + 16 + 16384 + 256 + 64];
+	unsigned char rec2[sizeof rec];
+	unsigned char ref[16384];
+	unsigned char key[16], mkey[32], iv[16];
+	br_sslrec_out_cbc_context oc;
+	br_sslrec_in_cbc_context ic, ic2;
+	size_t u, v, len, mlen, rlen;
+	int w, explicit_IV;
+
+	printf("Test CBC_EtM: ");
+	fflush(stdout);
+
+	for (u = 0; u < sizeof ref; u ++) {
+		ref[u] = (unsigned char)(u * 13 + 1);
+	}
+	memset(key, 'K', sizeof key);
+	memset(mkey, 'M', sizeof mkey);
+	memset(iv, 'I', sizeof iv);
+
+	/*
+	 * Round-trip of successive records of various lengths, with
+	 * the same contexts (so that sequence numbers and chained IVs
+	 * are exercised). Without an explicit IV (TLS 1.0), records
+	 * of more than one byte must be split into a one-byte record
+	 * and a record with the rest of the data.
+	 */
+	for (w = 0; w < 2; w ++) {
+		for (explicit_IV = 0; explicit_IV <= 1; explicit_IV ++) {
+			unsigned version;
+
+			version = explicit_IV ? 0x0303 : 0x0301;
+			mlen = br_digest_size(hashes[w]);
+			br_sslrec_out_cbc_etm_vtable.init(&oc.vtable,
+				&br_aes_ct_cbcenc_vtable, key, sizeof key,
+				hashes[w], mkey, sizeof mkey, mlen,
+				explicit_IV ? NULL : iv);
+			br_sslrec_in_cbc_etm_vtable.init(&ic.vtable,
+				&br_aes_ct_cbcdec_vtable, key, sizeof key,
+				hashes[w], mkey, sizeof mkey, mlen,
+				explicit_IV ? NULL : iv);
+			for (len = 0; len <= 16384;
+				len += (len < 300) ? 1 : 4021)
+			{
+				size_t a, b;
+				unsigned char *buf;
+
+				a = 5;
+				b = sizeof rec;
+				oc.vtable->inner.max_plaintext(
+					(const br_sslrec_out_class *const *)
+					&oc.vtable, &a, &b);
+				if (b - a < len) {
+					fprintf(stderr, "EtM: no room\n");
+					exit(EXIT_FAILURE);
+				}
+				memcpy(rec + a, ref, len);
+				rlen = len;
+				buf = oc.vtable->inner.encrypt(
+					(const br_sslrec_out_class **)
+					&oc.vtable, 23, version, rec + a, &rlen);
+				if (!explicit_IV && len > 1) {
+					if (br_dec16be(buf + 3) != 16 + mlen) {
+						fprintf(stderr,
+							"EtM: no 1/n-1 split\n");
+						exit(EXIT_FAILURE);
+					}
+				} else if (br_dec16be(buf + 3) != rlen - 5) {
+					fprintf(stderr, "EtM: extra record\n");
+					exit(EXIT_FAILURE);
+				}
+				check_CBC_EtM_records(&ic, version,
+					buf, rlen, ref, len);
+			}
+			printf(".");
+			fflush(stdout);
+		}
+	}
+
+	/*
+	 * Flipping any single bit of a record (explicit IV, ciphertext,
+	 * padding or MAC) must make it fail.
+	 */
+	br_sslrec_out_cbc_etm_vtable.init(&oc.vtable,
+		&br_aes_ct_cbcenc_vtable, key, sizeof key,
+		&br_sha1_vtable, mkey, 20, 20, NULL);
+	br_sslrec_in_cbc_etm_vtable.init(&ic.vtable,
+		&br_aes_ct_cbcdec_vtable, key, sizeof key,
+		&br_sha1_vtable, mkey, 20, 20, NULL);
+	memcpy(rec + 5 + 16, ref, 100);
+	rlen = 100;
+	oc.vtable->inner.encrypt((const br_sslrec_out_class **)&oc.vtable,
+		23, 0x0303, rec + 5 + 16, &rlen);
+	rlen -= 5;
+	for (u = 0; u < rlen * 8; u ++) {
+		size_t dlen;
+
+		memcpy(rec2, rec + 5, rlen);
+		rec2[u >> 3] ^= 1 << (u & 7);
+		ic2 = ic;
+		dlen = rlen;
+		if (ic2.vtable->inner.decrypt(
+			(const br_sslrec_in_class **)&ic2.vtable,
+			23, 0x0303, rec2, &dlen) != NULL)
+		{
+			fprintf(stderr, "EtM: altered record accepted"
+				" (bit %lu)\n", (unsigned long)u);
+			exit(EXIT_FAILURE);
+		}
+	}
+	check_CBC_EtM_records(&ic, 0x0303, rec, rlen + 5, ref, 100);
+	printf(".");
+	fflush(stdout);
+
+	/*
+	 * Records with a valid MAC but an invalid padding must also be
+	 * rejected. The first record is valid, to check the record
+	 * construction itself.
+	 */
+	for (v = 0; v < 4; v ++) {
+		unsigned char plain[48];
+		unsigned char *buf;
+		size_t dlen;
+
+		memcpy(plain, ref, sizeof plain);
+		switch (v) {
+		case 0:
+			/* valid: 40 bytes of data, 8 bytes of padding */
+			memset(plain + 40, 7, 8);
+			break;
+		case 1:
+			/* one padding byte differs from the others */
+			memset(plain + 40, 7, 8);
+			plain[42] = 6;
+			break;
+		case 2:
+			/* padding length larger than the data */
+			plain[47] = 48;
+			break;
+		default:
+			/* padding longer than a block, one byte differs */
+			memset(plain + 8, 39, 40);
+			plain[20] ^= 1;
+			break;
+		}
+		ic2 = ic;
+		dlen = make_CBC_EtM_record(rec2, key, mkey,
+			ic2.seq, plain, sizeof plain);
+		buf = ic2.vtable->inner.decrypt(
+			(const br_sslrec_in_class **)&ic2.vtable,
+			23, 0x0303, rec2, &dlen);
+		if (v == 0) {
+			if (buf == NULL || dlen != 40) {
+				fprintf(stderr, "EtM: valid record rejected\n");
+				exit(EXIT_FAILURE);
+			}
+			check_equals("EtM (manual record)", buf, ref, 40);
+		} else if (buf != NULL) {
+			fprintf(stderr, "EtM: bad padding accepted (%lu)\n",
+				(unsigned long)v);
+			exit(EXIT_FAILURE);
+		}
+	}
+	printf(".");
+	fflush(stdout);
+
+	/*
+	 * Bounds for check_length(): the encrypted part (after removing
+	 * the MAC) must contain at least one block of data (plus the
+	 * explicit IV, if any), at most 16384 + 256 bytes (rounded down
+	 * to a multiple of the block size), and be a multiple of the
+	 * block size.
+	 */
+	for (explicit_IV = 0; explicit_IV <= 1; explicit_IV ++) {
+		static const struct {
+			size_t len;
+			int ok;
+		} bounds[] = {
+			{ 0, 0 }, { 19, 0 }, { 20, 0 }, { 20 + 15, 0 },
+			{ 20 + 16, 1 }, { 20 + 17, 0 }, { 20 + 32, 1 },
+			{ 20 + 16640 - 16, 1 }, { 20 + 16640, 1 },
+			{ 20 + 16640 + 16, 1 }, { 20 + 16640 + 32, 0 }
+		};
+
+		br_sslrec_in_cbc_etm_vtable.init(&ic.vtable,
+			&br_aes_ct_cbcdec_vtable, key, sizeof key,
+			&br_sha1_vtable, mkey, 20, 20,
+			explicit_IV ? NULL : iv);
+		for (u = 0; u < (sizeof bounds) / sizeof(bounds[0]); u ++) {
+			size_t blen;
+			int ok;
+
+			/*
+			 * With an explicit IV, there is one extra block
+			 * at both ends of the range.
+			 */
+			blen = bounds[u].len;
+			ok = bounds[u].ok;
+			if (explicit_IV) {
+				if (blen == 20 + 16) {
+					ok = 0;
+				}
+			} else {
+				if (blen == 20 + 16640 + 16) {
+					ok = 0;
+				}
+			}
+			if (ic.vtable->inner.check_length(
+				(const br_sslrec_in_class *const *)&ic.vtable,
+				blen) != ok)
+			{
+				fprintf(stderr, "EtM: wrong check_length()"
+					" for %lu (explicit IV: %d)\n",
+					(unsigned long)blen, explicit_IV);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+	printf(".");
+	fflush(stdout);
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+/*
+ * CCM test vectors, from NIST SP 800-38C (appendix C): key, nonce,
+ * additional data, plaintext, and ciphertext with the tag appended.
+ */
+static const char *const KAT_CCM[] = {
+	"404142434445464748494a4b4c4d4e4f",
+	"10111213141516",
+	"0001020304050607",
+	"20212223",
+	"7162015b4dac255d",
+
+	"404142434445464748494a4b4c4d4e4f",
+	"1011121314151617",
+	"000102030405060708090a0b0c0d0e0f",
+	"202122232425262728292a2b2c2d2e2f",
+	"d2a1f0e051ea5f62081a7792073d593d1fc64fbfaccd",
+
+	"404142434445464748494a4b4c4d4e4f",
+	"101112131415161718191a1b",
+	"000102030405060708090a0b0c0d0e0f10111213",
+	"202122232425262728292a2b2c2d2e2f3031323334353637",
+	"e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5484392fbc1b09951",
+
+	NULL
+};
+
+static void
+test_CCM_generic(char *name,
+	const br_block_cbcenc_class *ve, const br_block_ctr_class *vc)
+{
+	br_aes_gen_cbcenc_keys ke, ke_ref;
+	br_aes_gen_ctr_keys kc, kc_ref;
+	unsigned char key[32], nonce[13], aad[300];
+	unsigned char plain[1000], cipher[1000], buf[1000];
+	unsigned char tag[16], tag_ref[16];
+	size_t u, key_len, nonce_len, aad_len, len, tag_len;
+
+	printf("Test %s: ", name);
+	fflush(stdout);
+
+	for (u = 0; KAT_CCM[u]; u += 5) {
+		key_len = hextobin(key, KAT_CCM[u]);
+		nonce_len = hextobin(nonce, KAT_CCM[u + 1]);
+		aad_len = hextobin(aad, KAT_CCM[u + 2]);
+		len = hextobin(plain, KAT_CCM[u + 3]);
+		tag_len = hextobin(cipher, KAT_CCM[u + 4]) - len;
+		ve->init(&ke.vtable, key, key_len);
+		vc->init(&kc.vtable, key, key_len);
+
+		memcpy(buf, plain, len);
+		br_ccm_run(&ke.vtable, &kc.vtable, nonce, nonce_len,
+			aad, aad_len, buf, len, tag, tag_len, 1);
+		check_equals("KAT CCM (enc)", buf, cipher, len);
+		check_equals("KAT CCM (tag 1)", tag, cipher + len, tag_len);
+		br_ccm_run(&ke.vtable, &kc.vtable, nonce, nonce_len,
+			aad, aad_len, buf, len, tag, tag_len, 0);
+		check_equals("KAT CCM (dec)", buf, plain, len);
+		check_equals("KAT CCM (tag 2)", tag, cipher + len, tag_len);
+		printf(".");
+		fflush(stdout);
+	}
+
+	/*
+	 * Compare with the 'aes_big' implementation on longer inputs
+	 * (additional data and plaintext larger than the internal
+	 * CBC-MAC buffer), for all key sizes.
+	 */
+	for (u = 0; u < sizeof plain; u ++) {
+		plain[u] = (unsigned char)(u * 13 + 1);
+	}
+	for (u = 0; u < sizeof aad; u ++) {
+		aad[u] = (unsigned char)(u * 7 + 2);
+	}
+	for (key_len = 16; key_len <= 32; key_len += 8) {
+		for (u = 0; u < key_len; u ++) {
+			key[u] = (unsigned char)(u + key_len);
+		}
+		ve->init(&ke.vtable, key, key_len);
+		vc->init(&kc.vtable, key, key_len);
+		br_aes_big_cbcenc_init(&ke_ref.big, key, key_len);
+		br_aes_big_ctr_init(&kc_ref.big, key, key_len);
+		for (len = 0; len <= sizeof plain; len += 97) {
+			aad_len = len % (sizeof aad);
+			memset(nonce, (int)len, sizeof nonce);
+			memcpy(cipher, plain, len);
+			br_ccm_run(&ke_ref.vtable, &kc_ref.vtable,
+				nonce, 12, aad, aad_len,
+				cipher, len, tag_ref, 16, 1);
+			memcpy(buf, plain, len);
+			br_ccm_run(&ke.vtable, &kc.vtable, nonce, 12,
+				aad, aad_len, buf, len, tag, 16, 1);
+			check_equals("CCM (cross-check enc)", buf, cipher, len);
+			check_equals("CCM (cross-check tag)", tag, tag_ref, 16);
+			br_ccm_run(&ke.vtable, &kc.vtable, nonce, 12,
+				aad, aad_len, buf, len, tag, 16, 0);
+			check_equals("CCM (cross-check dec)", buf, plain, len);
+			check_equals("CCM (cross-check tag)", tag, tag_ref, 16);
+		}
+		printf(".");
+		fflush(stdout);
+	}
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_CCM(void)
+{
+	const br_block_cbcenc_class *x_cbcenc;
+	const br_block_ctr_class *x_ctr;
+
+	test_CCM_generic("CCM (aes_big)",
+		&br_aes_big_cbcenc_vtable, &br_aes_big_ctr_vtable);
+	test_CCM_generic("CCM (aes_ct)",
+		&br_aes_ct_cbcenc_vtable, &br_aes_ct_ctr_vtable);
+	test_CCM_generic("CCM (aes_ct64)",
+		&br_aes_ct64_cbcenc_vtable, &br_aes_ct64_ctr_vtable);
+	x_cbcenc = br_aes_x86ni_cbcenc_get_vtable();
+	x_ctr = br_aes_x86ni_ctr_get_vtable();
+	if (x_cbcenc != NULL && x_ctr != NULL) {
+		test_CCM_generic("CCM (aes_x86ni)", x_cbcenc, x_ctr);
+	}
+}
+
+/*
+ * ChaCha20 and ChaCha20+Poly1305 test vectors, from RFC 7539 (sections
+ * 2.4.2 and 2.8.2).
+ */
+static const char *const SUNSCREEN_PLAIN =
+	"4c616469657320616e642047656e746c656d656e206f662074686520636c6173"
+	"73206f66202739393a204966204920636f756c64206f6666657220796f75206f"
+	"6e6c79206f6e652074697020666f7220746865206675747572652c2073756e73"
+	"637265656e20776f756c642062652069742e";
+
+static void
+test_ChaCha20_generic(char *name, br_chacha20_run cr)
+{
+	unsigned char key[32], nonce[12], plain[200], cipher[200], buf[200];
+	unsigned char buf2[1200];
+	size_t u, len;
+
+	printf("Test %s: ", name);
+	fflush(stdout);
+
+	hextobin(key, "000102030405060708090a0b0c0d0e0f"
+		"101112131415161718191a1b1c1d1e1f");
+	hextobin(nonce, "000000000000004a00000000");
+	len = hextobin(plain, SUNSCREEN_PLAIN);
+	hextobin(cipher,
+		"6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+		"f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+		"07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+		"5af90bbf74a35be6b40b8eedf2785e42874d");
+	memcpy(buf, plain, len);
+	if (cr(key, nonce, 1, buf, len) != 3) {
+		fprintf(stderr, "ChaCha20: wrong counter\n");
+		exit(EXIT_FAILURE);
+	}
+	check_equals("KAT ChaCha20", buf, cipher, len);
+
+	/*
+	 * Processing by chunks must yield the same result, provided
+	 * that chunk lengths are multiple of 64 (except the last one).
+	 */
+	for (u = 0; u <= len; u += 64) {
+		uint32_t cc;
+
+		memcpy(buf, plain, len);
+		cc = cr(key, nonce, 1, buf, u);
+		cr(key, nonce, cc, buf + u, len - u);
+		check_equals("KAT ChaCha20 (chunks)", buf, cipher, len);
+		printf(".");
+		fflush(stdout);
+	}
+
+	/*
+	 * Compare with the reference implementation on longer inputs,
+	 * so that multi-block code paths and partial final blocks are
+	 * exercised. Initial counters close to 2^32 also check the
+	 * counter wrap-around.
+	 */
+	if (cr != &br_chacha20_ct_run) {
+		unsigned char ref[1200], tmp[1200];
+		uint32_t cc1, cc2;
+
+		for (u = 0; u < sizeof ref; u ++) {
+			ref[u] = (unsigned char)(u * 7 + 3);
+		}
+		for (len = 0; len <= sizeof ref; len += 1 + (len >> 3)) {
+			uint32_t cc0;
+
+			cc0 = (uint32_t)len * 0x01000193;
+			if ((len & 1) != 0) {
+				cc0 = 0xFFFFFFFC + (uint32_t)(len & 7);
+			}
+			memcpy(tmp, ref, len);
+			cc1 = br_chacha20_ct_run(key, nonce, cc0, tmp, len);
+			memcpy(buf2, ref, len);
+			cc2 = cr(key, nonce, cc0, buf2, len);
+			check_equals("ChaCha20 (cross-check)", buf2, tmp, len);
+			if (cc1 != cc2) {
+				fprintf(stderr, "ChaCha20: wrong counter (%lu)\n",
+					(unsigned long)len);
+				exit(EXIT_FAILURE);
+			}
+		}
+		printf(".");
+		fflush(stdout);
+	}
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_ChaCha20_ct(void)
+{
+	test_ChaCha20_generic("ChaCha20_ct", &br_chacha20_ct_run);
+}
+
+static void
+test_ChaCha20_sse2(void)
+{
+	br_chacha20_run cr;
+
+	cr = br_chacha20_sse2_get();
+	if (cr == 0) {
+		printf("Test ChaCha20_sse2: UNAVAILABLE\n");
+		return;
+	}
+	test_ChaCha20_generic("ChaCha20_sse2", cr);
+}
+
+static void
+test_ChaCha20_avx2(void)
+{
+	br_chacha20_run cr;
+
+	cr = br_chacha20_avx2_get();
+	if (cr == 0) {
+		printf("Test ChaCha20_avx2: UNAVAILABLE\n");
+		return;
+	}
+	test_ChaCha20_generic("ChaCha20_avx2", cr);
+}
+
+/*
+ * Reference Poly1305 MAC (RFC 7539), computed with the generic i31 big
+ * integer code. This is slow but simple; it is used to check the
+ * optimised implementations.
+ */
+static void
+poly1305_ref_mac(const unsigned char *pkey,
+	const unsigned char *msg, size_t len, unsigned char *tag)
+{
+	static const unsigned char P1305[] = {
+		0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFB
+	};
+
+	uint32_t p[7], r[7], a[7], t[7];
+	uint32_t p0i, ctl, cc;
+	unsigned char rb[16], tmp[17];
+	size_t u, v;
+
+	br_i31_decode(p, P1305, sizeof P1305);
+	p0i = br_i31_ninv31(p[1]);
+
+	/*
+	 * Clamp r, and convert it to Montgomery representation so that
+	 * a Montgomery multiplication by r is a plain multiplication.
+	 */
+	memcpy(rb, pkey, 16);
+	rb[3] &= 0x0F;
+	rb[7] &= 0x0F;
+	rb[11] &= 0x0F;
+	rb[15] &= 0x0F;
+	rb[4] &= 0xFC;
+	rb[8] &= 0xFC;
+	rb[12] &= 0xFC;
+	tmp[0] = 0;
+	for (u = 0; u < 16; u ++) {
+		tmp[16 - u] = rb[u];
+	}
+	br_i31_decode_reduce(r, tmp, sizeof tmp, p);
+	br_i31_to_monty(r, p);
+
+	/*
+	 * Each chunk of up to 16 bytes is interpreted in little-endian,
+	 * with an extra byte of value 1 right after the chunk.
+	 */
+	br_i31_zero(a, p[0]);
+	for (u = 0; u < len; u += 16) {
+		size_t clen;
+
+		clen = len - u;
+		if (clen > 16) {
+			clen = 16;
+		}
+		memset(tmp, 0, sizeof tmp);
+		for (v = 0; v < clen; v ++) {
+			tmp[16 - v] = msg[u + v];
+		}
+		tmp[16 - clen] = 0x01;
+		br_i31_decode_reduce(t, tmp, sizeof tmp, p);
+		ctl = br_i31_add(a, t, 1);
+		ctl |= NOT(br_i31_sub(a, p, 0));
+		br_i31_sub(a, p, ctl);
+		br_i31_montymul(t, a, r, p, p0i);
+		memcpy(a, t, sizeof t);
+	}
+
+	/*
+	 * Tag is the low 128 bits of the accumulator, plus s.
+	 */
+	br_i31_encode(tmp, sizeof tmp, a);
+	cc = 0;
+	for (u = 0; u < 16; u ++) {
+		cc += (uint32_t)tmp[16 - u] + (uint32_t)pkey[16 + u];
+		tag[u] = (unsigned char)cc;
+		cc >>= 8;
+	}
+}
+
+/*
+ * Reference ChaCha20+Poly1305, with the same API as br_poly1305_run.
+ * Total length of additional data and ciphertext must not exceed 480
+ * bytes.
+ */
+static void
+poly1305_ref_run(const void *key, const void *iv,
+	void *data, size_t len, const void *aad, size_t aad_len,
+	void *tag, br_chacha20_run ichacha, int encrypt)
+{
+	unsigned char pkey[32], msg[512];
+	size_t mlen;
+
+	memset(pkey, 0, sizeof pkey);
+	ichacha(key, iv, 0, pkey, sizeof pkey);
+	if (encrypt) {
+		ichacha(key, iv, 1, data, len);
+	}
+	memset(msg, 0, sizeof msg);
+	if (aad_len > 0) {
+		memcpy(msg, aad, aad_len);
+	}
+	mlen = (aad_len + 15) & ~(size_t)15;
+	memcpy(msg + mlen, data, len);
+	mlen += (len + 15) & ~(size_t)15;
+	br_enc64le(msg + mlen, (uint64_t)aad_len);
+	br_enc64le(msg + mlen + 8, (uint64_t)len);
+	mlen += 16;
+	poly1305_ref_mac(pkey, msg, mlen, tag);
+	if (!encrypt) {
+		ichacha(key, iv, 1, data, len);
+	}
+}
+
+/*
+ * Fake ChaCha20 implementation, for Poly1305 edge cases: the Poly1305
+ * key is the "key" itself, and the data is left unencrypted. This
+ * allows setting the values of r, s and the accumulator directly.
+ */
+static uint32_t
+chacha20_fake_run(const void *key,
+	const void *iv, uint32_t cc, void *data, size_t len)
+{
+	(void)iv;
+	if (cc == 0) {
+		memcpy(data, key, len < 32 ? len : 32);
+	}
+	return cc + (uint32_t)((len + 63) >> 6);
+}
+
+/*
+ * Poly1305 edge cases. Order: key (r and s), data, tag. The data is
+ * used as ciphertext with empty additional data, so the accumulated
+ * value includes the final block with the lengths. With r = 1, the
+ * accumulator is the sum of the blocks (each with its extra 2^128 bit),
+ * which is set to values around 2^130-5 to exercise the final carry
+ * propagation and the conditional subtraction of p; other vectors check
+ * the carry when s is added.
+ */
+static const char *const KAT_POLY1305_EDGE[] = {
+	/* Sum is exactly 2^130-5. */
+	"01000000000000000000000000000000000102030405060708090a0b0c0d0e0f",
+	"fbffffffffffffffdfffffffffffffff00000000000000000000000000000000",
+	"000102030405060708090a0b0c0d0e0f",
+
+	/* Sum is 2^130-6. */
+	"0100000000000000000000000000000000000000000000000000000000000000",
+	"faffffffffffffffdfffffffffffffff00000000000000000000000000000000",
+	"faffffffffffffffffffffffffffffff",
+
+	/* Sum is 2^130-4. */
+	"01000000000000000000000000000000000102030405060708090a0b0c0d0e0f",
+	"fcffffffffffffffdfffffffffffffff00000000000000000000000000000000",
+	"010102030405060708090a0b0c0d0e0f",
+
+	/* Sum is 2^130-1. */
+	"0100000000000000000000000000000000000000000000000000000000000000",
+	"ffffffffffffffffdfffffffffffffff00000000000000000000000000000000",
+	"04000000000000000000000000000000",
+
+	/* Sum exceeds 2^130. */
+	"01000000000000000000000000000000000102030405060708090a0b0c0d0e0f",
+	"0700000000000000100000000000000000000000000000000000000000000000"
+	"00000000000000000000000000000000",
+	"0c0102030405060748090a0b0c0d0e0f",
+
+	/* All-ones blocks. */
+	"0100000000000000000000000000000000000000000000000000000000000000",
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+	"06000000000000004000000000000000",
+
+	/* Addition of s overflows 2^128. */
+	"02000000000000000000000000000000ffffffffffffffffffffffffffffffff",
+	"02000000000000000000000000000000",
+	"0c000000000000002000000000000000",
+
+	/* Addition of s overflows 2^128 (large accumulator). */
+	"02000000000000000000000000000000ffffffffffffffffffffffffffffffff",
+	"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+	"11000000000000004000000000000000",
+	NULL
+};
+
+static void
+test_Poly1305_generic(char *name, br_poly1305_run ipoly)
+{
+	unsigned char key[32], nonce[12], aad[12], aad2[40];
+	unsigned char plain[200], cipher[200], buf[200];
+	unsigned char tag[16], ref_tag[16];
+	size_t u, len, alen;
+
+	printf("Test %s: ", name);
+	fflush(stdout);
+
+	hextobin(key, "808182838485868788898a8b8c8d8e8f"
+		"909192939495969798999a9b9c9d9e9f");
+	hextobin(nonce, "070000004041424344454647");
+	hextobin(aad, "50515253c0c1c2c3c4c5c6c7");
+	len = hextobin(plain, SUNSCREEN_PLAIN);
+	hextobin(cipher,
+		"d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+		"3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+		"92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+		"3ff4def08e4b7a9de576d26586cec64b6116");
+	hextobin(ref_tag, "1ae10b594f09e26a7e902ecbd0600691");
+
+	memcpy(buf, plain, len);
+	ipoly(key, nonce, buf, len, aad, sizeof aad,
+		tag, &br_chacha20_ct_run, 1);
+	check_equals("KAT ChaCha20+Poly1305 (enc)", buf, cipher, len);
+	check_equals("KAT ChaCha20+Poly1305 (tag 1)", tag, ref_tag, 16);
+	printf(".");
+	fflush(stdout);
+
+	ipoly(key, nonce, buf, len, aad, sizeof aad,
+		tag, &br_chacha20_ct_run, 0);
+	check_equals("KAT ChaCha20+Poly1305 (dec)", buf, plain, len);
+	check_equals("KAT ChaCha20+Poly1305 (tag 2)", tag, ref_tag, 16);
+	printf(".");
+	fflush(stdout);
+
+	/*
+	 * Edge cases for the final reduction.
+	 */
+	for (u = 0; KAT_POLY1305_EDGE[u]; u += 3) {
+		hextobin(key, KAT_POLY1305_EDGE[u]);
+		len = hextobin(plain, KAT_POLY1305_EDGE[u + 1]);
+		hextobin(ref_tag, KAT_POLY1305_EDGE[u + 2]);
+		memcpy(buf, plain, len);
+		ipoly(key, nonce, buf, len, NULL, 0,
+			tag, &chacha20_fake_run, 1);
+		check_equals("Poly1305 edge (tag 1)", tag, ref_tag, 16);
+		ipoly(key, nonce, buf, len, NULL, 0,
+			tag, &chacha20_fake_run, 0);
+		check_equals("Poly1305 edge (tag 2)", tag, ref_tag, 16);
+		check_equals("Poly1305 edge (data)", buf, plain, len);
+		poly1305_ref_run(key, nonce, buf, len, NULL, 0,
+			tag, &chacha20_fake_run, 1);
+		check_equals("Poly1305 edge (ref)", tag, ref_tag, 16);
+	}
+	printf(".");
+	fflush(stdout);
+
+	/*
+	 * Compare with the reference implementation, for all lengths of
+	 * additional data and plaintext (up to 40 and 150 bytes,
+	 * respectively), so that partial last blocks are covered.
+	 */
+	hextobin(key, "808182838485868788898a8b8c8d8e8f"
+		"909192939495969798999a9b9c9d9e9f");
+	for (u = 0; u < sizeof plain; u ++) {
+		plain[u] = (unsigned char)(u * 11 + 7);
+	}
+	for (alen = 0; alen <= 40; alen ++) {
+		for (u = 0; u < alen; u ++) {
+			aad2[u] = (unsigned char)(u * 5 + alen);
+		}
+		for (len = 0; len <= 150; len ++) {
+			memcpy(cipher, plain, len);
+			poly1305_ref_run(key, nonce, cipher, len, aad2, alen,
+				ref_tag, &br_chacha20_ct_run, 1);
+			memcpy(buf, plain, len);
+			ipoly(key, nonce, buf, len, aad2, alen,
+				tag, &br_chacha20_ct_run, 1);
+			check_equals("ChaCha20+Poly1305 (enc)",
+				buf, cipher, len);
+			check_equals("ChaCha20+Poly1305 (tag 1)",
+				tag, ref_tag, 16);
+			ipoly(key, nonce, buf, len, aad2, alen,
+				tag, &br_chacha20_ct_run, 0);
+			check_equals("ChaCha20+Poly1305 (dec)",
+				buf, plain, len);
+			check_equals("ChaCha20+Poly1305 (tag 2)",
+				tag, ref_tag, 16);
+		}
+		if (alen % 8 == 0) {
+			printf(".");
+			fflush(stdout);
+		}
+	}
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_Poly1305_ctmul(void)
+{
+	test_Poly1305_generic("Poly1305_ctmul", &br_poly1305_ctmul_run);
+}
+
+/*
+ * DES known-answer tests. Order: plaintext, key, ciphertext.
+ * (mostly from NIST SP 800-20).
+ */
+static const char *const KAT_DES[] = {
+	"10316E028C8F3B4A", "0000000000000000", "82DCBAFBDEAB6602",
+	"8000000000000000", "0000000000000000", "95A8D72813DAA94D",
+	"4000000000000000", "0000000000000000", "0EEC1487DD8C26D5",
+	"2000000000000000", "0000000000000000", "7AD16FFB79C45926",
+	"1000000000000000", "0000000000000000", "D3746294CA6A6CF3",
+	"0800000000000000", "0000000000000000", "809F5F873C1FD761",
+	"0400000000000000", "0000000000000000", "C02FAFFEC989D1FC",
+	"0200000000000000", "0000000000000000", "4615AA1D33E72F10",
+	"0100000000000000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0080000000000000", "0000000000000000", "2055123350C00858",
+	"0040000000000000", "0000000000000000", "DF3B99D6577397C8",
+	"0020000000000000", "0000000000000000", "31FE17369B5288C9",
+	"0010000000000000", "0000000000000000", "DFDD3CC64DAE1642",
+	"0008000000000000", "0000000000000000", "178C83CE2B399D94",
+	"0004000000000000", "0000000000000000", "50F636324A9B7F80",
+	"0002000000000000", "0000000000000000", "A8468EE3BC18F06D",
+	"0001000000000000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000800000000000", "0000000000000000", "A2DC9E92FD3CDE92",
+	"0000400000000000", "0000000000000000", "CAC09F797D031287",
+	"0000200000000000", "0000000000000000", "90BA680B22AEB525",
+	"0000100000000000", "0000000000000000", "CE7A24F350E280B6",
+	"0000080000000000", "0000000000000000", "882BFF0AA01A0B87",
+	"0000040000000000", "0000000000000000", "25610288924511C2",
+	"0000020000000000", "0000000000000000", "C71516C29C75D170",
+	"0000010000000000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000008000000000", "0000000000000000", "5199C29A52C9F059",
+	"0000004000000000", "0000000000000000", "C22F0A294A71F29F",
+	"0000002000000000", "0000000000000000", "EE371483714C02EA",
+	"0000001000000000", "0000000000000000", "A81FBD448F9E522F",
+	"0000000800000000", "0000000000000000", "4F644C92E192DFED",
+	"0000000400000000", "0000000000000000", "1AFA9A66A6DF92AE",
+	"0000000200000000", "0000000000000000", "B3C1CC715CB879D8",
+	"0000000100000000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000000080000000", "0000000000000000", "19D032E64AB0BD8B",
+	"0000000040000000", "0000000000000000", "3CFAA7A7DC8720DC",
+	"0000000020000000", "0000000000000000", "B7265F7F447AC6F3",
+	"0000000010000000", "0000000000000000", "9DB73B3C0D163F54",
+	"0000000008000000", "0000000000000000", "8181B65BABF4A975",
+	"0000000004000000", "0000000000000000", "93C9B64042EAA240",
+	"0000000002000000", "0000000000000000", "5570530829705592",
+	"0000000001000000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000000000800000", "0000000000000000", "8638809E878787A0",
+	"0000000000400000", "0000000000000000", "41B9A79AF79AC208",
+	"0000000000200000", "0000000000000000", "7A9BE42F2009A892",
+	"0000000000100000", "0000000000000000", "29038D56BA6D2745",
+	"0000000000080000", "0000000000000000", "5495C6ABF1E5DF51",
+	"0000000000040000", "0000000000000000", "AE13DBD561488933",
+	"0000000000020000", "0000000000000000", "024D1FFA8904E389",
+	"0000000000010000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000000000008000", "0000000000000000", "D1399712F99BF02E",
+	"0000000000004000", "0000000000000000", "14C1D7C1CFFEC79E",
+	"0000000000002000", "0000000000000000", "1DE5279DAE3BED6F",
+	"0000000000001000", "0000000000000000", "E941A33F85501303",
+	"0000000000000800", "0000000000000000", "DA99DBBC9A03F379",
+	"0000000000000400", "0000000000000000", "B7FC92F91D8E92E9",
+	"0000000000000200", "0000000000000000", "AE8E5CAA3CA04E85",
+	"0000000000000100", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000000000000080", "0000000000000000", "9CC62DF43B6EED74",
+	"0000000000000040", "0000000000000000", "D863DBB5C59A91A0",
+	"0000000000000020", "0000000000000000", "A1AB2190545B91D7",
+	"0000000000000010", "0000000000000000", "0875041E64C570F7",
+	"0000000000000008", "0000000000000000", "5A594528BEBEF1CC",
+	"0000000000000004", "0000000000000000", "FCDB3291DE21F0C0",
+	"0000000000000002", "0000000000000000", "869EFD7F9F265A09",
+	"0000000000000001", "0000000000000000", "8CA64DE9C1B123A7",
+	"0000000000000000", "8000000000000000", "95F8A5E5DD31D900",
+	"0000000000000000", "4000000000000000", "DD7F121CA5015619",
+	"0000000000000000", "2000000000000000", "2E8653104F3834EA",
+	"0000000000000000", "1000000000000000", "4BD388FF6CD81D4F",
+	"0000000000000000", "0800000000000000", "20B9E767B2FB1456",
+	"0000000000000000", "0400000000000000", "55579380D77138EF",
+	"0000000000000000", "0200000000000000", "6CC5DEFAAF04512F",
+	"0000000000000000", "0100000000000000", "0D9F279BA5D87260",
+	"0000000000000000", "0080000000000000", "D9031B0271BD5A0A",
+	"0000000000000000", "0040000000000000", "424250B37C3DD951",
+	"0000000000000000", "0020000000000000", "B8061B7ECD9A21E5",
+	"0000000000000000", "0010000000000000", "F15D0F286B65BD28",
+	"0000000000000000", "0008000000000000", "ADD0CC8D6E5DEBA1",
+	"0000000000000000", "0004000000000000", "E6D5F82752AD63D1",
+	"0000000000000000", "0002000000000000", "ECBFE3BD3F591A5E",
+	"0000000000000000", "0001000000000000", "F356834379D165CD",
+	"0000000000000000", "0000800000000000", "2B9F982F20037FA9",
+	"0000000000000000", "0000400000000000", "889DE068A16F0BE6",
+	"0000000000000000", "0000200000000000", "E19E275D846A1298",
+	"0000000000000000", "0000100000000000", "329A8ED523D71AEC",
+	"0000000000000000", "0000080000000000", "E7FCE22557D23C97",
+	"0000000000000000", "0000040000000000", "12A9F5817FF2D65D",
+	"0000000000000000", "0000020000000000", "A484C3AD38DC9C19",
+	"0000000000000000", "0000010000000000", "FBE00A8A1EF8AD72",
+	"0000000000000000", "0000008000000000", "750D079407521363",
+	"0000000000000000", "0000004000000000", "64FEED9C724C2FAF",
+	"0000000000000000", "0000002000000000", "F02B263B328E2B60",
+	"0000000000000000", "0000001000000000", "9D64555A9A10B852",
+	"0000000000000000", "0000000800000000", "D106FF0BED5255D7",
+	"0000000000000000", "0000000400000000", "E1652C6B138C64A5",
+	"0000000000000000", "0000000200000000", "E428581186EC8F46",
+	"0000000000000000", "0000000100000000", "AEB5F5EDE22D1A36",
+	"0000000000000000", "0000000080000000", "E943D7568AEC0C5C",
+	"0000000000000000", "0000000040000000", "DF98C8276F54B04B",
+	"0000000000000000", "0000000020000000", "B160E4680F6C696F",
+	"0000000000000000", "0000000010000000", "FA0752B07D9C4AB8",
+	"0000000000000000", "0000000008000000", "CA3A2B036DBC8502",
+	"0000000000000000", "0000000004000000", "5E0905517BB59BCF",
+	"0000000000000000", "0000000002000000", "814EEB3B91D90726",
+	"0000000000000000", "0000000001000000", "4D49DB1532919C9F",
+	"0000000000000000", "0000000000800000", "25EB5FC3F8CF0621",
+	"0000000000000000", "0000000000400000", "AB6A20C0620D1C6F",
+	"0000000000000000", "0000000000200000", "79E90DBC98F92CCA",
+	"0000000000000000", "0000000000100000", "866ECEDD8072BB0E",
+	"0000000000000000", "0000000000080000", "8B54536F2F3E64A8",
+	"0000000000000000", "0000000000040000", "EA51D3975595B86B",
+	"0000000000000000", "0000000000020000", "CAFFC6AC4542DE31",
+	"0000000000000000", "0000000000010000", "8DD45A2DDF90796C",
+	"0000000000000000", "0000000000008000", "1029D55E880EC2D0",
+	"0000000000000000", "0000000000004000", "5D86CB23639DBEA9",
+	"0000000000000000", "0000000000002000", "1D1CA853AE7C0C5F",
+	"0000000000000000", "0000000000001000", "CE332329248F3228",
+	"0000000000000000", "0000000000000800", "8405D1ABE24FB942",
+	"0000000000000000", "0000000000000400", "E643D78090CA4207",
+	"0000000000000000", "0000000000000200", "48221B9937748A23",
+	"0000000000000000", "0000000000000100", "DD7C0BBD61FAFD54",
+	"0000000000000000", "0000000000000080", "2FBC291A570DB5C4",
+	"0000000000000000", "0000000000000040", "E07C30D7E4E26E12",
+	"0000000000000000", "0000000000000020", "0953E2258E8E90A1",
+	"0000000000000000", "0000000000000010", "5B711BC4CEEBF2EE",
+	"0000000000000000", "0000000000000008", "CC083F1E6D9E85F6",
+	"0000000000000000", "0000000000000004", "D2FD8867D50D2DFE",
+	"0000000000000000", "0000000000000002", "06E7EA22CE92708F",
+	"0000000000000000", "0000000000000001", "166B40B44ABA4BD6",
+	"0000000000000000", "0000000000000000", "8CA64DE9C1B123A7",
+	"0101010101010101", "0101010101010101", "994D4DC157B96C52",
+	"0202020202020202", "0202020202020202", "E127C2B61D98E6E2",
+	"0303030303030303", "0303030303030303", "984C91D78A269CE3",
+	"0404040404040404", "0404040404040404", "1F4570BB77550683",
+	"0505050505050505", "0505050505050505", "3990ABF98D672B16",
+	"0606060606060606", "0606060606060606", "3F5150BBA081D585",
+	"0707070707070707", "0707070707070707", "C65242248C9CF6F2",
+	"0808080808080808", "0808080808080808", "10772D40FAD24257",
+	"0909090909090909", "0909090909090909", "F0139440647A6E7B",
+	"0A0A0A0A0A0A0A0A", "0A0A0A0A0A0A0A0A", "0A288603044D740C",
+	"0B0B0B0B0B0B0B0B", "0B0B0B0B0B0B0B0B", "6359916942F7438F",
+	"0C0C0C0C0C0C0C0C", "0C0C0C0C0C0C0C0C", "934316AE443CF08B",
+	"0D0D0D0D0D0D0D0D", "0D0D0D0D0D0D0D0D", "E3F56D7F1130A2B7",
+	"0E0E0E0E0E0E0E0E", "0E0E0E0E0E0E0E0E", "A2E4705087C6B6B4",
+	"0F0F0F0F0F0F0F0F", "0F0F0F0F0F0F0F0F", "D5D76E09A447E8C3",
+	"1010101010101010", "1010101010101010", "DD7515F2BFC17F85",
+	"1111111111111111", "1111111111111111", "F40379AB9E0EC533",
+	"1212121212121212", "1212121212121212", "96CD27784D1563E5",
+	"1313131313131313", "1313131313131313", "2911CF5E94D33FE1",
+	"1414141414141414", "1414141414141414", "377B7F7CA3E5BBB3",
+	"1515151515151515", "1515151515151515", "701AA63832905A92",
+	"1616161616161616", "1616161616161616", "2006E716C4252D6D",
+	"1717171717171717", "1717171717171717", "452C1197422469F8",
+	"1818181818181818", "1818181818181818", "C33FD1EB49CB64DA",
+	"1919191919191919", "1919191919191919", "7572278F364EB50D",
+	"1A1A1A1A1A1A1A1A", "1A1A1A1A1A1A1A1A", "69E51488403EF4C3",
+	"1B1B1B1B1B1B1B1B", "1B1B1B1B1B1B1B1B", "FF847E0ADF192825",
+	"1C1C1C1C1C1C1C1C", "1C1C1C1C1C1C1C1C", "521B7FB3B41BB791",
+	"1D1D1D1D1D1D1D1D", "1D1D1D1D1D1D1D1D", "26059A6A0F3F6B35",
+	"1E1E1E1E1E1E1E1E", "1E1E1E1E1E1E1E1E", "F24A8D2231C77538",
+	"1F1F1F1F1F1F1F1F", "1F1F1F1F1F1F1F1F", "4FD96EC0D3304EF6",
+	"2020202020202020", "2020202020202020", "18A9D580A900B699",
+	"2121212121212121", "2121212121212121", "88586E1D755B9B5A",
 	"2222222222222222", "2222222222222222", "0F8ADFFB11DC2784",
 	"2323232323232323", "2323232323232323", "2F30446C8312404A",
 	"2424242424242424", "2424242424242424", "0BA03D9E6C196511",
@@ -4147,11 +5765,61 @@ test_RSA_core(char *name, br_rsa_public fpub, br_rsa_private fpriv)
 static void
 test_RSA_i31(void)
 {
+	static const unsigned char SHA1_OID[] = {
+		0x05, 0x2B, 0x0E, 0x03, 0x02, 0x1A
+	};
+	br_rsa_i31_expanded_key xsk;
+	unsigned char t1[128], t2[128], hv[20];
+	int i;
+
 	test_RSA_core("RSA i31 core", &br_rsa_i31_public, &br_rsa_i31_private);
 	/* FIXME
 	test_RSA_sign("RSA i31 sign",
 		&br_rsa_i31_pkcs1_vrfy, &br_rsa_i31_pkcs1_sign);
 	*/
+
+	/*
+	 * The expanded key must yield the same results as the
+	 * source key.
+	 */
+	printf("Test RSA i31 expanded: ");
+	fflush(stdout);
+	if (!br_rsa_i31_expand_key(&xsk, &RSA_SK)) {
+		fprintf(stderr, "RSA key expansion failed\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < 100; i ++) {
+		size_t u;
+
+		t1[0] = 0;
+		for (u = 1; u < sizeof t1; u ++) {
+			t1[u] = (unsigned char)(u * (i + 7) + (i << 3));
+		}
+		memcpy(t2, t1, sizeof t1);
+		if (!br_rsa_i31_private_expanded(t1, &xsk)
+			|| !br_rsa_i31_private(t2, &RSA_SK))
+		{
+			fprintf(stderr, "RSA private operation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("RSA i31 expanded priv", t1, t2, sizeof t1);
+		memcpy(hv, t1 + 1, sizeof hv);
+		if (!br_rsa_i31_pkcs1_sign_expanded(SHA1_OID,
+			hv, sizeof hv, &xsk, t1)
+			|| !br_rsa_i31_pkcs1_sign(SHA1_OID,
+			hv, sizeof hv, &RSA_SK, t2))
+		{
+			fprintf(stderr, "RSA signature failed\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("RSA i31 expanded sign", t1, t2, sizeof t1);
+		if ((i % 10) == 9) {
+			printf(".");
+			fflush(stdout);
+		}
+	}
+	printf(" done.\n");
+	fflush(stdout);
 }
 
 static void
@@ -4164,6 +5832,56 @@ test_RSA_i32(void)
 	*/
 }
 
+static void
+test_RSA_i62(void)
+{
+	br_rsa_public fpub;
+	br_rsa_private fpriv;
+	unsigned char t1[128], t2[128];
+	int i;
+
+	fpub = br_rsa_i62_public_get();
+	fpriv = br_rsa_i62_private_get();
+	if (fpub == 0 || fpriv == 0) {
+		printf("Test RSA i62: UNAVAILABLE\n");
+		return;
+	}
+	test_RSA_core("RSA i62 core", fpub, fpriv);
+
+	/*
+	 * Compare with the i31 engine on some arbitrary values.
+	 */
+	printf("Test RSA i62/i31: ");
+	fflush(stdout);
+	for (i = 0; i < 100; i ++) {
+		size_t u;
+
+		t1[0] = 0;
+		for (u = 1; u < sizeof t1; u ++) {
+			t1[u] = (unsigned char)(u * (i + 7) + (i << 3));
+		}
+		memcpy(t2, t1, sizeof t1);
+		if (!fpriv(t1, &RSA_SK) || !br_rsa_i31_private(t2, &RSA_SK)) {
+			fprintf(stderr, "RSA private operation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("RSA i62/i31 priv", t1, t2, sizeof t1);
+		if (!fpub(t1, sizeof t1, &RSA_PK)
+			|| !br_rsa_i31_public(t2, sizeof t2, &RSA_PK))
+		{
+			fprintf(stderr, "RSA public operation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("RSA i62/i31 pub", t1, t2, sizeof t1);
+		if ((i % 10) == 9) {
+			printf(".");
+			fflush(stdout);
+		}
+	}
+	printf(" done.\n");
+	fflush(stdout);
+}
+
 #if 0
 static void
 test_RSA_signatures(void)
@@ -4386,6 +6104,47 @@ test_GHASH_ctmul64(void)
 	test_GHASH("GHASH_ctmul64", br_ghash_ctmul64);
 }
 
+static void
+test_GHASH_pclmul(void)
+{
+	br_ghash gh;
+	unsigned char h[16], data[300], y1[16], y2[16];
+	size_t u;
+
+	gh = br_ghash_pclmul_get();
+	if (gh == 0) {
+		printf("Test GHASH_pclmul: UNAVAILABLE\n");
+		return;
+	}
+	test_GHASH("GHASH_pclmul", gh);
+
+	/*
+	 * The KAT vectors are too short to exercise the four-block
+	 * aggregated path; compare with ctmul on longer inputs.
+	 */
+	printf("Test GHASH_pclmul (long): ");
+	fflush(stdout);
+	for (u = 0; u < sizeof data; u ++) {
+		data[u] = (unsigned char)(u * 7 + 3);
+	}
+	for (u = 0; u < sizeof h; u ++) {
+		h[u] = (unsigned char)(u * 37 + 11);
+	}
+	for (u = 0; u <= sizeof data; u ++) {
+		memset(y1, (int)u, sizeof y1);
+		memset(y2, (int)u, sizeof y2);
+		br_ghash_ctmul(y1, h, data, u);
+		gh(y2, h, data, u);
+		check_equals("GHASH long", y1, y2, sizeof y1);
+		if (u % 30 == 0) {
+			printf(".");
+			fflush(stdout);
+		}
+	}
+	printf(" done.\n");
+	fflush(stdout);
+}
+
 static void
 test_EC_inner(const char *sk, const char *sU,
 	const br_ec_impl *impl, int curve)
@@ -4429,6 +6188,15 @@ test_EC_inner(const char *sk, const char *sU,
 		fprintf(stderr, "KAT mul: mismatch\n");
 		exit(EXIT_FAILURE);
 	}
+	memset(eG, 0, sizeof eG);
+	if (impl->mulgen(eG, bk, klen, curve) != ulen) {
+		fprintf(stderr, "KAT mulgen failed\n");
+		exit(EXIT_FAILURE);
+	}
+	if (memcmp(eG, eU, ulen) != 0) {
+		fprintf(stderr, "KAT mulgen: mismatch\n");
+		exit(EXIT_FAILURE);
+	}
 
 	/*
 	 * Test the two-point-mul function. We want to test the basic
@@ -4505,6 +6273,18 @@ test_EC_inner(const char *sk, const char *sU,
 			exit(EXIT_FAILURE);
 		}
 
+		/*
+		 * D must also match z*G computed with mulgen().
+		 */
+		if (impl->mulgen(eC, bz, nlen, cd->curve) != ulen) {
+			fprintf(stderr, "mulgen() failed\n");
+			exit(EXIT_FAILURE);
+		}
+		if (memcmp(eC, eD, ulen) != 0) {
+			fprintf(stderr, "mul() / mulgen() mismatch\n");
+			exit(EXIT_FAILURE);
+		}
+
 		/*
 		 * Check with x*A = y*B. We do so by setting b = x and y = a.
 		 */
@@ -4603,6 +6383,246 @@ test_EC_prime_i31(void)
 		| (uint32_t)1 << BR_EC_secp521r1);
 }
 
+/*
+ * br_ec_prime_i31 built with BR_EC_COMPILED=1 (straight-line point
+ * formulas instead of the microcode interpreter). This object is linked
+ * only in this test program (see the Makefile), so that both variants
+ * are tested in the default build.
+ */
+extern const br_ec_impl br_ec_prime_i31_compiled;
+
+/*
+ * Check that the compiled formulas and the interpreter return the same
+ * results, for random multipliers and points, and for invalid points.
+ */
+static void
+test_EC_compiled_cross(int curve)
+{
+	const br_ec_impl *iref, *icomp;
+	const unsigned char *G;
+	br_hmac_drbg_context rng;
+	size_t Glen, nlen;
+	int i;
+
+	iref = &br_ec_prime_i31;
+	icomp = &br_ec_prime_i31_compiled;
+	G = iref->generator(curve, &Glen);
+	iref->order(curve, &nlen);
+	br_hmac_drbg_init(&rng, &br_sha256_vtable, "compiled EC", 11);
+	for (i = 0; i < 20; i ++) {
+		unsigned char x[66], y[66];
+		unsigned char P1[133], P2[133], Q1[133], Q2[133];
+		uint32_t r1, r2;
+
+		br_hmac_drbg_generate(&rng, x, nlen);
+		br_hmac_drbg_generate(&rng, y, nlen);
+		x[0] >>= 1;
+		y[0] >>= 1;
+		x[nlen - 1] |= 1;
+		y[nlen - 1] |= 1;
+
+		if (iref->mulgen(P1, x, nlen, curve) != Glen
+			|| icomp->mulgen(P2, x, nlen, curve) != Glen
+			|| memcmp(P1, P2, Glen) != 0)
+		{
+			fprintf(stderr, "compiled EC: mulgen() mismatch\n");
+			exit(EXIT_FAILURE);
+		}
+		memcpy(Q1, G, Glen);
+		memcpy(Q2, G, Glen);
+		r1 = iref->muladd(Q1, P1, Glen, x, nlen, y, nlen, curve);
+		r2 = icomp->muladd(Q2, P2, Glen, x, nlen, y, nlen, curve);
+		if (r1 != 1 || r2 != 1 || memcmp(Q1, Q2, Glen) != 0) {
+			fprintf(stderr, "compiled EC: muladd() mismatch\n");
+			exit(EXIT_FAILURE);
+		}
+
+		/*
+		 * Flip one bit in the X or Y coordinate: the point is then
+		 * (almost always) not on the curve, and both variants
+		 * must reject it the same way.
+		 */
+		P1[1 + ((i * 7) % (Glen - 1))] ^= (unsigned char)(1 << (i & 7));
+		memcpy(P2, P1, Glen);
+		r1 = iref->mul(P1, Glen, y, nlen, curve);
+		r2 = icomp->mul(P2, Glen, y, nlen, curve);
+		if (r1 != r2 || (r1 && memcmp(P1, P2, Glen) != 0)) {
+			fprintf(stderr, "compiled EC: invalid point mismatch\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	printf(".");
+	fflush(stdout);
+}
+
+static void
+test_EC_prime_i31_compiled(void)
+{
+	test_EC_KAT("EC_prime_i31_compiled", &br_ec_prime_i31_compiled,
+		(uint32_t)1 << BR_EC_secp256r1
+		| (uint32_t)1 << BR_EC_secp384r1
+		| (uint32_t)1 << BR_EC_secp521r1);
+	printf("Test EC_prime_i31 compiled/interpreter: ");
+	fflush(stdout);
+	test_EC_compiled_cross(BR_EC_secp256r1);
+	test_EC_compiled_cross(BR_EC_secp384r1);
+	test_EC_compiled_cross(BR_EC_secp521r1);
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_EC_p256_m32(void)
+{
+	test_EC_KAT("EC_p256_m32", &br_ec_p256_m32,
+		(uint32_t)1 << BR_EC_secp256r1
+		| (uint32_t)1 << BR_EC_secp384r1
+		| (uint32_t)1 << BR_EC_secp521r1);
+}
+
+/*
+ * Test vectors for X25519 (RFC 7748, sections 5.2 and 6.1). Multipliers
+ * are given as in the RFC (little-endian); they are reversed before use
+ * since br_ec_impl uses big-endian multipliers.
+ */
+static const char *const C25519_KAT[] = {
+	"a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4",
+	"e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c",
+	"c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552",
+
+	"4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d",
+	"e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493",
+	"95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957",
+
+	"77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a",
+	"de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f",
+	"4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742",
+
+	"5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb",
+	"8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a",
+	"4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742",
+
+	NULL
+};
+
+static void
+revbytes(unsigned char *buf, size_t len)
+{
+	size_t u;
+
+	for (u = 0; u < (len >> 1); u ++) {
+		unsigned char t;
+
+		t = buf[u];
+		buf[u] = buf[len - 1 - u];
+		buf[len - 1 - u] = t;
+	}
+}
+
+static void
+test_EC_c25519(const char *name, const br_ec_impl *iec)
+{
+	unsigned char bu[32], bk[32], br[32], bx[32];
+	size_t u, glen;
+	int i;
+
+	printf("Test %s: ", name);
+	fflush(stdout);
+
+	if (((iec->supported_curves >> BR_EC_curve25519) & 1) == 0) {
+		fprintf(stderr, "Curve25519 not supported\n");
+		exit(EXIT_FAILURE);
+	}
+	for (u = 0; C25519_KAT[u]; u += 3) {
+		hextobin(bk, C25519_KAT[u]);
+		hextobin(bu, C25519_KAT[u + 1]);
+		hextobin(br, C25519_KAT[u + 2]);
+		revbytes(bk, sizeof bk);
+		if (iec->mul(bu, sizeof bu, bk, sizeof bk,
+			BR_EC_curve25519) != 1)
+		{
+			fprintf(stderr, "Curve25519 multiplication failed\n");
+			exit(EXIT_FAILURE);
+		}
+		check_equals("KAT Curve25519", bu, br, sizeof br);
+		printf(".");
+		fflush(stdout);
+	}
+
+	/*
+	 * Public keys from section 6.1: multiplication of the base
+	 * point, with mulgen() and with mul().
+	 */
+	hextobin(bk, C25519_KAT[6]);
+	hextobin(br, C25519_KAT[10]);
+	revbytes(bk, sizeof bk);
+	memset(bu, 0, sizeof bu);
+	if (iec->mulgen(bu, bk, sizeof bk, BR_EC_curve25519) != 32) {
+		fprintf(stderr, "Curve25519 mulgen() failed\n");
+		exit(EXIT_FAILURE);
+	}
+	check_equals("KAT Curve25519 (mulgen)", bu, br, sizeof br);
+	memcpy(bu, iec->generator(BR_EC_curve25519, &glen), sizeof bu);
+	if (glen != 32) {
+		fprintf(stderr, "Curve25519 generator() failed\n");
+		exit(EXIT_FAILURE);
+	}
+	iec->mul(bu, glen, bk, sizeof bk, BR_EC_curve25519);
+	check_equals("KAT Curve25519 (generator)", bu, br, sizeof br);
+	if (iec->xoff(BR_EC_curve25519, &glen) != 0 || glen != 32) {
+		fprintf(stderr, "Curve25519 xoff() failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/*
+	 * Iterated test (RFC 7748, section 5.2): 1000 iterations,
+	 * starting with k = u = 9; each iteration computes
+	 * X25519(k, u) and sets u to k, and k to the result.
+	 */
+	memset(bk, 0, sizeof bk);
+	bk[0] = 9;
+	memcpy(bu, bk, sizeof bk);
+	for (i = 1; i <= 1000; i ++) {
+		memcpy(bx, bk, sizeof bk);
+		revbytes(bx, sizeof bx);
+		memcpy(br, bu, sizeof bu);
+		iec->mul(br, sizeof br, bx, sizeof bx, BR_EC_curve25519);
+		memcpy(bu, bk, sizeof bk);
+		memcpy(bk, br, sizeof br);
+		if (i == 1) {
+			hextobin(br, "422c8e7a6227d7bca1350b3e2bb7279f"
+				"7897b87bb6854b783c60e80311ae3079");
+			check_equals("KAT Curve25519 (1)", bk, br, sizeof br);
+		}
+		if (i % 100 == 0) {
+			printf(".");
+			fflush(stdout);
+		}
+	}
+	hextobin(br, "684cf59ba83309552800ef566f2f4d3c"
+		"1c3887c49360e3875f2eb94d99532c51");
+	check_equals("KAT Curve25519 (1000)", bk, br, sizeof br);
+
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_EC_c25519_m32(void)
+{
+	test_EC_c25519("EC_c25519_m32", &br_ec_c25519_m32);
+}
+
+static void
+test_EC_all_m32(void)
+{
+	test_EC_KAT("EC_all_m32", &br_ec_all_m32,
+		(uint32_t)1 << BR_EC_secp256r1
+		| (uint32_t)1 << BR_EC_secp384r1
+		| (uint32_t)1 << BR_EC_secp521r1);
+	test_EC_c25519("EC_all_m32 (Curve25519)", &br_ec_all_m32);
+}
+
 static const unsigned char EC_P256_PUB_POINT[] = {
 	0x04, 0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D,
 	0x31, 0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D,
@@ -4975,7 +6995,8 @@ const ecdsa_kat_vector ECDSA_KAT[] = {
 };
 
 static void
-test_ECDSA_KAT(br_ecdsa_sign sign, br_ecdsa_vrfy vrfy, int asn1)
+test_ECDSA_KAT(const br_ec_impl *iec,
+	br_ecdsa_sign sign, br_ecdsa_vrfy vrfy, int asn1)
 {
 	size_t u;
 
@@ -5002,28 +7023,28 @@ test_ECDSA_KAT(br_ecdsa_sign sign, br_ecdsa_vrfy vrfy, int asn1)
 			sig_len = hextobin(sig, kv->sraw);
 		}
 
-		if (vrfy(&br_ec_prime_i31, hash, hash_len,
+		if (vrfy(iec, hash, hash_len,
 			kv->pub, sig, sig_len) != 1)
 		{
 			fprintf(stderr, "ECDSA KAT verify failed (1)\n");
 			exit(EXIT_FAILURE);
 		}
 		hash[0] ^= 0x80;
-		if (vrfy(&br_ec_prime_i31, hash, hash_len,
+		if (vrfy(iec, hash, hash_len,
 			kv->pub, sig, sig_len) != 0)
 		{
 			fprintf(stderr, "ECDSA KAT verify shoud have failed\n");
 			exit(EXIT_FAILURE);
 		}
 		hash[0] ^= 0x80;
-		if (vrfy(&br_ec_prime_i31, hash, hash_len,
+		if (vrfy(iec, hash, hash_len,
 			kv->pub, sig, sig_len) != 1)
 		{
 			fprintf(stderr, "ECDSA KAT verify failed (2)\n");
 			exit(EXIT_FAILURE);
 		}
 
-		sig2_len = sign(&br_ec_prime_i31, kv->hf, hash, kv->priv, sig2);
+		sig2_len = sign(iec, kv->hf, hash, kv->priv, sig2);
 		if (sig2_len == 0) {
 			fprintf(stderr, "ECDSA KAT sign failed\n");
 			exit(EXIT_FAILURE);
@@ -5045,10 +7066,46 @@ test_ECDSA_i31(void)
 	fflush(stdout);
 	printf("[raw]");
 	fflush(stdout);
-	test_ECDSA_KAT(&br_ecdsa_i31_sign_raw, &br_ecdsa_i31_vrfy_raw, 0);
+	test_ECDSA_KAT(&br_ec_prime_i31,
+		&br_ecdsa_i31_sign_raw, &br_ecdsa_i31_vrfy_raw, 0);
+	printf(" [asn1]");
+	fflush(stdout);
+	test_ECDSA_KAT(&br_ec_prime_i31,
+		&br_ecdsa_i31_sign_asn1, &br_ecdsa_i31_vrfy_asn1, 1);
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_ECDSA_i31_compiled(void)
+{
+	printf("Test ECDSA/i31 (compiled EC): ");
+	fflush(stdout);
+	printf("[raw]");
+	fflush(stdout);
+	test_ECDSA_KAT(&br_ec_prime_i31_compiled,
+		&br_ecdsa_i31_sign_raw, &br_ecdsa_i31_vrfy_raw, 0);
+	printf(" [asn1]");
+	fflush(stdout);
+	test_ECDSA_KAT(&br_ec_prime_i31_compiled,
+		&br_ecdsa_i31_sign_asn1, &br_ecdsa_i31_vrfy_asn1, 1);
+	printf(" done.\n");
+	fflush(stdout);
+}
+
+static void
+test_ECDSA_p256_m32(void)
+{
+	printf("Test ECDSA/p256_m32: ");
+	fflush(stdout);
+	printf("[raw]");
+	fflush(stdout);
+	test_ECDSA_KAT(&br_ec_p256_m32,
+		&br_ecdsa_i31_sign_raw, &br_ecdsa_i31_vrfy_raw, 0);
 	printf(" [asn1]");
 	fflush(stdout);
-	test_ECDSA_KAT(&br_ecdsa_i31_sign_asn1, &br_ecdsa_i31_vrfy_asn1, 1);
+	test_ECDSA_KAT(&br_ec_p256_m32,
+		&br_ecdsa_i31_sign_asn1, &br_ecdsa_i31_vrfy_asn1, 1);
 	printf(" done.\n");
 	fflush(stdout);
 }
@@ -5104,6 +7161,8 @@ static const struct {
 	STU(SHA256),
 	STU(SHA384),
 	STU(SHA512),
+	STU(SHA_x86ni),
+	STU(SHA256_mb),
 	STU(MD5_SHA1),
 	STU(multihash),
 	STU(HMAC),
@@ -5113,16 +7172,35 @@ static const struct {
 	STU(AES_small),
 	STU(AES_ct),
 	STU(AES_ct64),
+	STU(AES_x86ni),
+	STU(GCM_kernel_x86ni),
+	STU(AES_ct64_sse2),
+	STU(AES_ct64_avx2),
+	STU(CBC_HMAC_kernel_x86ni),
+	STU(CBC_EtM),
+	STU(CCM),
+	STU(ChaCha20_ct),
+	STU(ChaCha20_sse2),
+	STU(ChaCha20_avx2),
+	STU(Poly1305_ctmul),
 	STU(DES_tab),
 	STU(DES_ct),
 	STU(RSA_i31),
 	STU(RSA_i32),
+	STU(RSA_i62),
 	STU(GHASH_ctmul),
 	STU(GHASH_ctmul32),
 	STU(GHASH_ctmul64),
+	STU(GHASH_pclmul),
 	STU(EC_prime_i31),
+	STU(EC_prime_i31_compiled),
 	/* STU(EC_prime_i32), */
+	STU(EC_p256_m32),
+	STU(EC_c25519_m32),
+	STU(EC_all_m32),
 	STU(ECDSA_i31),
+	STU(ECDSA_i31_compiled),
+	STU(ECDSA_p256_m32),
 	{ 0, 0 }
 };
 
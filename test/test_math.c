@@ -51,10 +51,17 @@ typedef struct {
 	uint32_t (*ninv)(uint32_t x);
 	void (*montymul)(uint32_t *d, const uint32_t *x, const uint32_t *y,
 		const uint32_t *m, uint32_t m0i);
+	void (*montysqr)(uint32_t *d, const uint32_t *x,
+		const uint32_t *m, uint32_t m0i);
 	void (*to_monty)(uint32_t *x, const uint32_t *m);
 	void (*from_monty)(uint32_t *x, const uint32_t *m, uint32_t m0i);
 	void (*modpow)(uint32_t *x, const unsigned char *e, size_t elen,
 		const uint32_t *m, uint32_t m0i, uint32_t *t1, uint32_t *t2);
+	uint32_t (*modpow_vartime)(uint32_t *x, const unsigned char *e,
+		size_t elen, const uint32_t *m, uint32_t m0i,
+		uint32_t *tmp, size_t twlen);
+	uint32_t (*moddiv)(uint32_t *x, const uint32_t *y,
+		const uint32_t *m, uint32_t *t);
 } int_impl;
 
 static const int_impl i31_impl = {
@@ -69,9 +76,12 @@ static const int_impl i31_impl = {
 	&br_i31_sub,
 	&br_i31_ninv31,
 	&br_i31_montymul,
+	&br_i31_montysqr,
 	&br_i31_to_monty,
 	&br_i31_from_monty,
-	&br_i31_modpow
+	&br_i31_modpow,
+	&br_i31_modpow_vartime,
+	&br_i31_moddiv
 };
 static const int_impl i32_impl = {
 	32,
@@ -85,9 +95,12 @@ static const int_impl i32_impl = {
 	&br_i32_sub,
 	&br_i32_ninv32,
 	&br_i32_montymul,
+	&br_i32_montysqr,
 	&br_i32_to_monty,
 	&br_i32_from_monty,
-	&br_i32_modpow
+	&br_i32_modpow,
+	&br_i32_modpow_vartime,
+	&br_i32_moddiv
 };
 
 static const int_impl *impl;
@@ -246,6 +259,7 @@ test_modint(void)
 			size_t plen, alen, blen, vlen;
 			uint32_t mp[40], ma[40], mb[40], mv[60], mx[100];
 			uint32_t mt1[40], mt2[40], mt3[40];
+			uint32_t mtt[40 * 17];
 			uint32_t ctl;
 			uint32_t mp0i;
 
@@ -331,15 +345,27 @@ test_modint(void)
 			mpz_mod(t1, t1, p);
 			check_eqz(mt1, t1);
 
+			impl->decode_mod(ma, ea, alen, mp);
+			impl->to_monty(ma, mp);
+			impl->montysqr(mt1, ma, mp, mp0i);
+			impl->from_monty(mt1, mp, mp0i);
+			mpz_mul(t1, a, a);
+			mpz_mod(t1, t1, p);
+			check_eqz(mt1, t1);
+
 			impl->decode_mod(ma, ea, alen, mp);
 			impl->modpow(ma, ev, vlen, mp, mp0i, mt1, mt2);
 			mpz_powm(t1, a, v, p);
 			check_eqz(ma, t1);
 
-			/*
-			br_modint_decode(ma, mp, ea, alen);
-			br_modint_decode(mb, mp, eb, blen);
-			if (!br_modint_div(ma, mb, mp, mt1, mt2, mt3)) {
+			impl->decode_mod(ma, ea, alen, mp);
+			impl->modpow_vartime(ma, ev, vlen, mp, mp0i,
+				mtt, (sizeof mtt) / (sizeof mtt[0]));
+			check_eqz(ma, t1);
+
+			impl->decode_mod(ma, ea, alen, mp);
+			impl->decode_mod(mb, eb, blen, mp);
+			if (!impl->moddiv(ma, mb, mp, mtt)) {
 				fprintf(stderr, "division failed\n");
 				exit(EXIT_FAILURE);
 			}
@@ -349,6 +375,7 @@ test_modint(void)
 			mpz_mod(t1, t1, p);
 			check_eqz(ma, t1);
 
+			/*
 			br_modint_decode(ma, mp, ea, alen);
 			br_modint_decode(mb, mp, eb, blen);
 			for (j = 0; j <= (2 * k + 5); j ++) {
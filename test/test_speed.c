@@ -88,7 +88,12 @@ test_speed_ ## fname(void) \
 	memset(key, 'T', sizeof key); \
 	memset(buf, 'P', sizeof buf); \
 	memset(iv, 'X', sizeof iv); \
-	vt = &br_ ## cname ## _cbc ## dir ## _vtable; \
+	vt = br_ ## cname ## _cbc ## dir ## _get_vtable(); \
+	if (vt == NULL) { \
+		printf("%-30s UNAVAILABLE\n", #Name); \
+		fflush(stdout); \
+		return; \
+	} \
 	for (i = 0; i < 10; i ++) { \
 		vt->init(&ec.vtable, key, sizeof key); \
 		vt->run(&ec.vtable, iv, buf, sizeof buf); \
@@ -132,7 +137,12 @@ test_speed_ ## fname(void) \
 	memset(key, 'T', sizeof key); \
 	memset(buf, 'P', sizeof buf); \
 	memset(iv, 'X', sizeof iv); \
-	vt = &br_ ## cname ## _ctr_vtable; \
+	vt = br_ ## cname ## _ctr_get_vtable(); \
+	if (vt == NULL) { \
+		printf("%-30s UNAVAILABLE\n", #Name); \
+		fflush(stdout); \
+		return; \
+	} \
 	for (i = 0; i < 10; i ++) { \
 		vt->init(&ec.vtable, key, sizeof key); \
 		vt->run(&ec.vtable, iv, 1, buf, sizeof buf); \
@@ -161,48 +171,727 @@ test_speed_ ## fname(void) \
 	} \
 }
 
-SPEED_HASH(MD5, md5)
-SPEED_HASH(SHA-1, sha1)
-SPEED_HASH(SHA-256, sha256)
-SPEED_HASH(SHA-512, sha512)
+SPEED_HASH(MD5, md5)
+SPEED_HASH(SHA-1, sha1)
+SPEED_HASH(SHA-256, sha256)
+SPEED_HASH(SHA-512, sha512)
+
+/*
+ * Speed test for an alternate hash implementation, obtained at runtime
+ * as a vtable (NULL if not available).
+ */
+#define SPEED_HASH_VT(Name, fname, get_vt) \
+static void \
+test_speed_ ## fname(void) \
+{ \
+	unsigned char buf[8192]; \
+	unsigned char tmp[64]; \
+	br_hash_compat_context mc; \
+	const br_hash_class *hc; \
+	int i; \
+	long num; \
+ \
+	hc = get_vt(); \
+	if (hc == NULL) { \
+		printf("%-30s UNAVAILABLE\n", #Name); \
+		fflush(stdout); \
+		return; \
+	} \
+	memset(buf, 'T', sizeof buf); \
+	for (i = 0; i < 10; i ++) { \
+		hc->init(&mc.vtable); \
+		hc->update(&mc.vtable, buf, sizeof buf); \
+		hc->out(&mc.vtable, tmp); \
+	} \
+	num = 10; \
+	for (;;) { \
+		clock_t begin, end; \
+		double tt; \
+		long k; \
+ \
+		hc->init(&mc.vtable); \
+		begin = clock(); \
+		for (k = num; k > 0; k --) { \
+			hc->update(&mc.vtable, buf, sizeof buf); \
+		} \
+		end = clock(); \
+		hc->out(&mc.vtable, tmp); \
+		tt = (double)(end - begin) / CLOCKS_PER_SEC; \
+		if (tt >= 2.0) { \
+			printf("%-30s %8.2f MB/s\n", #Name, \
+				((double)sizeof buf) * (double)num \
+				/ (tt * 1000000.0)); \
+			fflush(stdout); \
+			return; \
+		} \
+		num <<= 1; \
+	} \
+}
+
+SPEED_HASH_VT(SHA-1 (x86ni), sha1_x86ni, br_sha1_x86ni_get_vtable)
+SPEED_HASH_VT(SHA-256 (x86ni), sha256_x86ni, br_sha256_x86ni_get_vtable)
+
+/*
+ * Multi-buffer SHA-256: eight independent messages are hashed together;
+ * the reported speed is the aggregate throughput over all messages.
+ */
+static void
+test_speed_sha256_mb_inner(char *name, const br_sha256_mb_impl *impl)
+{
+	unsigned char buf[8][8192];
+	unsigned char tmp[32];
+	br_sha256_context mc[8];
+	br_sha256_context *pc[8];
+	const void *pd[8];
+	int i;
+	long num;
+
+	if (impl == NULL) {
+		printf("%-30s UNAVAILABLE\n", name);
+		fflush(stdout);
+		return;
+	}
+	memset(buf, 'T', sizeof buf);
+	for (i = 0; i < 8; i ++) {
+		pc[i] = &mc[i];
+		pd[i] = buf[i];
+		br_sha256_init(&mc[i]);
+	}
+	for (i = 0; i < 10; i ++) {
+		br_sha256_mb_update(impl, pc, pd, sizeof buf[0], 8);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		for (i = 0; i < 8; i ++) {
+			br_sha256_init(&mc[i]);
+		}
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			br_sha256_mb_update(impl, pc, pd, sizeof buf[0], 8);
+		}
+		end = clock();
+		for (i = 0; i < 8; i ++) {
+			br_sha256_out(&mc[i], tmp);
+		}
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s\n", name,
+				((double)sizeof buf) * (double)num
+				/ (tt * 1000000.0));
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_sha256_mb_portable(void)
+{
+	test_speed_sha256_mb_inner("SHA-256 x8 (mb portable)",
+		&br_sha256_mb_portable);
+}
+
+static void
+test_speed_sha256_mb_sse2(void)
+{
+	test_speed_sha256_mb_inner("SHA-256 x8 (mb sse2)",
+		br_sha256_mb_sse2_get());
+}
+
+static void
+test_speed_sha256_mb_avx2(void)
+{
+	test_speed_sha256_mb_inner("SHA-256 x8 (mb avx2)",
+		br_sha256_mb_avx2_get());
+}
+
+static void
+test_speed_sha256_mb_x86ni(void)
+{
+	test_speed_sha256_mb_inner("SHA-256 x8 (mb x86ni)",
+		br_sha256_mb_x86ni_get());
+}
+
+#define SPEED_AES(iname) \
+SPEED_BLOCKCIPHER_CBC(AES-128 CBC encrypt (iname), aes128_ ## iname ## _cbcenc, aes_ ## iname, 16, enc) \
+SPEED_BLOCKCIPHER_CBC(AES-128 CBC decrypt (iname), aes128_ ## iname ## _cbcdec, aes_ ## iname, 16, dec) \
+SPEED_BLOCKCIPHER_CBC(AES-192 CBC encrypt (iname), aes192_ ## iname ## _cbcenc, aes_ ## iname, 24, enc) \
+SPEED_BLOCKCIPHER_CBC(AES-192 CBC decrypt (iname), aes192_ ## iname ## _cbcdec, aes_ ## iname, 24, dec) \
+SPEED_BLOCKCIPHER_CBC(AES-256 CBC encrypt (iname), aes256_ ## iname ## _cbcenc, aes_ ## iname, 32, enc) \
+SPEED_BLOCKCIPHER_CBC(AES-256 CBC decrypt (iname), aes256_ ## iname ## _cbcdec, aes_ ## iname, 32, dec) \
+SPEED_BLOCKCIPHER_CTR(AES-128 CTR (iname), aes128_ ## iname ## _ctr, aes_ ## iname, 16) \
+SPEED_BLOCKCIPHER_CTR(AES-192 CTR (iname), aes192_ ## iname ## _ctr, aes_ ## iname, 24) \
+SPEED_BLOCKCIPHER_CTR(AES-256 CTR (iname), aes256_ ## iname ## _ctr, aes_ ## iname, 32)
+
+#define br_aes_big_cbcenc_get_vtable()     (&br_aes_big_cbcenc_vtable)
+#define br_aes_big_cbcdec_get_vtable()     (&br_aes_big_cbcdec_vtable)
+#define br_aes_big_ctr_get_vtable()        (&br_aes_big_ctr_vtable)
+#define br_aes_small_cbcenc_get_vtable()   (&br_aes_small_cbcenc_vtable)
+#define br_aes_small_cbcdec_get_vtable()   (&br_aes_small_cbcdec_vtable)
+#define br_aes_small_ctr_get_vtable()      (&br_aes_small_ctr_vtable)
+#define br_aes_ct_cbcenc_get_vtable()      (&br_aes_ct_cbcenc_vtable)
+#define br_aes_ct_cbcdec_get_vtable()      (&br_aes_ct_cbcdec_vtable)
+#define br_aes_ct_ctr_get_vtable()         (&br_aes_ct_ctr_vtable)
+#define br_aes_ct64_cbcenc_get_vtable()    (&br_aes_ct64_cbcenc_vtable)
+#define br_aes_ct64_cbcdec_get_vtable()    (&br_aes_ct64_cbcdec_vtable)
+#define br_aes_ct64_ctr_get_vtable()       (&br_aes_ct64_ctr_vtable)
+
+SPEED_AES(big)
+SPEED_AES(small)
+SPEED_AES(ct)
+SPEED_AES(ct64)
+SPEED_AES(x86ni)
+
+#define SPEED_AES_PAR(iname) \
+SPEED_BLOCKCIPHER_CBC(AES-128 CBC decrypt (iname), aes128_ ## iname ## _cbcdec, aes_ ## iname, 16, dec) \
+SPEED_BLOCKCIPHER_CBC(AES-192 CBC decrypt (iname), aes192_ ## iname ## _cbcdec, aes_ ## iname, 24, dec) \
+SPEED_BLOCKCIPHER_CBC(AES-256 CBC decrypt (iname), aes256_ ## iname ## _cbcdec, aes_ ## iname, 32, dec) \
+SPEED_BLOCKCIPHER_CTR(AES-128 CTR (iname), aes128_ ## iname ## _ctr, aes_ ## iname, 16) \
+SPEED_BLOCKCIPHER_CTR(AES-192 CTR (iname), aes192_ ## iname ## _ctr, aes_ ## iname, 24) \
+SPEED_BLOCKCIPHER_CTR(AES-256 CTR (iname), aes256_ ## iname ## _ctr, aes_ ## iname, 32)
+
+SPEED_AES_PAR(ct64_sse2)
+SPEED_AES_PAR(ct64_avx2)
+
+#define SPEED_DES(iname) \
+SPEED_BLOCKCIPHER_CBC(DES CBC encrypt (iname), des_ ## iname ## _cbcenc, des_ ## iname, 8, enc) \
+SPEED_BLOCKCIPHER_CBC(DES CBC decrypt (iname), des_ ## iname ## _cbcdec, des_ ## iname, 8, dec) \
+SPEED_BLOCKCIPHER_CBC(3DES CBC encrypt (iname), 3des_ ## iname ## _cbcenc, des_ ## iname, 24, enc) \
+SPEED_BLOCKCIPHER_CBC(3DES CBC decrypt (iname), 3des_ ## iname ## _cbcdec, des_ ## iname, 24, dec)
+
+#define br_des_tab_cbcenc_get_vtable()     (&br_des_tab_cbcenc_vtable)
+#define br_des_tab_cbcdec_get_vtable()     (&br_des_tab_cbcdec_vtable)
+#define br_des_ct_cbcenc_get_vtable()      (&br_des_ct_cbcenc_vtable)
+#define br_des_ct_cbcdec_get_vtable()      (&br_des_ct_cbcdec_vtable)
+
+SPEED_DES(tab)
+SPEED_DES(ct)
+
+static void
+test_speed_ghash_inner(char *name, br_ghash gh)
+{
+	unsigned char buf[8192], h[16], y[16];
+	int i;
+	long num;
+
+	memset(buf, 'T', sizeof buf);
+	memset(h, 'P', sizeof h);
+	memset(y, 0, sizeof y);
+	for (i = 0; i < 10; i ++) {
+		gh(y, h, buf, sizeof buf);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			gh(y, h, buf, sizeof buf);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s\n", name,
+				((double)sizeof buf) * (double)num
+				/ (tt * 1000000.0));
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_ghash_ctmul(void)
+{
+	test_speed_ghash_inner("GHASH (ctmul)", &br_ghash_ctmul);
+}
+
+static void
+test_speed_ghash_ctmul32(void)
+{
+	test_speed_ghash_inner("GHASH (ctmul32)", &br_ghash_ctmul32);
+}
+
+static void
+test_speed_ghash_ctmul64(void)
+{
+	test_speed_ghash_inner("GHASH (ctmul64)", &br_ghash_ctmul64);
+}
+
+static void
+test_speed_ghash_pclmul(void)
+{
+	br_ghash gh;
+
+	gh = br_ghash_pclmul_get();
+	if (gh == 0) {
+		printf("%-30s UNAVAILABLE\n", "GHASH (pclmul)");
+		fflush(stdout);
+	} else {
+		test_speed_ghash_inner("GHASH (pclmul)", gh);
+	}
+}
+
+static void
+test_speed_chacha20_inner(char *name, br_chacha20_run cr)
+{
+	unsigned char buf[8192], key[32], iv[12];
+	int i;
+	long num;
+
+	memset(buf, 'T', sizeof buf);
+	memset(key, 'K', sizeof key);
+	memset(iv, 'I', sizeof iv);
+	for (i = 0; i < 10; i ++) {
+		cr(key, iv, i, buf, sizeof buf);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			cr(key, iv, (uint32_t)k, buf, sizeof buf);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s\n", name,
+				((double)sizeof buf) * (double)num
+				/ (tt * 1000000.0));
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_chacha20_ct(void)
+{
+	test_speed_chacha20_inner("ChaCha20 (ct)", &br_chacha20_ct_run);
+}
+
+static void
+test_speed_chacha20_sse2(void)
+{
+	br_chacha20_run cr;
+
+	cr = br_chacha20_sse2_get();
+	if (cr == 0) {
+		printf("%-30s UNAVAILABLE\n", "ChaCha20 (SSE2)");
+		fflush(stdout);
+	} else {
+		test_speed_chacha20_inner("ChaCha20 (SSE2)", cr);
+	}
+}
+
+static void
+test_speed_chacha20_avx2(void)
+{
+	br_chacha20_run cr;
+
+	cr = br_chacha20_avx2_get();
+	if (cr == 0) {
+		printf("%-30s UNAVAILABLE\n", "ChaCha20 (AVX2)");
+		fflush(stdout);
+	} else {
+		test_speed_chacha20_inner("ChaCha20 (AVX2)", cr);
+	}
+}
+
+static void
+test_speed_poly1305_inner(char *name, br_poly1305_run pl)
+{
+	unsigned char buf[8192], key[32], iv[12], aad[13], tag[16];
+	int i;
+	long num;
+
+	memset(buf, 'T', sizeof buf);
+	memset(key, 'K', sizeof key);
+	memset(iv, 'I', sizeof iv);
+	memset(aad, 'A', sizeof aad);
+	for (i = 0; i < 10; i ++) {
+		pl(key, iv, buf, sizeof buf, aad, sizeof aad,
+			tag, &br_chacha20_ct_run, 1);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			pl(key, iv, buf, sizeof buf, aad, sizeof aad,
+				tag, &br_chacha20_ct_run, 1);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s\n", name,
+				((double)sizeof buf) * (double)num
+				/ (tt * 1000000.0));
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_poly1305_ctmul(void)
+{
+	test_speed_poly1305_inner("ChaCha20+Poly1305 (ctmul)",
+		&br_poly1305_ctmul_run);
+}
+
+/*
+ * Record-level benchmark for AES/GCM: encryption of full-sized records
+ * (16 kB of plaintext) with the SSL record engine.
+ */
+static void
+test_speed_gcm_record_inner(char *name,
+	const br_block_ctr_class *bc, br_ghash gh,
+	const br_gcm_kernel_class *kern)
+{
+	unsigned char rec[13 + 16384 + 16];
+	unsigned char key[16], iv[4];
+	br_sslrec_gcm_context gc;
+	int i;
+	long num;
+
+	if (bc == NULL || gh == 0) {
+		printf("%-30s UNAVAILABLE\n", name);
+		fflush(stdout);
+		return;
+	}
+	memset(rec, 'T', sizeof rec);
+	memset(key, 'K', sizeof key);
+	memset(iv, 'I', sizeof iv);
+	br_sslrec_out_gcm_vtable.init(&gc.vtable.out,
+		bc, key, sizeof key, gh, iv);
+	br_sslrec_gcm_set_kernel(&gc, kern);
+	for (i = 0; i < 10; i ++) {
+		size_t len;
+
+		len = 16384;
+		gc.vtable.out->inner.encrypt(
+			(const br_sslrec_out_class **)&gc.vtable.out,
+			23, 0x0303, rec + 13, &len);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			size_t len;
+
+			len = 16384;
+			gc.vtable.out->inner.encrypt(
+				(const br_sslrec_out_class **)&gc.vtable.out,
+				23, 0x0303, rec + 13, &len);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s\n", name,
+				16384.0 * (double)num / (tt * 1000000.0));
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_gcm_record_ct64(void)
+{
+	test_speed_gcm_record_inner("AES-128 GCM record (ct64)",
+		&br_aes_ct64_ctr_vtable, &br_ghash_ctmul64, NULL);
+}
+
+static void
+test_speed_gcm_record_x86ni(void)
+{
+	test_speed_gcm_record_inner("AES-128 GCM record (x86ni)",
+		br_aes_x86ni_ctr_get_vtable(), br_ghash_pclmul_get(), NULL);
+}
+
+static void
+test_speed_gcm_record_x86ni_fused(void)
+{
+	const br_gcm_kernel_class *kern;
+
+	kern = br_aes_x86ni_gcm_kernel_get();
+	test_speed_gcm_record_inner("AES-128 GCM record (fused)",
+		kern == NULL ? NULL : kern->ctr_vtable,
+		br_ghash_pclmul_get(), kern);
+}
+
+static void
+test_speed_ccm_record_inner(char *name,
+	const br_block_cbcenc_class *be, const br_block_ctr_class *bc)
+{
+	unsigned char rec[13 + 16384 + 16];
+	unsigned char key[16], iv[4];
+	br_sslrec_ccm_context cc;
+	int i;
+	long num;
+
+	if (be == NULL || bc == NULL) {
+		printf("%-30s UNAVAILABLE\n", name);
+		fflush(stdout);
+		return;
+	}
+	memset(rec, 'T', sizeof rec);
+	memset(key, 'K', sizeof key);
+	memset(iv, 'I', sizeof iv);
+	br_sslrec_out_ccm_vtable.init(&cc.vtable.out,
+		be, bc, key, sizeof key, iv, 16);
+	for (i = 0; i < 10; i ++) {
+		size_t len;
+
+		len = 16384;
+		cc.vtable.out->inner.encrypt(
+			(const br_sslrec_out_class **)&cc.vtable.out,
+			23, 0x0303, rec + 13, &len);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			size_t len;
+
+			len = 16384;
+			cc.vtable.out->inner.encrypt(
+				(const br_sslrec_out_class **)&cc.vtable.out,
+				23, 0x0303, rec + 13, &len);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s\n", name,
+				16384.0 * (double)num / (tt * 1000000.0));
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_ccm_record_ct64(void)
+{
+	test_speed_ccm_record_inner("AES-128 CCM record (ct64)",
+		&br_aes_ct64_cbcenc_vtable, &br_aes_ct64_ctr_vtable);
+}
+
+static void
+test_speed_ccm_record_x86ni(void)
+{
+	test_speed_ccm_record_inner("AES-128 CCM record (x86ni)",
+		br_aes_x86ni_cbcenc_get_vtable(),
+		br_aes_x86ni_ctr_get_vtable());
+}
+
+/*
+ * Record-level benchmark for CBC + HMAC/SHA-1 decryption, with either
+ * MAC-then-encrypt (constant-time MAC check) or Encrypt-then-MAC
+ * (RFC 7366). Records use TLS 1.2 (explicit IV) and contain 'plen'
+ * bytes of plaintext; each iteration decrypts a fresh copy of the
+ * same record, so that the measured cost includes a copy of the
+ * record.
+ */
+static void
+test_speed_cbc_record_inner(char *name, size_t plen,
+	const br_sslrec_in_cbc_class *ri, const br_sslrec_out_cbc_class *ro)
+{
+	unsigned char rec[16 + 5 + 16384 + 256 + 20];
+	unsigned char orig[sizeof rec];
+	unsigned char key[16], mkey[20];
+	const br_block_cbcenc_class *be;
+	const br_block_cbcdec_class *bd;
+	br_sslrec_out_cbc_context oc;
+	br_sslrec_in_cbc_context ic;
+	unsigned char *buf;
+	size_t a, b, len;
+	int i;
+	long num;
+
+	be = br_aes_x86ni_cbcenc_get_vtable();
+	bd = br_aes_x86ni_cbcdec_get_vtable();
+	if (be == NULL || bd == NULL) {
+		be = &br_aes_ct64_cbcenc_vtable;
+		bd = &br_aes_ct64_cbcdec_vtable;
+	}
+	memset(rec, 'T', sizeof rec);
+	memset(key, 'K', sizeof key);
+	memset(mkey, 'M', sizeof mkey);
+	ro->init(&oc.vtable, be, key, sizeof key,
+		&br_sha1_vtable, mkey, sizeof mkey, 20, NULL);
+	ri->init(&ic.vtable, bd, key, sizeof key,
+		&br_sha1_vtable, mkey, sizeof mkey, 20, NULL);
+	a = 5;
+	b = sizeof rec;
+	oc.vtable->inner.max_plaintext(
+		(const br_sslrec_out_class *const *)&oc.vtable, &a, &b);
+	len = plen;
+	buf = oc.vtable->inner.encrypt(
+		(const br_sslrec_out_class **)&oc.vtable,
+		23, 0x0303, rec + a, &len);
+	memcpy(orig, buf + 5, len - 5);
+	len -= 5;
+	if (!ic.vtable->inner.check_length(
+		(const br_sslrec_in_class *const *)&ic.vtable, len))
+	{
+		fprintf(stderr, "%s: wrong record length\n", name);
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < 10; i ++) {
+		size_t dlen;
+
+		memcpy(rec, orig, len);
+		ic.seq = 0;
+		dlen = len;
+		if (ic.vtable->inner.decrypt(
+			(const br_sslrec_in_class **)&ic.vtable,
+			23, 0x0303, rec, &dlen) == NULL || dlen != plen)
+		{
+			fprintf(stderr, "%s: decryption failed\n", name);
+			exit(EXIT_FAILURE);
+		}
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			size_t dlen;
+
+			memcpy(rec, orig, len);
+			ic.seq = 0;
+			dlen = len;
+			ic.vtable->inner.decrypt(
+				(const br_sslrec_in_class **)&ic.vtable,
+				23, 0x0303, rec, &dlen);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f MB/s %8.2f us/rec\n", name,
+				(double)plen * (double)num / (tt * 1000000.0),
+				tt * 1000000.0 / (double)num);
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
 
-#define SPEED_AES(iname) \
-SPEED_BLOCKCIPHER_CBC(AES-128 CBC encrypt (iname), aes128_ ## iname ## _cbcenc, aes_ ## iname, 16, enc) \
-SPEED_BLOCKCIPHER_CBC(AES-128 CBC decrypt (iname), aes128_ ## iname ## _cbcdec, aes_ ## iname, 16, dec) \
-SPEED_BLOCKCIPHER_CBC(AES-192 CBC encrypt (iname), aes192_ ## iname ## _cbcenc, aes_ ## iname, 24, enc) \
-SPEED_BLOCKCIPHER_CBC(AES-192 CBC decrypt (iname), aes192_ ## iname ## _cbcdec, aes_ ## iname, 24, dec) \
-SPEED_BLOCKCIPHER_CBC(AES-256 CBC encrypt (iname), aes256_ ## iname ## _cbcenc, aes_ ## iname, 32, enc) \
-SPEED_BLOCKCIPHER_CBC(AES-256 CBC decrypt (iname), aes256_ ## iname ## _cbcdec, aes_ ## iname, 32, dec) \
-SPEED_BLOCKCIPHER_CTR(AES-128 CTR (iname), aes128_ ## iname ## _ctr, aes_ ## iname, 16) \
-SPEED_BLOCKCIPHER_CTR(AES-192 CTR (iname), aes192_ ## iname ## _ctr, aes_ ## iname, 24) \
-SPEED_BLOCKCIPHER_CTR(AES-256 CTR (iname), aes256_ ## iname ## _ctr, aes_ ## iname, 32)
+static void
+test_speed_cbc_record_mte(void)
+{
+	test_speed_cbc_record_inner("AES-128 CBC record (MtE)", 16384,
+		&br_sslrec_in_cbc_vtable, &br_sslrec_out_cbc_vtable);
+}
 
-SPEED_AES(big)
-SPEED_AES(small)
-SPEED_AES(ct)
-SPEED_AES(ct64)
+static void
+test_speed_cbc_record_etm(void)
+{
+	test_speed_cbc_record_inner("AES-128 CBC record (EtM)", 16384,
+		&br_sslrec_in_cbc_etm_vtable, &br_sslrec_out_cbc_etm_vtable);
+}
 
-#define SPEED_DES(iname) \
-SPEED_BLOCKCIPHER_CBC(DES CBC encrypt (iname), des_ ## iname ## _cbcenc, des_ ## iname, 8, enc) \
-SPEED_BLOCKCIPHER_CBC(DES CBC decrypt (iname), des_ ## iname ## _cbcdec, des_ ## iname, 8, dec) \
-SPEED_BLOCKCIPHER_CBC(3DES CBC encrypt (iname), 3des_ ## iname ## _cbcenc, des_ ## iname, 24, enc) \
-SPEED_BLOCKCIPHER_CBC(3DES CBC decrypt (iname), 3des_ ## iname ## _cbcdec, des_ ## iname, 24, dec)
+static void
+test_speed_cbc_record_mte_small(void)
+{
+	test_speed_cbc_record_inner("AES-128 CBC 256 B record (MtE)", 256,
+		&br_sslrec_in_cbc_vtable, &br_sslrec_out_cbc_vtable);
+}
 
-SPEED_DES(tab)
-SPEED_DES(ct)
+static void
+test_speed_cbc_record_etm_small(void)
+{
+	test_speed_cbc_record_inner("AES-128 CBC 256 B record (EtM)", 256,
+		&br_sslrec_in_cbc_etm_vtable, &br_sslrec_out_cbc_etm_vtable);
+}
 
+/*
+ * Record-level benchmark for AES/CBC + HMAC encryption of full-sized
+ * records (16 kB of plaintext, TLS 1.2), optionally with a CBC+HMAC
+ * kernel.
+ */
 static void
-test_speed_ghash_inner(char *name, br_ghash gh)
+test_speed_cbc_record_enc_inner(char *name,
+	const br_hash_class *dig, const br_sslrec_out_cbc_class *ro,
+	const br_cbc_hmac_kernel_class *kern, int use_kern)
 {
-	unsigned char buf[8192], h[16], y[16];
+	unsigned char rec[16 + 5 + 16384 + 256 + 32];
+	unsigned char key[16], mkey[32];
+	const br_block_cbcenc_class *be;
+	br_sslrec_out_cbc_context oc;
+	size_t a, b, mlen;
 	int i;
 	long num;
 
-	memset(buf, 'T', sizeof buf);
-	memset(h, 'P', sizeof h);
-	memset(y, 0, sizeof y);
+	/*
+	 * The two-pass code uses the SHA opcodes too, when available, so
+	 * that only the stitching itself is measured.
+	 */
+	be = br_aes_x86ni_cbcenc_get_vtable();
+	if (br_digest_id(dig) == br_sha1_ID) {
+		if (br_sha1_x86ni_get_vtable() != NULL) {
+			dig = br_sha1_x86ni_get_vtable();
+		}
+	} else {
+		if (br_sha256_x86ni_get_vtable() != NULL) {
+			dig = br_sha256_x86ni_get_vtable();
+		}
+	}
+	if (be == NULL || (use_kern && kern == NULL)) {
+		printf("%-30s UNAVAILABLE\n", name);
+		fflush(stdout);
+		return;
+	}
+	mlen = br_digest_size(dig);
+	memset(rec, 'T', sizeof rec);
+	memset(key, 'K', sizeof key);
+	memset(mkey, 'M', sizeof mkey);
+	ro->init(&oc.vtable, be, key, sizeof key,
+		dig, mkey, mlen, mlen, NULL);
+	br_sslrec_out_cbc_set_kernel(&oc, use_kern ? kern : NULL);
+	a = 5;
+	b = sizeof rec;
+	oc.vtable->inner.max_plaintext(
+		(const br_sslrec_out_class *const *)&oc.vtable, &a, &b);
 	for (i = 0; i < 10; i ++) {
-		gh(y, h, buf, sizeof buf);
+		size_t len;
+
+		len = 16384;
+		oc.vtable->inner.encrypt(
+			(const br_sslrec_out_class **)&oc.vtable,
+			23, 0x0303, rec + a, &len);
 	}
 	num = 10;
 	for (;;) {
@@ -212,14 +901,18 @@ test_speed_ghash_inner(char *name, br_ghash gh)
 
 		begin = clock();
 		for (k = num; k > 0; k --) {
-			gh(y, h, buf, sizeof buf);
+			size_t len;
+
+			len = 16384;
+			oc.vtable->inner.encrypt(
+				(const br_sslrec_out_class **)&oc.vtable,
+				23, 0x0303, rec + a, &len);
 		}
 		end = clock();
 		tt = (double)(end - begin) / CLOCKS_PER_SEC;
 		if (tt >= 2.0) {
 			printf("%-30s %8.2f MB/s\n", name,
-				((double)sizeof buf) * (double)num
-				/ (tt * 1000000.0));
+				16384.0 * (double)num / (tt * 1000000.0));
 			fflush(stdout);
 			return;
 		}
@@ -228,21 +921,48 @@ test_speed_ghash_inner(char *name, br_ghash gh)
 }
 
 static void
-test_speed_ghash_ctmul(void)
+test_speed_cbc_record_enc_sha1(void)
 {
-	test_speed_ghash_inner("GHASH (ctmul)", &br_ghash_ctmul);
+	test_speed_cbc_record_enc_inner("AES-128 CBC/SHA-1 rec (MtE)",
+		&br_sha1_vtable, &br_sslrec_out_cbc_vtable, NULL, 0);
 }
 
 static void
-test_speed_ghash_ctmul32(void)
+test_speed_cbc_record_enc_sha1_stitch(void)
 {
-	test_speed_ghash_inner("GHASH (ctmul32)", &br_ghash_ctmul32);
+	test_speed_cbc_record_enc_inner("AES-128 CBC/SHA-1 rec (MtE st)",
+		&br_sha1_vtable, &br_sslrec_out_cbc_vtable,
+		br_aes_x86ni_cbc_hmac_kernel_get(), 1);
 }
 
 static void
-test_speed_ghash_ctmul64(void)
+test_speed_cbc_record_enc_sha256(void)
 {
-	test_speed_ghash_inner("GHASH (ctmul64)", &br_ghash_ctmul64);
+	test_speed_cbc_record_enc_inner("AES-128 CBC/SHA-256 rec (MtE)",
+		&br_sha256_vtable, &br_sslrec_out_cbc_vtable, NULL, 0);
+}
+
+static void
+test_speed_cbc_record_enc_sha256_stitch(void)
+{
+	test_speed_cbc_record_enc_inner("AES-128 CBC/SHA-256 rec (MtE st)",
+		&br_sha256_vtable, &br_sslrec_out_cbc_vtable,
+		br_aes_x86ni_cbc_hmac_kernel_get(), 1);
+}
+
+static void
+test_speed_cbc_record_enc_sha1_etm(void)
+{
+	test_speed_cbc_record_enc_inner("AES-128 CBC/SHA-1 rec (EtM)",
+		&br_sha1_vtable, &br_sslrec_out_cbc_etm_vtable, NULL, 0);
+}
+
+static void
+test_speed_cbc_record_enc_sha1_etm_stitch(void)
+{
+	test_speed_cbc_record_enc_inner("AES-128 CBC/SHA-1 rec (EtM st)",
+		&br_sha1_vtable, &br_sslrec_out_cbc_etm_vtable,
+		br_aes_x86ni_cbc_hmac_kernel_get(), 1);
 }
 
 static const unsigned char RSA_N[] = {
@@ -462,6 +1182,46 @@ test_speed_rsa_i31(void)
 		&br_rsa_i31_public, &br_rsa_i31_private);
 }
 
+static void
+test_speed_rsa_i31_expanded(void)
+{
+	br_rsa_i31_expanded_key xsk;
+	unsigned char tmp[sizeof RSA_N];
+	int i;
+	long num;
+
+	if (!br_rsa_i31_expand_key(&xsk, &RSA_SK)) {
+		abort();
+	}
+	memset(tmp, 'R', sizeof tmp);
+	tmp[0] = 0;
+	for (i = 0; i < 10; i ++) {
+		if (!br_rsa_i31_private_expanded(tmp, &xsk)) {
+			abort();
+		}
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			br_rsa_i31_private_expanded(tmp, &xsk);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f priv/s\n", "RSA i31 expanded",
+				(double)num / tt);
+			fflush(stdout);
+			break;
+		}
+		num <<= 1;
+	}
+}
+
 static void
 test_speed_rsa_i32(void)
 {
@@ -469,6 +1229,22 @@ test_speed_rsa_i32(void)
 		&br_rsa_i32_public, &br_rsa_i32_private);
 }
 
+static void
+test_speed_rsa_i62(void)
+{
+	br_rsa_public pub;
+	br_rsa_private priv;
+
+	pub = br_rsa_i62_public_get();
+	priv = br_rsa_i62_private_get();
+	if (pub == 0 || priv == 0) {
+		printf("%-30s UNAVAILABLE\n", "RSA i62");
+		fflush(stdout);
+		return;
+	}
+	test_speed_rsa_inner("RSA i62", pub, priv);
+}
+
 static void
 test_speed_ec_inner(const char *name,
 	const br_ec_impl *impl, const br_ec_curve_def *cd)
@@ -509,6 +1285,30 @@ test_speed_ec_inner(const char *name,
 		}
 		num <<= 1;
 	}
+
+	for (i = 0; i < 10; i ++) {
+		impl->mulgen(U, bx, nlen, cd->curve);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			impl->mulgen(U, bx, nlen, cd->curve);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f mulgen/s\n", name,
+				(double)num / tt);
+			fflush(stdout);
+			break;
+		}
+		num <<= 1;
+	}
 }
 
 static void
@@ -519,6 +1319,27 @@ test_speed_ec_prime_i31(void)
 	test_speed_ec_inner("EC i31 P-521", &br_ec_prime_i31, &br_secp521r1);
 }
 
+static void
+test_speed_ec_p256_m32(void)
+{
+	test_speed_ec_inner("EC p256_m32", &br_ec_p256_m32, &br_secp256r1);
+}
+
+static void
+test_speed_ec_c25519_m32(void)
+{
+	br_ec_curve_def cd;
+
+	/*
+	 * There is no br_ec_curve_def for Curve25519; we make one from
+	 * the implementation's (fake) order and generator.
+	 */
+	cd.curve = BR_EC_curve25519;
+	cd.order = br_ec_c25519_m32.order(cd.curve, &cd.order_len);
+	cd.generator = br_ec_c25519_m32.generator(cd.curve, &cd.generator_len);
+	test_speed_ec_inner("EC c25519_m32", &br_ec_c25519_m32, &cd);
+}
+
 static void
 test_speed_ecdsa_inner(const char *name,
 	const br_ec_impl *impl, const br_ec_curve_def *cd,
@@ -621,6 +1442,15 @@ test_speed_ecdsa_i31(void)
 		&br_ecdsa_i31_vrfy_asn1);
 }
 
+static void
+test_speed_ecdsa_p256_m32(void)
+{
+	test_speed_ecdsa_inner("ECDSA p256_m32 P-256",
+		&br_ec_p256_m32, &br_secp256r1,
+		&br_ecdsa_i31_sign_asn1,
+		&br_ecdsa_i31_vrfy_asn1);
+}
+
 #if 0
 /* obsolete */
 static void
@@ -830,9 +1660,7 @@ test_speed_i31(void)
 	}
 }
 
-#if 0
-
-static unsigned char P2048[] = {
+static const unsigned char P2048[] = {
 	0xFD, 0xB6, 0xE0, 0x3E, 0x00, 0x49, 0x4C, 0xF0, 0x69, 0x3A, 0xDD, 0x7D,
 	0xF8, 0xA2, 0x41, 0xB0, 0x6C, 0x67, 0xC5, 0xBA, 0xB8, 0x46, 0x80, 0xF5,
 	0xBF, 0xAB, 0x98, 0xFC, 0x84, 0x73, 0xA5, 0x63, 0xC9, 0x52, 0x12, 0xDA,
@@ -857,34 +1685,161 @@ static unsigned char P2048[] = {
 	0x31, 0xAC, 0x2B, 0x73
 };
 
-static unsigned char G2048[] = {
+static const unsigned char G2048[] = {
 	0x02
 };
 
 static void
-test_speed_modpow(void)
+modpow_i31(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	br_i31_modpow(x, e, elen, m, m0i, tmp, tmp + (twlen >> 1));
+}
+
+static void
+modpow_i31_opt(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	br_i31_modpow_opt(x, e, elen, m, m0i, tmp, twlen);
+}
+
+static void
+modpow_i32(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	br_i32_modpow(x, e, elen, m, m0i, tmp, tmp + (twlen >> 1));
+}
+
+static void
+modpow_i32_opt(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	br_i32_modpow_opt(x, e, elen, m, m0i, tmp, twlen);
+}
+
+static void
+modpow_i62_opt(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen)
+{
+	uint64_t t62[35 * 35];
+
+	(void)tmp;
+	br_i62_modpow_opt(x, e, elen, m, m0i, t62,
+		twlen < (sizeof t62 / sizeof t62[0])
+		? twlen : (sizeof t62 / sizeof t62[0]));
+}
+
+/*
+ * Modular exponentiation modulo a 2048-bit prime, with a 2048-bit
+ * exponent. 'twlen' is the size (in words) of the temporary area;
+ * with br_ixx_modpow_opt(), it determines the window size.
+ */
+static void
+test_speed_modpow_inner(const char *name, int i31,
+	void (*modpow)(uint32_t *x, const unsigned char *e, size_t elen,
+	const uint32_t *m, uint32_t m0i, uint32_t *tmp, size_t twlen),
+	size_t twlen)
 {
-	uint32_t mx[65], mp[65], me[65], t1[65], t2[65], len;
-	unsigned char e[64];
+	uint32_t mx[70], mp[70], tmp[33 * 70];
+	unsigned char e[256];
+	uint32_t m0i;
 	int i;
 	long num;
 
-	len = br_int_decode(mp, sizeof mp / sizeof mp[0],
-		P2048, sizeof P2048);
-	if (len != 65) {
-		abort();
-	}
 	memset(e, 'P', sizeof e);
-	if (!br_int_decode(me, sizeof me / sizeof me[0], e, sizeof e)) {
-		abort();
+	if (i31) {
+		br_i31_decode(mp, P2048, sizeof P2048);
+		m0i = br_i31_ninv31(mp[1]);
+		br_i31_decode_reduce(mx, G2048, sizeof G2048, mp);
+	} else {
+		br_i32_decode(mp, P2048, sizeof P2048);
+		m0i = br_i32_ninv32(mp[1]);
+		br_i32_decode_reduce(mx, G2048, sizeof G2048, mp);
 	}
-	if (!br_modint_decode(mx, mp, G2048, sizeof G2048)) {
-		abort();
+	for (i = 0; i < 10; i ++) {
+		modpow(mx, e, sizeof e, mp, m0i, tmp, twlen);
+	}
+	num = 10;
+	for (;;) {
+		clock_t begin, end;
+		double tt;
+		long k;
+
+		begin = clock();
+		for (k = num; k > 0; k --) {
+			modpow(mx, e, sizeof e, mp, m0i, tmp, twlen);
+		}
+		end = clock();
+		tt = (double)(end - begin) / CLOCKS_PER_SEC;
+		if (tt >= 2.0) {
+			printf("%-30s %8.2f exp/s\n", name,
+				(double)num / tt);
+			fflush(stdout);
+			return;
+		}
+		num <<= 1;
+	}
+}
+
+static void
+test_speed_modpow(void)
+{
+	test_speed_modpow_inner("i31 pow[2048:2048]", 1,
+		&modpow_i31, 2 * 70);
+	test_speed_modpow_inner("i31 pow[2048:2048] (w=3)", 1,
+		&modpow_i31_opt, 9 * 70);
+	test_speed_modpow_inner("i31 pow[2048:2048] (w=5)", 1,
+		&modpow_i31_opt, 33 * 70);
+	test_speed_modpow_inner("i62 pow[2048:2048] (w=3)", 1,
+		&modpow_i62_opt, 11 * 35);
+	test_speed_modpow_inner("i62 pow[2048:2048] (w=5)", 1,
+		&modpow_i62_opt, 35 * 35);
+	test_speed_modpow_inner("i32 pow[2048:2048]", 0,
+		&modpow_i32, 2 * 70);
+	test_speed_modpow_inner("i32 pow[2048:2048] (w=3)", 0,
+		&modpow_i32_opt, 9 * 70);
+	test_speed_modpow_inner("i32 pow[2048:2048] (w=5)", 0,
+		&modpow_i32_opt, 33 * 70);
+}
+
+/*
+ * Montgomery multiplication and squaring, with the schoolbook and the
+ * Karatsuba code, for the factor sizes of RSA-2048, RSA-3072 and
+ * RSA-4096 (1024, 1536 and 2048 bits). This can be used to find the
+ * crossover point for BR_I31_KARATSUBA.
+ */
+static void
+test_speed_karatsuba_inner(size_t bits, int kara, int sqr)
+{
+	unsigned char mb[256], xb[256];
+	uint32_t mp[70], mx[70], mz[70];
+	uint32_t m0i;
+	size_t u, len;
+	char name[50];
+	int i;
+	long num;
+
+	len = bits >> 3;
+	for (u = 0; u < len; u ++) {
+		mb[u] = (unsigned char)(u * 37 + 11);
+		xb[u] = (unsigned char)(u * 59 + 3);
 	}
+	mb[0] |= 0x80;
+	mb[len - 1] |= 0x01;
+	br_i31_decode(mp, mb, len);
+	m0i = br_i31_ninv31(mp[1]);
+	br_i31_decode_reduce(mx, xb, len, mp);
+	sprintf(name, "i31 %s%s[%lu]", sqr ? "montysqr" : "montymul",
+		kara ? "_k" : "", (unsigned long)bits);
+
 	for (i = 0; i < 10; i ++) {
-		br_modint_to_monty(mx, mp);
-		br_modint_montypow(mx, me, mp, t1, t2);
-		br_modint_from_monty(mx, mp);
+		if (sqr) {
+			(kara ? br_i31_montysqr_k : br_i31_montysqr)(
+				mz, mx, mp, m0i);
+		} else {
+			(kara ? br_i31_montymul_k : br_i31_montymul)(
+				mz, mx, mx, mp, m0i);
+		}
 	}
 	num = 10;
 	for (;;) {
@@ -894,14 +1849,18 @@ test_speed_modpow(void)
 
 		begin = clock();
 		for (k = num; k > 0; k --) {
-			br_modint_to_monty(mx, mp);
-			br_modint_montypow(mx, me, mp, t1, t2);
-			br_modint_from_monty(mx, mp);
+			if (sqr) {
+				(kara ? br_i31_montysqr_k : br_i31_montysqr)(
+					mz, mx, mp, m0i);
+			} else {
+				(kara ? br_i31_montymul_k : br_i31_montymul)(
+					mz, mx, mx, mp, m0i);
+			}
 		}
 		end = clock();
 		tt = (double)(end - begin) / CLOCKS_PER_SEC;
 		if (tt >= 2.0) {
-			printf("%-30s %8.2f exp/s\n", "pow[2048:256]",
+			printf("%-30s %8.2f ops/s\n", name,
 				(double)num / tt);
 			fflush(stdout);
 			return;
@@ -911,28 +1870,46 @@ test_speed_modpow(void)
 }
 
 static void
-test_speed_moddiv(void)
+test_speed_karatsuba(void)
+{
+	size_t bits;
+
+	for (bits = 1024; bits <= 2048; bits += 512) {
+		test_speed_karatsuba_inner(bits, 0, 0);
+		test_speed_karatsuba_inner(bits, 1, 0);
+		test_speed_karatsuba_inner(bits, 0, 1);
+		test_speed_karatsuba_inner(bits, 1, 1);
+	}
+}
+
+/*
+ * Modular division modulo a 2048-bit prime.
+ */
+static void
+test_speed_moddiv_inner(const char *name, int i31)
 {
-	uint32_t mx[65], my[65], mp[65], t1[65], t2[65], t3[65], len;
+	uint32_t mx[70], my[70], mp[70], tmp[4 * 70];
 	unsigned char x[255], y[255];
 	int i;
 	long num;
 
-	len = br_int_decode(mp, sizeof mp / sizeof mp[0],
-		P2048, sizeof P2048);
-	if (len != 65) {
-		abort();
-	}
 	memset(x, 'T', sizeof x);
 	memset(y, 'P', sizeof y);
-	if (!br_modint_decode(mx, mp, x, sizeof x)) {
-		abort();
-	}
-	if (!br_modint_decode(my, mp, y, sizeof y)) {
-		abort();
+	if (i31) {
+		br_i31_decode(mp, P2048, sizeof P2048);
+		br_i31_decode_reduce(mx, x, sizeof x, mp);
+		br_i31_decode_reduce(my, y, sizeof y, mp);
+	} else {
+		br_i32_decode(mp, P2048, sizeof P2048);
+		br_i32_decode_reduce(mx, x, sizeof x, mp);
+		br_i32_decode_reduce(my, y, sizeof y, mp);
 	}
 	for (i = 0; i < 10; i ++) {
-		br_modint_div(mx, my, mp, t1, t2, t3);
+		if (i31) {
+			br_i31_moddiv(mx, my, mp, tmp);
+		} else {
+			br_i32_moddiv(mx, my, mp, tmp);
+		}
 	}
 	num = 10;
 	for (;;) {
@@ -942,12 +1919,16 @@ test_speed_moddiv(void)
 
 		begin = clock();
 		for (k = num; k > 0; k --) {
-			br_modint_div(mx, my, mp, t1, t2, t3);
+			if (i31) {
+				br_i31_moddiv(mx, my, mp, tmp);
+			} else {
+				br_i32_moddiv(mx, my, mp, tmp);
+			}
 		}
 		end = clock();
 		tt = (double)(end - begin) / CLOCKS_PER_SEC;
 		if (tt >= 2.0) {
-			printf("%-30s %8.2f div/s\n", "div[2048]",
+			printf("%-30s %8.2f div/s\n", name,
 				(double)num / tt);
 			fflush(stdout);
 			return;
@@ -955,7 +1936,13 @@ test_speed_moddiv(void)
 		num <<= 1;
 	}
 }
-#endif
+
+static void
+test_speed_moddiv(void)
+{
+	test_speed_moddiv_inner("i31 div[2048]", 1);
+	test_speed_moddiv_inner("i32 div[2048]", 0);
+}
 
 #define STU(x)   { test_speed_ ## x, #x }
 
@@ -967,6 +1954,12 @@ static const struct {
 	STU(sha1),
 	STU(sha256),
 	STU(sha512),
+	STU(sha1_x86ni),
+	STU(sha256_x86ni),
+	STU(sha256_mb_portable),
+	STU(sha256_mb_sse2),
+	STU(sha256_mb_avx2),
+	STU(sha256_mb_x86ni),
 
 	STU(aes128_big_cbcenc),
 	STU(aes128_big_cbcdec),
@@ -1008,6 +2001,30 @@ static const struct {
 	STU(aes192_ct64_ctr),
 	STU(aes256_ct64_ctr),
 
+	STU(aes128_x86ni_cbcenc),
+	STU(aes128_x86ni_cbcdec),
+	STU(aes192_x86ni_cbcenc),
+	STU(aes192_x86ni_cbcdec),
+	STU(aes256_x86ni_cbcenc),
+	STU(aes256_x86ni_cbcdec),
+	STU(aes128_x86ni_ctr),
+	STU(aes192_x86ni_ctr),
+	STU(aes256_x86ni_ctr),
+
+	STU(aes128_ct64_sse2_cbcdec),
+	STU(aes192_ct64_sse2_cbcdec),
+	STU(aes256_ct64_sse2_cbcdec),
+	STU(aes128_ct64_sse2_ctr),
+	STU(aes192_ct64_sse2_ctr),
+	STU(aes256_ct64_sse2_ctr),
+
+	STU(aes128_ct64_avx2_cbcdec),
+	STU(aes192_ct64_avx2_cbcdec),
+	STU(aes256_ct64_avx2_cbcdec),
+	STU(aes128_ct64_avx2_ctr),
+	STU(aes192_ct64_avx2_ctr),
+	STU(aes256_ct64_avx2_ctr),
+
 	STU(des_tab_cbcenc),
 	STU(des_tab_cbcdec),
 	STU(3des_tab_cbcenc),
@@ -1021,13 +2038,43 @@ static const struct {
 	STU(ghash_ctmul),
 	STU(ghash_ctmul32),
 	STU(ghash_ctmul64),
+	STU(ghash_pclmul),
+
+	STU(chacha20_ct),
+	STU(chacha20_sse2),
+	STU(chacha20_avx2),
+	STU(poly1305_ctmul),
+
+	STU(gcm_record_ct64),
+	STU(gcm_record_x86ni),
+	STU(gcm_record_x86ni_fused),
+	STU(ccm_record_ct64),
+	STU(ccm_record_x86ni),
+	STU(cbc_record_mte),
+	STU(cbc_record_etm),
+	STU(cbc_record_mte_small),
+	STU(cbc_record_etm_small),
+	STU(cbc_record_enc_sha1),
+	STU(cbc_record_enc_sha1_stitch),
+	STU(cbc_record_enc_sha256),
+	STU(cbc_record_enc_sha256_stitch),
+	STU(cbc_record_enc_sha1_etm),
+	STU(cbc_record_enc_sha1_etm_stitch),
 
 	STU(rsa_i31),
+	STU(rsa_i31_expanded),
 	STU(rsa_i32),
+	STU(rsa_i62),
 	STU(ec_prime_i31),
+	STU(ec_p256_m32),
+	STU(ec_c25519_m32),
 	STU(ecdsa_i31),
+	STU(ecdsa_p256_m32),
 
-	STU(i31)
+	STU(i31),
+	STU(modpow),
+	STU(moddiv),
+	STU(karatsuba)
 };
 
 static int
@@ -258,6 +258,9 @@ HT_expand(HT *ht)
 	n = ht->num_buckets;
 	n2 = n << 1;
 	new_buckets = xmalloc(n2 * sizeof *new_buckets);
+	for (u = 0; u < n2; u ++) {
+		new_buckets[u] = NULL;
+	}
 	for (u = 0; u < n; u ++) {
 		ht_elt *e, *f;
 
@@ -234,6 +234,8 @@ extern const cipher_suite cipher_suites[];
 #define REQ_ECDHE_RSA      0x0100   /* suite uses ECDHE_RSA key exchange */
 #define REQ_ECDHE_ECDSA    0x0200   /* suite uses ECDHE_ECDSA key exchange */
 #define REQ_ECDH           0x0400   /* suite uses static ECDH key exchange */
+#define REQ_CHAPOL         0x0800   /* suite needs ChaCha20+Poly1305 */
+#define REQ_AESCCM         0x1000   /* suite needs AES/CCM encryption */
 
 /*
  * Parse a list of cipher suite names. The names are comma-separated. If
@@ -22,6 +22,8 @@
  * SOFTWARE.
  */
 
+#define _POSIX_C_SOURCE   200112L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -484,22 +486,26 @@ do_client(int argc, char *argv[])
 		}
 		/* TODO: algorithm implementation selection */
 		if ((req & REQ_AESCBC) != 0) {
-			br_ssl_engine_set_aes_cbc(&cc.eng,
-				&br_aes_ct_cbcenc_vtable,
-				&br_aes_ct_cbcdec_vtable);
+			br_ssl_engine_set_default_aes_cbc(&cc.eng);
 			br_ssl_engine_set_cbc(&cc.eng,
 				&br_sslrec_in_cbc_vtable,
 				&br_sslrec_out_cbc_vtable);
+			br_ssl_engine_set_cbc_etm(&cc.eng,
+				&br_sslrec_in_cbc_etm_vtable,
+				&br_sslrec_out_cbc_etm_vtable);
 		}
 		if ((req & REQ_AESGCM) != 0) {
-			br_ssl_engine_set_aes_ctr(&cc.eng,
-				&br_aes_ct_ctr_vtable);
-			br_ssl_engine_set_ghash(&cc.eng,
-				&br_ghash_ctmul);
+			br_ssl_engine_set_default_aes_gcm(&cc.eng);
 			br_ssl_engine_set_gcm(&cc.eng,
 				&br_sslrec_in_gcm_vtable,
 				&br_sslrec_out_gcm_vtable);
 		}
+		if ((req & REQ_AESCCM) != 0) {
+			br_ssl_engine_set_default_aes_ccm(&cc.eng);
+		}
+		if ((req & REQ_CHAPOL) != 0) {
+			br_ssl_engine_set_default_chapol(&cc.eng);
+		}
 		if ((req & REQ_3DESCBC) != 0) {
 			br_ssl_engine_set_des_cbc(&cc.eng,
 				&br_des_ct_cbcenc_vtable,
@@ -507,20 +513,23 @@ do_client(int argc, char *argv[])
 			br_ssl_engine_set_cbc(&cc.eng,
 				&br_sslrec_in_cbc_vtable,
 				&br_sslrec_out_cbc_vtable);
+			br_ssl_engine_set_cbc_etm(&cc.eng,
+				&br_sslrec_in_cbc_etm_vtable,
+				&br_sslrec_out_cbc_etm_vtable);
 		}
 		if ((req & REQ_RSAKEYX) != 0) {
 			br_ssl_client_set_rsapub(&cc, &br_rsa_i31_public);
 		}
 		if ((req & REQ_ECDHE_RSA) != 0) {
-			br_ssl_engine_set_ec(&cc.eng, &br_ec_prime_i31);
+			br_ssl_engine_set_ec(&cc.eng, &br_ec_all_m32);
 			br_ssl_client_set_rsavrfy(&cc, &br_rsa_i31_pkcs1_vrfy);
 		}
 		if ((req & REQ_ECDHE_ECDSA) != 0) {
-			br_ssl_engine_set_ec(&cc.eng, &br_ec_prime_i31);
+			br_ssl_engine_set_ec(&cc.eng, &br_ec_all_m32);
 			br_ssl_client_set_ecdsa(&cc, &br_ecdsa_i31_vrfy_asn1);
 		}
 		if ((req & REQ_ECDH) != 0) {
-			br_ssl_engine_set_ec(&cc.eng, &br_ec_prime_i31);
+			br_ssl_engine_set_ec(&cc.eng, &br_ec_all_m32);
 		}
 	}
 	br_ssl_engine_set_suites(&cc.eng, suite_ids, num_suites);
@@ -551,7 +560,7 @@ do_client(int argc, char *argv[])
 	}
 	br_x509_minimal_set_rsa(&xc, &br_rsa_i31_pkcs1_vrfy);
 	br_x509_minimal_set_ecdsa(&xc,
-		&br_ec_prime_i31, &br_ecdsa_i31_vrfy_asn1);
+		&br_ec_p256_m32, &br_ecdsa_i31_vrfy_asn1);
 
 	/*
 	 * If there is no provided trust anchor, then certificate validation
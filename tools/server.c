@@ -22,6 +22,8 @@
  * SOFTWARE.
  */
 
+#define _POSIX_C_SOURCE   200112L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -387,7 +389,7 @@ sp_do_keyx(const br_ssl_server_policy_class **pctx,
 			&br_rsa_i31_private, &pc->sk->key.rsa,
 			data, len);
 	case BR_KEYTYPE_EC:
-		return br_ec_prime_i31.mul(data, len, pc->sk->key.ec.x,
+		return br_ec_p256_m32.mul(data, len, pc->sk->key.ec.x,
 			pc->sk->key.ec.xlen, pc->sk->key.ec.curve);
 	default:
 		fprintf(stderr, "ERROR: unknown private key type (%d)\n",
@@ -512,7 +514,7 @@ sp_do_sign(const br_ssl_server_policy_class **pctx,
 			}
 			return 0;
 		}
-		sig_len = br_ecdsa_i31_sign_asn1(&br_ec_prime_i31, 
+		sig_len = br_ecdsa_i31_sign_asn1(&br_ec_p256_m32, 
 			hc, hv, &pc->sk->key.ec, data);
 		if (sig_len == 0) {
 			if (pc->verbose) {
@@ -836,7 +838,7 @@ do_server(int argc, char *argv[])
 		break;
 	case BR_KEYTYPE_EC:
 		curve = sk->key.ec.curve;
-		supp = br_ec_prime_i31.supported_curves;
+		supp = br_ec_p256_m32.supported_curves;
 		if (curve > 31 || !((supp >> curve) & 1)) {
 			fprintf(stderr, "ERROR: private key curve (%d)"
 				" is not supported\n", curve);
@@ -927,22 +929,26 @@ do_server(int argc, char *argv[])
 		}
 		/* TODO: algorithm implementation selection */
 		if ((req & REQ_AESCBC) != 0) {
-			br_ssl_engine_set_aes_cbc(&cc.eng,
-				&br_aes_ct_cbcenc_vtable,
-				&br_aes_ct_cbcdec_vtable);
+			br_ssl_engine_set_default_aes_cbc(&cc.eng);
 			br_ssl_engine_set_cbc(&cc.eng,
 				&br_sslrec_in_cbc_vtable,
 				&br_sslrec_out_cbc_vtable);
+			br_ssl_engine_set_cbc_etm(&cc.eng,
+				&br_sslrec_in_cbc_etm_vtable,
+				&br_sslrec_out_cbc_etm_vtable);
 		}
 		if ((req & REQ_AESGCM) != 0) {
-			br_ssl_engine_set_aes_ctr(&cc.eng,
-				&br_aes_ct_ctr_vtable);
-			br_ssl_engine_set_ghash(&cc.eng,
-				&br_ghash_ctmul);
+			br_ssl_engine_set_default_aes_gcm(&cc.eng);
 			br_ssl_engine_set_gcm(&cc.eng,
 				&br_sslrec_in_gcm_vtable,
 				&br_sslrec_out_gcm_vtable);
 		}
+		if ((req & REQ_AESCCM) != 0) {
+			br_ssl_engine_set_default_aes_ccm(&cc.eng);
+		}
+		if ((req & REQ_CHAPOL) != 0) {
+			br_ssl_engine_set_default_chapol(&cc.eng);
+		}
 		if ((req & REQ_3DESCBC) != 0) {
 			br_ssl_engine_set_des_cbc(&cc.eng,
 				&br_des_ct_cbcenc_vtable,
@@ -950,9 +956,12 @@ do_server(int argc, char *argv[])
 			br_ssl_engine_set_cbc(&cc.eng,
 				&br_sslrec_in_cbc_vtable,
 				&br_sslrec_out_cbc_vtable);
+			br_ssl_engine_set_cbc_etm(&cc.eng,
+				&br_sslrec_in_cbc_etm_vtable,
+				&br_sslrec_out_cbc_etm_vtable);
 		}
 		if ((req & (REQ_ECDHE_RSA | REQ_ECDHE_ECDSA)) != 0) {
-			br_ssl_engine_set_ec(&cc.eng, &br_ec_prime_i31);
+			br_ssl_engine_set_ec(&cc.eng, &br_ec_all_m32);
 		}
 	}
 	br_ssl_engine_set_suites(&cc.eng, suite_ids, num_suites);
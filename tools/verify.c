@@ -265,7 +265,7 @@ do_verify(int argc, char *argv[])
 	br_x509_minimal_set_hash(&mc, br_sha512_ID, &br_sha512_vtable);
 	br_x509_minimal_set_rsa(&mc, &br_rsa_i31_pkcs1_vrfy);
 	br_x509_minimal_set_ecdsa(&mc,
-		&br_ec_prime_i31, &br_ecdsa_i31_vrfy_asn1);
+		&br_ec_p256_m32, &br_ecdsa_i31_vrfy_asn1);
 	for (i = 0; i < 2; i ++) {
 		const br_x509_pkey *tpk;
 		int err;